@@ -357,7 +357,7 @@ static struct tile *dai_find_strategic_airbase(struct ai_type *ait,
     pcity = tile_city(ptile);
     if (pcity
         && def_ai_city_data(pcity, ait)->grave_danger
-           > (unit_list_size(ptile->units) - 1) << 1) {
+           > (unit_stack_size(ptile->units) - 1) << 1) {
       if (lost_hp <= 0 || regen_turns_min <= 1) {
         log_debug("%s stays defending %s",
                   unit_rule_name(punit), city_name_get(pcity));
@@ -405,7 +405,7 @@ static struct tile *dai_find_strategic_airbase(struct ai_type *ait,
          * at least considering that planes are usually
          * expensive and weak city defenders */
         && def_ai_city_data(pcity, ait)->grave_danger
-           > unit_list_size(ptile->units) << 1) {
+           > unit_stack_size(ptile->units) << 1) {
       if (lost_hp <= 0) {
         best_tile = ptile;
         break; /* Fly there immediately!! */
@@ -417,12 +417,12 @@ static bool is_city_surrounded_by_our_spies(struct player *pplayer,
       /* We cannot see danger at (ptile) => assume there is none. */
       continue;
     }
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       if (unit_owner(punit) == pplayer
           && aia_utype_is_considered_spy(unit_type_get(punit))) {
         return TRUE;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   } adjc_iterate_end;
 
   return FALSE;
@@ -603,7 +603,7 @@ static bool dai_diplomat_bribe_nearby(struct ai_type *ait,
 
     if (!pvictim
         || !POTENTIALLY_HOSTILE_PLAYER(ait, pplayer, unit_owner(pvictim))
-        || unit_list_size(ptile->units) > 1
+        || unit_stack_size(ptile->units) > 1
         || tile_city(ptile)
         || !is_action_enabled_unit_on_unit(ACTION_SPY_BRIBE_UNIT,
                                            punit, pvictim)) {
@@ -612,14 +612,14 @@ static bool dai_diplomat_bribe_nearby(struct ai_type *ait,
 
     /* Calculate if enemy is a threat */
     /* First find best defender on our tile */
-    unit_list_iterate(ptile->units, aunit) {
+    unit_stack_iterate(ptile->units, aunit) {
       const struct unit_type *atype = unit_type_get(aunit);
 
       newval = DEFENSE_POWER(atype);
       if (bestval < newval) {
         bestval = newval;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
     /* Compare with victim's attack power */
     ptype = unit_type_get(pvictim);
     newval = ATTACK_POWER(ptype);
@@ -549,7 +549,7 @@ int aiferry_find_boat(struct ai_type *ait, struct unit *punit,
     }
     
     square_iterate(&(wld.map), pos.tile, radius, ptile) {
-      unit_list_iterate(ptile->units, aunit) {
+      unit_stack_iterate(ptile->units, aunit) {
         if (is_boat_free(ait, aunit, punit, cap)) {
           /* Turns for the unit to get to rendezvous pnt */
           int u_turns = pos.turn;
@@ -574,7 +574,7 @@ int aiferry_find_boat(struct ai_type *ait, struct unit *punit,
             best_id = aunit->id;
           }
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     } square_iterate_end;
   } pf_map_positions_iterate_end;
   pf_map_destroy(search_map);
@@ -591,11 +591,11 @@ static int aiferry_find_boat_nearby(struct ai_type *ait, struct unit *punit,
   UNIT_LOG(LOGLEVEL_FINDFERRY, punit, "asked find_ferry_nearby for a boat");
 
   square_iterate(&(wld.map), unit_tile(punit), 1, ptile) {
-    unit_list_iterate(ptile->units, aunit) {
+    unit_stack_iterate(ptile->units, aunit) {
       if (is_boat_free(ait, aunit, punit, cap)) {
         return aunit->id;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   } square_iterate_end;
 
   return 0;
@@ -613,7 +613,7 @@ static void dai_activate_passengers(struct ai_type *ait, struct unit *ferry)
 {
   struct player *ferry_owner = unit_owner(ferry);
   
-  unit_list_iterate_safe(unit_tile(ferry)->units, aunit) {
+  unit_stack_iterate_safe(unit_tile(ferry)->units, aunit) {
     if (unit_transport_get(aunit) == ferry) {
       unit_activity_handling(aunit, ACTIVITY_IDLE);
       def_ai_unit_data(aunit, ait)->done = FALSE;
@@ -623,7 +623,7 @@ static void dai_activate_passengers(struct ai_type *ait, struct unit *ferry)
         dai_manage_unit(ait, ferry_owner, aunit);
       }
     }
-  } unit_list_iterate_safe_end;
+  } unit_stack_iterate_safe_end;
 }
 
 /**********************************************************************//**
@@ -953,7 +953,7 @@ static bool aiferry_findcargo(struct ai_type *ait, struct unit *pferry)
   
   pfm = pf_map_new(&parameter);
   pf_map_tiles_iterate(pfm, ptile, TRUE) {
-    unit_list_iterate(ptile->units, aunit) {
+    unit_stack_iterate(ptile->units, aunit) {
       struct unit_ai *unit_data = def_ai_unit_data(aunit, ait);
 
       if (unit_owner(pferry) == unit_owner(aunit) 
@@ -970,7 +970,7 @@ static bool aiferry_findcargo(struct ai_type *ait, struct unit *pferry)
         pf_map_destroy(pfm);
         return TRUE;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   } pf_map_tiles_iterate_end;
 
   /* False positive can happen if we cannot find a route to the passenger
@@ -1049,7 +1049,7 @@ static bool aiferry_find_interested_city(struct ai_type *ait,
         continue;
       }
 
-      unit_list_iterate(pos.tile->units, aunit) {
+      unit_stack_iterate(pos.tile->units, aunit) {
 	if (aunit != pferry && unit_owner(aunit) == unit_owner(pferry)
             && unit_has_type_role(aunit, L_FERRYBOAT)) {
 
@@ -1059,7 +1059,7 @@ static bool aiferry_find_interested_city(struct ai_type *ait,
 	  really_needed = FALSE;
 	  break;
 	}
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
 
       if (really_needed) {
         UNIT_LOG(LOGLEVEL_FERRY, pferry, "will go to %s unless we "
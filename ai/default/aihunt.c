@@ -69,11 +69,11 @@ static struct unit *dai_hunter_find(struct player *pplayer,
       return punit;
     }
   } unit_list_iterate_end;
-  unit_list_iterate(pcity->tile->units, punit) {
+  unit_stack_iterate(pcity->tile->units, punit) {
     if (dai_hunter_qualify(pplayer, punit)) {
       return punit;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return NULL;
 }
@@ -153,7 +153,7 @@ static void dai_hunter_missile_want(struct player *pplayer,
   struct unit_type *best_unit_type = NULL;
   struct unit *hunter = NULL;
 
-  unit_list_iterate(pcity->tile->units, punit) {
+  unit_stack_iterate(pcity->tile->units, punit) {
     if (dai_hunter_qualify(pplayer, punit)) {
       unit_type_iterate(pcargo) {
         if (can_unit_type_transport(unit_type_get(punit),
@@ -167,7 +167,7 @@ static void dai_hunter_missile_want(struct player *pplayer,
         break;
       }
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   if (!hunter) {
     return;
@@ -311,7 +311,7 @@ static void dai_hunter_try_launch(struct ai_type *ait,
   struct pf_parameter parameter;
   struct pf_map *pfm;
 
-  unit_list_iterate_safe(unit_tile(punit)->units, missile) {
+  unit_stack_iterate_safe(unit_tile(punit)->units, missile) {
     struct unit *sucker = NULL;
 
     if (unit_owner(missile) == pplayer
@@ -330,7 +330,7 @@ static void dai_hunter_try_launch(struct ai_type *ait,
             || !can_unit_attack_tile(punit, NULL, ptile)) {
           continue;
         }
-        unit_list_iterate(ptile->units, victim) {
+        unit_stack_iterate(ptile->units, victim) {
           enum diplstate_type ds =
 	    player_diplstate_get(pplayer, unit_owner(victim))->type;
           const struct unit_type *ptype;
@@ -357,7 +357,7 @@ static void dai_hunter_try_launch(struct ai_type *ait,
                      victim->id, TILE_XY(unit_tile(victim)));
             break;
           }
-        } unit_list_iterate_end;
+        } unit_stack_iterate_end;
         if (sucker) {
           break; /* found something - kill it! */
         }
@@ -387,7 +387,7 @@ static void dai_hunter_try_launch(struct ai_type *ait,
         break; /* try next missile, if any */
       }
     } /* if */
-  } unit_list_iterate_safe_end;
+  } unit_stack_iterate_safe_end;
 }
 
 /**********************************************************************//**
@@ -400,7 +400,7 @@ static void dai_hunter_juiciness(struct player *pplayer, struct unit *punit,
   *stackthreat = 0;
   *stackcost = 0;
 
-  unit_list_iterate(unit_tile(target)->units, sucker) {
+  unit_stack_iterate(unit_tile(target)->units, sucker) {
     const struct unit_type *suck_type = unit_type_get(sucker);
 
     *stackthreat += ATTACK_POWER(suck_type);
@@ -412,7 +412,7 @@ static void dai_hunter_juiciness(struct player *pplayer, struct unit *punit,
       *stackthreat += 500; /* extra threatening */
     }
     *stackcost += unit_build_shield_cost_base(sucker);
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   *stackthreat *= 9; /* WAG - reduced by distance later */
   *stackthreat += *stackcost;
@@ -466,7 +466,7 @@ int dai_hunter_manage(struct ai_type *ait, struct player *pplayer,
       continue;
     }
 
-    unit_list_iterate_safe(ptile->units, target) {
+    unit_stack_iterate_safe(ptile->units, target) {
       struct player *aplayer = unit_owner(target);
       int dist1, dist2, stackthreat = 0, stackcost = 0;
       int sanity_target = target->id;
@@ -603,7 +603,7 @@ int dai_hunter_manage(struct ai_type *ait, struct player *pplayer,
       pf_map_destroy(pfm);
       unit_data->done = TRUE;
       return stackthreat; /* still have work to do */
-    } unit_list_iterate_safe_end;
+    } unit_stack_iterate_safe_end;
   } pf_map_move_costs_iterate_end;
 
   UNIT_LOG(LOGLEVEL_HUNT, punit, "ran out of map finding hunt target");
@@ -79,7 +79,7 @@ static struct tile *find_best_tile_to_paradrop_to(struct ai_type *ait,
   
     acity = tile_city(ptile);
     if (acity && city_owner(acity) == unit_owner(punit)
-        && unit_list_size(ptile->units) == 0) {
+        && unit_stack_size(ptile->units) == 0) {
       val = city_size_get(acity) * def_ai_city_data(acity, ait)->urgency;
       if (val > best) {
 	best = val;
@@ -101,7 +101,7 @@ static struct tile *find_best_tile_to_paradrop_to(struct ai_type *ait,
   square_iterate(&(wld.map), unit_tile(punit), range, ptile) {
     acity = tile_city(ptile);
     if (acity && pplayers_at_war(unit_owner(punit), city_owner(acity))
-        && (unit_list_size(ptile->units) == 0)) {
+        && (unit_stack_size(ptile->units) == 0)) {
       if (!map_is_known_and_seen(ptile, pplayer, V_MAIN)
           && has_handicap(pplayer, H_FOG)) {
         continue;
@@ -143,12 +143,12 @@ static struct tile *find_best_tile_to_paradrop_to(struct ai_type *ait,
     if (acity && !pplayers_allied(city_owner(acity), pplayer)) {
       continue;
     }
-    if (!acity && unit_list_size(ptile->units) > 0) {
+    if (!acity && unit_stack_size(ptile->units) > 0) {
       continue;
     }
     /* Iterate over adjacent tile to find good victim */
     adjc_iterate(&(wld.map), ptile, target) {
-      if (unit_list_size(target->units) == 0
+      if (unit_stack_size(target->units) == 0
           || !can_unit_attack_tile(punit, NULL, target)
           || is_ocean_tile(target)
           || (has_handicap(pplayer, H_FOG)
@@ -157,7 +157,7 @@ static struct tile *find_best_tile_to_paradrop_to(struct ai_type *ait,
       }
       val = 0;
       if (is_stack_vulnerable(target)) {
-        unit_list_iterate(target->units, victim) {
+        unit_stack_iterate(target->units, victim) {
           if ((!has_handicap(pplayer, H_FOG)
                || can_player_see_unit(pplayer, victim))
               && (unit_attack_unit_at_tile_result(punit, NULL,
@@ -165,7 +165,7 @@ static struct tile *find_best_tile_to_paradrop_to(struct ai_type *ait,
                   == ATT_OK)) {
             val += victim->hp * 100;
           }
-        } unit_list_iterate_end;
+        } unit_stack_iterate_end;
       } else {
         val += get_defender(punit, target, NULL)->hp * 100;
       }
@@ -219,7 +219,7 @@ void dai_manage_paratrooper(struct ai_type *ait, struct player *pplayer,
     return;
   }
   
-  if (pcity && unit_list_size(unit_tile(punit)->units) == 1) {
+  if (pcity && unit_stack_size(unit_tile(punit)->units) == 1) {
     UNIT_LOG(LOGLEVEL_PARATROOPER, punit, "Defending the city.");
     return;
   }
@@ -347,7 +347,7 @@ static int calculate_want_for_paratrooper(struct unit *punit,
     }
     
     /* There are lots of units, the city will be safe against paratroopers. */
-    if (unit_list_size(ptile->units) > 2) {
+    if (unit_stack_size(ptile->units) > 2) {
       continue;
     }
     
@@ -196,11 +196,11 @@ static bool dai_gothere_bodyguard(struct ai_type *ait,
   }
 
   /* Estimate enemy attack power. */
-  unit_list_iterate(dest_tile->units, aunit) {
+  unit_stack_iterate(dest_tile->units, aunit) {
     if (POTENTIALLY_HOSTILE_PLAYER(ait, pplayer, unit_owner(aunit))) {
       danger += adv_unit_att_rating(aunit);
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
   dcity = tile_city(dest_tile);
   if (dcity && POTENTIALLY_HOSTILE_PLAYER(ait, pplayer, city_owner(dcity))) {
     /* Assume enemy will build another defender, add it's attack strength */
@@ -733,7 +733,7 @@ void dai_unit_new_task(struct ai_type *ait, struct unit *punit,
     UNIT_LOG(LOGLEVEL_HUNT, target, "is being hunted");
 
     /* Grab missiles lying around and bring them along */
-    unit_list_iterate(unit_tile(punit)->units, missile) {
+    unit_stack_iterate(unit_tile(punit)->units, missile) {
       if (unit_owner(missile) == unit_owner(punit)
           && def_ai_unit_data(missile, ait)->task != AIUNIT_ESCORT
           && !unit_transported(missile)
@@ -745,7 +745,7 @@ void dai_unit_new_task(struct ai_type *ait, struct unit *punit,
         dai_unit_new_task(ait, missile, AIUNIT_ESCORT, unit_tile(target));
         unit_transport_load_send(missile, punit);
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   }
 
   /* Map ai tasks to advisor tasks. For most ai tasks there is
@@ -1297,12 +1297,12 @@ int stack_cost(struct unit *pattacker, struct unit *pdefender)
 
   if (is_stack_vulnerable(ptile)) {
     /* lotsa people die */
-    unit_list_iterate(ptile->units, aunit) {
+    unit_stack_iterate(ptile->units, aunit) {
       if (unit_attack_unit_at_tile_result(pattacker, NULL, aunit, ptile)
           == ATT_OK) {
         victim_cost += unit_build_shield_cost_base(aunit);
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   } else if (unit_attack_unit_at_tile_result(pattacker, NULL,
                                              pdefender, ptile)
              == ATT_OK) {
@@ -221,7 +221,7 @@ static bool has_defense(struct city *pcity)
 {
   struct tile *ptile = city_tile(pcity);
 
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     if (is_military_unit(punit) && base_get_defense_power(punit) != 0
         && punit->hp != 0) {
       struct unit_class *pclass = unit_class_get(punit);
@@ -232,7 +232,7 @@ static bool has_defense(struct city *pcity)
       }
     }
   }
-  unit_list_iterate_end;
+  unit_stack_iterate_end;
 
   return FALSE;
 }
@@ -375,7 +375,7 @@ static void reinforcements_cost_and_value(struct unit *punit,
   *cost = 0;
   *value = 0;
   square_iterate(&(wld.map), ptile0, 1, ptile) {
-    unit_list_iterate(ptile->units, aunit) {
+    unit_stack_iterate(ptile->units, aunit) {
       if (aunit != punit
 	  && pplayers_allied(unit_owner(punit), unit_owner(aunit))) {
         int val = adv_unit_att_rating(aunit);
@@ -385,7 +385,7 @@ static void reinforcements_cost_and_value(struct unit *punit,
           *cost += unit_build_shield_cost_base(aunit);
         }
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   } square_iterate_end;
 }
 
@@ -400,7 +400,7 @@ static bool is_my_turn(struct unit *punit, struct unit *pdef)
   CHECK_UNIT(punit);
 
   square_iterate(&(wld.map), unit_tile(pdef), 1, ptile) {
-    unit_list_iterate(ptile->units, aunit) {
+    unit_stack_iterate(ptile->units, aunit) {
       if (aunit == punit || unit_owner(aunit) != unit_owner(punit)) {
         continue;
       }
@@ -425,7 +425,7 @@ static bool is_my_turn(struct unit *punit, struct unit *pdef)
         return FALSE;
       }
     }
-    unit_list_iterate_end;
+    unit_stack_iterate_end;
   }
   square_iterate_end;
   return TRUE;
@@ -469,7 +469,7 @@ static int dai_rampage_want(struct unit *punit, struct tile *ptile)
      * Note that we do not specially encourage attacks against
      * cities: rampage is a hit-n-run operation. */
     if (!is_stack_vulnerable(ptile) 
-        && unit_list_size(ptile->units) > 1) {
+        && unit_stack_size(ptile->units) > 1) {
       benefit = (benefit * punit->hp) / unit_type_get(punit)->hp;
     }
 
@@ -486,7 +486,7 @@ static int dai_rampage_want(struct unit *punit, struct tile *ptile)
 
       return MAX(0, desire);
     }
-  } else if (0 == unit_list_size(ptile->units)) {
+  } else if (0 == unit_stack_size(ptile->units)) {
     /* No defender. */
     struct city *pcity = tile_city(ptile);
 
@@ -737,7 +737,7 @@ int look_for_charge(struct ai_type *ait, struct player *pplayer,
     pcity = tile_city(ptile);
 
     /* Consider unit bodyguard. */
-    unit_list_iterate(ptile->units, buddy) {
+    unit_stack_iterate(ptile->units, buddy) {
       const struct unit_type *ptype = unit_type_get(punit);
       const struct unit_type *buddy_type = unit_type_get(buddy);
 
@@ -770,7 +770,7 @@ int look_for_charge(struct ai_type *ait, struct player *pplayer,
         *acity = NULL;
         best_def = def;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
 
     /* City bodyguard. TODO: allied city bodyguard? */
     if (ai_fuzzy(pplayer, TRUE)
@@ -1400,7 +1400,7 @@ int find_something_to_kill(struct ai_type *ait, struct player *pplayer,
       acity_data = def_ai_city_data(acity, ait);
 
       reserves = (acity_data->invasion.attack
-                  - unit_list_size(acity->tile->units));
+                  - unit_stack_size(acity->tile->units));
 
       if (punit->id == 0) {
         /* Real unit would add to reserves once built. */
@@ -1426,7 +1426,7 @@ int find_something_to_kill(struct ai_type *ait, struct player *pplayer,
       /* AI was not sending enough reinforcements to totally wipe out a city
        * and conquer it in one turn.
        * This variable enables total carnage. -- Syela */
-      victim_count = unit_list_size(atile->units);
+      victim_count = unit_stack_size(atile->units);
 
       if (!can_occupy && NULL == pdefender) {
         /* Nothing there to bash and we can't occupy!
@@ -1698,13 +1698,13 @@ static void dai_military_attack_barbarian(struct ai_type *ait,
         }
       } else {
         /* We are not in a boat yet. Search for one. */
-        unit_list_iterate(unit_tile(punit)->units, aunit) {
+        unit_stack_iterate(unit_tile(punit)->units, aunit) {
           if (is_boat_free(ait, aunit, punit, 1)
               && unit_transport_load(punit, aunit, FALSE)) {
             ferry = aunit;
             break;
           }
-        } unit_list_iterate_end;
+        } unit_stack_iterate_end;
       }
 
       if (ferry) {
@@ -2143,7 +2143,8 @@ static bool dai_caravan_can_trade_cities_diff_cont(struct player *pplayer,
 
 /**********************************************************************//**
   Try to move caravan to suitable city and to make it caravan's homecity.
-  Returns FALSE iff caravan dies.
+  That is the city on its continent nearest to it in moves, or in
+  distance for units needing fuel.  Returns FALSE iff caravan dies.
 **************************************************************************/
 static bool search_homecity_for_caravan(struct ai_type *ait, struct unit *punit)
 {
@@ -2151,9 +2152,11 @@ static bool search_homecity_for_caravan(struct ai_type *ait, struct unit *punit)
   int min_dist = FC_INFINITY;
   struct tile *current_loc = unit_tile(punit);
   Continent_id continent = tile_continent(current_loc);
+  struct player *pplayer = unit_owner(punit);
+  struct tile_list *sources = tile_list_new();
   bool alive = TRUE;
 
-  city_list_iterate(punit->owner->cities, pcity) {
+  city_list_iterate(pplayer->cities, pcity) {
     struct tile *ctile = city_tile(pcity);
 
     if (tile_continent(ctile) == continent) {
@@ -2163,9 +2166,34 @@ static bool search_homecity_for_caravan(struct ai_type *ait, struct unit *punit)
         min_dist = this_dist;
         nearest = pcity;
       }
+      tile_list_append(sources, ctile);
     }
   } city_list_iterate_end;
 
+  if (nearest != NULL) {
+    struct pf_parameter parameter;
+
+    pft_fill_utype_parameter(&parameter, unit_type_get(punit),
+                             city_tile(nearest), pplayer);
+    parameter.omniscience = !has_handicap(pplayer, H_MAP);
+
+    if (NULL == parameter.get_moves_left_req) {
+      struct pf_map *pfm;
+      struct pf_path *path;
+
+      /* Flood from all the cities at once: the path to the caravan
+       * starts at the city nearest to it in moves. */
+      pfm = pf_map_new_multi_source(&parameter, sources);
+      path = pf_map_path(pfm, current_loc);
+      if (NULL != path) {
+        nearest = tile_city(path->positions[0].tile);
+        pf_path_destroy(path);
+      }
+      pf_map_destroy(pfm);
+    }
+  }
+  tile_list_destroy(sources);
+
   if (nearest != NULL) {
     alive = dai_unit_goto(ait, punit, nearest->tile);
     if (alive && same_pos(unit_tile(punit), nearest->tile)) {
@@ -2514,7 +2542,7 @@ void dai_manage_military(struct ai_type *ait, struct player *pplayer,
     unit_data = def_ai_unit_data(punit, ait);
     struct city *pcity = tile_city(unit_tile(punit));
 
-    if (unit_list_find(unit_tile(punit)->units,
+    if (unit_stack_find(unit_tile(punit)->units,
                        unit_data->ferryboat)) {
       unit_activity_handling(punit, ACTIVITY_SENTRY);
     } else if (pcity || punit->activity == ACTIVITY_IDLE) {
@@ -2699,7 +2727,7 @@ static void dai_set_defenders(struct ai_type *ait, struct player *pplayer)
       struct unit *best = NULL;
       bool defense_needed = total_defense <= total_attack; /* Defense or martial */
 
-      unit_list_iterate(pcity->tile->units, punit) {
+      unit_stack_iterate(pcity->tile->units, punit) {
         struct unit_ai *unit_data = def_ai_unit_data(punit, ait);
 
         if ((unit_data->task == AIUNIT_NONE || emergency)
@@ -2712,7 +2740,7 @@ static void dai_set_defenders(struct ai_type *ait, struct player *pplayer)
             best = punit;
           }
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
       
       if (best == NULL) {
         if (defense_needed) {
@@ -2749,7 +2777,7 @@ static void dai_set_defenders(struct ai_type *ait, struct player *pplayer)
     }
     CITY_LOG(LOG_DEBUG, pcity, "Evaluating defense: %d defense, %d incoming"
              ", %d defenders (out of %d)", total_defense, total_attack, count,
-             unit_list_size(pcity->tile->units));
+             unit_stack_size(pcity->tile->units));
   } city_list_iterate_end;
 }
 
@@ -2862,7 +2890,7 @@ static void dai_manage_barbarian_leader(struct ai_type *ait,
 
   if (0 == leader->moves_left
       || (can_unit_survive_at_tile(&(wld.map), leader, leader_tile)
-          && 1 < unit_list_size(leader_tile->units))) {
+          && 1 < unit_stack_size(leader_tile->units))) {
     unit_activity_handling(leader, ACTIVITY_SENTRY);
     return;
   }
@@ -2874,7 +2902,7 @@ static void dai_manage_barbarian_leader(struct ai_type *ait,
     /* First release boat from leaders lead */
     aiferry_clear_boat(ait, leader);
 
-    unit_list_iterate(leader_tile->units, warrior) {
+    unit_stack_iterate(leader_tile->units, warrior) {
       if (!unit_has_type_role(warrior, L_BARBARIAN_LEADER)
           && get_transporter_capacity(warrior) == 0
           && warrior->moves_left > 0) {
@@ -2888,7 +2916,7 @@ static void dai_manage_barbarian_leader(struct ai_type *ait,
          * has to be replaced with unit_list_iterate_safe()*/
         return;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   }
 
   /* If we are not in charge of the boat, continue as if we
@@ -2910,7 +2938,7 @@ static void dai_manage_barbarian_leader(struct ai_type *ait,
 
     /* Find the closest body guard. FIXME: maybe choose the strongest too? */
     pf_map_tiles_iterate(pfm, ptile, FALSE) {
-      unit_list_iterate(ptile->units, punit) {
+      unit_stack_iterate(ptile->units, punit) {
         if (unit_owner(punit) == pplayer
             && !unit_has_type_role(punit, L_BARBARIAN_LEADER)
             && goto_is_sane(punit, leader_tile)) {
@@ -2921,7 +2949,7 @@ static void dai_manage_barbarian_leader(struct ai_type *ait,
           pf_map_destroy(pfm);
           return;
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     } pf_map_tiles_iterate_end;
 
     pf_map_destroy(pfm);
@@ -3049,7 +3077,7 @@ void dai_consider_tile_dangerous(struct ai_type *ait, struct tile *ptile,
       /* We cannot see danger at (ptile1) => assume there is none */
       continue;
     }
-    unit_list_iterate(ptile1->units, enemy) {
+    unit_stack_iterate(ptile1->units, enemy) {
       if (pplayers_at_war(unit_owner(enemy), unit_owner(punit)) 
           && (unit_attack_unit_at_tile_result(enemy, NULL, punit, ptile)
               == ATT_OK)
@@ -3062,7 +3090,7 @@ void dai_consider_tile_dangerous(struct ai_type *ait, struct tile *ptile,
           return;
         }
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   } adjc_iterate_end;
 
   *result = OVERRIDE_FALSE;
@@ -3220,6 +3248,7 @@ void dai_unit_init(struct ai_type *ait, struct unit *punit)
   unit_data->passenger = 0;
   unit_data->bodyguard = 0;
   unit_data->charge = 0;
+  fc_mem_account(MEM_TAG_AI, sizeof(struct unit_ai), 1);
 
   unit_set_ai_data(punit, ait, unit_data);
 }
@@ -3251,6 +3280,7 @@ void dai_unit_close(struct ai_type *ait, struct unit *punit)
   if (unit_data != NULL) {
     unit_set_ai_data(punit, ait, NULL);
     FC_FREE(unit_data);
+    fc_mem_account(MEM_TAG_AI, -(long) sizeof(struct unit_ai), -1);
   }
 }
 
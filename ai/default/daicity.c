@@ -19,6 +19,7 @@
 #include <math.h> /* pow */
 
 /* utility */
+#include "mem.h"
 #include "rand.h"
 #include "registry.h"
 
@@ -393,7 +394,7 @@ static void dai_upgrade_units(struct city *pcity, int limit, bool military)
 
   dai_calc_data(pplayer, NULL, &expenses, NULL);
 
-  unit_list_iterate(pcity->tile->units, punit) {
+  unit_stack_iterate(pcity->tile->units, punit) {
     if (pcity->owner == punit->owner) {
       /* Only upgrade units you own, not allied ones */
 
@@ -438,7 +439,7 @@ static void dai_upgrade_units(struct city *pcity, int limit, bool military)
         }
       } action_list_iterate_end;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 }
 
 /**********************************************************************//**
@@ -529,7 +530,7 @@ static void dai_spend_gold(struct ai_type *ait, struct player *pplayer)
    * learn how to ferry explorers to new land. */
   city_list_iterate(pplayer->cities, pcity) {
     struct tile *ptile = pcity->tile;
-    unit_list_iterate_safe(ptile->units, punit) {
+    unit_stack_iterate_safe(ptile->units, punit) {
       if (unit_has_type_role(punit, L_EXPLORER)
           && pcity->id == punit->homecity
           && def_ai_city_data(pcity, ait)->urgency == 0) {
@@ -537,7 +538,7 @@ static void dai_spend_gold(struct ai_type *ait, struct player *pplayer)
                  unit_rule_name(punit));
         unit_do_disband_trad(pplayer, punit, ACT_REQ_PLAYER);
       }
-    } unit_list_iterate_safe_end;
+    } unit_stack_iterate_safe_end;
   } city_list_iterate_end;
 
   dai_calc_data(pplayer, NULL, &expenses, NULL);
@@ -1107,6 +1108,7 @@ void dai_city_alloc(struct ai_type *ait, struct city *pcity)
 
   city_data->building_wait = BUILDING_WAIT_MINIMUM;
   adv_init_choice(&(city_data->choice));
+  fc_mem_account(MEM_TAG_AI, sizeof(struct ai_city), 1);
 
   city_set_ai_data(pcity, ait, city_data);
 }
@@ -1122,6 +1124,7 @@ void dai_city_free(struct ai_type *ait, struct city *pcity)
     adv_deinit_choice(&(city_data->choice));
     city_set_ai_data(pcity, ait, NULL);
     FC_FREE(city_data);
+    fc_mem_account(MEM_TAG_AI, -(long) sizeof(struct ai_city), -1);
   }
 }
 
@@ -349,7 +349,7 @@ adv_want dai_effect_value(struct player *pplayer, struct government *gov,
     break;  /* Useless for AI */
   case EFT_NUKE_PROOF:
     if (adv->threats.nuclear) {
-      v += city_size_get(pcity) * unit_list_size(pcity->tile->units)
+      v += city_size_get(pcity) * unit_stack_size(pcity->tile->units)
            * (capital + 1) * amount / 100;
     }
     break;
@@ -417,7 +417,7 @@ adv_want dai_effect_value(struct player *pplayer, struct government *gov,
     v += (8 * v * amount + num);
     break;
   case EFT_UNIT_NO_LOSE_POP:
-    v += unit_list_size(pcity->tile->units) * 2;
+    v += unit_stack_size(pcity->tile->units) * 2;
     break;
   case EFT_HP_REGEN:
     num = num_affected_units(peffect, adv);
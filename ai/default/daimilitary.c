@@ -28,6 +28,7 @@
 #include "movement.h"
 #include "research.h"
 #include "specialist.h"
+#include "unitgrid.h"
 #include "unitlist.h"
 
 /* common/aicore */
@@ -278,10 +279,10 @@ int assess_defense_quadratic(struct ai_type *ait, struct city *pcity)
     walls++;
   }
 
-  unit_list_iterate(pcity->tile->units, punit) {
+  unit_stack_iterate(pcity->tile->units, punit) {
     defense += base_assess_defense_unit(pcity, punit, igwall, FALSE,
                                         walls);
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   if (defense > 1<<12) {
     CITY_LOG(LOG_VERBOSE, pcity, "Overflow danger in assess_defense_quadratic:"
@@ -317,9 +318,9 @@ static int assess_defense_backend(struct ai_type *ait, struct city *pcity,
   /* Estimate of our total city defensive might */
   int defense = 0;
 
-  unit_list_iterate(pcity->tile->units, punit) {
+  unit_stack_iterate(pcity->tile->units, punit) {
     defense += assess_defense_unit(ait, pcity, punit, igwall);
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return defense;
 }
@@ -452,6 +453,42 @@ static void dai_reevaluate_building(struct city *pcity, adv_want *value,
   }
 }
 
+#ifdef FREECIV_WEB
+/**********************************************************************//**
+  Returns the units of aplayer near enough to the tile for freeciv-web
+  to consider them a danger, and some more.  They are collected into
+  'near' from the unit grid, falling back to all the units of aplayer.
+**************************************************************************/
+static struct unit_list *assess_danger_near_units(struct player *pplayer,
+                                                  struct player *aplayer,
+                                                  const struct tile *ptile,
+                                                  struct unit_list *near)
+{
+  struct unit_list *cells[UNIT_GRID_MAX_NEAR];
+  int dist = ASSESS_DANGER_MAX_DISTANCE;
+  int ncells, i;
+
+  if (has_handicap(pplayer, H_ASSESS_DANGER_LIMITED)) {
+    dist = MIN(dist, AI_HANDICAP_DISTANCE_LIMIT);
+  }
+
+  ncells = unit_grid_near(&wld, aplayer, ptile, dist,
+                          cells, ARRAY_SIZE(cells));
+  if (ncells < 0) {
+    return aplayer->units;
+  }
+
+  unit_list_clear(near);
+  for (i = 0; i < ncells; i++) {
+    unit_list_iterate(cells[i], punit) {
+      unit_list_append(near, punit);
+    } unit_list_iterate_end;
+  }
+
+  return near;
+}
+#endif /* FREECIV_WEB */
+
 /**********************************************************************//**
   Create cached information about danger, urgency and grave danger to our
   cities.
@@ -491,6 +528,9 @@ static unsigned int assess_danger(struct ai_type *ait, struct city *pcity,
   int city_def_against[U_LAST];
   int assess_turns;
   bool omnimap;
+#ifdef FREECIV_WEB
+  struct unit_list *near_units;
+#endif /* FREECIV_WEB */
 
   TIMING_LOG(AIT_DANGER, TIMER_START);
 
@@ -519,7 +559,7 @@ static unsigned int assess_danger(struct ai_type *ait, struct city *pcity,
 
   /* What flag-specific bonuses do our units have. */
   /* We value them less than general defense increment */
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     const struct unit_type *def = unit_type_get(punit);
 
     if (unit_has_type_flag(punit, UTYF_DIPLOMAT)) {
@@ -561,8 +601,8 @@ static unsigned int assess_danger(struct ai_type *ait, struct city *pcity,
 
       defender_type_handled[utype_index(def)] = TRUE;
     }
-  } unit_list_iterate_end;
-  if (sth_does_not_scramble || unit_list_size(ptile->units) <= 0) {
+  } unit_stack_iterate_end;
+  if (sth_does_not_scramble || unit_stack_size(ptile->units) <= 0) {
     /* Scrambling units tend to be expensive. If we have a barenaked city, we'll
      * need at least a cheap unit. If we have only scramblers,
      * maybe it's OK. */
@@ -579,6 +619,10 @@ static unsigned int assess_danger(struct ai_type *ait, struct city *pcity,
 
   omnimap = !has_handicap(pplayer, H_MAP);
 
+#ifdef FREECIV_WEB
+  near_units = unit_list_new();
+#endif /* FREECIV_WEB */
+
   /* Check. */
   players_iterate(aplayer) {
     struct pf_reverse_map *pcity_map;
@@ -596,7 +640,11 @@ static unsigned int assess_danger(struct ai_type *ait, struct city *pcity,
     if (ul_cb != NULL) {
       units = ul_cb(aplayer);
     } else {
+#ifdef FREECIV_WEB
+      units = assess_danger_near_units(pplayer, aplayer, ptile, near_units);
+#else
       units = aplayer->units;
+#endif /* FREECIV_WEB */
     }
     unit_list_iterate(units, punit) {
       int move_time;
@@ -697,6 +745,10 @@ static unsigned int assess_danger(struct ai_type *ait, struct city *pcity,
 
   } players_iterate_end;
 
+#ifdef FREECIV_WEB
+  unit_list_destroy(near_units);
+#endif /* FREECIV_WEB */
+
   if (total_danger) {
     /* If any hostile player has any dangerous unit that can in any time
      * reach the city, we consider building walls here, if none yet.
@@ -1008,7 +1060,7 @@ static void process_attacker_want(struct ai_type *ait,
   if (!is_stack_vulnerable(ptile)) {
     /* If it is a city, a fortress or an air base,
      * we may have to whack it many times */
-    victim_count += unit_list_size(ptile->units);
+    victim_count += unit_stack_size(ptile->units);
   }
 
   simple_ai_unit_type_iterate(punittype) {
@@ -1528,7 +1580,7 @@ struct adv_choice *military_advisor_choose_build(struct ai_type *ait,
   }
 
   if (martial_need
-      && unit_list_size(pcity->tile->units) < get_city_bonus(pcity, EFT_MARTIAL_LAW_MAX)) {
+      && unit_stack_size(pcity->tile->units) < get_city_bonus(pcity, EFT_MARTIAL_LAW_MAX)) {
     martial_value = dai_content_effect_value(pplayer, pcity,
                                              get_city_bonus(pcity, EFT_MARTIAL_LAW_EACH),
                                              1, FEELING_FINAL);
@@ -1537,7 +1589,7 @@ struct adv_choice *military_advisor_choose_build(struct ai_type *ait,
   /* Otherwise no need to defend yet */
   if (city_data->danger != 0 || martial_value > 0) {
     struct impr_type *pimprove;
-    int num_defenders = unit_list_size(ptile->units);
+    int num_defenders = unit_stack_size(ptile->units);
     int wall_id, danger;
     bool build_walls = TRUE;
     int qdanger = city_data->danger * city_data->danger;
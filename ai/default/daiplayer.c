@@ -15,6 +15,9 @@
 #include <fc_config.h>
 #endif
 
+/* utility */
+#include "mem.h"
+
 /* common */
 #include "ai.h"
 #include "city.h"
@@ -38,6 +41,7 @@ void dai_player_alloc(struct ai_type *ait, struct player *pplayer)
 {
   struct ai_plr *player_data = fc_calloc(1, sizeof(struct ai_plr));
 
+  fc_mem_account(MEM_TAG_AI, sizeof(struct ai_plr), 1);
   player_set_ai_data(pplayer, ait, player_data);
 
   dai_data_init(ait, pplayer);
@@ -55,6 +59,7 @@ void dai_player_free(struct ai_type *ait, struct player *pplayer)
   if (player_data != NULL) {
     player_set_ai_data(pplayer, ait, NULL);
     FC_FREE(player_data);
+    fc_mem_account(MEM_TAG_AI, -(long) sizeof(struct ai_plr), -1);
   }
 }
 
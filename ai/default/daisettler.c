@@ -141,6 +141,11 @@ static void tile_data_cache_destroy(struct tile_data_cache *ptdc);
 #define SPECHASH_IDATA_FREE tile_data_cache_destroy
 #include "spechash.h"
 
+/* Tile data caches kept for reuse, shared by the settler engines of all
+ * the players. */
+static struct fc_pool *tdc_pool = NULL;
+static int tdc_pool_users = 0;
+
 struct ai_settler {
   struct tile_data_cache_hash *tdc_hash;
 
@@ -457,7 +462,10 @@ static struct cityresult *cityresult_fill(struct ai_type *ait,
 *****************************************************************************/
 struct tile_data_cache *tile_data_cache_new(void)
 {
-  struct tile_data_cache *ptdc_copy = fc_calloc(1, sizeof(*ptdc_copy));
+  struct tile_data_cache *ptdc_copy = fc_pool_alloc(tdc_pool);
+
+  memset(ptdc_copy, 0, sizeof(*ptdc_copy));
+  fc_mem_account(MEM_TAG_AI, sizeof(*ptdc_copy), 1);
 
   /* Set the turn the tile data cache was created. */
   ptdc_copy->turn = game.info.turn;
@@ -492,7 +500,8 @@ struct tile_data_cache *
 static void tile_data_cache_destroy(struct tile_data_cache *ptdc)
 {
   if (ptdc) {
-    free(ptdc);
+    fc_pool_free(tdc_pool, ptdc);
+    fc_mem_account(MEM_TAG_AI, -(long) sizeof(*ptdc), -1);
   }
 }
 
@@ -995,6 +1004,10 @@ void dai_auto_settler_init(struct ai_plr *ai)
   fc_assert_ret(ai != NULL);
   fc_assert_ret(ai->settler == NULL);
 
+  if (tdc_pool_users++ == 0) {
+    tdc_pool = fc_pool_new(sizeof(struct tile_data_cache));
+  }
+
   ai->settler = fc_calloc(1, sizeof(*ai->settler));
   ai->settler->tdc_hash = tile_data_cache_hash_new();
 
@@ -1225,6 +1238,11 @@ void dai_auto_settler_free(struct ai_plr *ai)
       tile_data_cache_hash_destroy(ai->settler->tdc_hash);
     }
     free(ai->settler);
+
+    if (--tdc_pool_users == 0) {
+      fc_pool_destroy(tdc_pool);
+      tdc_pool = NULL;
+    }
   }
   ai->settler = NULL;
 }
@@ -182,14 +182,14 @@ static void texai_tile_worker_task_select(struct player *pplayer,
     struct extra_type *tgt = NULL;
 
     /* Do not request activities that already are under way. */
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       if (unit_owner(punit) == pplayer
           && unit_has_type_flag(punit, UTYF_SETTLERS)
           && punit->activity == action_id_get_activity(act)) {
         consider = FALSE;
         break;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
 
     if (!consider) {
       continue;
@@ -313,14 +313,14 @@ static void texai_tile_worker_task_select(struct player *pplayer,
       struct road_type *proad;
 
       /* Do not request activities that already are under way. */
-      unit_list_iterate(ptile->units, punit) {
+      unit_stack_iterate(ptile->units, punit) {
         if (unit_owner(punit) == pplayer
             && unit_has_type_flag(punit, UTYF_SETTLERS)
             && punit->activity == action_get_activity(paction)) {
           consider = FALSE;
           break;
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
 
       if (!consider) {
         continue;
@@ -310,7 +310,7 @@ void texai_unit_info_recv(void *data, enum texaimsgtype msgtype)
     punit->id = info->id;
 
     idex_register_unit(&texai_world, punit);
-    unit_list_prepend(ptile->units, punit);
+    unit_stack_prepend(ptile->units, punit);
     unit_list_prepend(plr_data->units, punit);
 
     unit_tile_set(punit, ptile);
@@ -351,7 +351,7 @@ void texai_unit_destruction_recv(void *data)
     struct texai_plr *plr_data = player_ai_data(punit->owner,
                                                 texai_get_self());
 
-    unit_list_remove(punit->tile->units, punit);
+    unit_stack_remove(punit->tile->units, punit);
     unit_list_remove(plr_data->units, punit);
     idex_unregister_unit(&texai_world, punit);
     unit_virtual_destroy(punit);
@@ -388,8 +388,8 @@ void texai_unit_moved_recv(void *data)
   struct tile *ptile = index_to_tile(&(texai_world.map), info->tindex);
 
   if (punit != NULL) {
-    unit_list_remove(punit->tile->units, punit);
-    unit_list_prepend(ptile->units, punit);
+    unit_stack_remove(punit->tile->units, punit);
+    unit_stack_prepend(ptile->units, punit);
 
     unit_tile_set(punit, ptile);
   } else {
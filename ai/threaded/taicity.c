@@ -127,14 +127,14 @@ static void tai_tile_worker_task_select(struct player *pplayer,
     enum extra_rmcause rmcause;
 
     /* Do not request activities that already are under way. */
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       if (unit_owner(punit) == pplayer
           && unit_has_type_flag(punit, UTYF_SETTLERS)
           && punit->activity == action_id_get_activity(act)) {
         consider = FALSE;
         break;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
 
     if (!consider) {
       continue;
@@ -259,14 +259,14 @@ static void tai_tile_worker_task_select(struct player *pplayer,
       struct road_type *proad;
 
       /* Do not request activities that already are under way. */
-      unit_list_iterate(ptile->units, punit) {
+      unit_stack_iterate(ptile->units, punit) {
         if (unit_owner(punit) == pplayer
             && unit_has_type_flag(punit, UTYF_SETTLERS)
             && punit->activity == action_get_activity(paction)) {
           consider = FALSE;
           break;
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
 
       if (!consider) {
         continue;
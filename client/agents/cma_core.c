@@ -331,10 +331,12 @@ static bool apply_result_on_server(struct city *pcity,
 }
 
 /************************************************************************//**
-  Prints the data of the stats struct via log_test(...).
+  Prints the data of the stats struct via log_test(...), and the CM
+  result cache statistics of the turn.
 ****************************************************************************/
 static void report_stats(void)
 {
+  int hits, misses;
 #if SHOW_TIME_STATS
   int total, per_mill;
 
@@ -347,6 +349,13 @@ static void report_stats(void)
            (1000 - per_mill) / 10, (1000 - per_mill) % 10,
            stats.apply_result_applied, total);
 #endif /* SHOW_TIME_STATS */
+
+  cm_cache_stats_get(&hits, &misses);
+  if (hits + misses > 0) {
+    log_verbose("CMA: result cache: %d hits, %d misses",
+                hits, misses);
+  }
+  cm_cache_stats_reset();
 }
 
 /************************************************************************//**
@@ -447,7 +456,6 @@ static void city_changed(int city_id)
   struct city *pcity = game_city_by_number(city_id);
 
   if (pcity) {
-    cm_clear_cache(pcity);
     handle_city(pcity);
   }
 }
@@ -66,6 +66,11 @@ static void sha_unit_change(int id)
 
   fc_assert_ret(NULL != pold_unit);
   *pold_unit = *punit;
+#ifdef FREECIV_WEB
+  /* The copy is not in the unit grid. */
+  pold_unit->grid = NULL;
+  pold_unit->grid_cell = NULL;
+#endif /* FREECIV_WEB */
 }
 
 /**********************************************************************//**
@@ -1251,16 +1251,15 @@ void city_rotate_specialist(struct city *pcity, int citizen_index)
 **************************************************************************/
 void activate_all_units(struct tile *ptile)
 {
-  struct unit_list *punit_list = ptile->units;
   struct unit *pmyunit = NULL;
 
-  unit_list_iterate(punit_list, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     if (unit_owner(punit) == client.conn.playing) {
       /* Activate this unit. */
       pmyunit = punit;
       request_new_unit_activity(punit, ACTIVITY_IDLE);
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
   if (pmyunit) {
     /* Put the focus on one of the activated units. */
     unit_focus_set(pmyunit);
@@ -280,7 +280,7 @@ static const char *cr_entry_attack(const struct city *pcity,
   static char buf[32];
   int attack_best[4] = {-1, -1, -1, -1}, i;
 
-  unit_list_iterate(pcity->tile->units, punit) {
+  unit_stack_iterate(pcity->tile->units, punit) {
     /* What about allied units?  Should we just count them? */
     attack_best[3] = unit_type_get(punit)->attack_strength;
 
@@ -292,7 +292,7 @@ static const char *cr_entry_attack(const struct city *pcity,
       attack_best[i] = attack_best[i + 1];
       attack_best[i + 1] = tmp;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   buf[0] = '\0';
   for (i = 0; i < 3; i++) {
@@ -318,7 +318,7 @@ static const char *cr_entry_defense(const struct city *pcity,
   static char buf[32];
   int defense_best[4] = {-1, -1, -1, -1}, i;
 
-  unit_list_iterate(pcity->tile->units, punit) {
+  unit_stack_iterate(pcity->tile->units, punit) {
     /* What about allied units?  Should we just count them? */
     defense_best[3] = unit_type_get(punit)->defense_strength;
 
@@ -330,7 +330,7 @@ static const char *cr_entry_defense(const struct city *pcity,
       defense_best[i] = defense_best[i + 1];
       defense_best[i + 1] = tmp;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   buf[0] = '\0';
   for (i = 0; i < 3; i++) {
@@ -370,7 +370,7 @@ static const char *cr_entry_present(const struct city *pcity,
                                     const void *data)
 {
   static char buf[8];
-  int num_present = unit_list_size(pcity->tile->units);
+  int num_present = unit_stack_size(pcity->tile->units);
 
   fc_snprintf(buf, sizeof(buf), "%2d", num_present);
 
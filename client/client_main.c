@@ -1571,13 +1571,13 @@ static struct player *mapimg_client_tile_unit(const struct tile *ptile,
                                               const struct player *pplayer,
                                               bool knowledge)
 {
-  int unit_count = unit_list_size(ptile->units);
+  int unit_count = unit_stack_size(ptile->units);
 
   if (unit_count == 0) {
     return NULL;
   }
 
-  return unit_owner(unit_list_get(ptile->units, 0));
+  return unit_owner(unit_stack_get(ptile->units, 0));
 }
 
 /**********************************************************************//**
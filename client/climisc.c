@@ -106,7 +106,7 @@ void client_remove_unit(struct unit *punit)
   pcity = tile_city(ptile);
   if (NULL != pcity) {
     if (can_player_see_units_in_city(client_player(), pcity)) {
-      pcity->client.occupied = (0 < unit_list_size(pcity->tile->units));
+      pcity->client.occupied = (0 < unit_stack_size(pcity->tile->units));
       refresh_city_dialog(pcity);
     }
 
@@ -559,12 +559,12 @@ bool city_unit_present(const struct city *pcity,
   if (VUT_UTYPE == target->kind) {
     const struct unit_type *tvtype = target->value.utype;
 
-    unit_list_iterate(pcity->tile->units, punit) {
+    unit_stack_iterate(pcity->tile->units, punit) {
       if (unit_type_get(punit) == tvtype) {
         return TRUE;
       }
     }
-    unit_list_iterate_end;
+    unit_stack_iterate_end;
   }
   return FALSE;
 }
@@ -932,16 +932,12 @@ int num_supported_units_in_city(struct city *pcity)
 **************************************************************************/
 int num_present_units_in_city(struct city *pcity)
 {
-  struct unit_list *plist;
-
   if (can_player_see_units_in_city(client.conn.playing, pcity)) {
     /* Other players don't see inside the city (but observers do). */
-    plist = pcity->client.info_units_present;
+    return unit_list_size(pcity->client.info_units_present);
   } else {
-    plist = pcity->tile->units;
+    return unit_stack_size(pcity->tile->units);
   }
-
-  return unit_list_size(plist);
 }
 
 /**********************************************************************//**
@@ -643,7 +643,7 @@ static struct unit *find_best_focus_candidate(bool accept_current)
   }
 
   iterate_outward(&(wld.map), ptile, FC_INFINITY, ptile2) {
-    unit_list_iterate(ptile2->units, punit) {
+    unit_stack_iterate(ptile2->units, punit) {
       if ((!unit_is_in_focus(punit) || accept_current)
           && unit_owner(punit) == client.conn.playing
           && punit->client.focus_status == FOCUS_AVAIL
@@ -654,7 +654,7 @@ static struct unit *find_best_focus_candidate(bool accept_current)
           && punit->ssa_controller == SSA_NONE) {
         return punit;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   } iterate_outward_end;
 
   return NULL;
@@ -806,26 +806,26 @@ struct unit *find_visible_unit(struct tile *ptile)
   struct unit *panyowned = NULL, *panyother = NULL, *ptptother = NULL;
 
   /* If no units here, return nothing. */
-  if (unit_list_size(ptile->units) == 0) {
+  if (unit_stack_size(ptile->units) == 0) {
     return NULL;
   }
 
   /* If a unit is attacking we should show that on top */
   if (punit_attacking && same_pos(unit_tile(punit_attacking), ptile)) {
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       if (punit == punit_attacking) {
         return punit;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   }
 
   /* If a unit is defending we should show that on top */
   if (punit_defending && same_pos(unit_tile(punit_defending), ptile)) {
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       if (punit == punit_defending) {
         return punit;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   }
 
   /* If the unit in focus is at this tile, show that on top */
@@ -846,7 +846,7 @@ struct unit *find_visible_unit(struct tile *ptile)
        3: any transporter
        4: any unit
      (always return first in stack). */
-  unit_list_iterate(ptile->units, punit)
+  unit_stack_iterate(ptile->units, punit)
     if (unit_owner(punit) == client.conn.playing) {
       if (!unit_transported(punit)) {
         if (get_transporter_capacity(punit) > 0) {
@@ -862,7 +862,7 @@ struct unit *find_visible_unit(struct tile *ptile)
 	panyother = punit;
       }
     }
-  unit_list_iterate_end;
+  unit_stack_iterate_end;
 
   return (panyowned ? panyowned : (ptptother ? ptptother : panyother));
 }
@@ -980,7 +980,7 @@ void update_unit_pix_label(struct unit_list *punitlist)
     set_unit_icon(-1, punit);
 
     i = 0;			/* index into unit_below_canvas */
-    unit_list_iterate(unit_tile(punit)->units, aunit) {
+    unit_stack_iterate(unit_tile(punit)->units, aunit) {
       if (aunit != punit) {
 	if (i < num_units_below) {
 	  set_unit_icon(i, aunit);
@@ -988,7 +988,7 @@ void update_unit_pix_label(struct unit_list *punitlist)
 	i++;
       }
     }
-    unit_list_iterate_end;
+    unit_stack_iterate_end;
     
     if (i > num_units_below) {
       set_unit_icons_more_arrow(TRUE);
@@ -1291,11 +1291,11 @@ void control_mouse_cursor(struct tile *ptile)
 static bool is_activity_on_tile(struct tile *ptile,
 				enum unit_activity activity)
 {
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     if (punit->activity == activity) {
       return TRUE;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return FALSE;
 }
@@ -1484,7 +1484,7 @@ struct unit *request_unit_unload_all(struct unit *punit)
     return NULL;
   }
 
-  unit_list_iterate(ptile->units, pcargo) {
+  unit_stack_iterate(ptile->units, pcargo) {
     if (unit_transport_get(pcargo) == punit) {
       request_unit_unload(pcargo);
 
@@ -1497,7 +1497,7 @@ struct unit *request_unit_unload_all(struct unit *punit)
 	plast = pcargo;
       }
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return plast;
 }
@@ -1550,13 +1550,13 @@ void wakeup_sentried_units(struct tile *ptile)
   if (!can_client_issue_orders()) {
     return;
   }
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     if (punit->activity == ACTIVITY_SENTRY
 	&& unit_owner(punit) == client.conn.playing) {
       request_new_unit_activity(punit, ACTIVITY_IDLE);
     }
   }
-  unit_list_iterate_end;
+  unit_stack_iterate_end;
 }
 
 /**********************************************************************//**
@@ -1626,7 +1626,7 @@ void request_unit_select(struct unit_list *punits,
 
   if (selloc == SELLOC_TILE) {
     tile_hash_iterate(tile_table, hash_tile) {
-      unit_list_iterate(hash_tile->units, punit) {
+      unit_stack_iterate(hash_tile->units, punit) {
         if (unit_owner(punit) != pplayer) {
           continue;
         }
@@ -1635,7 +1635,7 @@ void request_unit_select(struct unit_list *punits,
           continue;
         }
         unit_focus_add(punit);
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     } tile_hash_iterate_end;
   } else {
     unit_list_iterate(pplayer->units, punit) {
@@ -2672,7 +2672,7 @@ void do_move_unit(struct unit *punit, struct unit *target_unit)
     update_unit_info_label(get_units_in_focus());
   }
 
-  unit_list_remove(src_tile->units, punit);
+  unit_stack_remove(src_tile->units, punit);
 
   if (!unit_transported(punit)) {
     /* Mark the unit as moving unit, then find_visible_unit() won't return
@@ -2698,7 +2698,7 @@ void do_move_unit(struct unit *punit, struct unit *target_unit)
   }
 
   unit_tile_set(punit, dst_tile);
-  unit_list_prepend(dst_tile->units, punit);
+  unit_stack_prepend(dst_tile->units, punit);
 
   if (!unit_transported(punit)) {
     /* For find_visible_unit(), see above. */
@@ -2790,13 +2790,13 @@ void do_map_click(struct tile *ptile, enum quickselect_type qtype)
              && can_player_see_city_internals(client.conn.playing, pcity)) {
     /* Otherwise use popups. */
     popup_city_dialog(pcity);
-  } else if (unit_list_size(ptile->units) == 0
+  } else if (unit_stack_size(ptile->units) == 0
              && NULL == pcity
              && get_num_units_in_focus() > 0) {
     maybe_goto = gui_options.keyboardless_goto;
-  } else if (unit_list_size(ptile->units) == 1
-             && !get_transporter_occupancy(unit_list_get(ptile->units, 0))) {
-    struct unit *punit = unit_list_get(ptile->units, 0);
+  } else if (unit_stack_size(ptile->units) == 1
+             && !get_transporter_occupancy(unit_stack_get(ptile->units, 0))) {
+    struct unit *punit = unit_stack_get(ptile->units, 0);
 
     if (unit_owner(punit) == client.conn.playing) {
       if (can_unit_do_activity(punit, ACTIVITY_IDLE)) {
@@ -2811,7 +2811,7 @@ void do_map_click(struct tile *ptile, enum quickselect_type qtype)
       /* Don't hide the unit in the city. */
       unit_select_dialog_popup(ptile);
     }
-  } else if (unit_list_size(ptile->units) > 0) {
+  } else if (unit_stack_size(ptile->units) > 0) {
     /* The stack list is always popped up, even if it includes enemy units.
      * If the server doesn't want the player to know about them it shouldn't
      * tell him!  The previous behavior would only pop up the stack if you
@@ -2835,7 +2835,7 @@ void do_map_click(struct tile *ptile, enum quickselect_type qtype)
 static struct unit *quickselect(struct tile *ptile,
                                 enum quickselect_type qtype)
 {
-  int listsize = unit_list_size(ptile->units);
+  int listsize = unit_stack_size(ptile->units);
   struct unit *panytransporter = NULL,
               *panymovesea  = NULL, *panysea  = NULL,
               *panymoveland = NULL, *panyland = NULL,
@@ -2850,7 +2850,7 @@ static struct unit *quickselect(struct tile *ptile,
   if (listsize == 0) {
     return NULL;
   } else if (listsize == 1) {
-    struct unit *punit = unit_list_get(ptile->units, 0);
+    struct unit *punit = unit_stack_get(ptile->units, 0);
     return (unit_owner(punit) == client.conn.playing) ? punit : NULL;
   }
 
@@ -2867,7 +2867,7 @@ static struct unit *quickselect(struct tile *ptile,
    *          Any unit
    */
 
-  unit_list_iterate(ptile->units, punit)  {
+  unit_stack_iterate(ptile->units, punit)  {
     if (unit_owner(punit) != client.conn.playing || unit_is_in_focus(punit)) {
       continue;
     }
@@ -2916,7 +2916,7 @@ static struct unit *quickselect(struct tile *ptile,
   if (!panyunit) {
     panyunit = punit;
   }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
 
   if (qtype == SELECT_SEA) {
     if (panytransporter) {
@@ -3882,7 +3882,7 @@ void key_editor_toggle_fogofwar(void)
 **************************************************************************/
 void finish_city(struct tile *ptile, const char *name)
 {
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     if (punit->client.asking_city_name) {
       /* Unit will disappear only in case city building still success.
        * Cancel city building status just in case something has changed
@@ -3892,7 +3892,7 @@ void finish_city(struct tile *ptile, const char *name)
       request_do_action(ACTION_FOUND_CITY, punit->id, ptile->index,
                         0, name);
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 }
 
 /**********************************************************************//**
@@ -3901,7 +3901,7 @@ void finish_city(struct tile *ptile, const char *name)
 **************************************************************************/
 void cancel_city(struct tile *ptile)
 {
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     punit->client.asking_city_name = FALSE;
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 }
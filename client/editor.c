@@ -477,8 +477,8 @@ static void editor_grab_applied_player(const struct tile *ptile)
 
   if (tile_city(ptile) != NULL) {
     apno = player_number(city_owner(tile_city(ptile)));
-  } else if (unit_list_size(ptile->units) > 0) {
-    struct unit *punit = unit_list_get(ptile->units, 0);
+  } else if (unit_stack_size(ptile->units) > 0) {
+    struct unit *punit = unit_stack_get(ptile->units, 0);
 
     apno = player_number(unit_owner(punit));
   } else if (tile_owner(ptile) != NULL) {
@@ -537,11 +537,11 @@ static void editor_grab_tool(const struct tile *ptile)
   } else if (tile_city(ptile)) {
     ett = ETT_CITY;
 
-  } else if (unit_list_size(ptile->units) > 0) {
+  } else if (unit_stack_size(ptile->units) > 0) {
     int max_score = 0, score;
     struct unit *grabbed_punit = NULL;
 
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       if (uclass_has_flag(unit_class_get(punit), UCF_UNREACHABLE)) {
         score = 5;
       } else if (utype_move_type(unit_type_get(punit)) == UMT_LAND) {
@@ -559,7 +559,7 @@ static void editor_grab_tool(const struct tile *ptile)
         max_score = score;
         grabbed_punit = punit;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
 
     if (grabbed_punit) {
       ett = ETT_UNIT;
@@ -1556,7 +1556,7 @@ void edit_buffer_copy(struct edit_buffer *ebuf, const struct tile *ptile)
       } extra_type_iterate_end;
       break;
     case EBT_UNIT:
-      unit_list_iterate(ptile->units, punit) {
+      unit_stack_iterate(ptile->units, punit) {
         if (!punit) {
           continue;
         }
@@ -1564,9 +1564,9 @@ void edit_buffer_copy(struct edit_buffer *ebuf, const struct tile *ptile)
                                     unit_type_get(punit), punit->veteran);
         vunit->homecity = punit->homecity;
         vunit->hp = punit->hp;
-        unit_list_append(vtile->units, vunit);
+        unit_stack_append(vtile->units, vunit);
         copied = TRUE;
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
       break;
     case EBT_CITY:
       if (tile_city(ptile)) {
@@ -1704,11 +1704,11 @@ static void paste_tile(struct edit_buffer *ebuf,
       } extra_type_iterate_end;
       break;
     case EBT_UNIT:
-      unit_list_iterate(vtile->units, vunit) {
+      unit_stack_iterate(vtile->units, vunit) {
         value = utype_number(unit_type_get(vunit));
         owner = player_number(unit_owner(vunit));
         dsend_packet_edit_unit_create(my_conn, owner, tile, value, 1, 0);
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
       break;
     case EBT_CITY:
       vcity = tile_city(vtile);
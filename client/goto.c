@@ -54,6 +54,7 @@ struct part {
   int end_moves_left, end_fuel_left;
   struct pf_path *path;
   struct pf_map *map;
+  bool shared_map;      /* If 'map' belongs to 'goto_map_group'. */
 };
 
 struct goto_map {
@@ -89,6 +90,9 @@ struct goto_map {
   } goto_map_list_iterate_end;
 
 static struct goto_map_list *goto_maps = NULL;
+/* The first parts of units starting from the same tile with the same
+ * parameter share their map. */
+static struct pf_map_group *goto_map_group = NULL;
 static bool goto_warned = FALSE;
 
 static void reset_last_part(struct goto_map *goto_map);
@@ -168,6 +172,10 @@ void free_client_goto(void)
     goto_map_list_destroy(goto_maps);
     goto_maps = NULL;
   }
+  if (NULL != goto_map_group) {
+    pf_map_group_destroy(goto_map_group);
+    goto_map_group = NULL;
+  }
 
   goto_destination = NULL;
   goto_warned = FALSE;
@@ -460,7 +468,14 @@ static void add_part(struct goto_map *goto_map)
   p->path = NULL;
   p->end_tile = p->start_tile;
   parameter.start_tile = p->start_tile;
-  p->map = pf_map_new(&parameter);
+  if (goto_map->num_parts == 1 && NULL != goto_map_group) {
+    /* Only pf_map_path() is used on it, so it can be shared. */
+    p->map = pf_map_group_get(goto_map_group, &parameter);
+    p->shared_map = TRUE;
+  } else {
+    p->map = pf_map_new(&parameter);
+    p->shared_map = FALSE;
+  }
 }
 
 /************************************************************************//**
@@ -477,7 +492,9 @@ static void remove_last_part(struct goto_map *goto_map)
     /* We do not always have a path */
     pf_path_destroy(p->path);
   }
-  pf_map_destroy(p->map);
+  if (!p->shared_map) {
+    pf_map_destroy(p->map);
+  }
   goto_map->num_parts--;
 }
 
@@ -1002,6 +1019,11 @@ void enter_goto_state(struct unit_list *punits)
   /* Can't have selection rectangle and goto going on at the same time. */
   cancel_selection_rectangle();
 
+  if (NULL != goto_map_group) {
+    pf_map_group_destroy(goto_map_group);
+  }
+  goto_map_group = pf_map_group_new();
+
   unit_list_iterate(punits, punit) {
     struct goto_map *goto_map = goto_map_new(punit);
 
@@ -1027,6 +1049,11 @@ void exit_goto_state(void)
   } goto_map_list_iterate_end;
   goto_map_list_clear(goto_maps);
 
+  if (NULL != goto_map_group) {
+    pf_map_group_destroy(goto_map_group);
+    goto_map_group = NULL;
+  }
+
   goto_destination = NULL;
   goto_warned = FALSE;
 }
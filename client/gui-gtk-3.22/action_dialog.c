@@ -1064,12 +1064,15 @@ static void act_sel_new_unit_tgt_callback(GtkWidget *w, gpointer data)
   if ((punit = game_unit_by_number(args->actor_unit_id))
       && (ptile = index_to_tile(&(wld.map), args->target_tile_id))
       && (tunit = game_unit_by_number(args->target_unit_id))) {
-    select_tgt_unit(punit, ptile, ptile->units, tunit,
+    struct unit_list *tgt_units = unit_stack_to_list(ptile->units);
+
+    select_tgt_unit(punit, ptile, tgt_units, tunit,
                     _("Target unit selection"),
                     _("Looking for target unit:"),
                     _("Units at tile:"),
                     _("Select"),
                     G_CALLBACK(tgt_unit_change_callback));
+    unit_list_destroy(tgt_units);
   }
 
   did_not_decide = TRUE;
@@ -1517,7 +1520,7 @@ void popup_action_selection(struct unit *actor_unit,
   } action_iterate_end;
 
   if (target_unit != NULL
-      && unit_list_size(target_tile->units) > 1) {
+      && unit_stack_size(target_tile->units) > 1) {
     action_button_map[BUTTON_NEW_UNIT_TGT] =
         choice_dialog_get_number_of_buttons(shl);
     choice_dialog_add(shl, _("Change unit target"),
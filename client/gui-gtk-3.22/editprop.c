@@ -5190,9 +5190,9 @@ static void property_page_add_objbinds_from_tile(struct property_page *pp,
     return;
 
   case OBJTYPE_UNIT:
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       property_page_add_objbind(pp, punit);
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
     return;
 
   case OBJTYPE_CITY:
@@ -85,12 +85,12 @@ bool request_transport(struct unit *cargo, struct tile *ptile)
   struct unit_list *potential_transports = unit_list_new();
   struct unit *best_transport = transporter_for_unit_at(cargo, ptile);
 
-  unit_list_iterate(ptile->units, ptransport) {
+  unit_stack_iterate(ptile->units, ptransport) {
     if (can_unit_transport(ptransport, cargo)
         && get_transporter_occupancy(ptransport) < get_transporter_capacity(ptransport)) {
       unit_list_append(potential_transports, ptransport);
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   tcount = unit_list_size(potential_transports);
 
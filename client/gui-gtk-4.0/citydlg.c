@@ -492,7 +492,7 @@ void real_city_dialog_refresh(struct city *pcity)
   city_dialog_update_present_units(pdialog);
 
   if (!client_has_player() || city_owner(pcity) == client_player()) {
-    bool have_present_units = (unit_list_size(pcity->tile->units) > 0);
+    bool have_present_units = (unit_stack_size(pcity->tile->units) > 0);
 
     refresh_worklist(pdialog->production.worklist);
 
@@ -2211,9 +2211,9 @@ static void city_dialog_update_present_units(struct city_dialog *pdialog)
 
   if (NULL != client.conn.playing
       && city_owner(pdialog->pcity) != client.conn.playing) {
-    units = pdialog->pcity->client.info_units_present;
+    units = unit_list_copy(pdialog->pcity->client.info_units_present);
   } else {
-    units = pdialog->pcity->tile->units;
+    units = unit_stack_to_list(pdialog->pcity->tile->units);
   }
 
   nodes = &pdialog->overview.present_units;
@@ -2298,6 +2298,8 @@ static void city_dialog_update_present_units(struct city_dialog *pdialog)
   buf = g_strdup_printf(_("Present units %d"), n);
   gtk_frame_set_label(GTK_FRAME(pdialog->overview.present_units_frame), buf);
   g_free(buf);
+
+  unit_list_destroy(units);
 }
 
 /***********************************************************************//**
@@ -2364,7 +2366,7 @@ static void show_units_response(void *data)
   struct city_dialog *pdialog = (struct city_dialog *) data;
   struct tile *ptile = pdialog->pcity->tile;
 
-  if (unit_list_size(ptile->units)) {
+  if (unit_stack_size(ptile->units)) {
     unit_select_dialog_popup(ptile);
   }
 }
@@ -3176,9 +3176,9 @@ void city_dialog::update_units()
 
   if (NULL != client.conn.playing
       && city_owner(dlgcity) != client.conn.playing) {
-    units = dlgcity->client.info_units_present;
+    units = unit_list_copy(dlgcity->client.info_units_present);
   } else {
-    units = dlgcity->tile->units;
+    units = unit_stack_to_list(dlgcity->tile->units);
   }
 
   unit_list_iterate(units, punit) {
@@ -3188,6 +3188,7 @@ void city_dialog::update_units()
   } unit_list_iterate_end;
 
   n = unit_list_size(units);
+  unit_list_destroy(units);
   fc_snprintf(buf, sizeof(buf), _("Present units %d"), n);
   curr_units->setText(QString(buf));
 
@@ -1237,8 +1237,8 @@ void popdown_races_dialog(void)
 void unit_select_dialog_popup(struct tile *ptile)
 {
   if (ptile != NULL
-      && (unit_list_size(ptile->units) > 1
-          || (unit_list_size(ptile->units) == 1 && tile_city(ptile)))) {
+      && (unit_stack_size(ptile->units) > 1
+          || (unit_stack_size(ptile->units) == 1 && tile_city(ptile)))) {
     gui()->toggle_unit_sel_widget(ptile);
   }
 }
@@ -1427,7 +1427,7 @@ void choice_dialog::set_layout()
   targeted_unit = game_unit_by_number(target_id[ATK_UNIT]);
 
   if ((game_unit_by_number(unit_id)) && targeted_unit
-      && unit_list_size(targeted_unit->tile->units) > 1) {
+      && unit_stack_size(targeted_unit->tile->units) > 1) {
     struct canvas *pix;
     QPushButton *next, *prev;
     unit_skip = new QHBoxLayout;
@@ -1577,7 +1577,7 @@ void choice_dialog::next_unit()
 
   ptile = targeted_unit->tile;
 
-  unit_list_iterate(ptile->units, ptgt) {
+  unit_stack_iterate(ptile->units, ptgt) {
     if (first) {
       new_target = ptgt;
       first = false;
@@ -1589,7 +1589,7 @@ void choice_dialog::next_unit()
     if (ptgt == targeted_unit) {
        break_next = true;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
   targeted_unit = new_target;
   pix = qtg_canvas_create(tileset_unit_width(tileset),
                           tileset_unit_height(tileset));
@@ -1613,12 +1613,12 @@ void choice_dialog::prev_unit()
   }
 
   ptile = targeted_unit->tile;
-  unit_list_iterate(ptile->units, ptgt) {
+  unit_stack_iterate(ptile->units, ptgt) {
     if ((ptgt == targeted_unit) && new_target != nullptr) {
        break;
     }
     new_target = ptgt;
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
   targeted_unit = new_target;
   pix = qtg_canvas_create(tileset_unit_width(tileset),
                           tileset_unit_height(tileset));
@@ -4652,8 +4652,8 @@ void units_select::paint(QPainter *painter, QPaintEvent *event)
                                       QString::number(unit_type_get(punit)->hp));
   }
   str = QString(PL_("%1 unit", "%1 units",
-                    unit_list_size(utile->units)))
-                .arg(unit_list_size(utile->units));
+                    unit_stack_size(utile->units)))
+                .arg(unit_stack_size(utile->units));
   for (i = *f_size; i > 4; i--) {
     if (point_size < 0) {
       info_font.setPixelSize(i);
@@ -4727,7 +4727,7 @@ void units_select::update_menu()
 void units_select::update_units()
 {
   int i = 1;
-  struct unit_list *punit_list;
+  struct unit_stack *punit_list;
 
   unit_count = 0;
   if (utile == NULL) {
@@ -4740,12 +4740,12 @@ void units_select::update_units()
   if (utile != nullptr) {
     punit_list = utile->units;
     if (punit_list != nullptr) {
-      unit_list_iterate(utile->units, punit) {
+      unit_stack_iterate(utile->units, punit) {
         unit_count++;
         if (i > show_line * 4)
           unit_list.push_back(punit);
         i++;
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     }
   }
   if (unit_list.count() == 0) {
@@ -4772,7 +4772,7 @@ void units_select::wheelEvent(QWheelEvent *event)
   if (!more && utile == NULL) {
     return;
   }
-  nr = qCeil(static_cast<qreal>(unit_list_size(utile->units)) / 4) - 3;
+  nr = qCeil(static_cast<qreal>(unit_stack_size(utile->units)) / 4) - 3;
   if (event->angleDelta().y() < 0) {
     show_line++;
     show_line = qMin(show_line, nr);
@@ -4835,12 +4835,12 @@ bool qtg_request_transport(struct unit *pcargo, struct tile *ptile)
   struct unit_list *potential_transports = unit_list_new();
   struct unit *best_transport = transporter_for_unit_at(pcargo, ptile);
 
-  unit_list_iterate(ptile->units, ptransport) {
+  unit_stack_iterate(ptile->units, ptransport) {
     if (can_unit_transport(ptransport, pcargo)
         && get_transporter_occupancy(ptransport) < get_transporter_capacity(ptransport)) {
       unit_list_append(potential_transports, ptransport);
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   tcount = unit_list_size(potential_transports);
 
@@ -642,8 +642,8 @@ void hud_units::update_actions(unit_list *punits)
   text_str += QString(_("HP:%1/%2")).arg(
                 QString::number(punit->hp),
                 QString::number(unit_type_get(punit)->hp));
-  num = unit_list_size(punit->tile->units);
-  snum = QString::number(unit_list_size(punit->tile->units) - 1);
+  num = unit_stack_size(punit->tile->units);
+  snum = QString::number(unit_stack_size(punit->tile->units) - 1);
   if (unit_list_size(get_units_in_focus()) > 1) {
     int n = unit_list_size(get_units_in_focus());
     /* TRANS: preserve leading space; always at least 2 */
@@ -1234,14 +1234,14 @@ void hud_unit_loader::show_me()
   int w,h;
   sprite *spite;
 
-  unit_list_iterate(qtile->units, ptransport) {
+  unit_stack_iterate(qtile->units, ptransport) {
     if (can_unit_transport(ptransport, cargo)
         && get_transporter_occupancy(ptransport)
         < get_transporter_capacity(ptransport)) {
       transports.append(ptransport);
       max_size = qMax(max_size, get_transporter_occupancy(ptransport));
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   setRowCount(transports.count());
   setColumnCount(max_size + 1);
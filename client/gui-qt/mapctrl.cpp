@@ -329,7 +329,7 @@ void map_view::shortcut_pressed(int key)
 
     sc = fc_shortcuts::sc()->get_shortcut(SC_SHOW_UNITS);
     if (((key && key == sc->key) || bt == sc->mouse) && md == sc->mod
-        && ctile != nullptr && unit_list_size(ctile->units) > 0) {
+        && ctile != nullptr && unit_stack_size(ctile->units) > 0) {
       gui()->toggle_unit_sel_widget(ctile);
 
       return;
@@ -3727,12 +3727,12 @@ void multiairlift(struct city *acity, Unit_type_id ut)
   city_list_iterate(client.conn.playing->cities, pcity) {
     if (get_city_bonus(pcity, EFT_AIRLIFT) > 0) {
       ptile = city_tile(pcity);
-      unit_list_iterate(ptile->units, punit) {
+      unit_stack_iterate(ptile->units, punit) {
         if (punit->utype == utype_by_number(ut)) {
           request_unit_airlift(punit, acity);
           break;
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     }
   } city_list_iterate_end;
 }
@@ -1847,6 +1847,8 @@ static void redraw_supported_units_city_dialog(struct widget *city_window,
                    pcity_dlg->panel->end_widget_list, 0);
     }
   }
+
+  unit_list_destroy(units);
 }
 
 /**********************************************************************//**
@@ -1864,9 +1866,9 @@ static void redraw_army_city_dialog(struct widget *city_window,
   int size;
 
   if (city_owner(pcity_dlg->pcity) != client.conn.playing) {
-    units = pcity_dlg->pcity->client.info_units_present;
+    units = unit_list_copy(pcity_dlg->pcity->client.info_units_present);
   } else {
-    units = pcity_dlg->pcity->tile->units;
+    units = unit_stack_to_list(pcity_dlg->pcity->tile->units);
   }
 
   size = unit_list_size(units);
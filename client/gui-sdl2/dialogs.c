@@ -1089,7 +1089,7 @@ void unit_select_dialog_popup(struct tile *ptile)
 
 #define NUM_SEEN 20
 
-  n = unit_list_size(ptile->units);
+  n = unit_stack_size(ptile->units);
 
   if (!n || unit_select_dlg) {
     return;
@@ -1130,7 +1130,7 @@ void unit_select_dialog_popup(struct tile *ptile)
   for (i = 0; i < n; i++) {
     const char *vetname;
 
-    punit = unit_list_get(ptile->units, i);
+    punit = unit_stack_get(ptile->units, i);
     punittype = unit_type_get(punit);
     vetname = utype_veteran_name_translation(punittype, punit->veteran);
 
@@ -1560,14 +1560,14 @@ static int adv_unit_sentry_idle_callback(struct widget *pwidget)
     if (punit) {
       struct tile *ptile = unit_tile(punit);
 
-      unit_list_iterate(ptile->units, other_unit) {
+      unit_stack_iterate(ptile->units, other_unit) {
         if (unit_owner(other_unit) == client.conn.playing
             && ACTIVITY_IDLE == other_unit->activity
             && other_unit->ssa_controller == SSA_NONE
             && can_unit_do_activity(other_unit, ACTIVITY_SENTRY)) {
           request_new_unit_activity(other_unit, ACTIVITY_SENTRY);
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     }
   }
 
@@ -1681,7 +1681,7 @@ void popup_advanced_terrain_dialog(struct tile *ptile, Uint16 pos_x, Uint16 pos_
   }
 
   pcity = tile_city(ptile);
-  n = unit_list_size(ptile->units);
+  n = unit_stack_size(ptile->units);
   focus_unit = head_of_units_in_focus();
 
   if (!n && !pcity && !focus_unit) {
@@ -1895,7 +1895,7 @@ void popup_advanced_terrain_dialog(struct tile *ptile, Uint16 pos_x, Uint16 pos_
                              : NULL);
       attacker = (focus_unit ? get_attacker(focus_unit, ptile) : NULL);
       for (i = 0; i < n; i++) {
-        punit = unit_list_get(ptile->units, i);
+        punit = unit_stack_get(ptile->units, i);
         if (punit == focus_unit) {
           continue;
         }
@@ -2007,7 +2007,7 @@ void popup_advanced_terrain_dialog(struct tile *ptile, Uint16 pos_x, Uint16 pos_
 #undef ADV_NUM_SEEN
     } else { /* n == 1 */
       /* one unit - give orders */
-      punit = unit_list_get(ptile->units, 0);
+      punit = unit_stack_get(ptile->units, 0);
       punittype = unit_type_get(punit);
       if (punit != focus_unit) {
         const char *vetname;
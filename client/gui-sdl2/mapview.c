@@ -714,7 +714,7 @@ void redraw_unit_info_label(struct unit_list *punitlist)
 
       /* ------------------------------------------- */
 
-      n = unit_list_size(ptile->units);
+      n = unit_stack_size(ptile->units);
       y = 0;
 
       if (n > 1 && ((!right && info2
@@ -805,7 +805,7 @@ void redraw_unit_info_label(struct unit_list *punitlist)
         dock = info_window;
         n = 0;
 
-        unit_list_iterate(ptile->units, aunit) {
+        unit_stack_iterate(ptile->units, aunit) {
           SDL_Surface *tmp_surf;
 
           if (aunit == punit) {
@@ -877,7 +877,7 @@ void redraw_unit_info_label(struct unit_list *punitlist)
 
           buf->action = focus_units_info_callback;
 
-        } unit_list_iterate_end;
+        } unit_stack_iterate_end;
 
         dlg->begin_active_widget_list = buf;
         dlg->end_active_widget_list = end;
@@ -162,11 +162,11 @@ static void define_tiles_within_rectangle(bool append)
         mapdeco_set_highlight(ptile, TRUE);
         found_any_cities = tiles_hilited_cities = TRUE;
       }
-      unit_list_iterate(ptile->units, punit) {
+      unit_stack_iterate(ptile->units, punit) {
         if (unit_owner(punit) == client.conn.playing) {
           unit_list_append(units, punit);
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     }
   }
 
@@ -762,10 +762,10 @@ void fill_tile_unit_list(const struct tile *ptile, struct unit **unit_list)
   int i = 0;
 
   /* First populate the unit list. */
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     unit_list[i] = punit;
     i++;
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   /* Then sort it. */
   qsort(unit_list, i, sizeof(*unit_list), unit_list_compare);
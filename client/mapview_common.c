@@ -1900,7 +1900,7 @@ static void show_full_citybar(struct canvas *pcanvas,
     get_text_size(&name_rect.w, &name_rect.h, FONT_CITY_NAME, name);
 
     if (can_player_see_units_in_city(client.conn.playing, pcity)) {
-      int count = unit_list_size(pcity->tile->units);
+      int count = unit_stack_size(pcity->tile->units);
 
       count = CLIP(0, count, citybar->occupancy.size - 1);
       occupy = citybar->occupancy.p[count];
@@ -2808,7 +2808,7 @@ struct city *find_city_or_settler_near_tile(const struct tile *ptile,
   if (!game.scenario.prevent_new_cities) {
     /* check within maximum (squared) city radius */
     city_tile_iterate(max_rad, ptile, tile1) {
-      unit_list_iterate(tile1->units, psettler) {
+      unit_stack_iterate(tile1->units, psettler) {
         if ((NULL == client.conn.playing
              || unit_owner(psettler) == client.conn.playing)
             && unit_can_do_action(psettler, ACTION_FOUND_CITY)
@@ -2820,7 +2820,7 @@ struct city *find_city_or_settler_near_tile(const struct tile *ptile,
             best_settler = psettler;
           }
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     } city_tile_iterate_end;
 
     if (best_settler) {
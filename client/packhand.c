@@ -897,7 +897,7 @@ void handle_city_info(const struct packet_city_info *packet)
    * get an update if it changes. */
   if (can_player_see_units_in_city(client.conn.playing, pcity)) {
     pcity->client.occupied
-      = (unit_list_size(pcity->tile->units) > 0);
+      = (unit_stack_size(pcity->tile->units) > 0);
   }
 
   pcity->client.walls = packet->walls;
@@ -1874,7 +1874,7 @@ static bool handle_unit_packet_common(struct unit *packet_unit)
 	if (can_player_see_units_in_city(client.conn.playing, ccity)) {
 	  /* Unit moved out of a city - update the occupied status. */
 	  bool new_occupied =
-	    (unit_list_size(ccity->tile->units) > 0);
+	    (unit_stack_size(ccity->tile->units) > 0);
 
           if (ccity->client.occupied != new_occupied) {
             ccity->client.occupied = new_occupied;
@@ -1979,7 +1979,7 @@ static bool handle_unit_packet_common(struct unit *packet_unit)
     idex_register_unit(&wld, punit);
 
     unit_list_prepend(unit_owner(punit)->units, punit);
-    unit_list_prepend(unit_tile(punit)->units, punit);
+    unit_stack_prepend(unit_tile(punit)->units, punit);
 
     unit_register_battlegroup(punit);
 
@@ -2000,12 +2000,12 @@ static bool handle_unit_packet_common(struct unit *packet_unit)
      * (This might be necessary if the cargo info was sent to us before
      * this transporter.) */
     if (punit->client.occupied) {
-      unit_list_iterate(unit_tile(punit)->units, aunit) {
+      unit_stack_iterate(unit_tile(punit)->units, aunit) {
         if (aunit->client.transported_by == punit->id) {
           fc_assert(aunit->transporter == NULL);
           unit_transport_load(aunit, punit, TRUE);
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     }
 
     if ((pcity = tile_city(unit_tile(punit)))) {
@@ -3067,6 +3067,7 @@ void handle_tile_info(const struct packet_tile_info *packet)
 
   if (!BV_ARE_EQUAL(ptile->extras, packet->extras)) {
     ptile->extras = packet->extras;
+    tile_dense_sync(ptile);
     tile_changed = TRUE;
   }
 
@@ -3219,17 +3220,17 @@ void handle_tile_info(const struct packet_tile_info *packet)
   if (TILE_KNOWN_SEEN == old_known && TILE_KNOWN_SEEN != new_known) {
     /* This is an error. So first we log the error,
      * then make an assertion. */
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       log_error("%p %d %s at (%d,%d) %s", punit, punit->id,
                 unit_rule_name(punit), TILE_XY(unit_tile(punit)),
                 player_name(unit_owner(punit)));
-    } unit_list_iterate_end;
-    fc_assert_msg(0 == unit_list_size(ptile->units), "Ghost units seen");
+    } unit_stack_iterate_end;
+    fc_assert_msg(0 == unit_stack_size(ptile->units), "Ghost units seen");
     /* Repairing... */
-    unit_list_clear(ptile->units);
+    unit_stack_clear(ptile->units);
   }
 
-  ptile->continent = packet->continent;
+  tile_set_continent(ptile, packet->continent);
   wld.map.num_continents = MAX(ptile->continent, wld.map.num_continents);
 
   if (packet->label[0] == '\0') {
@@ -3478,6 +3479,9 @@ void handle_rulesets_ready(void)
   /* Cache what city production can receive help from caravans. */
   city_production_caravan_shields_init();
 
+  /* Cache the tables for city tile output. */
+  city_tile_output_tables_init();
+
   /* Adjust editor for changed ruleset. */
   editor_ruleset_changed();
 
@@ -4730,11 +4734,11 @@ void handle_city_name_suggestion_info(int unit_id, const char *name)
     if (gui_options.ask_city_name) {
       bool other_asking = FALSE;
 
-      unit_list_iterate(unit_tile(punit)->units, other) {
+      unit_stack_iterate(unit_tile(punit)->units, other) {
         if (other->client.asking_city_name) {
           other_asking = TRUE;
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
       punit->client.asking_city_name = TRUE;
 
       if (!other_asking) {
@@ -276,7 +276,7 @@ const char *popup_info_text(struct tile *ptile)
       }
     }
     if (can_player_see_units_in_city(client_player(), pcity)) {
-      int count = unit_list_size(ptile->units);
+      int count = unit_stack_size(ptile->units);
 
       if (count > 0) {
         /* TRANS: preserve leading space */
@@ -403,7 +403,7 @@ const char *popup_info_text(struct tile *ptile)
       int att_chance = FC_INFINITY, def_chance = FC_INFINITY;
       bool found = FALSE;
 
-      unit_list_iterate(ptile->units, tile_unit) {
+      unit_stack_iterate(ptile->units, tile_unit) {
 	if (unit_owner(tile_unit) != unit_owner(pfocus_unit)) {
           int att = unit_win_chance(pfocus_unit, tile_unit, NULL) * 100;
           int def = (1.0 - unit_win_chance(tile_unit, pfocus_unit,
@@ -415,7 +415,7 @@ const char *popup_info_text(struct tile *ptile)
 	  att_chance = MIN(att, att_chance);
 	  def_chance = MIN(def, def_chance);
 	}
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
 
       if (found) {
 	/* TRANS: "Chance to win: A:95% D:46%" */
@@ -449,9 +449,9 @@ const char *popup_info_text(struct tile *ptile)
     }
 
     if ((NULL == client.conn.playing || owner == client.conn.playing)
-        && unit_list_size(ptile->units) >= 2) {
+        && unit_stack_size(ptile->units) >= 2) {
       /* TRANS: "5 more" units on this tile */
-      astr_add(&str, _("  (%d more)"), unit_list_size(ptile->units) - 1);
+      astr_add(&str, _("  (%d more)"), unit_stack_size(ptile->units) - 1);
     }
   }
 
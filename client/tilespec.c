@@ -5842,7 +5842,7 @@ int fill_sprite_array(struct tileset *t,
   case LAYER_UNIT:
   case LAYER_FOCUS_UNIT:
     if (do_draw_unit && XOR(layer == LAYER_UNIT, unit_is_in_focus(punit))) {
-      bool stacked = ptile && (unit_list_size(ptile->units) > 1);
+      bool stacked = ptile && (unit_stack_size(ptile->units) > 1);
       bool backdrop = !pcity;
 
       if (ptile && unit_is_in_focus(punit)
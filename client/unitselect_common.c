@@ -110,7 +110,7 @@ struct usdata_hash *usdlg_data_new(const struct tile *ptile)
   }
 
   /* Add units on the tile (SELLOC_UNITS). */
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     /* Save all top level transporters on the tile (SELLOC_UNITS) as 'idle'
      * units (ACTIVITY_IDLE). */
     if (!unit_transported(punit)) {
@@ -127,7 +127,7 @@ struct usdata_hash *usdlg_data_new(const struct tile *ptile)
 
       unit_list_append(data->units[SELLOC_UNITS][ACTIVITY_IDLE], punit);
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return ushash;
 }
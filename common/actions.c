@@ -4122,12 +4122,12 @@ is_action_possible(const action_id wanted_action,
       /* Reason: Be merciful. */
       /* Info leak: The player sees all units checked. Invisible units are
        * ignored. */
-      unit_list_iterate(target_tile->units, pother) {
+      unit_stack_iterate(target_tile->units, pother) {
         if (can_player_see_unit(actor_player, pother)
             && !pplayers_allied(actor_player, unit_owner(pother))) {
           return TRI_NO;
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     }
 
     /* Reason: Keep paratroopers_range working. */
@@ -4175,11 +4175,11 @@ is_action_possible(const action_id wanted_action,
       return TRI_NO;
     }
 
-    unit_list_iterate(target_tile->units, punit) {
+    unit_stack_iterate(target_tile->units, punit) {
       if (get_total_defense_power(actor_unit, punit) > 0) {
         return TRI_NO;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
     break;
 
   case ACTRES_CONQUER_CITY:
@@ -4512,14 +4512,14 @@ is_action_possible(const action_id wanted_action,
     /* We cannot move a transport into a tile that holds
      * units or cities not allied with all of our cargo. */
     if (get_transporter_capacity(actor_unit) > 0) {
-      unit_list_iterate(unit_tile(actor_unit)->units, pcargo) {
+      unit_stack_iterate(unit_tile(actor_unit)->units, pcargo) {
         if (unit_contained_in(pcargo, actor_unit)
             && (is_non_allied_unit_tile(target_tile, unit_owner(pcargo))
                 || is_non_allied_city_tile(target_tile,
                                            unit_owner(pcargo)))) {
            return TRI_NO;
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     }
     break;
 
@@ -4542,14 +4542,14 @@ is_action_possible(const action_id wanted_action,
     /* We cannot move a transport into a tile that holds
      * units or cities not allied with all of our cargo. */
     if (get_transporter_capacity(actor_unit) > 0) {
-      unit_list_iterate(unit_tile(actor_unit)->units, pcargo) {
+      unit_stack_iterate(unit_tile(actor_unit)->units, pcargo) {
         if (unit_contained_in(pcargo, actor_unit)
             && (is_non_allied_unit_tile(target_tile, unit_owner(pcargo))
                 || is_non_allied_city_tile(target_tile,
                                            unit_owner(pcargo)))) {
            return TRI_NO;
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     }
     break;
 
@@ -4565,7 +4565,7 @@ is_action_possible(const action_id wanted_action,
       }
 
       found = FALSE;
-      unit_list_iterate(target_tile->units, punit) {
+      unit_stack_iterate(target_tile->units, punit) {
         struct player *uplayer = unit_owner(punit);
 
         if (uplayer == actor_player) {
@@ -4585,7 +4585,7 @@ is_action_possible(const action_id wanted_action,
           found = TRUE;
           break;
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
 
       if (!found) {
         return TRI_NO;
@@ -4621,14 +4621,14 @@ is_action_possible(const action_id wanted_action,
     /* We cannot move a transport into a tile that holds
      * units or cities not allied with all of our cargo. */
     if (get_transporter_capacity(actor_unit) > 0) {
-      unit_list_iterate(unit_tile(actor_unit)->units, pcargo) {
+      unit_stack_iterate(unit_tile(actor_unit)->units, pcargo) {
         if (unit_contained_in(pcargo, actor_unit)
             && (is_non_allied_unit_tile(target_tile, unit_owner(pcargo))
                 || is_non_allied_city_tile(target_tile,
                                            unit_owner(pcargo)))) {
            return TRI_NO;
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     }
     break;
 
@@ -4928,7 +4928,7 @@ is_action_enabled_unit_on_units_full(const action_id wanted_action,
                                      const struct tile *target_tile)
 {
   if (actor_unit == NULL || target_tile == NULL
-      || unit_list_size(target_tile->units) == 0) {
+      || unit_stack_size(target_tile->units) == 0) {
     /* Can't do an action when actor or target are missing. */
     return FALSE;
   }
@@ -4955,7 +4955,7 @@ is_action_enabled_unit_on_units_full(const action_id wanted_action,
     return FALSE;
   }
 
-  unit_list_iterate(target_tile->units, target_unit) {
+  unit_stack_iterate(target_tile->units, target_unit) {
     if (!is_action_enabled(wanted_action,
                            unit_owner(actor_unit), tile_city(actor_tile),
                            NULL, actor_tile,
@@ -4969,7 +4969,7 @@ is_action_enabled_unit_on_units_full(const action_id wanted_action,
       /* One unit makes it impossible for all units. */
       return FALSE;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   /* Not impossible for any of the units at the tile. */
   return TRUE;
@@ -6103,18 +6103,18 @@ action_prob_vs_units_full(const struct unit* actor_unit,
 
   /* Doesn't leak information since it must be 100% certain from the
    * player's perspective that the blocking action is legal. */
-  unit_list_iterate(target_tile->units, target_unit) {
+  unit_stack_iterate(target_tile->units, target_unit) {
     if (action_is_blocked_by(act, actor_unit,
                              target_tile, tile_city(target_tile),
                              target_unit)) {
       /* Don't offer to perform an action known to be blocked. */
       return ACTPROB_IMPOSSIBLE;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   /* Must be done here since an empty unseen tile will result in
    * ACTPROB_IMPOSSIBLE. */
-  if (unit_list_size(target_tile->units) == 0) {
+  if (unit_stack_size(target_tile->units) == 0) {
     /* Can't act against an empty tile. */
 
     if (player_can_trust_tile_has_no_units(unit_owner(actor_unit),
@@ -6155,7 +6155,7 @@ action_prob_vs_units_full(const struct unit* actor_unit,
                                                 target_tile)
               ? ACTPROB_CERTAIN : ACTPROB_NOT_KNOWN);
 
-  unit_list_iterate(target_tile->units, target_unit) {
+  unit_stack_iterate(target_tile->units, target_unit) {
     struct act_prob prob_unit;
 
     if (!can_player_see_unit(unit_owner(actor_unit), target_unit)) {
@@ -6198,7 +6198,7 @@ action_prob_vs_units_full(const struct unit* actor_unit,
       prob_all.max = (prob_all.max * prob_unit.max) / ACTPROB_VAL_MAX;
       break;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   /* Not impossible for any of the units at the tile. */
   return prob_all;
@@ -51,6 +51,7 @@
  */
 
 static int *citymap = NULL;
+static int citymap_tiles = 0;
 
 #define log_citymap log_debug
 
@@ -63,6 +64,13 @@ void citymap_turn_init(struct player *pplayer)
   /* The citymap is reinitialized at the start of ever turn.  This includes
    * a call to realloc, which only really matters if this is the first turn
    * of the game (but it's easier than a separate function to do this). */
+  if (citymap_tiles != MAP_INDEX_SIZE) {
+    fc_mem_account(MEM_TAG_AI,
+                   ((long) MAP_INDEX_SIZE - citymap_tiles)
+                   * (long) sizeof(*citymap),
+                   citymap == NULL ? 1 : 0);
+    citymap_tiles = MAP_INDEX_SIZE;
+  }
   citymap = fc_realloc(citymap, MAP_INDEX_SIZE * sizeof(*citymap));
   memset(citymap, 0, MAP_INDEX_SIZE * sizeof(*citymap));
 
@@ -109,6 +117,9 @@ void citymap_free(void)
 {
   if (citymap != NULL) {
     FC_FREE(citymap);
+    fc_mem_account(MEM_TAG_AI,
+                   -(long) citymap_tiles * (long) sizeof(*citymap), -1);
+    citymap_tiles = 0;
   }
 }
 
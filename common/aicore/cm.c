@@ -15,11 +15,13 @@
 #include <fc_config.h>
 #endif
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
 /* utility */
 #include "fcintl.h"
+#include "fcthread.h"
 #include "log.h"
 #include "mem.h"
 #include "shared.h"
@@ -27,10 +29,12 @@
 #include "timing.h"
 
 /* common */
+#include "citizens.h"
 #include "city.h"
 #include "game.h"
 #include "government.h"
 #include "map.h"
+#include "research.h"
 #include "specialist.h"
 
 #include "cm.h"
@@ -100,7 +104,9 @@
 #define LOG_PRUNE_BRANCH                                LOG_DEBUG
 
 #ifdef GATHER_TIME_STATS
-static struct {
+/* Statistics are gathered only in the thread that called cm_init().
+ * In the other threads the timers are NULL. */
+static fc_thread_local struct {
   struct one_perf {
     struct timer *wall_timer;
     int query_count;
@@ -192,16 +198,51 @@ struct partial_solution {
   int idle;             /* number of idle workers */
 };
 
+/*
+ * What a city map tile looked like when the lattice was built.
+ */
+struct cm_tile_info {
+  bool available;          /* in the lattice at all */
+  int production[O_LAST];  /* valid only if available */
+};
+
+/* Most tiles a city map can have. */
+#define CM_MAX_TILES (CITY_MAP_MAX_SIZE * CITY_MAP_MAX_SIZE)
+
+/*
+ * A result kept for reuse, with the fingerprint of the city and the
+ * parameter it was found for.
+ */
+#define CM_CACHE_SIZE 16
+
+struct cm_cache_entry {
+  bool valid;
+  uint64_t fingerprint;
+  struct cm_result result;
+};
+
 /*
  * State of the search.
  * This holds all the information needed to do the search, all in one
  * struct, in order to clean up the function calls.
+ *
+ * The state is kept in the city between queries (pcity->cm_state).  The
+ * next query only updates the lattice for the tiles that have changed,
+ * and starts the search from the best solution of the previous query.
  */
 struct cm_state {
   /* input from the caller */
   struct cm_parameter parameter;
   /*mutable*/ struct city *pcity;
 
+  /* what the lattice was built from */
+  int radius_sq;
+  citizens size;
+  struct cm_tile_info *tile_info; /* indexed by city map index */
+  bool spec_usable[SP_MAX];
+  int spec_production[SP_MAX][O_LAST];
+  int cleaned; /* number of types clean_lattice() has removed */
+
   /* the tile lattice */
   struct tile_type_vector lattice;
   struct tile_type_vector lattice_by_prod[O_LAST];
@@ -209,6 +250,7 @@ struct cm_state {
   /* the best known solution, and its fitness */
   struct partial_solution best;
   struct cm_fitness best_value;
+  bool best_is_seed; /* the previous solution, which gives way to ties */
 
   /* hard constraints on production: any solution with less production than
    * this fails to satisfy the constraints, so we can stop investigating
@@ -232,8 +274,38 @@ struct cm_state {
   } choice;
 
   bool *workers_map; /* placement of the workers within the city map */
+
+  /* the best solution of the previous query, for the initial bound */
+  bool has_prev;
+  bool *prev_workers; /* indexed by city map index */
+  citizens prev_specialists[SP_MAX];
+
+  /* results of the latest queries, reused if nothing has changed */
+  struct cm_cache_entry cache[CM_CACHE_SIZE];
+  int cache_next; /* entry to overwrite next */
+
+  /* statistics of the latest query */
+  int nodes; /* steps of the branch-and-bound */
+  bool cached;
+
+  long mem_bytes; /* as counted by fc_mem_account() */
 };
 
+/* Result cache statistics, for all cities. */
+static struct {
+  fc_mutex mutex;
+  int hits, misses;
+} cache_stats;
+
+/* Results handed out by cm_result_new(). The worker positions follow the
+ * result in the same object, sized for the largest city radius. */
+static struct {
+  fc_mutex mutex;
+  struct fc_pool *pool;
+} result_pool;
+
+#define RESULT_POSITIONS_OFFSET sizeof(struct cm_result)
+#define RESULT_MAX_POSITIONS (CITY_MAP_MAX_SIZE * CITY_MAP_MAX_SIZE)
 
 /* return #fields + specialist types */
 static int num_types(const struct cm_state *state);
@@ -277,6 +349,7 @@ static void real_print_partial_solution(enum log_level level,
 #define print_partial_solution(loglevel, soln, state)
 #endif /* CM_DEBUG */
 
+static void cm_state_free(struct cm_state *state);
 static void cm_result_copy(struct cm_result *result,
                            const struct city *pcity, bool *workers_map);
 
@@ -292,7 +365,14 @@ static bool choice_is_promising(struct cm_state *state, int newchoice,
 ****************************************************************************/
 void cm_init(void)
 {
-  /* In the B&B algorithm there's not really anything to initialize. */
+  fc_init_mutex(&cache_stats.mutex);
+  cache_stats.hits = 0;
+  cache_stats.misses = 0;
+
+  fc_init_mutex(&result_pool.mutex);
+  result_pool.pool = fc_pool_new(RESULT_POSITIONS_OFFSET
+                                 + RESULT_MAX_POSITIONS * sizeof(bool));
+
 #ifdef GATHER_TIME_STATS
   memset(&performance, 0, sizeof(performance));
 
@@ -315,11 +395,28 @@ void cm_init_citymap(void)
 }
 
 /************************************************************************//**
-  Clear the cache for a city.
+  Clear the cache for a city: free the state kept between queries.
 ****************************************************************************/
 void cm_clear_cache(struct city *pcity)
 {
-  /* The B&B algorithm doesn't have city caches so there's nothing to do. */
+  if (pcity->cm_state != NULL) {
+    cm_state_free(pcity->cm_state);
+    pcity->cm_state = NULL;
+  }
+}
+
+/************************************************************************//**
+  Forget the results kept for a city, but keep its state.
+****************************************************************************/
+void cm_clear_results(struct city *pcity)
+{
+  int i;
+
+  if (pcity->cm_state != NULL) {
+    for (i = 0; i < CM_CACHE_SIZE; i++) {
+      pcity->cm_state->cache[i].valid = FALSE;
+    }
+  }
 }
 
 /************************************************************************//**
@@ -335,6 +432,35 @@ void cm_free(void)
   timer_destroy(performance.opt.wall_timer);
   memset(&performance, 0, sizeof(performance));
 #endif /* GATHER_TIME_STATS */
+
+  fc_destroy_mutex(&cache_stats.mutex);
+
+  fc_pool_destroy(result_pool.pool);
+  result_pool.pool = NULL;
+  fc_destroy_mutex(&result_pool.mutex);
+}
+
+/************************************************************************//**
+  Get the number of cm_query_result() calls answered from the result
+  cache (hits) and solved anew (misses) since the last reset.
+****************************************************************************/
+void cm_cache_stats_get(int *hits, int *misses)
+{
+  fc_allocate_mutex(&cache_stats.mutex);
+  *hits = cache_stats.hits;
+  *misses = cache_stats.misses;
+  fc_release_mutex(&cache_stats.mutex);
+}
+
+/************************************************************************//**
+  Reset the result cache statistics.
+****************************************************************************/
+void cm_cache_stats_reset(void)
+{
+  fc_allocate_mutex(&cache_stats.mutex);
+  cache_stats.hits = 0;
+  cache_stats.misses = 0;
+  fc_release_mutex(&cache_stats.mutex);
 }
 
 /************************************************************************//**
@@ -343,14 +469,22 @@ void cm_free(void)
 struct cm_result *cm_result_new(struct city *pcity)
 {
   struct cm_result *result;
+  int tiles;
+
+  fc_allocate_mutex(&result_pool.mutex);
+  result = fc_pool_alloc(result_pool.pool);
+  fc_release_mutex(&result_pool.mutex);
 
   /* initialise all values */
-  result = fc_calloc(1, sizeof(*result));
+  memset(result, 0, sizeof(*result));
   result->city_radius_sq = pcity ? city_map_radius_sq_get(pcity)
                                  : CITY_MAP_MAX_RADIUS_SQ;
+  tiles = city_map_tiles(result->city_radius_sq);
+  fc_assert(tiles <= RESULT_MAX_POSITIONS);
   result->worker_positions
-    = fc_calloc(city_map_tiles(result->city_radius_sq),
-                sizeof(*result->worker_positions));
+    = (bool *) ((char *) result + RESULT_POSITIONS_OFFSET);
+  memset(result->worker_positions, 0,
+         tiles * sizeof(*result->worker_positions));
 
   /* test if the city pointer is valid; the cm_result struct can be
    * returned as it uses the maximal possible value for the size of
@@ -366,10 +500,9 @@ struct cm_result *cm_result_new(struct city *pcity)
 void cm_result_destroy(struct cm_result *result)
 {
   if (result != NULL) {
-    if (result->worker_positions != NULL) {
-      FC_FREE(result->worker_positions);
-    }
-    FC_FREE(result);
+    fc_allocate_mutex(&result_pool.mutex);
+    fc_pool_free(result_pool.pool, result);
+    fc_release_mutex(&result_pool.mutex);
   }
 }
 
@@ -684,7 +817,9 @@ static void apply_solution(struct cm_state *state,
   int i, citizen_count = 0, city_radius_sq = city_map_radius_sq_get(pcity);
 
 #ifdef GATHER_TIME_STATS
-  performance.current->apply_count++;
+  if (performance.current != NULL) {
+    performance.current->apply_count++;
+  }
 #endif
 
   fc_assert_ret(0 == soln->idle);
@@ -883,8 +1018,9 @@ static int compare_tile_type_by_fitness(const void *va, const void *vb)
   return compare_tile_type_by_lattice_order(*a, *b);
 }
 
-static Output_type_id compare_key;
-static double compare_key_trade_bonus;
+/* Thread local, as cities may get solved concurrently on the server. */
+static fc_thread_local Output_type_id compare_key;
+static fc_thread_local double compare_key_trade_bonus;
 
 /************************************************************************//**
   Compare by the production of type compare_key.
@@ -1123,13 +1259,16 @@ static void top_sort_lattice(struct tile_type_vector *lattice)
   We could clean up the tile arrays in each type (if we have two workers,
   we can use only the first tile of a depth 1 tile type), but that
   wouldn't save us anything later.
+
+  Returns the number of tile types removed.
 ****************************************************************************/
-static void clean_lattice(struct tile_type_vector *lattice,
-                          const struct city *pcity)
+static int clean_lattice(struct tile_type_vector *lattice,
+                         const struct city *pcity)
 {
   int i, j; /* i is the index we read, j is the index we write */
   struct tile_type_vector tofree;
   bool forced_loop = FALSE;
+  int removed;
 
   /* We collect the types we want to remove and free them in one fell 
      swoop at the end, in order to avoid memory errors.  */
@@ -1169,8 +1308,11 @@ static void clean_lattice(struct tile_type_vector *lattice,
     }
   }
   lattice->size = j;
+  removed = tofree.size;
 
   tile_type_vector_free_all(&tofree);
+
+  return removed;
 }
 
 /************************************************************************//**
@@ -1202,38 +1344,217 @@ static void sort_lattice_by_fitness(const struct cm_state *state,
 }
 
 /************************************************************************//**
-  Create the lattice.
+  Find out which city map tiles the city can work, and what they produce.
 ****************************************************************************/
-static void init_tile_lattice(struct city *pcity,
-                              struct tile_type_vector *lattice)
+static void read_tile_info(const struct city *pcity, int radius_sq,
+                           struct cm_tile_info *info)
 {
-  struct cm_tile_type type;
   struct tile *pcenter = city_tile(pcity);
+  struct cm_tile_type type;
 
-  /* add all the fields into the lattice */
-  tile_type_init(&type); /* init just once */
+  memset(info, 0, city_map_tiles(radius_sq) * sizeof(*info));
 
-  city_tile_iterate_index(city_map_radius_sq_get(pcity), pcenter, ptile,
-                          ctindex) {
+  city_tile_iterate_index(radius_sq, pcenter, ptile, ctindex) {
     if (is_free_worked(pcity, ptile)) {
       continue;
     } else if (city_can_work_tile(pcity, ptile)) {
-      compute_tile_production(pcity, ptile, &type); /* clobbers type */
+      compute_tile_production(pcity, ptile, &type);
+      info[ctindex].available = TRUE;
+      memcpy(info[ctindex].production, type.production,
+             sizeof(info[ctindex].production));
+    }
+  } city_tile_iterate_index_end;
+}
+
+/************************************************************************//**
+  Find out which specialists the city can use, and what they produce.
+  Returns TRUE iff that differs from what is in the state.
+****************************************************************************/
+static bool read_specialist_info(struct cm_state *state)
+{
+  bool changed = FALSE;
+
+  specialist_type_iterate(sp) {
+    bool usable = city_can_use_specialist(state->pcity, sp);
+
+    if (usable != state->spec_usable[sp]) {
+      state->spec_usable[sp] = usable;
+      changed = TRUE;
+    }
+    if (usable) {
+      output_type_iterate(o) {
+        int prod = get_specialist_output(state->pcity, sp, o);
+
+        if (prod != state->spec_production[sp][o]) {
+          state->spec_production[sp][o] = prod;
+          changed = TRUE;
+        }
+      } output_type_iterate_end;
+    }
+  } specialist_type_iterate_end;
+
+  return changed;
+}
+
+/************************************************************************//**
+  Create the lattice from the tile and specialist info of the state.
+****************************************************************************/
+static void init_tile_lattice(struct cm_state *state)
+{
+  struct tile_type_vector *lattice = &state->lattice;
+  struct cm_tile_type type;
+
+  /* add all the fields into the lattice */
+  tile_type_init(&type); /* init just once */
+
+  city_tile_iterate_index(state->radius_sq, city_tile(state->pcity), ptile,
+                          ctindex) {
+    if (state->tile_info[ctindex].available) {
+      memcpy(type.production, state->tile_info[ctindex].production,
+             sizeof(type.production));
       tile_type_lattice_add(lattice, &type, ctindex); /* copy type if needed */
     }
   } city_tile_iterate_index_end;
 
   /* Add all the specialists into the lattice.  */
-  init_specialist_lattice_nodes(lattice, pcity);
+  init_specialist_lattice_nodes(lattice, state->pcity);
 
   /* Set the lattice_depth fields, and clean up unreachable nodes. */
   top_sort_lattice(lattice);
-  clean_lattice(lattice, pcity);
+  state->cleaned = clean_lattice(lattice, state->pcity);
 
   /* All done now. */
   print_lattice(LOG_LATTICE, lattice);
 }
 
+/************************************************************************//**
+  Take the tile with the given city map index out of its tile type.
+  A tile type left without tiles is removed from the lattice.
+****************************************************************************/
+static void tile_lattice_remove(struct tile_type_vector *lattice,
+                                int tindex)
+{
+  int i, j;
+
+  for (i = 0; i < lattice->size; i++) {
+    struct cm_tile_type *ptype = lattice->p[i];
+
+    if (ptype->is_specialist) {
+      continue;
+    }
+    for (j = 0; j < ptype->tiles.size; j++) {
+      if (ptype->tiles.p[j].index == tindex) {
+        break;
+      }
+    }
+    if (j == ptype->tiles.size) {
+      continue;
+    }
+
+    tile_vector_remove(&ptype->tiles, j);
+    if (ptype->tiles.size == 0) {
+      /* Unlink the type from the rest of the lattice. */
+      tile_type_vector_iterate(&ptype->better_types, other) {
+        for (j = 0; j < other->worse_types.size; j++) {
+          if (other->worse_types.p[j] == ptype) {
+            tile_type_vector_remove(&other->worse_types, j);
+            break;
+          }
+        }
+      } tile_type_vector_iterate_end;
+      tile_type_vector_iterate(&ptype->worse_types, other) {
+        for (j = 0; j < other->better_types.size; j++) {
+          if (other->better_types.p[j] == ptype) {
+            tile_type_vector_remove(&other->better_types, j);
+            break;
+          }
+        }
+      } tile_type_vector_iterate_end;
+
+      tile_type_vector_remove(lattice, i);
+      tile_type_destroy(ptype);
+      free(ptype);
+      for (j = i; j < lattice->size; j++) {
+        lattice->p[j]->lattice_index = j;
+      }
+    }
+    return;
+  }
+}
+
+/************************************************************************//**
+  Bring the lattice of a kept state up to date with the city.  Tiles that
+  changed are moved to their new tile types in place; if that can't be
+  done the lattice is built again.
+****************************************************************************/
+static void update_tile_lattice(struct cm_state *state)
+{
+  int ntiles = city_map_tiles(state->radius_sq);
+  struct cm_tile_info info[CM_MAX_TILES];
+  bool rebuild, changed = FALSE;
+  int i;
+
+  fc_assert_ret(ntiles <= CM_MAX_TILES);
+
+  read_tile_info(state->pcity, state->radius_sq, info);
+  rebuild = read_specialist_info(state);
+
+  if (!rebuild) {
+    for (i = 0; i < ntiles; i++) {
+      if (info[i].available != state->tile_info[i].available
+          || (info[i].available
+              && memcmp(info[i].production, state->tile_info[i].production,
+                        sizeof(info[i].production)) != 0)) {
+        changed = TRUE;
+        break;
+      }
+    }
+    /* The types clean_lattice() removed may become reachable when the
+     * tiles change.  Then we need them back, so start over. */
+    rebuild = (changed && state->cleaned > 0);
+  }
+
+  if (rebuild) {
+    log_base(LOG_CM_STATE, "rebuilding lattice for %s",
+             city_name_get(state->pcity));
+    memcpy(state->tile_info, info, ntiles * sizeof(*info));
+    tile_type_vector_free_all(&state->lattice);
+    tile_type_vector_init(&state->lattice);
+    init_tile_lattice(state);
+    return;
+  }
+
+  if (!changed) {
+    return;
+  }
+
+  log_base(LOG_CM_STATE, "updating lattice for %s",
+           city_name_get(state->pcity));
+  for (i = 0; i < ntiles; i++) {
+    struct cm_tile_type type;
+
+    if (info[i].available == state->tile_info[i].available
+        && (!info[i].available
+            || memcmp(info[i].production, state->tile_info[i].production,
+                      sizeof(info[i].production)) == 0)) {
+      continue;
+    }
+    if (state->tile_info[i].available) {
+      tile_lattice_remove(&state->lattice, i);
+    }
+    if (info[i].available) {
+      tile_type_init(&type);
+      memcpy(type.production, info[i].production, sizeof(type.production));
+      tile_type_lattice_add(&state->lattice, &type, i);
+    }
+    state->tile_info[i] = info[i];
+  }
+
+  top_sort_lattice(&state->lattice);
+  state->cleaned = clean_lattice(&state->lattice, state->pcity);
+  print_lattice(LOG_LATTICE, &state->lattice);
+}
+
 
 /****************************************************************************
 
@@ -1641,7 +1962,12 @@ static bool choice_is_promising(struct cm_state *state, int newchoice,
                state->min_production[stat_index]);
       return FALSE;
     }
-    if (production[stat_index] > state->best.production[stat_index]
+    /* Branches that may only tie with the previous solution are looked
+     * at too, so that ties are decided as without it. */
+    if ((production[stat_index] > state->best.production[stat_index]
+         || (state->best_is_seed
+             && production[stat_index]
+                == state->best.production[stat_index]))
         && state->parameter.factor[stat_index] > 0 ) {
       beats_best = TRUE;
       /* may still fail to meet min at another production type, so
@@ -1793,10 +2119,13 @@ static bool bb_next(struct cm_state *state, bool negative_ok)
     struct cm_fitness value = evaluate_solution(state, &state->current);
 
     print_partial_solution(LOG_REACHED_LEAF, &state->current, state);
-    if (fitness_better(value, state->best_value)) {
+    if (fitness_better(value, state->best_value)
+        || (state->best_is_seed
+            && !fitness_better(state->best_value, value))) {
       log_base(LOG_BETTER_LEAF, "-> replaces previous best");
       copy_partial_solution(&state->best, &state->current, state);
       state->best_value = value;
+      state->best_is_seed = FALSE;
     }
   }
 
@@ -1821,32 +2150,20 @@ static bool bb_next(struct cm_state *state, bool negative_ok)
 }
 
 /************************************************************************//**
-  Initialize the state for the branch-and-bound algorithm.
+  Make the copies of the lattice sorted by each production, for the
+  heuristic.  These depend on the tax rates, so they are made again for
+  every query.
 ****************************************************************************/
-static struct cm_state *cm_state_init(struct city *pcity, bool negative_ok)
+static void sort_lattice_by_prod(struct cm_state *state)
 {
   const int SCIENCE = 0, TAX = 1, LUXURY = 2;
-  const struct player *pplayer = city_owner(pcity);
-  int numtypes;
-  struct cm_state *state = fc_malloc(sizeof(*state));
+  const struct city *pcity = state->pcity;
   int rates[3];
 
-  log_base(LOG_CM_STATE, "creating cm_state for %s (size %d)",
-           city_name_get(pcity), city_size_get(pcity));
-
-  /* copy the arguments */
-  state->pcity = pcity;
-
-  /* create the lattice */
-  tile_type_vector_init(&state->lattice);
-  init_tile_lattice(pcity, &state->lattice);
-  numtypes = tile_type_vector_size(&state->lattice);
-
-  get_tax_rates(pplayer, rates);
+  get_tax_rates(city_owner(pcity), rates);
 
-  /* For the heuristic, make sorted copies of the lattice */
   output_type_iterate(stat_index) {
-    tile_type_vector_init(&state->lattice_by_prod[stat_index]);
+    tile_type_vector_free(&state->lattice_by_prod[stat_index]);
     tile_type_vector_copy(&state->lattice_by_prod[stat_index], &state->lattice);
     compare_key = stat_index;
     /* calculate effect of 1 trade production on interesting production */
@@ -1868,6 +2185,36 @@ static struct cm_state *cm_state_init(struct city *pcity, bool negative_ok)
           sizeof(*state->lattice_by_prod[stat_index].p),
           compare_tile_type_by_stat);
   } output_type_iterate_end;
+}
+
+/************************************************************************//**
+  Initialize the state for the branch-and-bound algorithm.
+****************************************************************************/
+static struct cm_state *cm_state_init(struct city *pcity, bool negative_ok)
+{
+  int numtypes;
+  struct cm_state *state = fc_calloc(1, sizeof(*state));
+
+  log_base(LOG_CM_STATE, "creating cm_state for %s (size %d)",
+           city_name_get(pcity), city_size_get(pcity));
+
+  /* copy the arguments */
+  state->pcity = pcity;
+  state->radius_sq = city_map_radius_sq_get(pcity);
+  state->size = city_size_get(pcity);
+
+  /* create the lattice */
+  state->tile_info = fc_malloc(city_map_tiles(state->radius_sq)
+                               * sizeof(*state->tile_info));
+  read_tile_info(pcity, state->radius_sq, state->tile_info);
+  read_specialist_info(state);
+  tile_type_vector_init(&state->lattice);
+  init_tile_lattice(state);
+  numtypes = tile_type_vector_size(&state->lattice);
+
+  output_type_iterate(stat_index) {
+    tile_type_vector_init(&state->lattice_by_prod[stat_index]);
+  } output_type_iterate_end;
 
   state->min_luxury = - FC_INFINITY;
 
@@ -1875,6 +2222,7 @@ static struct cm_state *cm_state_init(struct city *pcity, bool negative_ok)
   init_partial_solution(&state->best, numtypes, city_size_get(pcity),
                         negative_ok);
   state->best_value = worst_fitness();
+  state->best_is_seed = FALSE;
 
   /* Initialize the current solution and choice stack to empty */
   init_partial_solution(&state->current, numtypes, city_size_get(pcity),
@@ -1886,6 +2234,44 @@ static struct cm_state *cm_state_init(struct city *pcity, bool negative_ok)
   /* Initialize workers map */
   state->workers_map = fc_calloc(city_map_tiles_from_city(state->pcity),
                                  sizeof(state->workers_map));
+  state->prev_workers = fc_calloc(city_map_tiles(state->radius_sq),
+                                  sizeof(*state->prev_workers));
+  state->has_prev = FALSE;
+
+  /* The tables, not counting the tile types nor the cached results. */
+  state->mem_bytes = sizeof(*state)
+    + city_map_tiles(state->radius_sq) * (long) (sizeof(*state->tile_info)
+                                                 + sizeof(bool))
+    + city_map_tiles_from_city(state->pcity) * (long) sizeof(bool *)
+    + city_size_get(pcity) * (long) sizeof(*state->choice.stack);
+  fc_mem_account(MEM_TAG_CM, state->mem_bytes, 1);
+
+  return state;
+}
+
+/************************************************************************//**
+  Get the state kept in the city, brought up to date, or a new one if the
+  city has none or has changed too much.
+****************************************************************************/
+static struct cm_state *cm_state_get(struct city *pcity, bool negative_ok)
+{
+  struct cm_state *state = pcity->cm_state;
+
+  if (state != NULL
+      && (state->radius_sq != city_map_radius_sq_get(pcity)
+          || state->size != city_size_get(pcity))) {
+    cm_clear_cache(pcity);
+    state = NULL;
+  }
+
+  if (state == NULL) {
+    state = cm_state_init(pcity, negative_ok);
+    pcity->cm_state = state;
+  } else {
+    log_base(LOG_CM_STATE, "reusing cm_state for %s (size %d)",
+             city_name_get(pcity), city_size_get(pcity));
+    update_tile_lattice(state);
+  }
 
   return state;
 }
@@ -1949,8 +2335,10 @@ static void begin_search(struct cm_state *state,
                          bool negative_ok)
 {
 #ifdef GATHER_TIME_STATS
-  timer_start(performance.current->wall_timer);
-  performance.current->query_count++;
+  if (performance.current != NULL) {
+    timer_start(performance.current->wall_timer);
+    performance.current->query_count++;
+  }
 #endif /* GATHER_TIME_STATS */
 
   /* copy the parameter and sort the main lattice by it */
@@ -1963,9 +2351,15 @@ static void begin_search(struct cm_state *state,
   }
 
   init_min_production(state);
+  state->min_luxury = - FC_INFINITY;
 
   /* clear out the old solution */
+  destroy_partial_solution(&state->best);
+  init_partial_solution(&state->best, num_types(state),
+                        city_size_get(state->pcity),
+                        negative_ok);
   state->best_value = worst_fitness();
+  state->best_is_seed = FALSE;
   destroy_partial_solution(&state->current);
   init_partial_solution(&state->current, num_types(state),
                         city_size_get(state->pcity),
@@ -1973,6 +2367,281 @@ static void begin_search(struct cm_state *state,
   state->choice.size = 0;
 }
 
+/************************************************************************//**
+  Start the search from the best solution of the previous query, if it
+  still fits the city and meets the parameter.  The search then only has
+  to look at branches that may match it.  It is only a bound: the first
+  solution the search finds that is as good replaces it, so ties are
+  decided the same way as without the previous query.
+****************************************************************************/
+static void seed_best_solution(struct cm_state *state)
+{
+  int ntiles = city_map_tiles(state->radius_sq);
+  int type_of_tile[CM_MAX_TILES];
+  struct partial_solution seed;
+  struct cm_fitness value;
+  int i;
+
+  if (!state->has_prev) {
+    return;
+  }
+  fc_assert_ret(ntiles <= CM_MAX_TILES);
+
+  for (i = 0; i < ntiles; i++) {
+    type_of_tile[i] = -1;
+  }
+  tile_type_vector_iterate(&state->lattice, ptype) {
+    if (!ptype->is_specialist) {
+      TYPED_VECTOR_ITERATE(struct cm_tile, &ptype->tiles, ptile) {
+        type_of_tile[ptile->index] = ptype->lattice_index;
+      } VECTOR_ITERATE_END;
+    }
+  } tile_type_vector_iterate_end;
+
+  init_partial_solution(&seed, num_types(state), state->size, FALSE);
+
+  for (i = 0; i < ntiles; i++) {
+    if (state->prev_workers[i]) {
+      if (type_of_tile[i] < 0 || seed.idle == 0) {
+        /* The tile is no longer available. */
+        destroy_partial_solution(&seed);
+        return;
+      }
+      add_worker(&seed, type_of_tile[i], state);
+    }
+  }
+
+  specialist_type_iterate(sp) {
+    struct cm_tile_type type;
+    int itype;
+
+    if (state->prev_specialists[sp] == 0) {
+      continue;
+    }
+    tile_type_init(&type);
+    type.is_specialist = TRUE;
+    memcpy(type.production, state->spec_production[sp],
+           sizeof(type.production));
+    itype = tile_type_vector_find_equivalent(&state->lattice, &type);
+    if (!state->spec_usable[sp] || itype < 0
+        || seed.idle < state->prev_specialists[sp]) {
+      destroy_partial_solution(&seed);
+      return;
+    }
+    add_workers(&seed, itype, state->prev_specialists[sp], state);
+  } specialist_type_iterate_end;
+
+  if (seed.idle == 0) {
+    value = evaluate_solution(state, &seed);
+    if (value.sufficient) {
+      log_base(LOG_CM_STATE, "starting from the previous solution");
+      copy_partial_solution(&state->best, &seed, state);
+      state->best_value = value;
+      state->best_is_seed = TRUE;
+    }
+  }
+
+  destroy_partial_solution(&seed);
+}
+
+/************************************************************************//**
+  Add the bytes of the value to the fingerprint (FNV-1a).
+****************************************************************************/
+static void fingerprint_add(uint64_t *fingerprint, const void *data,
+                            size_t size)
+{
+  const unsigned char *bytes = data;
+  size_t i;
+
+  for (i = 0; i < size; i++) {
+    *fingerprint ^= bytes[i];
+    *fingerprint *= 1099511628211ULL;
+  }
+}
+
+#define FINGERPRINT_ADD(_fp, _value) \
+  fingerprint_add(_fp, &(_value), sizeof(_value))
+
+/************************************************************************//**
+  Compute a fingerprint of everything the result of a query depends on:
+  the parameter, the tile and specialist outputs in the state, and what
+  feeds into the city refresh (bonuses, waste, buildings, wonders,
+  government, tax rates, techs, citizens, trade routes and units).  The
+  current arrangement of the citizens is left out on purpose; the result
+  does not depend on it.
+****************************************************************************/
+static uint64_t city_fingerprint(const struct cm_state *state,
+                                 const struct cm_parameter *parameter,
+                                 bool negative_ok)
+{
+  const struct city *pcity = state->pcity;
+  const struct player *pplayer = city_owner(pcity);
+  uint64_t fp = 14695981039346656037ULL;
+  int ntiles = city_map_tiles(state->radius_sq);
+  int rates[3];
+  int i, value;
+
+  /* The parameter. */
+  FINGERPRINT_ADD(&fp, parameter->minimal_surplus);
+  FINGERPRINT_ADD(&fp, parameter->factor);
+  FINGERPRINT_ADD(&fp, parameter->happy_factor);
+  FINGERPRINT_ADD(&fp, parameter->max_growth);
+  FINGERPRINT_ADD(&fp, parameter->require_happy);
+  FINGERPRINT_ADD(&fp, parameter->allow_disorder);
+  FINGERPRINT_ADD(&fp, parameter->allow_specialists);
+  FINGERPRINT_ADD(&fp, negative_ok);
+
+  /* What the lattice is built from. */
+  FINGERPRINT_ADD(&fp, state->radius_sq);
+  FINGERPRINT_ADD(&fp, state->size);
+  for (i = 0; i < ntiles; i++) {
+    FINGERPRINT_ADD(&fp, state->tile_info[i].available);
+    if (state->tile_info[i].available) {
+      FINGERPRINT_ADD(&fp, state->tile_info[i].production);
+    }
+  }
+  FINGERPRINT_ADD(&fp, state->spec_usable);
+  FINGERPRINT_ADD(&fp, state->spec_production);
+
+  /* What the city refresh depends on, apart from the arrangement of the
+   * citizens itself. */
+  FINGERPRINT_ADD(&fp, pcity->bonus);
+  FINGERPRINT_ADD(&fp, pcity->usage);
+  FINGERPRINT_ADD(&fp, pcity->martial_law);
+  FINGERPRINT_ADD(&fp, pcity->unit_happy_upkeep);
+  FINGERPRINT_ADD(&fp, pcity->anarchy);
+  FINGERPRINT_ADD(&fp, pcity->rapture);
+  output_type_iterate(o) {
+    value = city_waste(pcity, o, 1000, NULL);
+    FINGERPRINT_ADD(&fp, value);
+  } output_type_iterate_end;
+  city_built_iterate(pcity, pimprove) {
+    value = improvement_number(pimprove);
+    FINGERPRINT_ADD(&fp, value);
+  } city_built_iterate_end;
+  improvement_iterate(pimprove) {
+    if (is_wonder(pimprove)) {
+      value = improvement_number(pimprove);
+      FINGERPRINT_ADD(&fp, pplayer->wonders[value]);
+      FINGERPRINT_ADD(&fp, game.info.great_wonder_owners[value]);
+    }
+  } improvement_iterate_end;
+  value = government_number(government_of_city(pcity));
+  FINGERPRINT_ADD(&fp, value);
+  get_tax_rates(pplayer, rates);
+  FINGERPRINT_ADD(&fp, rates);
+  value = research_get(pplayer)->techs_researched;
+  FINGERPRINT_ADD(&fp, value);
+  value = city_list_size(pplayer->cities);
+  FINGERPRINT_ADD(&fp, value);
+  citizens_iterate(pcity, pslot, nationality) {
+    value = player_slot_index(pslot);
+    FINGERPRINT_ADD(&fp, value);
+    FINGERPRINT_ADD(&fp, nationality);
+  } citizens_iterate_end;
+  trade_routes_iterate(pcity, proute) {
+    const struct city *partner = game_city_by_number(proute->partner);
+
+    FINGERPRINT_ADD(&fp, proute->partner);
+    FINGERPRINT_ADD(&fp, proute->dir);
+    if (partner == NULL) {
+      continue;
+    }
+    if (game.info.trade_revenue_style == TRS_SIMPLE) {
+      /* Concurrent queries never touch the partner in this case. */
+      FINGERPRINT_ADD(&fp, partner->citizen_base[O_TRADE]);
+    } else {
+      value = city_size_get(partner);
+      FINGERPRINT_ADD(&fp, value);
+    }
+  } trade_routes_iterate_end;
+
+  return fp;
+}
+
+/************************************************************************//**
+  Copy a cached result to the caller's result.
+****************************************************************************/
+static void cache_result_copy(struct cm_result *dest,
+                              const struct cm_result *src)
+{
+  bool *worker_positions = dest->worker_positions;
+
+  fc_assert_ret(dest->city_radius_sq == src->city_radius_sq);
+
+  memcpy(worker_positions, src->worker_positions,
+         city_map_tiles(src->city_radius_sq) * sizeof(*worker_positions));
+  *dest = *src;
+  dest->worker_positions = worker_positions;
+}
+
+/************************************************************************//**
+  Look for a cached result with the given fingerprint.  Returns TRUE and
+  fills in the result if one is found.
+****************************************************************************/
+static bool cache_lookup(struct cm_state *state, uint64_t fingerprint,
+                         struct cm_result *result)
+{
+  int i;
+
+  for (i = 0; i < CM_CACHE_SIZE; i++) {
+    const struct cm_cache_entry *entry = &state->cache[i];
+
+    if (entry->valid && entry->fingerprint == fingerprint
+        && entry->result.city_radius_sq == result->city_radius_sq) {
+      cache_result_copy(result, &entry->result);
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/************************************************************************//**
+  Keep the result for later queries with the same fingerprint.
+****************************************************************************/
+static void cache_store(struct cm_state *state, uint64_t fingerprint,
+                        const struct cm_result *result)
+{
+  struct cm_cache_entry *entry = &state->cache[state->cache_next];
+
+  if (result->aborted || result->city_radius_sq != state->radius_sq) {
+    return;
+  }
+
+  if (entry->result.worker_positions == NULL) {
+    entry->result.worker_positions
+      = fc_calloc(city_map_tiles(state->radius_sq),
+                  sizeof(*entry->result.worker_positions));
+  }
+  entry->result.city_radius_sq = state->radius_sq;
+  cache_result_copy(&entry->result, result);
+  entry->fingerprint = fingerprint;
+  entry->valid = TRUE;
+
+  state->cache_next = (state->cache_next + 1) % CM_CACHE_SIZE;
+}
+
+/************************************************************************//**
+  Remember the result as the starting point for the next query.
+****************************************************************************/
+static void remember_solution(struct cm_state *state,
+                              const struct cm_result *result)
+{
+  state->has_prev = result->found_a_valid;
+  if (!state->has_prev) {
+    return;
+  }
+
+  city_map_iterate(state->radius_sq, cindex, x, y) {
+    state->prev_workers[cindex] = (result->worker_positions[cindex]
+                                   && !is_free_worked_index(cindex));
+  } city_map_iterate_end;
+  specialist_type_iterate(sp) {
+    state->prev_specialists[sp] = result->specialists[sp];
+  } specialist_type_iterate_end;
+}
+
 /************************************************************************//**
   Clean up after a search.
   Currently, does nothing except stop the timer and output.
@@ -1980,6 +2649,10 @@ static void begin_search(struct cm_state *state,
 static void end_search(struct cm_state *state)
 {
 #ifdef GATHER_TIME_STATS
+  if (performance.current == NULL) {
+    return;
+  }
+
   timer_stop(performance.current->wall_timer);
 
 #ifdef PRINT_TIME_STATS_EVERY_QUERY
@@ -1995,6 +2668,8 @@ static void end_search(struct cm_state *state)
 ****************************************************************************/
 static void cm_state_free(struct cm_state *state)
 {
+  int i;
+
   tile_type_vector_free_all(&state->lattice);
   output_type_iterate(stat_index) {
     tile_type_vector_free(&state->lattice_by_prod[stat_index]);
@@ -2002,8 +2677,14 @@ static void cm_state_free(struct cm_state *state)
   destroy_partial_solution(&state->best);
   destroy_partial_solution(&state->current);
 
+  FC_FREE(state->tile_info);
   FC_FREE(state->choice.stack);
   FC_FREE(state->workers_map);
+  FC_FREE(state->prev_workers);
+  for (i = 0; i < CM_CACHE_SIZE; i++) {
+    FC_FREE(state->cache[i].result.worker_positions);
+  }
+  fc_mem_account(MEM_TAG_CM, -state->mem_bytes, -1);
   FC_FREE(state);
 }
 
@@ -2019,7 +2700,9 @@ static void cm_find_best_solution(struct cm_state *state,
   struct city backup;
 
 #ifdef GATHER_TIME_STATS
-  performance.current = &performance.opt;
+  if (performance.opt.wall_timer != NULL) {
+    performance.current = &performance.opt;
+  }
 #endif
 
   begin_search(state, parameter, negative_ok);
@@ -2027,6 +2710,10 @@ static void cm_find_best_solution(struct cm_state *state,
   /* make a backup of the city to restore at the very end */
   memcpy(&backup, state->pcity, sizeof(backup));
 
+  if (!negative_ok) {
+    seed_best_solution(state);
+  }
+
   if (player_is_cpuhog(city_owner(state->pcity))) {
     max_count = CPUHOG_CM_MAX_LOOP;
   } else {
@@ -2056,6 +2743,8 @@ static void cm_find_best_solution(struct cm_state *state,
   }
 #endif /* CM_LOOP_NO_LIMIT */
 
+  state->nodes = loop_count;
+
   /* convert to the caller's format */
   convert_solution_to_result(state, &state->best, result);
 
@@ -2072,15 +2761,54 @@ void cm_query_result(struct city *pcity,
                      const struct cm_parameter *param,
                      struct cm_result *result, bool negative_ok)
 {
-  struct cm_state *state = cm_state_init(pcity, negative_ok);
+  struct cm_state *state = cm_state_get(pcity, negative_ok);
+  uint64_t fingerprint;
+  bool hit;
 
   /* Refresh the city.  Otherwise the CM can give wrong results or just be
    * slower than necessary.  Note that cities are often passed in in an
    * unrefreshed state (which should probably be fixed). */
   city_refresh_from_main_map(pcity, NULL);
 
-  cm_find_best_solution(state, param, result, negative_ok);
-  cm_state_free(state);
+  fingerprint = city_fingerprint(state, param, negative_ok);
+  hit = cache_lookup(state, fingerprint, result);
+  state->cached = hit;
+  if (hit) {
+    state->nodes = 0;
+  } else {
+    sort_lattice_by_prod(state);
+    cm_find_best_solution(state, param, result, negative_ok);
+    cache_store(state, fingerprint, result);
+  }
+  remember_solution(state, result);
+
+  fc_allocate_mutex(&cache_stats.mutex);
+  if (hit) {
+    cache_stats.hits++;
+  } else {
+    cache_stats.misses++;
+  }
+  fc_release_mutex(&cache_stats.mutex);
+}
+
+/************************************************************************//**
+  Get the statistics of the latest query of the city.  Returns FALSE if
+  there is no state kept for the city.
+****************************************************************************/
+bool cm_search_stats_get(const struct city *pcity,
+                         struct cm_search_stats *stats)
+{
+  const struct cm_state *state = pcity->cm_state;
+
+  if (state == NULL) {
+    return FALSE;
+  }
+
+  stats->lattice_size = num_types(state);
+  stats->nodes = state->nodes;
+  stats->cached = state->cached;
+
+  return TRUE;
 }
 
 /************************************************************************//**
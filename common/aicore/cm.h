@@ -72,17 +72,48 @@ void cm_result_destroy(struct cm_result *result);
  * Will try to meet the requirements and fill out the result. Caller
  * should test result->found_a_valid. cm_query_result() will not change
  * the actual city setting.
+ *
+ * Different cities may be queried concurrently from several threads as
+ * long as the main map does not change meanwhile. The city temporarily
+ * changes during the query, so with the simple trade revenue style it
+ * must not be queried at the same time as any of its trade partners.
  */
 void cm_query_result(struct city *pcity,
                      const struct cm_parameter *const parameter,
                      struct cm_result *result, bool negative_ok);
 
 /*
- * Call this function if the city has changed. To be safe call it
- * everytime before you call cm_query_result().
+ * cm_query_result() keeps its state in the city between queries, and
+ * checks it against the city every time, so this is not needed when the
+ * city changes.  Call this function to free that state, or to make the
+ * next query start from scratch.
  */
 void cm_clear_cache(struct city *pcity);
 
+/*
+ * cm_query_result() also keeps its latest results for each city, and
+ * answers a query from them when neither the city nor the parameter has
+ * changed since.  These count how often that happened.
+ */
+void cm_cache_stats_get(int *hits, int *misses);
+void cm_cache_stats_reset(void);
+
+/*
+ * Forget the results kept for the city, but not its state: the next
+ * query is solved again, starting from the kept state.
+ */
+void cm_clear_results(struct city *pcity);
+
+/* What the latest query of a city took, for benchmarking. */
+struct cm_search_stats {
+  int lattice_size;     /* number of tile types */
+  int nodes;            /* steps of the branch-and-bound */
+  bool cached;          /* answered from the result cache */
+};
+
+bool cm_search_stats_get(const struct city *pcity,
+                         struct cm_search_stats *stats);
+
 /***************** utility methods *************************************/
 bool cm_are_parameter_equal(const struct cm_parameter *const p1,
                             const struct cm_parameter *const p2);
@@ -78,6 +78,7 @@ enum pf_zoc_type {
 struct pf_map {
 #ifdef PF_DEBUG
   enum pf_mode mode;    /* The mode of the map, for conversion checking. */
+  bool multi_source;    /* If paths may start elsewhere than start tile. */
 #endif /* PF_DEBUG */
 
   /* "Virtual" function table. */
@@ -361,7 +362,7 @@ static inline bool pf_normal_node_init(struct pf_normal_map *pfnm,
         && NULL == tile_city(ptile)
         && !terrain_has_flag(tile_terrain(ptile), TER_NO_ZOC)
         && !params->get_zoc(params->owner, ptile, params->map)) {
-      node->zoc_number = (0 < unit_list_size(ptile->units)
+      node->zoc_number = (0 < unit_stack_size(ptile->units)
                           ? ZOC_ALLIED : ZOC_NO);
 #ifdef ZERO_VARIABLES_FOR_SEARCHING
     } else {
@@ -453,9 +454,11 @@ pf_normal_map_construct_path(const struct pf_normal_map *pfnm,
   path = fc_malloc(sizeof(*path));
 
   /* 1: Count the number of steps to get here.
-   * To do it, backtrack until we hit the starting point */
+   * To do it, backtrack until we hit the starting point. Note that for
+   * multi-source maps, it may be any of the sources, they are the only
+   * nodes without direction. */
   for (i = 0; ; i++) {
-    if (ptile == params->start_tile) {
+    if (direction8_invalid() == node->dir_to_here) {
       /* Ah-ha, reached the starting point! */
       break;
     }
@@ -758,9 +761,9 @@ static inline bool pf_normal_map_iterate_until(struct pf_normal_map *pfnm,
       if (!pf_normal_node_init(pfnm, node, ptile, PF_MS_NONE)) {
         return FALSE;
       }
-    } else if (TB_IGNORE == node->behavior) {
+    } else if (NS_INIT == node->status && TB_IGNORE == node->behavior) {
       /* Simpliciation: if we cannot enter this node at all, don't iterate
-       * the whole map. */
+       * the whole map. Sources of multi-source maps are reached anyway. */
       return FALSE;
     }
   } /* Else, this is a jumbo map, not dealing with normal nodes. */
@@ -843,6 +846,8 @@ static void pf_normal_map_destroy(struct pf_map *pfm)
   struct pf_normal_map *pfnm = PF_NORMAL_MAP(pfm);
 
   free(pfnm->lattice);
+  fc_mem_account(MEM_TAG_PF,
+                 -MAP_INDEX_SIZE * (long) sizeof(struct pf_normal_node), -1);
   map_index_pq_destroy(pfnm->queue);
   free(pfnm);
 }
@@ -863,10 +868,13 @@ static struct pf_map *pf_normal_map_new(const struct pf_parameter *parameter)
 #ifdef PF_DEBUG
   /* Set the mode, used for cast check. */
   base_map->mode = PF_NORMAL;
+  base_map->multi_source = FALSE;
 #endif /* PF_DEBUG */
 
   /* Allocate the map. */
   pfnm->lattice = fc_calloc(MAP_INDEX_SIZE, sizeof(struct pf_normal_node));
+  fc_mem_account(MEM_TAG_PF,
+                 MAP_INDEX_SIZE * (long) sizeof(struct pf_normal_node), 1);
   pfnm->queue = map_index_pq_new(INITIAL_QUEUE_SIZE);
 
   if (NULL == parameter->get_costs) {
@@ -930,6 +938,39 @@ static struct pf_map *pf_normal_map_new(const struct pf_parameter *parameter)
   return PF_MAP(pfnm);
 }
 
+/************************************************************************//**
+  Add an extra source to a 'pf_normal_map' which was not iterated yet. The
+  node gets the same costs as the start tile and is put in the priority
+  queue, so the flood will start from all sources at once.
+****************************************************************************/
+static void pf_normal_map_add_source(struct pf_normal_map *pfnm,
+                                     struct tile *ptile)
+{
+  struct pf_parameter *params = &PF_MAP(pfnm)->params;
+  struct pf_normal_node *node = pfnm->lattice + tile_index(ptile);
+  struct tile *start_tile = params->start_tile;
+
+  if (NS_UNINIT != node->status) {
+    /* The start tile, or a duplicate. */
+    return;
+  }
+
+  if (NULL == params->get_costs) {
+    /* Like the start tile, a source may be a tile the unit couldn't
+     * enter. Fake the start tile for pf_normal_node_init(). */
+    params->start_tile = ptile;
+    pf_normal_node_init(pfnm, node, ptile, PF_MS_NONE);
+    params->start_tile = start_tile;
+  }
+
+  node->cost = pf_move_rate(params) - pf_moves_left_initially(params);
+  node->extra_cost = 0;
+  node->dir_to_here = direction8_invalid();
+  node->status = NS_NEW;
+  map_index_pq_insert(pfnm->queue, tile_index(ptile),
+                      -pf_total_CC(params, node->cost, node->extra_cost));
+}
+
 
 /* ================ Specific pf_danger_* mode structures ================= */
 
@@ -1108,7 +1149,7 @@ static inline bool pf_danger_node_init(struct pf_danger_map *pfdm,
         && NULL == tile_city(ptile)
         && !terrain_has_flag(tile_terrain(ptile), TER_NO_ZOC)
         && !params->get_zoc(params->owner, ptile, params->map)) {
-      node->zoc_number = (0 < unit_list_size(ptile->units)
+      node->zoc_number = (0 < unit_stack_size(ptile->units)
                           ? ZOC_ALLIED : ZOC_NO);
 #ifdef ZERO_VARIABLES_FOR_SEARCHING
     } else {
@@ -1850,6 +1891,8 @@ static void pf_danger_map_destroy(struct pf_map *pfm)
     }
   }
   free(pfdm->lattice);
+  fc_mem_account(MEM_TAG_PF,
+                 -MAP_INDEX_SIZE * (long) sizeof(struct pf_danger_node), -1);
   map_index_pq_destroy(pfdm->queue);
   map_index_pq_destroy(pfdm->danger_queue);
   free(pfdm);
@@ -1871,10 +1914,13 @@ static struct pf_map *pf_danger_map_new(const struct pf_parameter *parameter)
 #ifdef PF_DEBUG
   /* Set the mode, used for cast check. */
   base_map->mode = PF_DANGER;
+  base_map->multi_source = FALSE;
 #endif /* PF_DEBUG */
 
   /* Allocate the map. */
   pfdm->lattice = fc_calloc(MAP_INDEX_SIZE, sizeof(struct pf_danger_node));
+  fc_mem_account(MEM_TAG_PF,
+                 MAP_INDEX_SIZE * (long) sizeof(struct pf_danger_node), 1);
   pfdm->queue = map_index_pq_new(INITIAL_QUEUE_SIZE);
   pfdm->danger_queue = map_index_pq_new(INITIAL_QUEUE_SIZE);
 
@@ -2155,7 +2201,7 @@ static inline bool pf_fuel_node_init(struct pf_fuel_map *pffm,
         && NULL == tile_city(ptile)
         && !terrain_has_flag(tile_terrain(ptile), TER_NO_ZOC)
         && !params->get_zoc(params->owner, ptile, params->map)) {
-      node->zoc_number = (0 < unit_list_size(ptile->units)
+      node->zoc_number = (0 < unit_stack_size(ptile->units)
                           ? ZOC_ALLIED : ZOC_NO);
 #ifdef ZERO_VARIABLES_FOR_SEARCHING
     } else {
@@ -3077,6 +3123,8 @@ static void pf_fuel_map_destroy(struct pf_map *pfm)
     pf_fuel_pos_unref(node->segment);
   }
   free(pffm->lattice);
+  fc_mem_account(MEM_TAG_PF,
+                 -MAP_INDEX_SIZE * (long) sizeof(struct pf_fuel_node), -1);
   map_index_pq_destroy(pffm->queue);
   map_index_pq_destroy(pffm->waited_queue);
   free(pffm);
@@ -3098,10 +3146,13 @@ static struct pf_map *pf_fuel_map_new(const struct pf_parameter *parameter)
 #ifdef PF_DEBUG
   /* Set the mode, used for cast check. */
   base_map->mode = PF_FUEL;
+  base_map->multi_source = FALSE;
 #endif /* PF_DEBUG */
 
   /* Allocate the map. */
   pffm->lattice = fc_calloc(MAP_INDEX_SIZE, sizeof(struct pf_fuel_node));
+  fc_mem_account(MEM_TAG_PF,
+                 MAP_INDEX_SIZE * (long) sizeof(struct pf_fuel_node), 1);
   pffm->queue = map_index_pq_new(INITIAL_QUEUE_SIZE);
   pffm->waited_queue = map_index_pq_new(INITIAL_QUEUE_SIZE);
 
@@ -3184,6 +3235,43 @@ struct pf_map *pf_map_new(const struct pf_parameter *parameter)
   return pf_normal_map_new(parameter);
 }
 
+/************************************************************************//**
+  Factory function to create a new map which is flooded from several tiles
+  at once. 'parameter->start_tile' is always a source, the tiles of
+  'sources' are added to it. All the sources share the other fields of
+  'parameter' (unit type, moves left...). The paths returned by the map
+  start at the source which reaches the target the best, which makes it
+  possible to answer questions like "which of these tiles is the nearest
+  from the target?" with a single flood.
+
+  Only normal maps are supported, i.e. the parameter must neither have
+  'is_pos_dangerous' nor 'get_moves_left_req' callbacks. Transported units
+  are not supported neither. Does not do any iterations.
+****************************************************************************/
+struct pf_map *pf_map_new_multi_source(const struct pf_parameter *parameter,
+                                       const struct tile_list *sources)
+{
+  struct pf_map *pfm;
+
+  fc_assert_ret_val(NULL == parameter->is_pos_dangerous, NULL);
+  fc_assert_ret_val(NULL == parameter->get_moves_left_req, NULL);
+  fc_assert_ret_val(NULL == parameter->transported_by_initially, NULL);
+
+  pfm = pf_normal_map_new(parameter);
+  if (NULL != pfm) {
+#ifdef PF_DEBUG
+    pfm->multi_source = TRUE;
+#endif
+    if (NULL != sources) {
+      tile_list_iterate(sources, ptile) {
+        pf_normal_map_add_source(PF_NORMAL_MAP(pfm), ptile);
+      } tile_list_iterate_end;
+    }
+  }
+
+  return pfm;
+}
+
 /************************************************************************//**
   After usage the map must be destroyed.
 ****************************************************************************/
@@ -3230,7 +3318,7 @@ struct pf_path *pf_map_path(struct pf_map *pfm, struct tile *ptile)
     const struct pf_position *pos = &path->positions[0];
 
     fc_assert(path->length >= 1);
-    fc_assert(pos->tile == param->start_tile);
+    fc_assert(pos->tile == param->start_tile || pfm->multi_source);
     fc_assert(pos->moves_left == param->moves_left_initially);
     fc_assert(pos->fuel_left == param->fuel_left_initially);
   }
@@ -3544,6 +3632,162 @@ void pf_path_print_real(const struct pf_path *path, enum log_level level,
 }
 
 
+/* ====================== pf_map_group functions ========================= */
+
+/* The path-finding map groups are used to share maps between units which
+ * would use exactly the same parameter, e.g. units of the same type and
+ * moves left stacked on the same tile. It stores a pf_map per different
+ * parameter. */
+
+static genhash_val_t pf_group_hash_val(const struct pf_parameter *parameter);
+static bool pf_group_hash_cmp(const struct pf_parameter *parameter1,
+                              const struct pf_parameter *parameter2);
+static void pf_map_group_destroy_param(struct pf_parameter *param);
+
+#define SPECHASH_TAG pf_group
+#define SPECHASH_IKEY_TYPE struct pf_parameter *
+#define SPECHASH_IDATA_TYPE struct pf_map *
+#define SPECHASH_IKEY_VAL pf_group_hash_val
+#define SPECHASH_IKEY_COMP pf_group_hash_cmp
+#define SPECHASH_IKEY_FREE pf_map_group_destroy_param
+#define SPECHASH_IDATA_FREE pf_map_destroy
+#include "spechash.h"
+
+/* The map group structure. */
+struct pf_map_group {
+  struct pf_group_hash *hash;   /* The maps, by parameter. */
+  int requests;                 /* Number of calls to pf_map_group_get(). */
+};
+
+/************************************************************************//**
+  Hash function for pf_parameter key of map groups.
+****************************************************************************/
+static genhash_val_t pf_group_hash_val(const struct pf_parameter *parameter)
+{
+  genhash_val_t result = tile_index(parameter->start_tile);
+
+  result += utype_index(parameter->utype) << 20;
+  result ^= (parameter->moves_left_initially
+             + (parameter->fuel_left_initially << 12)) << 8;
+  if (NULL != parameter->owner) {
+    result += player_index(parameter->owner) << 26;
+  }
+
+  return result;
+}
+
+/************************************************************************//**
+  Comparison function for pf_parameter key of map groups. Unlike the
+  reverse maps, we need every field to be identical, because we cannot
+  know what the callbacks are doing with them.
+****************************************************************************/
+static bool pf_group_hash_cmp(const struct pf_parameter *parameter1,
+                              const struct pf_parameter *parameter2)
+{
+  return (parameter1->map == parameter2->map
+          && parameter1->start_tile == parameter2->start_tile
+          && parameter1->moves_left_initially
+             == parameter2->moves_left_initially
+          && parameter1->fuel_left_initially
+             == parameter2->fuel_left_initially
+          && parameter1->transported_by_initially
+             == parameter2->transported_by_initially
+          && parameter1->cargo_depth == parameter2->cargo_depth
+          && BV_ARE_EQUAL(parameter1->cargo_types, parameter2->cargo_types)
+          && parameter1->move_rate == parameter2->move_rate
+          && parameter1->fuel == parameter2->fuel
+          && parameter1->utype == parameter2->utype
+          && parameter1->owner == parameter2->owner
+          && parameter1->omniscience == parameter2->omniscience
+          && parameter1->get_MC == parameter2->get_MC
+          && parameter1->get_move_scope == parameter2->get_move_scope
+          && parameter1->ignore_none_scopes == parameter2->ignore_none_scopes
+          && parameter1->get_TB == parameter2->get_TB
+          && parameter1->get_EC == parameter2->get_EC
+          && parameter1->get_action == parameter2->get_action
+          && parameter1->actions == parameter2->actions
+          && parameter1->is_action_possible
+             == parameter2->is_action_possible
+          && parameter1->get_zoc == parameter2->get_zoc
+          && parameter1->is_pos_dangerous == parameter2->is_pos_dangerous
+          && parameter1->get_moves_left_req
+             == parameter2->get_moves_left_req
+          && parameter1->get_costs == parameter2->get_costs
+          && parameter1->data == parameter2->data);
+}
+
+/************************************************************************//**
+  Destroy the parameter.
+****************************************************************************/
+static void pf_map_group_destroy_param(struct pf_parameter *param)
+{
+  free(param);
+}
+
+/************************************************************************//**
+  'pf_map_group' constructor.
+****************************************************************************/
+struct pf_map_group *pf_map_group_new(void)
+{
+  struct pf_map_group *pfmg = fc_malloc(sizeof(*pfmg));
+
+  pfmg->hash = pf_group_hash_new();
+  pfmg->requests = 0;
+
+  return pfmg;
+}
+
+/************************************************************************//**
+  'pf_map_group' destructor. Destroys all the maps of the group.
+****************************************************************************/
+void pf_map_group_destroy(struct pf_map_group *pfmg)
+{
+  fc_assert_ret(NULL != pfmg);
+
+  log_debug("pf_map_group: %d maps built for %d requests.",
+            pf_map_group_size(pfmg), pfmg->requests);
+  pf_group_hash_destroy(pfmg->hash);
+  free(pfmg);
+}
+
+/************************************************************************//**
+  Returns a map for the parameter, building it only if no map was built
+  yet for an identical parameter in this group. The map is owned by the
+  group, so it must not be destroyed by the caller.
+
+  As the map may be shared by several callers, only method A) functions
+  (pf_map_move_cost(), pf_map_path(), pf_map_position()) should be used
+  with it. Iterating it with the method B) functions would skip the
+  positions already iterated by the other users of the map.
+****************************************************************************/
+struct pf_map *pf_map_group_get(struct pf_map_group *pfmg,
+                                const struct pf_parameter *parameter)
+{
+  struct pf_parameter *copy;
+  struct pf_map *pfm;
+
+  pfmg->requests++;
+  if (pf_group_hash_lookup(pfmg->hash, parameter, &pfm)) {
+    return pfm;
+  }
+
+  pfm = pf_map_new(parameter);
+  copy = fc_malloc(sizeof(*copy));
+  *copy = *parameter;
+  pf_group_hash_insert(pfmg->hash, copy, pfm);
+
+  return pfm;
+}
+
+/************************************************************************//**
+  Returns the number of different maps the group built.
+****************************************************************************/
+int pf_map_group_size(const struct pf_map_group *pfmg)
+{
+  return (int) pf_group_hash_size(pfmg->hash);
+}
+
+
 /* ===================== pf_reverse_map functions ======================== */
 
 /* The path-finding reverse maps are used check the move costs that the
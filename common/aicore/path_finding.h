@@ -194,6 +194,26 @@ extern "C" {
  *
  * You may call pf_map_path() multiple times with the same pfm.
  *
+ * When several units would fill exactly the same parameter (e.g. units of
+ * the same type stacked on the same tile), they can share a map with
+ * pf_map_group_get() instead of building one each:
+ *
+ *    struct pf_map_group *pfmg = pf_map_group_new();
+ *
+ *    unit_stack_iterate(ptile->units, punit) {
+ *      // fill parameter for 'punit'
+ *      pfm = pf_map_group_get(pfmg, &parameter);
+ *      // use method A) functions only, the map is shared
+ *    } unit_stack_iterate_end;
+ *
+ *    // destroys all the maps of the group.
+ *    pf_map_group_destroy(pfmg);
+ *
+ * To find which of many tiles is the nearest from the goal, a map can
+ * also be flooded from all of them at once with pf_map_new_multi_source().
+ * The first position of the paths is then the source tile they start
+ * from.
+ *
  * B) the caller doesn't know the map position of the goal yet (but knows
  * what he is looking for, e.g. a port) and wants to iterate over
  * all paths in order of increasing costs (total_CC):
@@ -478,6 +498,10 @@ struct pf_map;
 /* The reverse map strucure. Opaque type. */
 struct pf_reverse_map;
 
+/* A group of maps shared by units with identical parameters. Opaque
+ * type. */
+struct pf_map_group;
+
 
 
 /* ========================= Public Interface ============================ */
@@ -485,6 +509,9 @@ struct pf_reverse_map;
 /* Create and free. */
 struct pf_map *pf_map_new(const struct pf_parameter *parameter)
                fc__warn_unused_result;
+struct pf_map *pf_map_new_multi_source(const struct pf_parameter *parameter,
+                                       const struct tile_list *sources)
+               fc__warn_unused_result;
 void pf_map_destroy(struct pf_map *pfm);
 
 /* Method A) functions. */
@@ -522,6 +549,14 @@ void pf_path_print_real(const struct pf_path *path, enum log_level level,
   }
 
 
+/* Map group functions (Maps shared by units with identical parameter). */
+struct pf_map_group *pf_map_group_new(void) fc__warn_unused_result;
+void pf_map_group_destroy(struct pf_map_group *pfmg);
+struct pf_map *pf_map_group_get(struct pf_map_group *pfmg,
+                                const struct pf_parameter *parameter);
+int pf_map_group_size(const struct pf_map_group *pfmg);
+
+
 /* Reverse map functions (Costs to go to start tile). */
 struct pf_reverse_map *pf_reverse_map_new(const struct player *pplayer,
                                           struct tile *start_tile,
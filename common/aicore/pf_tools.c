@@ -59,7 +59,7 @@ static inline bool pf_attack_possible(const struct tile *ptile,
   }
 
   attack_any = FALSE;
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     if (!pplayers_at_war(unit_owner(punit), param->owner)) {
       return FALSE;
     }
@@ -72,7 +72,7 @@ static inline bool pf_attack_possible(const struct tile *ptile,
       /* We would need to be able to attack all, this is not the case. */
       return FALSE;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return attack_any;
 }
@@ -252,7 +252,7 @@ pf_get_move_scope(const struct tile *ptile,
 
     *can_disembark = FALSE;
 
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       utype = unit_type_get(punit);
 
       if (!pf_transport_check(param, punit, utype)) {
@@ -282,7 +282,7 @@ pf_get_move_scope(const struct tile *ptile,
         *can_disembark = !unit_has_orders(punit);
         break;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   }
 
   return scope;
@@ -575,7 +575,7 @@ static bool is_possible_base_fuel(const struct tile *ptile,
   }
 
   /* Check for carriers */
-  unit_list_iterate(ptile->units, ptrans) {
+  unit_stack_iterate(ptile->units, ptrans) {
     const struct unit_type *trans_utype = unit_type_get(ptrans);
 
     if (pf_transport_check(param, ptrans, trans_utype)
@@ -584,7 +584,7 @@ static bool is_possible_base_fuel(const struct tile *ptile,
             || tile_has_native_base(ptile, trans_utype))) {
       return TRUE;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return FALSE;
 }
@@ -31,12 +31,14 @@
 #include "citizens.h"
 #include "counters.h"
 #include "effects.h"
+#include "extras.h"
 #include "game.h"
 #include "government.h"
 #include "improvement.h"
 #include "map.h"
 #include "movement.h"
 #include "packets.h"
+#include "road.h"
 #include "specialist.h"
 #include "traderoutes.h"
 #include "unit.h"
@@ -49,6 +51,9 @@
 /* Define this to add in extra (very slow) assertions for the city code. */
 #undef CITY_DEBUGGING
 
+/* Define this to check every partial city refresh against a full one. */
+#undef CITY_REFRESH_VERIFY
+
 static char *citylog_map_line(int y, int city_radius_sq, int *city_map_data);
 #ifdef FREECIV_DEBUG
 /* only used for debugging */
@@ -1585,7 +1590,7 @@ bool city_is_occupied(const struct city *pcity)
 {
   if (is_server()) {
     /* The server sees the units inside the city. */
-    return (unit_list_size(city_tile(pcity)->units) > 0);
+    return (unit_stack_size(city_tile(pcity)->units) > 0);
   } else {
     /* The client gets the occupied property from the server. */
     return pcity->client.occupied;
@@ -2271,6 +2276,271 @@ static inline void set_city_bonuses(struct city *pcity)
   } output_type_iterate_end;
 }
 
+/* The per tile output effects, in the order city_tile_output() applies
+ * them. */
+enum tile_output_effect {
+  TOE_ADD,
+  TOE_PENALTY,
+  TOE_INC_CELEBRATE,
+  TOE_INC,
+  TOE_PER,
+  TOE_PUNISH,
+  TOE_COUNT
+};
+
+static const enum effect_type tile_output_effects[TOE_COUNT] = {
+  EFT_OUTPUT_ADD_TILE,
+  EFT_OUTPUT_PENALTY_TILE,
+  EFT_OUTPUT_INC_TILE_CELEBRATE,
+  EFT_OUTPUT_INC_TILE,
+  EFT_OUTPUT_PER_TILE,
+  EFT_OUTPUT_TILE_PUNISH_PCT
+};
+
+/* Tables city_tile_output_batch() works from.  They only depend on the
+ * ruleset, so they are built once it has been loaded. */
+static struct {
+  bool ready;
+
+  /* Whether each of the per tile output effects may give something to
+   * each output type at all. */
+  bool relevant[TOE_COUNT][O_LAST];
+
+  /* The road extras that change tile output, and by how much. */
+  int num_roads;
+  struct {
+    const struct extra_type *pextra;
+    int const_incr[O_LAST];
+    int incr[O_LAST];
+    int bonus[O_LAST];
+  } roads[MAX_EXTRA_TYPES];
+} tile_output_tables;
+
+/**********************************************************************//**
+  Build the tables used to calculate the output of city tiles from the
+  ruleset.
+
+  An effect requiring another output type can never apply, so an effect
+  type without any other effects can be left out of the tile loops for
+  that output type.  Roads that give no output are left out of the walk
+  over the extras of a tile.
+**************************************************************************/
+void city_tile_output_tables_init(void)
+{
+  int i;
+
+  for (i = 0; i < TOE_COUNT; i++) {
+    output_type_iterate(o) {
+      tile_output_tables.relevant[i][o] = FALSE;
+    } output_type_iterate_end;
+
+    effect_list_iterate(get_effects(tile_output_effects[i]), peffect) {
+      Output_type_id only = O_LAST;
+
+      requirement_vector_iterate(&peffect->reqs, preq) {
+        if (preq->source.kind == VUT_OTYPE && preq->present) {
+          only = preq->source.value.outputtype;
+          break;
+        }
+      } requirement_vector_iterate_end;
+
+      output_type_iterate(o) {
+        if (only == O_LAST || only == o) {
+          tile_output_tables.relevant[i][o] = TRUE;
+        }
+      } output_type_iterate_end;
+    } effect_list_iterate_end;
+  }
+
+  tile_output_tables.num_roads = 0;
+  extra_type_by_cause_iterate(EC_ROAD, pextra) {
+    struct road_type *proad = extra_road_get(pextra);
+    bool gives = FALSE;
+
+    output_type_iterate(o) {
+      if (proad->tile_incr_const[o] != 0 || proad->tile_incr[o] != 0
+          || proad->tile_bonus[o] != 0) {
+        gives = TRUE;
+      }
+    } output_type_iterate_end;
+
+    if (gives) {
+      i = tile_output_tables.num_roads++;
+      tile_output_tables.roads[i].pextra = pextra;
+      output_type_iterate(o) {
+        tile_output_tables.roads[i].const_incr[o] = proad->tile_incr_const[o];
+        tile_output_tables.roads[i].incr[o] = proad->tile_incr[o];
+        tile_output_tables.roads[i].bonus[o] = proad->tile_bonus[o];
+      } output_type_iterate_end;
+    }
+  } extra_type_by_cause_iterate_end;
+
+  tile_output_tables.ready = TRUE;
+}
+
+/**********************************************************************//**
+  Forget the tables used to calculate the output of city tiles, as the
+  ruleset they were built from goes away.
+**************************************************************************/
+void city_tile_output_tables_free(void)
+{
+  tile_output_tables.ready = FALSE;
+}
+
+/**********************************************************************//**
+  Calculate the output of 'n' tiles for the city at once; the same as
+  calling city_tile_output() for each of them and each output type.
+  'out' is laid out by output type: the output of type o for tile t goes
+  to out[o * n + t].
+
+  The terrain, resource and road part is done for all the output types
+  of a tile in one go, from the tables city_tile_output_tables_init()
+  built.  The effects are then evaluated output type by output type,
+  skipping those that can not apply to it, and the arithmetic between
+  them runs over whole arrays.
+**************************************************************************/
+static void city_tile_output_batch(const struct city *pcity,
+                                   bool is_celebrating,
+                                   const struct tile *const *ptiles, int n,
+                                   int *out)
+{
+  bool known[n], positive[n];
+  int limit[n];
+  const struct output_type *output;
+  const struct player *pplayer = city_owner(pcity);
+  int center = -1;
+  int t, r;
+
+  if (!tile_output_tables.ready) {
+    /* Ruleset loaded without populating the caches. */
+    city_tile_output_tables_init();
+  }
+
+  for (t = 0; t < n; t++) {
+    const struct tile *ptile = ptiles[t];
+    struct terrain *pterrain = tile_terrain(ptile);
+    int const_incr[O_LAST] = { 0, }, incr[O_LAST] = { 0, };
+    int bonus[O_LAST] = { 0, };
+
+    known[t] = (T_UNKNOWN != pterrain);
+    if (!known[t]) {
+      /* See city_tile_output() */
+      output_type_iterate(o) {
+        out[o * n + t] = 0;
+      } output_type_iterate_end;
+      continue;
+    }
+    if (is_city_center(pcity, ptile)) {
+      center = t;
+    }
+
+    for (r = 0; r < tile_output_tables.num_roads; r++) {
+      if (tile_has_extra(ptile, tile_output_tables.roads[r].pextra)) {
+        output_type_iterate(o) {
+          const_incr[o] += tile_output_tables.roads[r].const_incr[o];
+          incr[o] += tile_output_tables.roads[r].incr[o];
+          bonus[o] += tile_output_tables.roads[r].bonus[o];
+        } output_type_iterate_end;
+      }
+    }
+
+    output_type_iterate(o) {
+      int prod = pterrain->output[o];
+
+      if (tile_resource_is_valid(ptile)) {
+        prod += tile_resource(ptile)->data.resource->output[o];
+      }
+      if (o == O_SHIELD && pterrain->mining_shield_incr != 0) {
+        prod += pterrain->mining_shield_incr
+          * get_target_bonus_effects(NULL, pplayer, NULL, pcity, NULL,
+                                     ptile, NULL, NULL, NULL, NULL, NULL,
+                                     EFT_MINING_PCT)
+          / 100;
+      } else if (o == O_FOOD && pterrain->irrigation_food_incr != 0) {
+        prod += pterrain->irrigation_food_incr
+          * get_target_bonus_effects(NULL, pplayer, NULL, pcity, NULL,
+                                     ptile, NULL, NULL, NULL, NULL, NULL,
+                                     EFT_IRRIGATION_PCT)
+          / 100;
+      }
+
+      prod += const_incr[o]
+              + incr[o] * pterrain->road_output_incr_pct[o] / 100;
+      prod += prod * bonus[o] / 100;
+      out[o * n + t] = prod;
+    } output_type_iterate_end;
+  }
+
+#define TILE_OUTPUT_EFFECT(_toe, _t)                                        \
+  get_tile_output_bonus(pcity, ptiles[_t], output, tile_output_effects[_toe])
+
+  output_type_iterate(o) {
+    int *prod = out + o * n;
+
+    output = get_output_type(o);
+
+    if (tile_output_tables.relevant[TOE_ADD][o]) {
+      for (t = 0; t < n; t++) {
+        if (known[t]) {
+          prod[t] += TILE_OUTPUT_EFFECT(TOE_ADD, t);
+        }
+      }
+    }
+    for (t = 0; t < n; t++) {
+      positive[t] = known[t] && prod[t] > 0;
+      limit[t] = 0;
+    }
+
+    /* No penalty if celebrating */
+    if (!is_celebrating && tile_output_tables.relevant[TOE_PENALTY][o]) {
+      for (t = 0; t < n; t++) {
+        if (positive[t]) {
+          limit[t] = TILE_OUTPUT_EFFECT(TOE_PENALTY, t);
+        }
+      }
+    }
+    if (is_celebrating
+        && tile_output_tables.relevant[TOE_INC_CELEBRATE][o]) {
+      for (t = 0; t < n; t++) {
+        if (positive[t]) {
+          prod[t] += TILE_OUTPUT_EFFECT(TOE_INC_CELEBRATE, t);
+        }
+      }
+    }
+    if (tile_output_tables.relevant[TOE_INC][o]) {
+      for (t = 0; t < n; t++) {
+        if (positive[t]) {
+          prod[t] += TILE_OUTPUT_EFFECT(TOE_INC, t);
+        }
+      }
+    }
+    if (tile_output_tables.relevant[TOE_PER][o]) {
+      for (t = 0; t < n; t++) {
+        if (positive[t]) {
+          prod[t] += prod[t] * TILE_OUTPUT_EFFECT(TOE_PER, t) / 100;
+        }
+      }
+    }
+    for (t = 0; t < n; t++) {
+      prod[t] -= (positive[t] && limit[t] > 0 && prod[t] > limit[t]);
+    }
+
+    if (tile_output_tables.relevant[TOE_PUNISH][o]) {
+      for (t = 0; t < n; t++) {
+        if (known[t]) {
+          prod[t] -= prod[t] * TILE_OUTPUT_EFFECT(TOE_PUNISH, t) / 100;
+        }
+      }
+    }
+
+    if (center >= 0) {
+      prod[center] = MAX(prod[center], game.info.min_city_center_output[o]);
+    }
+  } output_type_iterate_end;
+
+#undef TILE_OUTPUT_EFFECT
+}
+
 /**********************************************************************//**
   This function sets the cache for the tile outputs, the pcity->tile_cache[]
   array. It is called near the beginning of city_refresh_from_main_map().
@@ -2285,24 +2555,39 @@ static inline void city_tile_cache_update(struct city *pcity)
 {
   bool is_celebrating = base_city_celebrating(pcity);
   int radius_sq = city_map_radius_sq_get(pcity);
+  int tiles = city_map_tiles(radius_sq);
+  const struct tile *ptiles[tiles];
+  int indices[tiles];
+  int out[O_LAST * tiles];
+  int n = 0, t;
 
   /* initialize tile_cache if needed */
   if (pcity->tile_cache == NULL || pcity->tile_cache_radius_sq == -1
       || pcity->tile_cache_radius_sq != radius_sq) {
     pcity->tile_cache = fc_realloc(pcity->tile_cache,
-                                   city_map_tiles(radius_sq)
-                                   * sizeof(*(pcity->tile_cache)));
+                                   tiles * sizeof(*(pcity->tile_cache)));
     pcity->tile_cache_radius_sq = radius_sq;
   }
 
   /* Any unreal tiles are skipped - these values should have been memset
    * to 0 when the city was created. */
   city_tile_iterate_index(radius_sq, pcity->tile, ptile, city_tile_index) {
+    ptiles[n] = ptile;
+    indices[n] = city_tile_index;
+    n++;
+  } city_tile_iterate_index_end;
+
+  city_tile_output_batch(pcity, is_celebrating, ptiles, n, out);
+
+  for (t = 0; t < n; t++) {
     output_type_iterate(o) {
-      (pcity->tile_cache[city_tile_index]).output[o]
-        = city_tile_output(pcity, ptile, is_celebrating, o);
+#ifdef CITY_DEBUGGING
+      fc_assert(out[o * n + t]
+                == city_tile_output(pcity, ptiles[t], is_celebrating, o));
+#endif /* CITY_DEBUGGING */
+      (pcity->tile_cache[indices[t]]).output[o] = out[o * n + t];
     } output_type_iterate_end;
-  } city_tile_iterate_index_end;
+  }
 }
 
 /**********************************************************************//**
@@ -2971,13 +3256,13 @@ static inline void city_support(struct city *pcity)
     int count = 0;
     int martial_law_max = get_city_bonus(pcity, EFT_MARTIAL_LAW_MAX);
 
-    unit_list_iterate(pcity->tile->units, punit) {
+    unit_stack_iterate(pcity->tile->units, punit) {
       if ((count < martial_law_max || martial_law_max == 0)
           && is_military_unit(punit)
           && unit_owner(punit) == city_owner(pcity)) {
         count++;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
 
     pcity->martial_law = CLIP(0, count * martial_law_each, MAX_CITY_SIZE);
   }
@@ -2995,34 +3280,36 @@ static inline void city_support(struct city *pcity)
 }
 
 /**********************************************************************//**
-  Refreshes the internal cached data in the city structure.
-
-  !full_refresh will not update tile_cache[] or bonus[].  These two
-  values do not need to be recalculated for AI CMA testing.
-
-  'workers_map' is an boolean array which defines the placement of the
-  workers within the city map. It uses the tile index and its size is
-  defined by city_map_tiles_from_city(_pcity). See also cm_state_init().
+  Mark stages of the city refresh as stale, so that the next
+  city_refresh_from_main_map() recomputes them.  Code changing a city
+  calls this when it knows what its change affects; a city that was not
+  marked at all is refreshed completely.
 
-  If 'workers_map' is set, only basic updates are needed.
+  Changing only the worked tiles or the specialists affects
+  CITY_REFRESH_PRODUCTION.  Like the CM, this treats the output of a tile
+  as independent of whether the tile is worked.
 **************************************************************************/
-void city_refresh_from_main_map(struct city *pcity, bool *workers_map)
+void city_refresh_mark(struct city *pcity, unsigned int stages)
 {
-  if (workers_map == NULL) {
-    /* do a full refresh */
-
-    /* Calculate the bonus[] array values. */
-    set_city_bonuses(pcity);
-    /* Calculate the tile_cache[] values. */
-    city_tile_cache_update(pcity);
-    /* manage settlers, and units */
-    city_support(pcity);
-  }
+  pcity->refresh_dirty |= stages;
+}
 
-  /* Calculate output from citizens (uses city_tile_cache_get_output()). */
-  get_worked_tile_output(pcity, pcity->citizen_base, workers_map);
-  add_specialist_output(pcity, pcity->citizen_base);
+/**********************************************************************//**
+  Returns whether any of the given stages will be recomputed by the next
+  refresh of the city.
+**************************************************************************/
+bool city_refresh_stale(const struct city *pcity, unsigned int stages)
+{
+  return pcity->refresh_dirty == 0 || (pcity->refresh_dirty & stages) != 0;
+}
 
+/**********************************************************************//**
+  Recompute the stages of the city refresh which are left after the
+  citizens have been placed.  They depend on everything else and are
+  always recomputed.
+**************************************************************************/
+static void city_refresh_happy(struct city *pcity)
+{
   set_city_production(pcity);
   citizen_base_mood(pcity);
   /* Note that pollution is calculated before unhappy_city_check() makes
@@ -3050,6 +3337,121 @@ void city_refresh_from_main_map(struct city *pcity, bool *workers_map)
   set_surpluses(pcity);
 }
 
+#ifdef CITY_REFRESH_VERIFY
+/**********************************************************************//**
+  Redo a refresh which skipped stages as a full one, and complain about
+  every value the skipped stages would have changed.
+**************************************************************************/
+static void city_refresh_verify(struct city *pcity, unsigned int stages)
+{
+  struct city *partial = fc_malloc(sizeof(*partial));
+  int tiles = city_map_tiles(pcity->tile_cache_radius_sq);
+  struct tile_cache *cache = NULL;
+
+  *partial = *pcity;
+  if (tiles > 0 && pcity->tile_cache != NULL) {
+    cache = fc_malloc(tiles * sizeof(*cache));
+    memcpy(cache, pcity->tile_cache, tiles * sizeof(*cache));
+  }
+
+  pcity->refresh_dirty = CITY_REFRESH_ALL;
+  city_refresh_from_main_map(pcity, NULL);
+
+#define VERIFY_FIELD(_field)                                                \
+  if (memcmp(&partial->_field, &pcity->_field,                              \
+             sizeof(pcity->_field)) != 0) {                                 \
+    log_error("Refresh of %s with stages 0x%x left " #_field " stale.",    \
+              city_name_get(pcity), stages);                                \
+  }
+
+  VERIFY_FIELD(bonus);
+  VERIFY_FIELD(usage);
+  VERIFY_FIELD(martial_law);
+  VERIFY_FIELD(unit_happy_upkeep);
+  VERIFY_FIELD(citizen_base);
+  VERIFY_FIELD(prod);
+  VERIFY_FIELD(waste);
+  VERIFY_FIELD(unhappy_penalty);
+  VERIFY_FIELD(surplus);
+  VERIFY_FIELD(feel);
+  VERIFY_FIELD(pollution);
+
+#undef VERIFY_FIELD
+
+  if (cache != NULL
+      && pcity->tile_cache_radius_sq == partial->tile_cache_radius_sq
+      && memcmp(cache, pcity->tile_cache, tiles * sizeof(*cache)) != 0) {
+    log_error("Refresh of %s with stages 0x%x left tile_cache stale.",
+              city_name_get(pcity), stages);
+  }
+
+  free(cache);
+  free(partial);
+}
+#endif /* CITY_REFRESH_VERIFY */
+
+/**********************************************************************//**
+  Refreshes the internal cached data in the city structure.
+
+  Without 'workers_map' only the stages marked with city_refresh_mark()
+  since the last refresh are recomputed, or all of them if none were
+  marked.
+
+  'workers_map' is an boolean array which defines the placement of the
+  workers within the city map. It uses the tile index and its size is
+  defined by city_map_tiles_from_city(_pcity). See also cm_state_init().
+
+  If 'workers_map' is set, only basic updates are needed.  tile_cache[]
+  and bonus[] are then left alone, as they do not need to be
+  recalculated for AI CMA testing.
+**************************************************************************/
+void city_refresh_from_main_map(struct city *pcity, bool *workers_map)
+{
+  if (workers_map == NULL) {
+    unsigned int stages = pcity->refresh_dirty;
+
+    if (stages == 0) {
+      stages = CITY_REFRESH_ALL;
+    }
+    if (stages & CITY_REFRESH_TILE_CACHE) {
+      /* The citizens work the tiles in the cache. */
+      stages |= CITY_REFRESH_PRODUCTION;
+    }
+    pcity->refresh_dirty = 0;
+
+    if (stages & CITY_REFRESH_BONUS) {
+      /* Calculate the bonus[] array values. */
+      set_city_bonuses(pcity);
+    }
+    if (stages & CITY_REFRESH_TILE_CACHE) {
+      /* Calculate the tile_cache[] values. */
+      city_tile_cache_update(pcity);
+    }
+    if (stages & CITY_REFRESH_SUPPORT) {
+      /* manage settlers, and units */
+      city_support(pcity);
+    }
+    if (stages & CITY_REFRESH_PRODUCTION) {
+      /* Calculate output from citizens (uses city_tile_cache_get_output()). */
+      get_worked_tile_output(pcity, pcity->citizen_base, NULL);
+      add_specialist_output(pcity, pcity->citizen_base);
+    }
+
+    city_refresh_happy(pcity);
+
+#ifdef CITY_REFRESH_VERIFY
+    if (stages != CITY_REFRESH_ALL) {
+      city_refresh_verify(pcity, stages);
+    }
+#endif /* CITY_REFRESH_VERIFY */
+  } else {
+    get_worked_tile_output(pcity, pcity->citizen_base, workers_map);
+    add_specialist_output(pcity, pcity->citizen_base);
+
+    city_refresh_happy(pcity);
+  }
+}
+
 /**********************************************************************//**
   Give corruption/waste generated by city.  otype gives the output type
   (O_SHIELD/O_TRADE).  'total' gives the total output of this type in the
@@ -3385,6 +3787,8 @@ void destroy_city_virtual(struct city *pcity)
     free(pcity->cm_parameter);
   }
 
+  cm_clear_cache(pcity);
+
   if (pcity->counter_values) {
     free(pcity->counter_values);
   }
@@ -302,6 +302,18 @@ struct tile_cache; /* defined and only used within city.c */
 struct adv_city; /* defined in ./server/advisors/infracache.h */
 
 struct cm_parameter; /* defined in ./common/aicore/cm.h */
+struct cm_state;     /* defined in ./common/aicore/cm.c */
+
+/* Stages of city_refresh_from_main_map() which can be recomputed on their
+ * own; see city_refresh_mark(). */
+#define CITY_REFRESH_BONUS      (1 << 0) /* bonus[] */
+#define CITY_REFRESH_TILE_CACHE (1 << 1) /* tile_cache[] */
+#define CITY_REFRESH_SUPPORT    (1 << 2) /* usage[], martial law, military
+                                          * unhappiness */
+#define CITY_REFRESH_PRODUCTION (1 << 3) /* citizen_base[] */
+#define CITY_REFRESH_HAPPY      (1 << 4) /* prod[], waste[], feel[],
+                                          * surplus[] */
+#define CITY_REFRESH_ALL        ((1 << 5) - 1)
 
 struct city {
   char name[MAX_LEN_CITYNAME];
@@ -405,6 +417,11 @@ struct city {
   } rally_point;
 
   struct cm_parameter *cm_parameter;
+  struct cm_state *cm_state; /* Kept between cm queries */
+
+  /* CITY_REFRESH_* stages gone stale since the last refresh. Zero means
+   * nobody said, so everything is recomputed. */
+  unsigned int refresh_dirty;
 
   union {
     struct {
@@ -659,6 +676,8 @@ int compare_iter_index(const void *a, const void *b);
 void generate_city_map_indices(void);
 void free_city_map_index(void);
 void city_production_caravan_shields_init(void);
+void city_tile_output_tables_init(void);
+void city_tile_output_tables_free(void);
 
 /* output on spot */
 int city_tile_output(const struct city *pcity, const struct tile *ptile,
@@ -717,6 +736,8 @@ void city_remove_improvement(struct city *pcity,
 
 /* city update functions */
 void city_refresh_from_main_map(struct city *pcity, bool *workers_map);
+void city_refresh_mark(struct city *pcity, unsigned int stages);
+bool city_refresh_stale(const struct city *pcity, unsigned int stages);
 
 int city_waste(const struct city *pcity, Output_type_id otype, int total,
                int *breakdown);
@@ -0,0 +1,269 @@
+/***********************************************************************
+ Freeciv - Copyright (C) 1996 - A Kjeldberg, L Gregersen, P Unold
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+***********************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <fc_config.h>
+#endif
+
+/* utility */
+#include "log.h"
+#include "mem.h"
+
+/* common */
+#include "city.h"
+#include "map.h"
+
+#include "citygrid.h"
+
+struct city_grid {
+  int cols, rows;
+  struct city_list **cells;
+
+  /* A city could not be added; only a full scan finds all the cities. */
+  bool incomplete;
+};
+
+/**********************************************************************//**
+  Initialize the city grid of the world.  The cells are only allocated
+  with the first city, when the map size is known.
+**************************************************************************/
+void city_grid_init(struct world *iworld)
+{
+  iworld->city_grid = fc_calloc(1, sizeof(*iworld->city_grid));
+}
+
+/**********************************************************************//**
+  Free the city grid of the world.
+**************************************************************************/
+void city_grid_free(struct world *iworld)
+{
+  struct city_grid *grid = iworld->city_grid;
+  int i;
+
+  if (grid == NULL) {
+    return;
+  }
+
+  if (grid->cells != NULL) {
+    for (i = 0; i < grid->cols * grid->rows; i++) {
+      city_list_destroy(grid->cells[i]);
+    }
+    free(grid->cells);
+  }
+  free(grid);
+  iworld->city_grid = NULL;
+}
+
+/**********************************************************************//**
+  Find the number of columns and rows of grid cells covering the map.
+**************************************************************************/
+void grid_cells_size(const struct civ_map *nmap, int *cols, int *rows)
+{
+  *cols = (nmap->xsize + CITY_GRID_CELL - 1) / CITY_GRID_CELL;
+  *rows = (nmap->ysize + CITY_GRID_CELL - 1) / CITY_GRID_CELL;
+}
+
+/**********************************************************************//**
+  Returns the index of the grid cell the tile is in.
+**************************************************************************/
+int grid_cell_index(const struct civ_map *nmap, const struct tile *ptile)
+{
+  int index = tile_index(ptile);
+  int cols = (nmap->xsize + CITY_GRID_CELL - 1) / CITY_GRID_CELL;
+
+  return (index / nmap->xsize / CITY_GRID_CELL) * cols
+         + index % nmap->xsize / CITY_GRID_CELL;
+}
+
+/**********************************************************************//**
+  Returns the cell of the tile, allocating the cells if needed.  Returns
+  NULL if there is no map to lay the cells on.
+**************************************************************************/
+static struct city_list *city_grid_cell(struct world *iworld,
+                                        const struct tile *ptile)
+{
+  struct city_grid *grid = iworld->city_grid;
+
+  if (grid->cells == NULL) {
+    int i;
+
+    if (iworld->map.xsize <= 0 || iworld->map.ysize <= 0) {
+      return NULL;
+    }
+
+    grid_cells_size(&iworld->map, &grid->cols, &grid->rows);
+    grid->cells = fc_malloc(grid->cols * grid->rows * sizeof(*grid->cells));
+    for (i = 0; i < grid->cols * grid->rows; i++) {
+      grid->cells[i] = city_list_new();
+    }
+  }
+
+  return grid->cells[grid_cell_index(&iworld->map, ptile)];
+}
+
+/**********************************************************************//**
+  Add a city to the grid.
+**************************************************************************/
+void city_grid_add(struct world *iworld, struct city *pcity)
+{
+  struct city_list *cell;
+
+  if (iworld->city_grid == NULL) {
+    return;
+  }
+  if (pcity->tile == NULL) {
+    iworld->city_grid->incomplete = TRUE;
+    return;
+  }
+
+  cell = city_grid_cell(iworld, pcity->tile);
+  if (cell == NULL) {
+    iworld->city_grid->incomplete = TRUE;
+    return;
+  }
+  city_list_append(cell, pcity);
+}
+
+/**********************************************************************//**
+  Remove a city from the grid.
+**************************************************************************/
+void city_grid_remove(struct world *iworld, struct city *pcity)
+{
+  if (iworld->city_grid == NULL || iworld->city_grid->cells == NULL
+      || pcity->tile == NULL) {
+    return;
+  }
+
+  city_list_remove(city_grid_cell(iworld, pcity->tile), pcity);
+}
+
+/**********************************************************************//**
+  Find the cell columns (or rows) covering the native coordinates from
+  'center - dist' to 'center + dist'.  Returns the number of ranges,
+  which are from 'lo' to 'hi', both inclusive.
+**************************************************************************/
+static int grid_cell_ranges(int center, int dist, int size, int cells,
+                            bool wrap, int *lo, int *hi)
+{
+  int from = center - dist, to = center + dist;
+
+  if (!wrap) {
+    lo[0] = MAX(from, 0) / CITY_GRID_CELL;
+    hi[0] = MIN(to, size - 1) / CITY_GRID_CELL;
+    return 1;
+  }
+  if (to - from + 1 >= size) {
+    lo[0] = 0;
+    hi[0] = cells - 1;
+    return 1;
+  }
+  if (from >= 0 && to < size) {
+    lo[0] = from / CITY_GRID_CELL;
+    hi[0] = to / CITY_GRID_CELL;
+    return 1;
+  }
+
+  /* Wrapping over the edge of the map. */
+  if (from < 0) {
+    hi[0] = to / CITY_GRID_CELL;
+    lo[1] = (from + size) / CITY_GRID_CELL;
+  } else {
+    hi[0] = (to - size) / CITY_GRID_CELL;
+    lo[1] = from / CITY_GRID_CELL;
+  }
+  lo[0] = 0;
+  hi[1] = cells - 1;
+  if (lo[1] <= hi[0]) {
+    /* Both ends meet in the same cell. */
+    hi[0] = cells - 1;
+    return 1;
+  }
+
+  return 2;
+}
+
+/**********************************************************************//**
+  Find the grid cells holding every tile within real distance 'dist' of
+  the tile, and likely some more.  Fills 'indices' with their indices
+  and returns their number, or -1 if it would take more than
+  'max_indices' cells.  Every cell is handed out once.
+**************************************************************************/
+int grid_cells_near(const struct civ_map *nmap, const struct tile *ptile,
+                    int dist, int *indices, int max_indices)
+{
+  int index = tile_index(ptile);
+  int xlo[2], xhi[2], ylo[2], yhi[2];
+  int cols, rows, nx, ny, xranges, yranges, i, j, x, y;
+  int count = 0;
+
+  grid_cells_size(nmap, &cols, &rows);
+
+  if (nmap->topology_id & (TF_ISO | TF_HEX)) {
+    /* A step in map coordinates moves up to two native rows. */
+    nx = dist + 1;
+    ny = 2 * dist;
+  } else {
+    nx = dist;
+    ny = dist;
+  }
+
+  xranges = grid_cell_ranges(index % nmap->xsize, nx, nmap->xsize, cols,
+                             nmap->topology_id & TF_WRAPX, xlo, xhi);
+  yranges = grid_cell_ranges(index / nmap->xsize, ny, nmap->ysize, rows,
+                             nmap->topology_id & TF_WRAPY, ylo, yhi);
+
+  for (j = 0; j < yranges; j++) {
+    for (y = ylo[j]; y <= yhi[j]; y++) {
+      for (i = 0; i < xranges; i++) {
+        for (x = xlo[i]; x <= xhi[i]; x++) {
+          if (count >= max_indices) {
+            return -1;
+          }
+          indices[count++] = y * cols + x;
+        }
+      }
+    }
+  }
+
+  return count;
+}
+
+/**********************************************************************//**
+  Find the cells holding every city within real distance 'dist' of the
+  tile, and likely some more.  Fills 'cells' with them and returns their
+  number, or -1 if it would take more than 'max_cells' cells or the grid
+  does not know all the cities.  Every cell is handed out once.
+**************************************************************************/
+int city_grid_near(const struct world *iworld, const struct tile *ptile,
+                   int dist, struct city_list **cells, int max_cells)
+{
+  const struct city_grid *grid = iworld->city_grid;
+  int indices[CITY_GRID_MAX_NEAR];
+  int count, i;
+
+  if (grid == NULL || grid->incomplete) {
+    return -1;
+  }
+  if (grid->cells == NULL) {
+    /* No cities yet. */
+    return 0;
+  }
+
+  count = grid_cells_near(&iworld->map, ptile, dist, indices,
+                          MIN(max_cells, ARRAY_SIZE(indices)));
+  for (i = 0; i < count; i++) {
+    cells[i] = grid->cells[indices[i]];
+  }
+
+  return count;
+}
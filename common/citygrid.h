@@ -0,0 +1,58 @@
+/***********************************************************************
+ Freeciv - Copyright (C) 1996 - A Kjeldberg, L Gregersen, P Unold
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+***********************************************************************/
+#ifndef FC__CITYGRID_H
+#define FC__CITYGRID_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**************************************************************************
+   City grid: the cities of a world sorted into square cells of the map,
+   for finding the cities near a tile without looking at all of them.
+   It is kept up to date by idex_register_city() and
+   idex_unregister_city().
+***************************************************************************/
+
+/* common */
+#include "fc_types.h"
+#include "world_object.h"
+
+struct city_list;
+
+/* Side of a grid cell, in native tiles. */
+#define CITY_GRID_CELL 8
+
+/* Most cells city_grid_near() hands out at once. */
+#define CITY_GRID_MAX_NEAR 64
+
+void city_grid_init(struct world *iworld);
+void city_grid_free(struct world *iworld);
+
+void city_grid_add(struct world *iworld, struct city *pcity);
+void city_grid_remove(struct world *iworld, struct city *pcity);
+
+int city_grid_near(const struct world *iworld, const struct tile *ptile,
+                   int dist, struct city_list **cells, int max_cells);
+
+/* The cells, shared with the unit grid. */
+void grid_cells_size(const struct civ_map *nmap, int *cols, int *rows);
+int grid_cell_index(const struct civ_map *nmap, const struct tile *ptile);
+int grid_cells_near(const struct civ_map *nmap, const struct tile *ptile,
+                    int dist, int *indices, int max_indices);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif  /* FC__CITYGRID_H */
@@ -66,7 +66,7 @@ static void calc_activity(struct actcalc *calc, const struct tile *ptile,
   memset(calc, 0, sizeof(*calc));
 
   /* Contributions from real units */
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     Activity_type_id act = punit->activity;
 
     if (punit == pmodunit) {
@@ -91,7 +91,7 @@ static void calc_activity(struct actcalc *calc, const struct tile *ptile,
       t->activity_total[act] += get_activity_rate_this_turn(punit);
       t->activity_units[act] += get_activity_rate(punit);
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   /* Hypothetical contribution from pmodunit, if it changed to specified
    * activity/target */
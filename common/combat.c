@@ -47,7 +47,7 @@ static bool can_player_attack_tile(const struct player *pplayer,
   struct city *pcity = tile_city(ptile);
   
   /* 1. Is there anyone there at all? */
-  if (!pcity && unit_list_size((ptile->units)) == 0) {
+  if (!pcity && unit_stack_size((ptile->units)) == 0) {
     return FALSE;
   }
 
@@ -57,12 +57,12 @@ static bool can_player_attack_tile(const struct player *pplayer,
   }
 
   /* 3. Are we allowed to attack _all_ units there? */
-  unit_list_iterate(ptile->units, aunit) {
+  unit_stack_iterate(ptile->units, aunit) {
     if (!pplayers_at_war(unit_owner(aunit), pplayer)) {
       /* Enemy hiding behind a human/diplomatic shield */
       return FALSE;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return TRUE;
 }
@@ -192,7 +192,7 @@ unit_attack_all_at_tile_result(const struct unit *punit,
   bool any_reachable_unit = FALSE;
   bool any_neverprotect_unit = FALSE;
 
-  unit_list_iterate(ptile->units, aunit) {
+  unit_stack_iterate(ptile->units, aunit) {
     /* HACK: we don't count transported units here.  This prevents some
      * bugs like a submarine carrying a cruise missile being invulnerable
      * to other sea units.  However from a gameplay perspective it's a hack,
@@ -213,7 +213,7 @@ unit_attack_all_at_tile_result(const struct unit *punit,
       }
       any_reachable_unit = TRUE;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   /* If there are only unreachable, UTYF_NEVER_PROTECTS units, we still have
    * to return ATT_UNREACHABLE. */
@@ -232,7 +232,7 @@ unit_attack_any_at_tile_result(const struct unit *punit,
 {
   enum unit_attack_result result = ATT_OK;
 
-  unit_list_iterate(ptile->units, aunit) {
+  unit_stack_iterate(ptile->units, aunit) {
     /* HACK: we don't count transported units here.  This prevents some
      * bugs like a cargoplane carrying a land unit being vulnerable. */
     if (!unit_transported(aunit)) {
@@ -242,7 +242,7 @@ unit_attack_any_at_tile_result(const struct unit *punit,
         return result;
       }
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   /* That's result from check against last unit on tile, not first.
    * Shouldn't matter. */
@@ -276,7 +276,7 @@ unit_wipe_units_at_tile_result(const struct unit *punit,
     return ATT_NON_ATTACK;
   }
 
-  unit_list_iterate(ptile->units, target) {
+  unit_stack_iterate(ptile->units, target) {
     if (get_total_defense_power(punit, target) > 0) {
       return ATT_NOT_WIPABLE;
     }
@@ -299,7 +299,7 @@ unit_wipe_units_at_tile_result(const struct unit *punit,
     if (!is_unit_reachable_at(target, punit, ptile)) {
       return ATT_UNREACHABLE;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return ATT_OK;
 }
@@ -813,7 +813,7 @@ struct unit *get_defender(const struct unit *attacker,
    * making it able to fx choose a 1a/9d unit over a 10a/10d unit. It should
    * also be able to spare units without full hp's to some extent, as these
    * could be more valuable later. */
-  unit_list_iterate(ptile->units, defender) {
+  unit_stack_iterate(ptile->units, defender) {
     /* We used to skip over allied units, but the logic for that is
      * complicated and is now handled elsewhere. */
     if (unit_can_defend_here(&(wld.map), defender)
@@ -854,7 +854,7 @@ struct unit *get_defender(const struct unit *attacker,
 	rating_of_best = defense_rating;
       }
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return bestdef;
 }
@@ -871,7 +871,7 @@ struct unit *get_attacker(const struct unit *defender,
   struct unit *bestatt = 0;
   int bestvalue = -1, unit_a, best_cost = 0;
 
-  unit_list_iterate(ptile->units, attacker) {
+  unit_stack_iterate(ptile->units, attacker) {
     int build_cost = unit_build_shield_cost_base(attacker);
 
     if (pplayers_allied(unit_owner(defender), unit_owner(attacker))) {
@@ -884,7 +884,7 @@ struct unit *get_attacker(const struct unit *defender,
       bestatt = attacker;
       best_cost = build_cost;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return bestatt;
 }
@@ -905,7 +905,7 @@ struct unit *get_diplomatic_defender(const struct unit *act_unit,
   fc_assert_ret_val(act_unit, NULL);
   fc_assert_ret_val(tgt_tile, NULL);
 
-  unit_list_iterate(tgt_tile->units, punit) {
+  unit_stack_iterate(tgt_tile->units, punit) {
     if (unit_owner(punit) == unit_owner(act_unit)) {
       /* I can't confirm if we won't deny that we weren't involved.
        * (Won't defend against its owner.) */
@@ -935,7 +935,7 @@ struct unit *get_diplomatic_defender(const struct unit *act_unit,
     /* The first potential defender found is chosen. No priority is given
      * to the best defender. */
     return punit;
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   /* No diplomatic defender found. */
   return NULL;
@@ -172,7 +172,7 @@ void game_remove_unit(struct world *gworld, struct unit *punit)
               punit->homecity);
   }
 
-  unit_list_remove(unit_tile(punit)->units, punit);
+  unit_stack_remove(unit_tile(punit)->units, punit);
   unit_list_remove(unit_owner(punit)->units, punit);
 
   idex_unregister_unit(gworld, punit);
@@ -343,7 +343,11 @@ static void game_defaults(bool keep_ruleset_value)
     game.server.auto_ai_toggle    = GAME_DEFAULT_AUTO_AI_TOGGLE;
     game.server.autoattack        = GAME_DEFAULT_AUTOATTACK;
     game.server.barbarianrate     = GAME_DEFAULT_BARBARIANRATE;
+    game.server.border_verify     = GAME_DEFAULT_BORDER_VERIFY;
     game.server.civilwarsize      = GAME_DEFAULT_CIVILWARSIZE;
+    game.server.threads           = GAME_DEFAULT_THREADS;
+    game.server.city_threads      = GAME_DEFAULT_CITY_THREADS;
+    game.server.cm_threads        = GAME_DEFAULT_CM_THREADS;
     game.server.connectmsg[0]     = '\0';
     game.server.conquercost       = GAME_DEFAULT_CONQUERCOST;
     game.server.contactturns      = GAME_DEFAULT_CONTACTTURNS;
@@ -583,6 +587,7 @@ void game_ruleset_free(void)
   extras_free();
   music_styles_free();
   city_styles_free();
+  city_tile_output_tables_free();
   styles_free();
   actions_free();
   achievements_free();
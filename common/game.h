@@ -131,7 +131,10 @@ struct civ_game {
       int autoupgrade_veteran_loss;
       enum barbarians_rate barbarianrate;
       int base_incite_cost;
+      bool border_verify; /* recompute all borders to check the update */
       int civilwarsize;
+      int city_threads;   /* threads refreshing cities at turn end */
+      int cm_threads;     /* threads solving city governor queries */
       int conquercost;
       int contactturns;
       int diplchance;
@@ -192,6 +195,7 @@ struct civ_game {
       int techlost_recv;
       int tcptimeout;
       int techpenalty;
+      int threads;        /* size of the pool of threads */
       bool turnblock;
       int unitwaittime;   /* minimal time between two movements of a unit */
       int upgrade_veteran_loss;
@@ -672,6 +676,20 @@ extern struct world wld;
 
 #define GAME_DEFAULT_THREADED_SAVE   FALSE
 
+#define GAME_DEFAULT_BORDER_VERIFY   FALSE
+
+#define GAME_DEFAULT_THREADS         4
+#define GAME_MIN_THREADS             0
+#define GAME_MAX_THREADS             64
+
+#define GAME_DEFAULT_CITY_THREADS    0
+#define GAME_MIN_CITY_THREADS        0
+#define GAME_MAX_CITY_THREADS        64
+
+#define GAME_DEFAULT_CM_THREADS      0
+#define GAME_MIN_CM_THREADS          0
+#define GAME_MAX_CM_THREADS          64
+
 #define GAME_DEFAULT_USER_META_MESSAGE ""
 
 #define GAME_DEFAULT_SKILL_LEVEL     AI_LEVEL_EASY
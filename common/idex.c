@@ -15,11 +15,11 @@
    idex = ident index: a lookup table for quick mapping of unit and city
    id values to unit and city pointers.
 
-   Method: use separate hash tables for each type.
-   Means code duplication for city/unit cases, but simplicity advantages.
-   Don't have to manage memory at all: store pointers to unit and city
-   structs allocated elsewhere, and keys are pointers to id values inside
-   the structs.
+   Method: use a separate table for each type.  As the ids are small
+   and handed out densely (see identity_number()), the tables are arrays
+   indexed by the id, in blocks of IDEX_BLOCK_SIZE ids allocated once an
+   id in them gets used.  A lookup is two array reads.  Only pointers to
+   unit and city structs allocated elsewhere are stored.
 
    Note id values should probably be unsigned int: here leave as plain int
    so can use pointers to pcity->id etc.
@@ -29,34 +29,128 @@
 #include <fc_config.h>
 #endif
 
+#include <string.h>
+
 /* utility */
 #include "log.h"
+#include "mem.h"
 
 /* common */
 #include "city.h"
+#include "citygrid.h"
 #include "unit.h"
+#include "unitgrid.h"
 
 #include "idex.h"
 
+#define IDEX_BLOCK_BITS 10
+#define IDEX_BLOCK_SIZE (1 << IDEX_BLOCK_BITS)
+
+struct idex_table {
+  void ***blocks;
+  int num_blocks;
+};
+
+/**********************************************************************//**
+  Returns a new, empty id table.
+**************************************************************************/
+static struct idex_table *idex_table_new(void)
+{
+  return fc_calloc(1, sizeof(struct idex_table));
+}
+
+/**********************************************************************//**
+  Free the id table.
+**************************************************************************/
+static void idex_table_destroy(struct idex_table *ptable)
+{
+  int i;
+
+  for (i = 0; i < ptable->num_blocks; i++) {
+    free(ptable->blocks[i]);
+  }
+  free(ptable->blocks);
+  free(ptable);
+}
+
+/**********************************************************************//**
+  Returns the object with the id, or NULL if there is none.
+**************************************************************************/
+static inline void *idex_table_get(const struct idex_table *ptable, int id)
+{
+  void **block;
+
+  if (0 > id || (id >> IDEX_BLOCK_BITS) >= ptable->num_blocks) {
+    return NULL;
+  }
+  block = ptable->blocks[id >> IDEX_BLOCK_BITS];
+
+  return NULL != block ? block[id & (IDEX_BLOCK_SIZE - 1)] : NULL;
+}
+
+/**********************************************************************//**
+  Set the object with the id, or clear it if ptr is NULL.  Returns the
+  object that was there before.
+**************************************************************************/
+static void *idex_table_set(struct idex_table *ptable, int id, void *ptr)
+{
+  int nblock = id >> IDEX_BLOCK_BITS;
+  void **block, *old;
+
+  fc_assert_ret_val(0 <= id, NULL);
+
+  if (nblock >= ptable->num_blocks) {
+    int num_blocks = MAX(nblock + 1, 2 * ptable->num_blocks);
+
+    if (NULL == ptr) {
+      return NULL;
+    }
+    ptable->blocks = fc_realloc(ptable->blocks,
+                                num_blocks * sizeof(*ptable->blocks));
+    memset(ptable->blocks + ptable->num_blocks, 0,
+           (num_blocks - ptable->num_blocks) * sizeof(*ptable->blocks));
+    ptable->num_blocks = num_blocks;
+  }
+
+  block = ptable->blocks[nblock];
+  if (NULL == block) {
+    if (NULL == ptr) {
+      return NULL;
+    }
+    block = fc_calloc(IDEX_BLOCK_SIZE, sizeof(*block));
+    ptable->blocks[nblock] = block;
+  }
+
+  old = block[id & (IDEX_BLOCK_SIZE - 1)];
+  block[id & (IDEX_BLOCK_SIZE - 1)] = ptr;
+
+  return old;
+}
+
 /**********************************************************************//**
    Initialize.  Should call this at the start before use.
 **************************************************************************/
 void idex_init(struct world *iworld)
 {
-  iworld->cities = city_hash_new();
-  iworld->units = unit_hash_new();
+  iworld->cities = idex_table_new();
+  iworld->units = idex_table_new();
+  city_grid_init(iworld);
+  unit_grid_init(iworld);
 }
 
 /**********************************************************************//**
-   Free the hashs.
+   Free the tables.
 **************************************************************************/
 void idex_free(struct world *iworld)
 {
-  city_hash_destroy(iworld->cities);
+  idex_table_destroy(iworld->cities);
   iworld->cities = NULL;
 
-  unit_hash_destroy(iworld->units);
+  idex_table_destroy(iworld->units);
   iworld->units = NULL;
+
+  city_grid_free(iworld);
+  unit_grid_free(iworld);
 }
 
 /**********************************************************************//**
@@ -65,13 +159,14 @@ void idex_free(struct world *iworld)
 **************************************************************************/
 void idex_register_city(struct world *iworld, struct city *pcity)
 {
-  struct city *old;
+  struct city *old = idex_table_set(iworld->cities, pcity->id, pcity);
 
-  city_hash_replace_full(iworld->cities, pcity->id, pcity, NULL, &old);
   fc_assert_ret_msg(NULL == old,
                     "IDEX: city collision: new %d %p %s, old %d %p %s",
                     pcity->id, (void *) pcity, city_name_get(pcity),
                     old->id, (void *) old, city_name_get(old));
+
+  city_grid_add(iworld, pcity);
 }
 
 /**********************************************************************//**
@@ -80,13 +175,14 @@ void idex_register_city(struct world *iworld, struct city *pcity)
 **************************************************************************/
 void idex_register_unit(struct world *iworld, struct unit *punit)
 {
-  struct unit *old;
+  struct unit *old = idex_table_set(iworld->units, punit->id, punit);
 
-  unit_hash_replace_full(iworld->units, punit->id, punit, NULL, &old);
   fc_assert_ret_msg(NULL == old,
                     "IDEX: unit collision: new %d %p %s, old %d %p %s",
                     punit->id, (void *) punit, unit_rule_name(punit),
                     old->id, (void *) old, unit_rule_name(old));
+
+  unit_grid_add(iworld, punit);
 }
 
 /**********************************************************************//**
@@ -95,9 +191,8 @@ void idex_register_unit(struct world *iworld, struct unit *punit)
 **************************************************************************/
 void idex_unregister_city(struct world *iworld, struct city *pcity)
 {
-  struct city *old;
+  struct city *old = idex_table_set(iworld->cities, pcity->id, NULL);
 
-  city_hash_remove_full(iworld->cities, pcity->id, NULL, &old);
   fc_assert_ret_msg(NULL != old,
                     "IDEX: city unreg missing: %d %p %s",
                     pcity->id, (void *) pcity, city_name_get(pcity));
@@ -105,6 +200,8 @@ void idex_unregister_city(struct world *iworld, struct city *pcity)
                     "unreg %d %p %s, old %d %p %s",
                     pcity->id, (void *) pcity, city_name_get(pcity),
                     old->id, (void *) old, city_name_get(old));
+
+  city_grid_remove(iworld, pcity);
 }
 
 /**********************************************************************//**
@@ -113,9 +210,8 @@ void idex_unregister_city(struct world *iworld, struct city *pcity)
 **************************************************************************/
 void idex_unregister_unit(struct world *iworld, struct unit *punit)
 {
-  struct unit *old;
+  struct unit *old = idex_table_set(iworld->units, punit->id, NULL);
 
-  unit_hash_remove_full(iworld->units, punit->id, NULL, &old);
   fc_assert_ret_msg(NULL != old,
                     "IDEX: unit unreg missing: %d %p %s",
                     punit->id, (void *) punit, unit_rule_name(punit));
@@ -123,6 +219,8 @@ void idex_unregister_unit(struct world *iworld, struct unit *punit)
                     "unreg %d %p %s, old %d %p %s",
                     punit->id, (void *) punit, unit_rule_name(punit),
                     old->id, (void*) old, unit_rule_name(old));
+
+  unit_grid_remove(punit);
 }
 
 /**********************************************************************//**
@@ -131,9 +229,9 @@ void idex_unregister_unit(struct world *iworld, struct unit *punit)
 **************************************************************************/
 struct city *idex_lookup_city(struct world *iworld, int id)
 {
-  struct city *pcity;
+  struct city *pcity = idex_table_get(iworld->cities, id);
 
-  city_hash_lookup(iworld->cities, id, &pcity);
+  fc_assert_ret_val(NULL == pcity || pcity->id == id, NULL);
 
   return pcity;
 }
@@ -144,9 +242,9 @@ struct city *idex_lookup_city(struct world *iworld, int id)
 **************************************************************************/
 struct unit *idex_lookup_unit(struct world *iworld, int id)
 {
-  struct unit *punit;
+  struct unit *punit = idex_table_get(iworld->units, id);
 
-  unit_hash_lookup(iworld->units, id, &punit);
+  fc_assert_ret_val(NULL == punit || punit->id == id, NULL);
 
   return punit;
 }
@@ -14,7 +14,7 @@
 #ifdef HAVE_CONFIG_H
 #include <fc_config.h>
 #endif
-#include <string.h>             /* strlen */
+#include <string.h>             /* strlen, memset */
 
 /* utility */
 #include "fcintl.h"
@@ -159,8 +159,12 @@ void map_init(struct civ_map *imap, bool server_side)
   imap->num_continents = 0;
   imap->num_oceans = 0;
   imap->tiles = NULL;
+  memset(&imap->dense, 0, sizeof(imap->dense));
   imap->startpos_table = NULL;
   imap->iterate_outwards_indices = NULL;
+  imap->iterate_outwards_deltas = NULL;
+  imap->iterate_outwards_reach = NULL;
+  imap->iterate_outwards_sq_dist = NULL;
 
   /* The [xy]size values are set in map_init_topology.  It is initialized
    * to a non-zero value because some places erronously use these values
@@ -288,6 +292,50 @@ static void generate_map_indices(void)
 #endif
 
   wld.map.num_iterate_outwards_indices = tiles;
+
+  /* The index offsets of the positions only depend on whether the start
+   * is in an even or an odd native row.  Where no position wraps or
+   * leaves the map, they give the tiles without normalizing. */
+  wld.map.iterate_outwards_max_dist
+    = wld.map.iterate_outwards_indices[tiles - 1].dist;
+  fc_assert(NULL == wld.map.iterate_outwards_deltas);
+  wld.map.iterate_outwards_deltas
+    = fc_malloc(2 * tiles * sizeof(*wld.map.iterate_outwards_deltas));
+  wld.map.iterate_outwards_reach
+    = fc_calloc(2 * (wld.map.iterate_outwards_max_dist + 1),
+                sizeof(*wld.map.iterate_outwards_reach));
+  wld.map.iterate_outwards_sq_dist
+    = fc_malloc(tiles * sizeof(*wld.map.iterate_outwards_sq_dist));
+
+  for (i = 0; i < tiles; i++) {
+    const struct iter_index *pindex = &wld.map.iterate_outwards_indices[i];
+    int parity;
+
+    wld.map.iterate_outwards_sq_dist[i]
+      = map_vector_to_sq_distance(pindex->dx, pindex->dy);
+
+    for (parity = 0; parity < 2; parity++) {
+      int map_x, map_y, dx, dy;
+      int *reach = &wld.map.iterate_outwards_reach[2 * pindex->dist];
+
+      NATIVE_TO_MAP_POS(&map_x, &map_y, 0, parity);
+      MAP_TO_NATIVE_POS(&nat_x, &nat_y,
+                        map_x + pindex->dx, map_y + pindex->dy);
+      dx = nat_x;
+      dy = nat_y - parity;
+
+      wld.map.iterate_outwards_deltas[parity * tiles + i]
+        = dy * wld.map.xsize + dx;
+      reach[0] = MAX(reach[0], ABS(dx));
+      reach[1] = MAX(reach[1], ABS(dy));
+    }
+  }
+  for (i = 1; i <= wld.map.iterate_outwards_max_dist; i++) {
+    int *reach = &wld.map.iterate_outwards_reach[2 * i];
+
+    reach[0] = MAX(reach[0], reach[-2]);
+    reach[1] = MAX(reach[1], reach[-1]);
+  }
 }
 
 /*******************************************************************//**
@@ -340,6 +388,23 @@ void map_init_topology(void)
   fc_assert(wld.map.num_valid_dirs > 0 && wld.map.num_valid_dirs <= 8);
   fc_assert(wld.map.num_cardinal_dirs > 0
             && wld.map.num_cardinal_dirs <= wld.map.num_valid_dirs);
+
+  /* Index offsets of the adjacent tiles, as for iterate_outward(). */
+  wld.map.dir_reach_y = 0;
+  for (dir = 0; dir < 8; dir++) {
+    int parity;
+
+    for (parity = 0; parity < 2; parity++) {
+      int map_x, map_y, nat_x, nat_y;
+
+      NATIVE_TO_MAP_POS(&map_x, &map_y, 0, parity);
+      MAP_TO_NATIVE_POS(&nat_x, &nat_y,
+                        map_x + DIR_DX[dir], map_y + DIR_DY[dir]);
+      wld.map.dir_deltas[parity][dir]
+        = (nat_y - parity) * wld.map.xsize + nat_x;
+      wld.map.dir_reach_y = MAX(wld.map.dir_reach_y, ABS(nat_y - parity));
+    }
+  }
 }
 
 /*******************************************************************//**
@@ -352,7 +417,7 @@ static void tile_init(struct tile *ptile)
   BV_CLR_ALL(ptile->extras);
   ptile->resource = NULL;
   ptile->terrain  = T_UNKNOWN;
-  ptile->units    = unit_list_new();
+  ptile->units    = unit_stack_new();
   ptile->owner    = NULL; /* Not claimed by any player. */
   ptile->extras_owner = NULL;
   ptile->placing  = NULL;
@@ -470,7 +535,7 @@ struct tile *index_to_tile(const struct civ_map *imap, int mindex)
 ***********************************************************************/
 static void tile_free(struct tile *ptile)
 {
-  unit_list_destroy(ptile->units);
+  unit_stack_destroy(ptile->units);
 
   if (ptile->spec_sprite) {
     free(ptile->spec_sprite);
@@ -494,6 +559,7 @@ void map_allocate(struct civ_map *amap)
 
   fc_assert_ret(NULL == amap->tiles);
   amap->tiles = fc_calloc(MAP_INDEX_SIZE, sizeof(*amap->tiles));
+  fc_mem_account(MEM_TAG_MAP, MAP_INDEX_SIZE * (long) sizeof(*amap->tiles), 1);
 
   /* Note this use of whole_map_iterate may be a bit sketchy, since the
    * tile values (ptile->index, etc.) haven't been set yet.  It might be
@@ -510,12 +576,53 @@ void map_allocate(struct civ_map *amap)
   amap->startpos_table = startpos_hash_new();
 }
 
+/* Bytes per tile of the dense tile field arrays */
+#define TILE_DENSE_SIZE                                                   \
+  (sizeof(*wld.map.dense.terrain) + sizeof(*wld.map.dense.owner)          \
+   + sizeof(*wld.map.dense.continent) + sizeof(*wld.map.dense.extras))
+
+/*******************************************************************//**
+  Allocate the dense tile field arrays of the main map and fill them
+  from the tiles.
+***********************************************************************/
+static void main_map_dense_allocate(void)
+{
+  struct tile_dense *dense = &wld.map.dense;
+
+  fc_assert_ret(NULL == dense->terrain);
+
+  dense->terrain = fc_malloc(MAP_INDEX_SIZE * sizeof(*dense->terrain));
+  dense->owner = fc_malloc(MAP_INDEX_SIZE * sizeof(*dense->owner));
+  dense->continent = fc_malloc(MAP_INDEX_SIZE * sizeof(*dense->continent));
+  dense->extras = fc_malloc(MAP_INDEX_SIZE * sizeof(*dense->extras));
+  fc_mem_account(MEM_TAG_MAP, MAP_INDEX_SIZE * (long) TILE_DENSE_SIZE, 4);
+
+  main_map_dense_sync();
+}
+
+/*******************************************************************//**
+  Copy the hot fields of every tile of the main map to the dense
+  arrays.  For use after writing the tile fields directly in bulk, like
+  when loading a map.
+***********************************************************************/
+void main_map_dense_sync(void)
+{
+  if (NULL == wld.map.dense.terrain) {
+    return;
+  }
+
+  whole_map_iterate(&(wld.map), ptile) {
+    tile_dense_sync(ptile);
+  } whole_map_iterate_end;
+}
+
 /*******************************************************************//**
   Allocate main map and related global structures.
 ***********************************************************************/
 void main_map_allocate(void)
 {
   map_allocate(&(wld.map));
+  main_map_dense_allocate();
   generate_city_map_indices();
   generate_map_indices();
   CALL_FUNC_EACH_AI(map_alloc);
@@ -535,6 +642,17 @@ void map_free(struct civ_map *fmap)
 
     free(fmap->tiles);
     fmap->tiles = NULL;
+    fc_mem_account(MEM_TAG_MAP,
+                   -MAP_INDEX_SIZE * (long) sizeof(*fmap->tiles), -1);
+
+    if (fmap->dense.terrain != NULL) {
+      fc_mem_account(MEM_TAG_MAP, -MAP_INDEX_SIZE * (long) TILE_DENSE_SIZE,
+                     -4);
+    }
+    FC_FREE(fmap->dense.terrain);
+    FC_FREE(fmap->dense.owner);
+    FC_FREE(fmap->dense.continent);
+    FC_FREE(fmap->dense.extras);
 
     if (fmap->startpos_table) {
       startpos_hash_destroy(fmap->startpos_table);
@@ -542,6 +660,9 @@ void map_free(struct civ_map *fmap)
     }
 
     FC_FREE(fmap->iterate_outwards_indices);
+    FC_FREE(fmap->iterate_outwards_deltas);
+    FC_FREE(fmap->iterate_outwards_reach);
+    FC_FREE(fmap->iterate_outwards_sq_dist);
   }
 }
 
@@ -51,6 +51,7 @@ void map_init(struct civ_map *imap, bool server_side);
 void map_init_topology(void);
 void map_allocate(struct civ_map *amap);
 void main_map_allocate(void);
+void main_map_dense_sync(void);
 void map_free(struct civ_map *fmap);
 void main_map_free(void);
 
@@ -329,12 +330,16 @@ extern struct terrain_misc terrain_control;
  * See also iterate_outward() */
 #define iterate_outward_dxy(nmap, start_tile, max_dist, _tile, _x, _y)      \
 {									    \
-  int _x, _y, _tile##_x, _tile##_y, _start##_x, _start##_y;                 \
+  int _x, _y, _tile##_x, _tile##_y, _start##_x = 0, _start##_y = 0;        \
   struct tile *_tile;							    \
   const struct tile *_tile##_start = (start_tile);			    \
   int _tile##_max = (max_dist);						    \
   int _tile##_index = 0;						    \
-  index_to_map_pos(&_start##_x, &_start##_y, tile_index(_tile##_start));    \
+  const int *_tile##_deltas = iterate_outward_deltas(_tile##_start,         \
+                                                     _tile##_max);          \
+  if (NULL == _tile##_deltas) {                                             \
+    index_to_map_pos(&_start##_x, &_start##_y, tile_index(_tile##_start));  \
+  }                                                                         \
   for (;								    \
        _tile##_index < wld.map.num_iterate_outwards_indices;		    \
        _tile##_index++) { 						    \
@@ -343,11 +348,17 @@ extern struct terrain_misc terrain_control;
     }									    \
     _x = wld.map.iterate_outwards_indices[_tile##_index].dx;		    \
     _y = wld.map.iterate_outwards_indices[_tile##_index].dy;		    \
-    _tile##_x = _x + _start##_x;                                            \
-    _tile##_y = _y + _start##_y;                                            \
-    _tile = map_pos_to_tile(nmap, _tile##_x, _tile##_y);                    \
-    if (NULL == _tile) {                                                    \
-      continue;                                                             \
+    if (NULL != _tile##_deltas) {                                           \
+      /* Away from the edges; the index offset gives the tile. */          \
+      _tile = (nmap)->tiles + tile_index(_tile##_start)                     \
+              + _tile##_deltas[_tile##_index];                              \
+    } else {                                                                \
+      _tile##_x = _x + _start##_x;                                          \
+      _tile##_y = _y + _start##_y;                                          \
+      _tile = map_pos_to_tile(nmap, _tile##_x, _tile##_y);                  \
+      if (NULL == _tile) {                                                  \
+        continue;                                                           \
+      }                                                                     \
     }
 
 #define iterate_outward_dxy_end						    \
@@ -404,7 +415,7 @@ extern struct terrain_misc terrain_control;
   const int _tile##_cr_radius = (int)sqrt((double)MAX(_tile##_sq_radius, 0)); \
 									    \
   square_dxy_iterate(nmap, center_tile, _tile##_cr_radius, _tile, dx, dy) { \
-    const int dr = map_vector_to_sq_distance(dx, dy);			    \
+    const int dr = wld.map.iterate_outwards_sq_dist[_tile##_index];        \
 									    \
     if (dr <= _tile##_sq_radius) {
 
@@ -487,21 +498,30 @@ extern struct terrain_misc terrain_control;
 			     dirlist, dircount)				    \
 {									    \
   enum direction8 _dir;							    \
-  int _tile##_x, _tile##_y, _tile##_cx, _tile##_cy;                         \
+  int _tile##_x, _tile##_y, _tile##_cx = 0, _tile##_cy = 0;                 \
   struct tile *_tile;							    \
   const struct tile *_tile##_center = (center_tile);			    \
+  const int *_tile##_deltas = adjc_dir_deltas(_tile##_center);              \
   int _tile##_index = 0;						    \
-  index_to_map_pos(&_tile##_cx, &_tile##_cy, tile_index(_tile##_center));   \
+  if (NULL == _tile##_deltas) {                                             \
+    index_to_map_pos(&_tile##_cx, &_tile##_cy, tile_index(_tile##_center)); \
+  }                                                                         \
   for (;								    \
        _tile##_index < (dircount);					    \
        _tile##_index++) {						    \
     _dir = dirlist[_tile##_index];					    \
-    DIRSTEP(_tile##_x, _tile##_y, _dir);				    \
-    _tile##_x += _tile##_cx;                                                \
-    _tile##_y += _tile##_cy;                                                \
-    _tile = map_pos_to_tile(nmap, _tile##_x, _tile##_y);                    \
-    if (NULL == _tile) {                                                    \
-      continue;                                                             \
+    if (NULL != _tile##_deltas) {                                           \
+      /* Away from the edges; the index offset gives the tile. */          \
+      _tile = (nmap)->tiles + tile_index(_tile##_center)                    \
+              + _tile##_deltas[_dir];                                       \
+    } else {                                                                \
+      DIRSTEP(_tile##_x, _tile##_y, _dir);                                  \
+      _tile##_x += _tile##_cx;                                              \
+      _tile##_y += _tile##_cy;                                              \
+      _tile = map_pos_to_tile(nmap, _tile##_x, _tile##_y);                  \
+      if (NULL == _tile) {                                                  \
+        continue;                                                           \
+      }                                                                     \
     }
 
 #define adjc_dirlist_iterate_end					    \
@@ -722,6 +742,54 @@ static inline bool is_border_tile(const struct tile *ptile, int dist)
           || nat_y >= wld.map.ysize - ydist);
 }
 
+/****************************************************************************
+  Returns the index offsets of the iterate_outwards_indices positions from
+  the tile, or NULL if a position within real distance max_dist of it
+  may wrap or leave the map.
+****************************************************************************/
+static inline const int *iterate_outward_deltas(const struct tile *ptile,
+                                                int max_dist)
+{
+  int nat_x, nat_y, reach_x, reach_y;
+
+  if (NULL == wld.map.iterate_outwards_deltas || max_dist < 0) {
+    return NULL;
+  }
+  if (max_dist > wld.map.iterate_outwards_max_dist) {
+    max_dist = wld.map.iterate_outwards_max_dist;
+  }
+  reach_x = wld.map.iterate_outwards_reach[2 * max_dist];
+  reach_y = wld.map.iterate_outwards_reach[2 * max_dist + 1];
+
+  index_to_native_pos(&nat_x, &nat_y, tile_index(ptile));
+  if (nat_x < reach_x || nat_y < reach_y
+      || nat_x >= wld.map.xsize - reach_x
+      || nat_y >= wld.map.ysize - reach_y) {
+    return NULL;
+  }
+
+  return wld.map.iterate_outwards_deltas
+         + (nat_y & 1) * wld.map.num_iterate_outwards_indices;
+}
+
+/****************************************************************************
+  Returns the index offsets of the adjacent tiles in each direction from
+  the tile, or NULL if the tile is a border tile.
+****************************************************************************/
+static inline const int *adjc_dir_deltas(const struct tile *ptile)
+{
+  int nat_x, nat_y;
+
+  index_to_native_pos(&nat_x, &nat_y, tile_index(ptile));
+  if (nat_x < 1 || nat_x >= wld.map.xsize - 1
+      || nat_y < wld.map.dir_reach_y
+      || nat_y >= wld.map.ysize - wld.map.dir_reach_y) {
+    return NULL;
+  }
+
+  return wld.map.dir_deltas[nat_y & 1];
+}
+
 enum direction8 rand_direction(void);
 enum direction8 opposite_direction(enum direction8 dir);
 
@@ -68,16 +68,40 @@ enum map_startpos {
 #define SPECENUM_VALUE4 TEAM_PLACEMENT_VERTICAL
 #include "specenum_gen.h"
 
+/* Dense copies of the tile fields that whole map scans read most, indexed
+ * by tile_index().  The tile setters keep them in sync; code writing the
+ * fields directly must call tile_dense_sync().  Only the main map has
+ * them. */
+struct tile_dense {
+  struct terrain **terrain;
+  struct player **owner;
+  Continent_id *continent;
+  bv_extras *extras;
+};
+
 struct civ_map {
   int topology_id;
   enum direction8 valid_dirs[8], cardinal_dirs[8];
   int num_valid_dirs, num_cardinal_dirs;
   struct iter_index *iterate_outwards_indices;
   int num_iterate_outwards_indices;
+  /* Index offsets of the iterate_outwards_indices positions, first from
+   * a tile in an even native row and then from one in an odd row, and
+   * the native x and y they reach up to each distance. */
+  int *iterate_outwards_deltas;
+  int *iterate_outwards_reach;
+  /* Squared distance of each iterate_outwards_indices position. */
+  int *iterate_outwards_sq_dist;
+  int iterate_outwards_max_dist;
+  /* Index offsets of the adjacent tiles in each direction, from a tile in
+   * an even and an odd native row, and the native y they reach. */
+  int dir_deltas[2][8];
+  int dir_reach_y;
   int xsize, ysize; /* native dimensions */
   int num_continents;
   int num_oceans;               /* not updated at the client */
   struct tile *tiles;
+  struct tile_dense dense;
   struct startpos_hash *startpos_table;
 
   union {
@@ -758,7 +758,7 @@ bool unit_can_load(const struct unit *punit)
     }
   }
 
-  unit_list_iterate(unit_tile(punit)->units, ptransport) {
+  unit_stack_iterate(unit_tile(punit)->units, ptransport) {
     /* could_unit_load() instead of can_unit_load() since latter
      * would check against unit already being transported, and we need
      * to support unload+load to a new transport. */
@@ -767,7 +767,7 @@ bool unit_can_load(const struct unit *punit)
         return TRUE;
       }
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return FALSE;
 }
@@ -779,11 +779,11 @@ bool unit_can_load(const struct unit *punit)
 ****************************************************************************/
 bool unit_could_load_at(const struct unit *punit, const struct tile *ptile)
 {
-  unit_list_iterate(ptile->units, ptransport) {
+  unit_stack_iterate(ptile->units, ptransport) {
     if (could_unit_load(punit, ptransport)) {
       return TRUE;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return FALSE;
 }
@@ -106,13 +106,17 @@ static bool buffer_ensure_free_extra_space(struct socket_packet_buffer *buf,
 {
   /* room for more? */
   if (buf->nsize - buf->ndata < extra_space) {
+    int old_size = buf->nsize;
+
     buf->nsize = buf->ndata + extra_space;
 
     /* added this check so we don't gobble up too much mem */
     if (buf->nsize > MAX_LEN_BUFFER) {
+      buf->nsize = old_size;
       return FALSE;
     }
     buf->data = (unsigned char *) fc_realloc(buf->data, buf->nsize);
+    fc_mem_account(MEM_TAG_PACKETS, buf->nsize - old_size, 0);
   }
 
   return TRUE;
@@ -444,6 +448,7 @@ struct socket_packet_buffer *new_socket_packet_buffer(void)
   buf->do_buffer_sends = 0;
   buf->nsize = 10*MAX_LEN_PACKET;
   buf->data = (unsigned char *)fc_malloc(buf->nsize);
+  fc_mem_account(MEM_TAG_PACKETS, sizeof(*buf) + buf->nsize, 1);
 
   return buf;
 }
@@ -454,6 +459,7 @@ struct socket_packet_buffer *new_socket_packet_buffer(void)
 static void free_socket_packet_buffer(struct socket_packet_buffer *buf)
 {
   if (buf) {
+    fc_mem_account(MEM_TAG_PACKETS, -(long) (sizeof(*buf) + buf->nsize), -1);
     if (buf->data) {
       free(buf->data);
     }
@@ -962,12 +962,12 @@ bool can_player_see_hypotetic_units_at(const struct player *pplayer,
   /* Can't see city units. */
   pcity = tile_city(ptile);
   if (pcity && !can_player_see_units_in_city(pplayer, pcity)
-      && unit_list_size(ptile->units) > 0) {
+      && unit_stack_size(ptile->units) > 0) {
     return FALSE;
   }
 
   /* Can't see non-allied units in transports. */
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     if (unit_type_get(punit)->transport_capacity > 0
         && unit_owner(punit) != pplayer) {
 
@@ -976,7 +976,7 @@ bool can_player_see_hypotetic_units_at(const struct player *pplayer,
         return FALSE;
       }
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return TRUE;
 }
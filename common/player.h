@@ -321,7 +321,7 @@ struct player
                             * city. Once set, never becomes unset.
                             * (Previously 'capital'.) */
 
-      struct player_tile *private_map;
+      struct player_map *private_map;
 
       /* Player can see inside his borders. */
       bool border_vision;
@@ -355,7 +355,7 @@ struct player
       /* Only used at the client (the server is omniscient; ./client/). */
 
       /* Corresponds to the result of
-         (player:server:private_map[tile_index]:seen_count[vlayer] != 0). */
+         (map_get_player_tile(ptile, pplayer)->seen_count[vlayer] != 0). */
       struct dbv tile_vision[V_COUNT];
 
       enum mood_type mood;
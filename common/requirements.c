@@ -1817,16 +1817,16 @@ is_tile_units_in_range(const struct tile *target_tile, enum req_range range,
     if (!target_tile) {
       return TRI_MAYBE;
     }
-    return BOOL_TO_TRISTATE(unit_list_size(target_tile->units) <= max_units);
+    return BOOL_TO_TRISTATE(unit_stack_size(target_tile->units) <= max_units);
   case REQ_RANGE_CADJACENT:
     if (!target_tile) {
       return TRI_MAYBE;
     }
-    if (unit_list_size(target_tile->units) <= max_units) {
+    if (unit_stack_size(target_tile->units) <= max_units) {
       return TRI_YES;
     }
     cardinal_adjc_iterate(&(wld.map), target_tile, adjc_tile) {
-      if (unit_list_size(adjc_tile->units) <= max_units) {
+      if (unit_stack_size(adjc_tile->units) <= max_units) {
         return TRI_YES;
       }
     } cardinal_adjc_iterate_end;
@@ -1835,11 +1835,11 @@ is_tile_units_in_range(const struct tile *target_tile, enum req_range range,
     if (!target_tile) {
       return TRI_MAYBE;
     }
-    if (unit_list_size(target_tile->units) <= max_units) {
+    if (unit_stack_size(target_tile->units) <= max_units) {
       return TRI_YES;
     }
     adjc_iterate(&(wld.map), target_tile, adjc_tile) {
-      if (unit_list_size(adjc_tile->units) <= max_units) {
+      if (unit_stack_size(adjc_tile->units) <= max_units) {
         return TRI_YES;
       }
     } adjc_iterate_end;
@@ -2599,12 +2599,12 @@ is_diplrel_unitany_in_range(const struct tile *target_tile,
     return TRI_MAYBE;
   }
 
-  unit_list_iterate(target_tile->units, target_unit) {
+  unit_stack_iterate(target_tile->units, target_unit) {
     enum fc_tristate for_target_unit = is_diplrel_in_range(
         unit_owner(target_unit), other_player, range, diplrel);
 
     out = fc_tristate_or(out, for_target_unit);
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return out;
 }
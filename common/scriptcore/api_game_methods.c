@@ -966,19 +966,23 @@ int api_methods_tile_num_units(lua_State *L, Tile *ptile)
   LUASCRIPT_CHECK_STATE(L, 0);
   LUASCRIPT_CHECK_SELF(L, ptile, 0);
 
-  return unit_list_size(ptile->units);
+  return unit_stack_size(ptile->units);
 }
 
 /**********************************************************************//**
-  Return list head for unit list for Tile
+  Return the unit at the position in the stack of units on Tile, or NULL
+  past the last one
 **************************************************************************/
-Unit_List_Link *api_methods_private_tile_unit_list_head(lua_State *L,
-                                                        Tile *ptile)
+Unit *api_methods_private_tile_unit_at(lua_State *L, Tile *ptile, int index)
 {
   LUASCRIPT_CHECK_STATE(L, NULL);
   LUASCRIPT_CHECK_SELF(L, ptile, NULL);
 
-  return unit_list_head(ptile->units);
+  if (index < 0) {
+    return NULL;
+  }
+
+  return unit_stack_get(ptile->units, index);
 }
 
 /**********************************************************************//**
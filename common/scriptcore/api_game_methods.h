@@ -145,8 +145,7 @@ int api_methods_private_tile_next_outward_index(lua_State *L, Tile *pstart,
                                                 int tindex, int max_dist);
 Tile *api_methods_private_tile_for_outward_index(lua_State *L, Tile *pstart,
                                                  int tindex);
-Unit_List_Link *api_methods_private_tile_unit_list_head(lua_State *L,
-                                                        Tile *ptile);
+Unit *api_methods_private_tile_unit_at(lua_State *L, Tile *ptile, int index);
 
 /* Unit */
 bool api_methods_unit_city_can_be_built_here(lua_State *L, Unit *punit);
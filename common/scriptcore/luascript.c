@@ -26,6 +26,7 @@
 /* utility */
 #include "astring.h"
 #include "log.h"
+#include "mem.h"
 #include "registry.h"
 
 /* common */
@@ -326,6 +327,35 @@ int luascript_arg_error(lua_State *L, int narg, const char *msg)
   return luaL_argerror(L, narg, msg);
 }
 
+/**********************************************************************//**
+  Memory allocator of the lua states.  Does what the allocator of
+  luaL_newstate() does, and counts the memory as used by lua.  The
+  count of lua memory is the number of states, not of blocks.
+**************************************************************************/
+static void *luascript_alloc(void *ud, void *ptr, size_t osize,
+                             size_t nsize)
+{
+  void *nptr;
+
+  /* When ptr is NULL, osize tells the kind of object, not a size. */
+  if (ptr == NULL) {
+    osize = 0;
+  }
+
+  if (nsize == 0) {
+    free(ptr);
+    fc_mem_account(MEM_TAG_LUA, -(long) osize, 0);
+    return NULL;
+  }
+
+  nptr = realloc(ptr, nsize);
+  if (nptr != NULL) {
+    fc_mem_account(MEM_TAG_LUA, (long) nsize - (long) osize, 0);
+  }
+
+  return nptr;
+}
+
 /**********************************************************************//**
   Initialize the scripting state.
 **************************************************************************/
@@ -339,6 +369,14 @@ struct fc_lua *luascript_new(luascript_log_func_t output_fct,
     FC_FREE(fcl);
     return NULL;
   }
+  if (fc_mem_accounting_enabled()) {
+    /* Blocks allocated so far are freed through the new allocator, which
+     * knows their sizes. */
+    lua_setallocf(fcl->state, luascript_alloc, NULL);
+    fc_mem_account(MEM_TAG_LUA,
+                   lua_gc(fcl->state, LUA_GCCOUNT) * 1024L
+                   + lua_gc(fcl->state, LUA_GCCOUNTB), 1);
+  }
   fcl->output_fct = output_fct;
   fcl->caller = NULL;
 
@@ -398,6 +436,7 @@ void luascript_destroy(struct fc_lua *fcl)
     if (fcl->state) {
       lua_gc(fcl->state, LUA_GCCOLLECT, 0); /* Collected garbage */
       lua_close(fcl->state);
+      fc_mem_account(MEM_TAG_LUA, 0, -1);
     }
     free(fcl);
   }
@@ -33,6 +33,42 @@
 
 static bv_extras empty_extras;
 
+/************************************************************************//**
+  Return the index of the tile in the dense arrays of the main map, or -1
+  if the tile is not a real tile of the main map or there are no arrays.
+****************************************************************************/
+static inline int tile_dense_index(const struct tile *ptile)
+{
+  int tindex = tile_index(ptile);
+
+  if (NULL == wld.map.dense.terrain
+      || 0 > tindex || tindex >= MAP_INDEX_SIZE
+      || ptile != wld.map.tiles + tindex) {
+    return -1;
+  }
+
+  return tindex;
+}
+
+/************************************************************************//**
+  Copy the hot fields of the tile to the dense arrays of the main map.
+  The tile setters do this themselves; it is needed only after writing
+  the fields directly.
+****************************************************************************/
+void tile_dense_sync(const struct tile *ptile)
+{
+  int tindex = tile_dense_index(ptile);
+
+  if (0 > tindex) {
+    return;
+  }
+
+  wld.map.dense.terrain[tindex] = ptile->terrain;
+  wld.map.dense.owner[tindex] = ptile->owner;
+  wld.map.dense.continent[tindex] = ptile->continent;
+  wld.map.dense.extras[tindex] = ptile->extras;
+}
+
 #ifndef tile_index
 /************************************************************************//**
   Return the tile index.
@@ -74,6 +110,7 @@ void tile_set_owner(struct tile *ptile, struct player *pplayer,
       || (tile_city(ptile) != NULL || ptile->owner != NULL)) {
     ptile->owner = pplayer;
     ptile->claimer = claimer;
+    tile_dense_sync(ptile);
   }
 }
 
@@ -153,6 +190,7 @@ void tile_set_terrain(struct tile *ptile, struct terrain *pterrain)
       BV_CLR(ptile->extras, extra_index(ptile->resource));
     }
   }
+  tile_dense_sync(ptile);
 }
 
 /************************************************************************//**
@@ -381,6 +419,7 @@ Continent_id tile_continent(const struct tile *ptile)
 void tile_set_continent(struct tile *ptile, Continent_id val)
 {
   ptile->continent = val;
+  tile_dense_sync(ptile);
 }
 
 /************************************************************************//**
@@ -946,6 +985,7 @@ void tile_add_extra(struct tile *ptile, const struct extra_type *pextra)
 {
   if (pextra != NULL) {
     BV_SET(ptile->extras, extra_index(pextra));
+    tile_dense_sync(ptile);
   }
 }
 
@@ -956,6 +996,7 @@ void tile_remove_extra(struct tile *ptile, const struct extra_type *pextra)
 {
   if (pextra != NULL) {
     BV_CLR(ptile->extras, extra_index(pextra));
+    tile_dense_sync(ptile);
   }
 }
 
@@ -978,7 +1019,7 @@ struct tile *tile_virtual_new(const struct tile *ptile)
   BV_CLR_ALL(vtile->extras);
   vtile->resource = NULL;
   vtile->terrain = NULL;
-  vtile->units = unit_list_new();
+  vtile->units = unit_stack_new();
   vtile->worked = NULL;
   vtile->owner = NULL;
   vtile->placing = NULL;
@@ -1026,12 +1067,12 @@ void tile_virtual_destroy(struct tile *vtile)
   }
 
   if (vtile->units) {
-    unit_list_iterate(vtile->units, vunit) {
+    unit_stack_iterate(vtile->units, vunit) {
       if (unit_is_virtual(vunit)) {
         unit_virtual_destroy(vunit);
       }
-    } unit_list_iterate_end;
-    unit_list_destroy(vtile->units);
+    } unit_stack_iterate_end;
+    unit_stack_destroy(vtile->units);
     vtile->units = NULL;
   }
 
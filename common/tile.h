@@ -54,7 +54,7 @@ struct tile {
   bv_extras extras;
   struct extra_type *resource;          /* NULL for no resource */
   struct terrain *terrain;		/* NULL for unknown tiles */
-  struct unit_list *units;
+  struct unit_stack *units;
   struct city *worked;			/* NULL for not worked */
   struct player *owner;			/* NULL for not owned */
   struct extra_type *placing;
@@ -183,6 +183,8 @@ struct tile *tile_virtual_new(const struct tile *ptile);
 void tile_virtual_destroy(struct tile *vtile);
 bool tile_virtual_check(struct tile *vtile);
 
+void tile_dense_sync(const struct tile *ptile);
+
 void *tile_hash_key(const struct tile *ptile);
 
 bool tile_set_label(struct tile *ptile, const char *label);
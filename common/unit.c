@@ -37,6 +37,7 @@
 #include "road.h"
 #include "tech.h"
 #include "traderoutes.h"
+#include "unitgrid.h"
 #include "unitlist.h"
 
 #include "unit.h"
@@ -355,7 +356,7 @@ bool is_square_threatened(const struct player *pplayer,
 			  const struct tile *ptile, bool omniscient)
 {
   square_iterate(&(wld.map), ptile, 2, ptile1) {
-    unit_list_iterate(ptile1->units, punit) {
+    unit_stack_iterate(ptile1->units, punit) {
       if ((omniscient
            || can_player_see_unit(pplayer, punit))
           && pplayers_at_war(pplayer, unit_owner(punit))
@@ -366,7 +367,7 @@ bool is_square_threatened(const struct player *pplayer,
                                          unit_class_get(punit), ptile)))) {
 	return TRUE;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   } square_iterate_end;
 
   return FALSE;
@@ -900,12 +901,12 @@ bool can_unit_do_activity_targeted_at(const struct unit *punit,
       return FALSE;
     }
 
-    unit_list_iterate(ptile->units, tunit) {
+    unit_stack_iterate(ptile->units, tunit) {
       if (is_build_activity(tunit->activity, ptile)
           && !can_extras_coexist(target, tunit->activity_target)) {
         return FALSE;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   }
 
 #define RETURN_IS_ACTIVITY_ENABLED_UNIT_ON(paction)                       \
@@ -1105,11 +1106,11 @@ void set_unit_activity_targeted(struct unit *punit,
 bool is_unit_activity_on_tile(enum unit_activity activity,
                               const struct tile *ptile)
 {
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     if (punit->activity == activity) {
       return TRUE;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
   return FALSE;
 }
 
@@ -1122,11 +1123,11 @@ bv_extras get_unit_tile_pillage_set(const struct tile *ptile)
   bv_extras tgt_ret;
 
   BV_CLR_ALL(tgt_ret);
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     if (punit->activity == ACTIVITY_PILLAGE) {
       BV_SET(tgt_ret, extra_index(punit->activity_target));
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return tgt_ret;
 }
@@ -1260,6 +1261,7 @@ struct player *unit_nationality(const struct unit *punit)
 void unit_tile_set(struct unit *punit, struct tile *ptile)
 {
   fc_assert_ret(NULL != punit);
+  unit_grid_move(punit, ptile);
   punit->tile = ptile;
 }
 
@@ -1275,14 +1277,14 @@ struct unit *is_allied_unit_tile(const struct tile *ptile,
 {
   struct unit *punit = NULL;
 
-  unit_list_iterate(ptile->units, cunit) {
+  unit_stack_iterate(ptile->units, cunit) {
     if (pplayers_allied(pplayer, unit_owner(cunit))) {
       punit = cunit;
     } else {
       return NULL;
     }
   }
-  unit_list_iterate_end;
+  unit_stack_iterate_end;
 
   return punit;
 }
@@ -1296,11 +1298,11 @@ struct unit *is_allied_unit_tile(const struct tile *ptile,
 struct unit *is_enemy_unit_tile(const struct tile *ptile,
                                 const struct player *pplayer)
 {
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     if (pplayers_at_war(unit_owner(punit), pplayer)) {
       return punit;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return NULL;
 }
@@ -1311,12 +1313,12 @@ struct unit *is_enemy_unit_tile(const struct tile *ptile,
 struct unit *is_non_allied_unit_tile(const struct tile *ptile,
                                      const struct player *pplayer)
 {
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     if (!pplayers_allied(unit_owner(punit), pplayer)) {
       return punit;
     }
   }
-  unit_list_iterate_end;
+  unit_stack_iterate_end;
 
   return NULL;
 }
@@ -1327,11 +1329,11 @@ struct unit *is_non_allied_unit_tile(const struct tile *ptile,
 struct unit *is_other_players_unit_tile(const struct tile *ptile,
                                         const struct player *pplayer)
 {
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     if (unit_owner(punit) != pplayer) {
       return punit;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return NULL;
 }
@@ -1342,12 +1344,12 @@ struct unit *is_other_players_unit_tile(const struct tile *ptile,
 struct unit *is_non_attack_unit_tile(const struct tile *ptile,
                                      const struct player *pplayer)
 {
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     if (pplayers_non_attack(unit_owner(punit), pplayer)) {
       return punit;
     }
   }
-  unit_list_iterate_end;
+  unit_stack_iterate_end;
 
   return NULL;
 }
@@ -1363,7 +1365,7 @@ struct unit *is_non_attack_unit_tile(const struct tile *ptile,
 struct unit *unit_occupies_tile(const struct tile *ptile,
                                 const struct player *pplayer)
 {
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     if (!is_military_unit(punit)) {
       continue;
     }
@@ -1375,7 +1377,7 @@ struct unit *unit_occupies_tile(const struct tile *ptile,
     if (pplayers_at_war(unit_owner(punit), pplayer)) {
       return punit;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return NULL;
 }
@@ -1407,7 +1409,7 @@ bool is_my_zoc(const struct player *pplayer, const struct tile *ptile0,
 
     pcity = is_non_allied_city_tile(ptile, pplayer);
     if (pcity != NULL) {
-      if ((srv && unit_list_size(ptile->units) > 0)
+      if ((srv && unit_stack_size(ptile->units) > 0)
           || (!srv && (pcity->client.occupied
                        || TILE_KNOWN_UNSEEN == tile_get_known(ptile, pplayer)))) {
         /* Occupied enemy city, it doesn't matter if units inside have
@@ -1415,12 +1417,12 @@ bool is_my_zoc(const struct player *pplayer, const struct tile *ptile0,
         return FALSE;
       }
     } else {
-      unit_list_iterate(ptile->units, punit) {
+      unit_stack_iterate(ptile->units, punit) {
         if (!pplayers_allied(unit_owner(punit), pplayer)
             && !unit_has_type_flag(punit, UTYF_NOZOC)) {
           return FALSE;
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     }
   } square_iterate_end;
 
@@ -1647,6 +1649,7 @@ struct unit *unit_virtual_create(struct player *pplayer, struct city *pcity,
 void unit_virtual_destroy(struct unit *punit)
 {
   free_unit_orders(punit);
+  unit_grid_remove(punit);
 
   /* Unload unit if transported. */
   unit_transport_unload(punit);
@@ -1720,7 +1723,7 @@ static struct unit *base_transporter_for_unit(const struct unit *pcargo,
     int depth, outermost_moves_left, total_moves;
   } cur, best = { FALSE };
 
-  unit_list_iterate(ptile->units, ptrans) {
+  unit_stack_iterate(ptile->units, ptrans) {
     if (!unit_load_test(pcargo, ptrans)) {
       continue;
     } else if (best_trans == NULL) {
@@ -1817,7 +1820,7 @@ static struct unit *base_transporter_for_unit(const struct unit *pcargo,
 
     fc_assert(best_trans == ptrans);
     best = cur;
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return best_trans;
 }
@@ -202,6 +202,12 @@ struct unit {
 
   bool stay; /* Unit is prohibited from moving */
 
+#ifdef FREECIV_WEB
+  /* The unit grid the unit is registered in, and its cell there. */
+  struct unit_grid *grid;
+  struct unit_list *grid_cell;
+#endif /* FREECIV_WEB */
+
   union {
     struct {
       /* Only used at the client (the server is omniscient; ./client/). */
@@ -0,0 +1,265 @@
+/***********************************************************************
+ Freeciv - Copyright (C) 1996 - A Kjeldberg, L Gregersen, P Unold
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+***********************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <fc_config.h>
+#endif
+
+/* utility */
+#include "log.h"
+#include "mem.h"
+
+/* common */
+#include "citygrid.h"
+#include "map.h"
+#include "player.h"
+#include "unit.h"
+#include "unitlist.h"
+
+#include "unitgrid.h"
+
+#ifdef FREECIV_WEB
+
+struct unit_grid {
+  const struct civ_map *nmap;
+  int cols, rows;
+
+  /* The cells of each player slot, allocated with the player's first
+   * unit on the map. */
+  struct unit_list **cells[MAX_NUM_PLAYER_SLOTS];
+
+  /* The slots having cells, in the order they got them. */
+  int slots[MAX_NUM_PLAYER_SLOTS];
+  int num_slots;
+
+  /* There was no map for a unit; only the unit lists find all units. */
+  bool incomplete;
+};
+
+/**********************************************************************//**
+  Initialize the unit grid of the world.  The cells are only allocated
+  with the first unit on the map, when the map size is known.
+**************************************************************************/
+void unit_grid_init(struct world *iworld)
+{
+  iworld->unit_grid = fc_calloc(1, sizeof(*iworld->unit_grid));
+  iworld->unit_grid->nmap = &iworld->map;
+}
+
+/**********************************************************************//**
+  Free the unit grid of the world.  The units still in it are left
+  outside of any grid.
+**************************************************************************/
+void unit_grid_free(struct world *iworld)
+{
+  struct unit_grid *grid = iworld->unit_grid;
+  int s, i;
+
+  if (grid == NULL) {
+    return;
+  }
+
+  for (s = 0; s < grid->num_slots; s++) {
+    int slot = grid->slots[s];
+
+    for (i = 0; i < grid->cols * grid->rows; i++) {
+      unit_list_iterate(grid->cells[slot][i], punit) {
+        punit->grid = NULL;
+        punit->grid_cell = NULL;
+      } unit_list_iterate_end;
+      unit_list_destroy(grid->cells[slot][i]);
+    }
+    free(grid->cells[slot]);
+  }
+  free(grid);
+  iworld->unit_grid = NULL;
+}
+
+/**********************************************************************//**
+  Returns the cell of the tile for the units of the player slot,
+  allocating the cells if needed.  Returns NULL if there is no map to
+  lay the cells on.
+**************************************************************************/
+static struct unit_list *unit_grid_cell(struct unit_grid *grid, int slot,
+                                        const struct tile *ptile)
+{
+  const struct civ_map *nmap = grid->nmap;
+
+  if (grid->cells[slot] == NULL) {
+    int i;
+
+    if (nmap->xsize <= 0 || nmap->ysize <= 0) {
+      return NULL;
+    }
+
+    grid_cells_size(nmap, &grid->cols, &grid->rows);
+    grid->cells[slot] = fc_malloc(grid->cols * grid->rows
+                                  * sizeof(*grid->cells[slot]));
+    for (i = 0; i < grid->cols * grid->rows; i++) {
+      grid->cells[slot][i] = unit_list_new();
+    }
+    grid->slots[grid->num_slots++] = slot;
+  }
+
+  return grid->cells[slot][grid_cell_index(nmap, ptile)];
+}
+
+/**********************************************************************//**
+  Put the unit into the cell of the tile, or into no cell if the tile
+  is NULL.
+**************************************************************************/
+static void unit_grid_place(struct unit *punit, const struct tile *ptile)
+{
+  struct unit_list *cell = NULL;
+
+  if (ptile != NULL) {
+    cell = unit_grid_cell(punit->grid, player_index(unit_owner(punit)),
+                          ptile);
+    if (cell == NULL) {
+      punit->grid->incomplete = TRUE;
+    }
+  }
+
+  if (cell == punit->grid_cell) {
+    return;
+  }
+  if (punit->grid_cell != NULL) {
+    unit_list_remove(punit->grid_cell, punit);
+  }
+  if (cell != NULL) {
+    unit_list_prepend(cell, punit);
+  }
+  punit->grid_cell = cell;
+}
+
+/**********************************************************************//**
+  Add a unit to the grid of the world.  It is placed by its owner and
+  current tile, and follows later unit_tile_set() calls.
+**************************************************************************/
+void unit_grid_add(struct world *iworld, struct unit *punit)
+{
+  if (iworld->unit_grid == NULL) {
+    return;
+  }
+
+  fc_assert_ret(punit->grid == NULL);
+  punit->grid = iworld->unit_grid;
+  punit->grid_cell = NULL;
+  unit_grid_place(punit, unit_tile(punit));
+}
+
+/**********************************************************************//**
+  Remove a unit from its grid.  Call this and unit_grid_add() around a
+  change of the unit's owner.
+**************************************************************************/
+void unit_grid_remove(struct unit *punit)
+{
+  if (punit->grid_cell != NULL) {
+    unit_list_remove(punit->grid_cell, punit);
+  }
+  punit->grid = NULL;
+  punit->grid_cell = NULL;
+}
+
+/**********************************************************************//**
+  Move a unit in its grid to the cell of the tile it is about to be set
+  to.  Units not in any grid are left alone.
+**************************************************************************/
+void unit_grid_move(struct unit *punit, const struct tile *ptile)
+{
+  if (punit->grid != NULL) {
+    unit_grid_place(punit, ptile);
+  }
+}
+
+/**********************************************************************//**
+  Returns whether the unit is in the cell of its owner and tile, or in no
+  cell when it is on no tile.  Units outside of any grid are fine.
+**************************************************************************/
+bool unit_grid_is_placed(const struct unit *punit)
+{
+  struct unit_grid *grid = punit->grid;
+  struct tile *ptile = unit_tile(punit);
+  struct unit_list **pcells;
+
+  if (grid == NULL || grid->incomplete) {
+    return TRUE;
+  }
+  if (ptile == NULL) {
+    return punit->grid_cell == NULL;
+  }
+
+  pcells = grid->cells[player_index(unit_owner(punit))];
+
+  return (pcells != NULL
+          && punit->grid_cell == pcells[grid_cell_index(grid->nmap, ptile)]
+          && unit_list_search(punit->grid_cell, punit));
+}
+
+/**********************************************************************//**
+  Find the cells holding every unit of the player within real distance
+  'dist' of the tile, and likely some more; with a NULL player the cells
+  of all the players.  Fills 'cells' with them and returns their number,
+  or -1 if it would take more than 'max_cells' cells or the grid does
+  not know all the units.  Every cell is handed out once.
+**************************************************************************/
+int unit_grid_near(const struct world *iworld, const struct player *pplayer,
+                   const struct tile *ptile, int dist,
+                   struct unit_list **cells, int max_cells)
+{
+  const struct unit_grid *grid = iworld->unit_grid;
+  int indices[UNIT_GRID_MAX_NEAR];
+  int nindices, s, i;
+  int count = 0;
+
+  if (grid == NULL || grid->incomplete) {
+    return -1;
+  }
+
+  nindices = grid_cells_near(&iworld->map, ptile, dist, indices,
+                             MIN(max_cells, ARRAY_SIZE(indices)));
+  if (nindices < 0) {
+    return -1;
+  }
+
+  if (pplayer != NULL) {
+    struct unit_list **pcells = grid->cells[player_index(pplayer)];
+
+    if (pcells == NULL) {
+      /* No units of the player on the map yet. */
+      return 0;
+    }
+    for (i = 0; i < nindices; i++) {
+      cells[i] = pcells[indices[i]];
+    }
+
+    return nindices;
+  }
+
+  for (s = 0; s < grid->num_slots; s++) {
+    struct unit_list **pcells = grid->cells[grid->slots[s]];
+
+    for (i = 0; i < nindices; i++) {
+      if (unit_list_size(pcells[indices[i]]) > 0) {
+        if (count >= max_cells) {
+          return -1;
+        }
+        cells[count++] = pcells[indices[i]];
+      }
+    }
+  }
+
+  return count;
+}
+
+#endif /* FREECIV_WEB */
@@ -0,0 +1,67 @@
+/***********************************************************************
+ Freeciv - Copyright (C) 1996 - A Kjeldberg, L Gregersen, P Unold
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+***********************************************************************/
+#ifndef FC__UNITGRID_H
+#define FC__UNITGRID_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**************************************************************************
+   Unit grid: the units of each player of a world sorted into the cells
+   of the city grid, for finding a player's units near a tile without
+   looking at every tile around it or at all of the player's units.
+   Units enter it in idex_register_unit() and leave it in
+   idex_unregister_unit(); unit_tile_set() moves them between cells.
+
+   Only freeciv-web's assess_danger() asks the grid, so other builds do
+   not keep it up to date at all.
+***************************************************************************/
+
+/* common */
+#include "fc_types.h"
+#include "world_object.h"
+
+#ifdef FREECIV_WEB
+
+/* Cells worth asking unit_grid_near() for at once. */
+#define UNIT_GRID_MAX_NEAR 256
+
+void unit_grid_init(struct world *iworld);
+void unit_grid_free(struct world *iworld);
+
+void unit_grid_add(struct world *iworld, struct unit *punit);
+void unit_grid_remove(struct unit *punit);
+void unit_grid_move(struct unit *punit, const struct tile *ptile);
+bool unit_grid_is_placed(const struct unit *punit);
+
+int unit_grid_near(const struct world *iworld, const struct player *pplayer,
+                   const struct tile *ptile, int dist,
+                   struct unit_list **cells, int max_cells);
+
+#else  /* FREECIV_WEB */
+
+#define unit_grid_init(_iworld) (void) 0
+#define unit_grid_free(_iworld) (void) 0
+
+#define unit_grid_add(_iworld, _punit) (void) 0
+#define unit_grid_remove(_punit) (void) 0
+#define unit_grid_move(_punit, _ptile) (void) 0
+
+#endif /* FREECIV_WEB */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif  /* FC__UNITGRID_H */
@@ -15,8 +15,12 @@
 #include <fc_config.h>
 #endif
 
+#include <stdlib.h>
+#include <string.h>
+
 /* utility */
 #include "log.h"
+#include "mem.h"
 
 /* common */
 #include "game.h"
@@ -88,6 +92,147 @@ void unit_list_sort_ord_city(struct unit_list *punitlist)
 }
 
 
+/************************************************************************//**
+  Create a new empty unit stack.
+****************************************************************************/
+struct unit_stack *unit_stack_new(void)
+{
+  struct unit_stack *pstack = fc_malloc(sizeof(*pstack));
+
+  pstack->size = 0;
+  pstack->alloc = UNIT_STACK_INLINE;
+  pstack->units = pstack->inline_units;
+
+  return pstack;
+}
+
+/************************************************************************//**
+  Free the unit stack.  The units in it are left alone.
+****************************************************************************/
+void unit_stack_destroy(struct unit_stack *pstack)
+{
+  if (pstack == NULL) {
+    return;
+  }
+
+  if (pstack->units != pstack->inline_units) {
+    free(pstack->units);
+  }
+  free(pstack);
+}
+
+/************************************************************************//**
+  Make room for one more unit in the stack.
+****************************************************************************/
+static void unit_stack_grow(struct unit_stack *pstack)
+{
+  if (pstack->size < pstack->alloc) {
+    return;
+  }
+
+  pstack->alloc *= 2;
+  if (pstack->units == pstack->inline_units) {
+    pstack->units = fc_malloc(pstack->alloc * sizeof(*pstack->units));
+    memcpy(pstack->units, pstack->inline_units,
+           pstack->size * sizeof(*pstack->units));
+  } else {
+    pstack->units = fc_realloc(pstack->units,
+                               pstack->alloc * sizeof(*pstack->units));
+  }
+}
+
+/************************************************************************//**
+  Put the unit at the front of the stack.
+****************************************************************************/
+void unit_stack_prepend(struct unit_stack *pstack, struct unit *punit)
+{
+  unit_stack_grow(pstack);
+  memmove(pstack->units + 1, pstack->units,
+          pstack->size * sizeof(*pstack->units));
+  pstack->units[0] = punit;
+  pstack->size++;
+}
+
+/************************************************************************//**
+  Put the unit at the end of the stack.
+****************************************************************************/
+void unit_stack_append(struct unit_stack *pstack, struct unit *punit)
+{
+  unit_stack_grow(pstack);
+  pstack->units[pstack->size++] = punit;
+}
+
+/************************************************************************//**
+  Remove the unit from the stack, keeping the order of the others.
+  Returns TRUE if it was in the stack.
+****************************************************************************/
+bool unit_stack_remove(struct unit_stack *pstack, const struct unit *punit)
+{
+  int i;
+
+  for (i = 0; i < pstack->size; i++) {
+    if (pstack->units[i] == punit) {
+      pstack->size--;
+      memmove(pstack->units + i, pstack->units + i + 1,
+              (pstack->size - i) * sizeof(*pstack->units));
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/************************************************************************//**
+  Remove all the units from the stack.
+****************************************************************************/
+void unit_stack_clear(struct unit_stack *pstack)
+{
+  pstack->size = 0;
+}
+
+/************************************************************************//**
+  Look for a unit with the given ID in the unit stack.  Returns NULL if
+  none is found.
+****************************************************************************/
+struct unit *unit_stack_find(const struct unit_stack *pstack, int unit_id)
+{
+  unit_stack_iterate(pstack, punit) {
+    if (punit->id == unit_id) {
+      return punit;
+    }
+  } unit_stack_iterate_end;
+
+  return NULL;
+}
+
+/************************************************************************//**
+  Returns a new unit list holding the units of the stack in their order,
+  for code handling either.  The caller destroys it.
+****************************************************************************/
+struct unit_list *unit_stack_to_list(const struct unit_stack *pstack)
+{
+  struct unit_list *punitlist = unit_list_new();
+  int i;
+
+  for (i = 0; i < pstack->size; i++) {
+    unit_list_append(punitlist, pstack->units[i]);
+  }
+
+  return punitlist;
+}
+
+/************************************************************************//**
+  Sorts the unit stack by punit->server.ord_map values.
+
+  Only used in server/savegame.c.
+****************************************************************************/
+void unit_stack_sort_ord_map(struct unit_stack *pstack)
+{
+  fc_assert_ret(is_server());
+  qsort(pstack->units, pstack->size, sizeof(*pstack->units),
+        (int (*)(const void *, const void *)) compar_unit_ord_map);
+}
+
 /************************************************************************//**
   Return TRUE if the function returns true for any of the units.
 ****************************************************************************/
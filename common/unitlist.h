@@ -61,6 +61,128 @@ extern "C" {
   }									\
 }
 
+/* A unit stack: the units on a tile, held in one array in their order.
+ * Stacks of up to UNIT_STACK_INLINE units need no allocation beyond the
+ * stack itself.  Unlike a unit list, moving a unit onto a tile does not
+ * allocate a link, and iterating the stack reads consecutive memory. */
+#define UNIT_STACK_INLINE 4
+
+struct unit_stack {
+  int size;
+  int alloc;
+  struct unit **units; /* Either 'inline_units' or an allocated array. */
+  struct unit *inline_units[UNIT_STACK_INLINE];
+};
+
+struct unit_stack *unit_stack_new(void);
+void unit_stack_destroy(struct unit_stack *pstack);
+
+void unit_stack_prepend(struct unit_stack *pstack, struct unit *punit);
+void unit_stack_append(struct unit_stack *pstack, struct unit *punit);
+bool unit_stack_remove(struct unit_stack *pstack, const struct unit *punit);
+void unit_stack_clear(struct unit_stack *pstack);
+
+struct unit *unit_stack_find(const struct unit_stack *pstack, int unit_id);
+struct unit_list *unit_stack_to_list(const struct unit_stack *pstack)
+  fc__warn_unused_result;
+void unit_stack_sort_ord_map(struct unit_stack *pstack);
+
+/************************************************************************//**
+  Returns the number of units in the stack.
+****************************************************************************/
+static inline int unit_stack_size(const struct unit_stack *pstack)
+{
+  return pstack->size;
+}
+
+/************************************************************************//**
+  Returns the unit at the position in the stack, the last one for -1, or
+  NULL if there is no such position.
+****************************************************************************/
+static inline struct unit *unit_stack_get(const struct unit_stack *pstack,
+                                          int index)
+{
+  if (index == -1) {
+    index = pstack->size - 1;
+  }
+  if (index < 0 || index >= pstack->size) {
+    return NULL;
+  }
+
+  return pstack->units[index];
+}
+
+/************************************************************************//**
+  Returns the position unit_stack_iterate() goes on with, after having
+  been at 'punit' at position 'index'.  The unit may have been removed,
+  or a unit inserted before it, meanwhile.
+****************************************************************************/
+static inline int unit_stack_next_index(const struct unit_stack *pstack,
+                                        int index, const struct unit *punit)
+{
+  if (index < pstack->size && pstack->units[index] == punit) {
+    return index + 1;
+  }
+  if (index + 1 < pstack->size && pstack->units[index + 1] == punit) {
+    /* A unit was inserted before it. */
+    return index + 2;
+  }
+
+  /* It was removed, or a unit before it; the next unit moved down. */
+  return index;
+}
+
+/* Unit stack iterator.
+ *
+ * Like with unit_list_iterate(), removing the current unit from the
+ * stack in the loop is safe, and so is adding a unit to the stack.
+ * Units removed or added in larger numbers may be skipped or seen
+ * twice; use unit_stack_iterate_safe() when the loop may do that. */
+#define unit_stack_iterate(ARG_stack, NAME_unit)                            \
+do {                                                                        \
+  const struct unit_stack *NAME_unit##_stack = (ARG_stack);                 \
+  struct unit *NAME_unit;                                                   \
+  int NAME_unit##_at;                                                       \
+                                                                            \
+  for (NAME_unit##_at = 0;                                                  \
+       NAME_unit##_at < NAME_unit##_stack->size                             \
+       && (NAME_unit = NAME_unit##_stack->units[NAME_unit##_at], TRUE);     \
+       NAME_unit##_at = unit_stack_next_index(NAME_unit##_stack,            \
+                                              NAME_unit##_at,               \
+                                              NAME_unit)) {
+
+#define unit_stack_iterate_end                                              \
+  }                                                                         \
+} while (FALSE);
+
+/* Iterate over the units in the stack when the loop may remove or add
+ * any units; the units that died meanwhile are skipped. */
+#define unit_stack_iterate_safe(ARG_stack, _unit)                           \
+{                                                                           \
+  int _unit##_size = unit_stack_size(ARG_stack);                            \
+                                                                            \
+  if (_unit##_size > 0) {                                                   \
+    int _unit##_numbers[_unit##_size];                                      \
+    int _unit##_index = 0;                                                  \
+                                                                            \
+    unit_stack_iterate(ARG_stack, _unit) {                                  \
+      _unit##_numbers[_unit##_index++] = _unit->id;                         \
+    } unit_stack_iterate_end;                                               \
+                                                                            \
+    for (_unit##_index = 0;                                                 \
+         _unit##_index < _unit##_size;                                      \
+         _unit##_index++) {                                                 \
+      struct unit *_unit =                                                  \
+        game_unit_by_number(_unit##_numbers[_unit##_index]);                \
+                                                                            \
+      if (NULL != _unit) {
+
+#define unit_stack_iterate_safe_end                                         \
+      }                                                                     \
+    }                                                                       \
+  }                                                                         \
+}
+
 struct unit *unit_list_find(const struct unit_list *punitlist, int unit_id);
 
 void unit_list_sort_ord_map(struct unit_list *punitlist);
@@ -20,24 +20,19 @@ extern "C" {
 /* common */
 #include "map_types.h"
 
-
-/* struct city_hash. */
-#define SPECHASH_TAG city
-#define SPECHASH_INT_KEY_TYPE
-#define SPECHASH_IDATA_TYPE struct city *
-#include "spechash.h"
-
-/* struct unit_hash. */
-#define SPECHASH_TAG unit
-#define SPECHASH_INT_KEY_TYPE
-#define SPECHASH_IDATA_TYPE struct unit *
-#include "spechash.h"
+struct idex_table; /* defined in ./common/idex.c */
+struct city_grid; /* defined in ./common/citygrid.c */
+struct unit_grid; /* defined in ./common/unitgrid.c */
 
 struct world
 {
   struct civ_map map;
-  struct city_hash *cities;
-  struct unit_hash *units;
+  struct idex_table *cities;
+  struct idex_table *units;
+  struct city_grid *city_grid;
+#ifdef FREECIV_WEB
+  struct unit_grid *unit_grid;
+#endif /* FREECIV_WEB */
 };
 
 #ifdef __cplusplus
@@ -698,11 +698,11 @@ static bool may_unit_act_vs_unit(struct unit *actor, struct unit *target,
 struct unit *action_tgt_unit(struct unit *actor, struct tile *target_tile,
                              bool accept_all_actions)
 {
-  unit_list_iterate(target_tile->units, target) {
+  unit_stack_iterate(target_tile->units, target) {
     if (may_unit_act_vs_unit(actor, target, accept_all_actions)) {
       return target;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return NULL;
 }
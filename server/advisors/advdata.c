@@ -56,6 +56,11 @@
 
 #include "advdata.h"
 
+/* Bytes in the continent and ocean tables of a phase */
+#define ADV_PHASE_TABLES_SIZE(_adv)                                         \
+  ((long) ((_adv)->num_continents + (_adv)->num_oceans + 2)                 \
+   * (long) (2 * sizeof(bool) + sizeof(int)))
+
 static void adv_dipl_new(const struct player *plr1,
                          const struct player *plr2);
 static void adv_dipl_free(const struct player *plr1,
@@ -399,41 +404,55 @@ bool adv_data_phase_init(struct player *pplayer, bool is_new_phase)
   adv->explore.continent = fc_calloc(adv->num_continents + 1, sizeof(bool));
   adv->explore.ocean = fc_calloc(adv->num_oceans + 1, sizeof(bool));
 
-  whole_map_iterate(&(wld.map), ptile) {
-    Continent_id continent = tile_continent(ptile);
-
-    if (is_ocean_tile(ptile)) {
-      if (adv->explore.sea_done && has_handicap(pplayer, H_TARGETS) 
-          && !map_is_known(ptile, pplayer)) {
-	/* We're not done there. */
-        adv->explore.sea_done = FALSE;
-        adv->explore.ocean[-continent] = TRUE;
+  {
+    bv_extras huts;
+    int i;
+
+    BV_CLR_ALL(huts);
+    extra_type_by_rmcause_iterate(ERM_ENTER, pextra) {
+      BV_SET(huts, extra_index(pextra));
+    } extra_type_by_rmcause_iterate_end;
+
+    /* Scan the dense tile arrays; the tile itself is only needed for
+     * the knowledge checks. */
+    for (i = 0; i < MAP_INDEX_SIZE; i++) {
+      Continent_id continent = wld.map.dense.continent[i];
+      struct tile *ptile = wld.map.tiles + i;
+
+      if (is_ocean(wld.map.dense.terrain[i])) {
+        if (adv->explore.sea_done && has_handicap(pplayer, H_TARGETS)
+            && !map_is_known(ptile, pplayer)) {
+          /* We're not done there. */
+          adv->explore.sea_done = FALSE;
+          adv->explore.ocean[-continent] = TRUE;
+        }
+        /* skip rest, which is land only */
+        continue;
+      }
+      if (adv->explore.continent[continent]) {
+        /* we don't need more explaining, we got the point */
+        continue;
+      }
+      if (BV_CHECK_MASK(wld.map.dense.extras[i], huts)
+          && (!has_handicap(pplayer, H_HUTS)
+              || map_is_known(ptile, pplayer))) {
+        adv->explore.land_done = FALSE;
+        adv->explore.continent[continent] = TRUE;
+        continue;
+      }
+      if (has_handicap(pplayer, H_TARGETS) && !map_is_known(ptile, pplayer)) {
+        /* this AI must explore */
+        adv->explore.land_done = FALSE;
+        adv->explore.continent[continent] = TRUE;
       }
-      /* skip rest, which is land only */
-      continue;
-    }
-    if (adv->explore.continent[tile_continent(ptile)]) {
-      /* we don't need more explaining, we got the point */
-      continue;
-    }
-    if (hut_on_tile(ptile) 
-        && (!has_handicap(pplayer, H_HUTS)
-             || map_is_known(ptile, pplayer))) {
-      adv->explore.land_done = FALSE;
-      adv->explore.continent[continent] = TRUE;
-      continue;
-    }
-    if (has_handicap(pplayer, H_TARGETS) && !map_is_known(ptile, pplayer)) {
-      /* this AI must explore */
-      adv->explore.land_done = FALSE;
-      adv->explore.continent[continent] = TRUE;
     }
-  } whole_map_iterate_end;
+  }
 
   /*** Statistics ***/
 
   adv->stats.cities = fc_calloc(adv->num_continents + 1, sizeof(int));
   adv->stats.ocean_cities = fc_calloc(adv->num_oceans + 1, sizeof(int));
+  fc_mem_account(MEM_TAG_AI, ADV_PHASE_TABLES_SIZE(adv), 6);
   adv->stats.average_production = 0;
   city_list_iterate(pplayer->cities, pcity) {
     Continent_id continent = tile_continent(pcity->tile);
@@ -578,6 +597,8 @@ void adv_data_phase_done(struct player *pplayer)
   free(adv->stats.ocean_cities);
   adv->stats.ocean_cities = NULL;
 
+  fc_mem_account(MEM_TAG_AI, -(long) ADV_PHASE_TABLES_SIZE(adv), -6);
+
   adv->num_continents = 0;
   adv->num_oceans     = 0;
 
@@ -1001,9 +1022,7 @@ void adv_best_government(struct player *pplayer)
         /* Ideally we should change tax rates here, but since
          * this is a rather big CPU operation, we'd rather not. */
         check_player_max_rates(pplayer);
-        city_list_iterate(pplayer->cities, acity) {
-          auto_arrange_workers(acity);
-        } city_list_iterate_end;
+        auto_arrange_workers_list(pplayer->cities);
         city_list_iterate(pplayer->cities, pcity) {
           val += adv_eval_calc_city(pcity, adv);
         } city_list_iterate_end;
@@ -1033,9 +1052,7 @@ void adv_best_government(struct player *pplayer)
     } governments_iterate_end;
     /* Now reset our gov to it's real state. */
     pplayer->government = current_gov;
-    city_list_iterate(pplayer->cities, acity) {
-      auto_arrange_workers(acity);
-    } city_list_iterate_end;
+    auto_arrange_workers_list(pplayer->cities);
     if (player_is_cpuhog(pplayer)) {
       adv->govt_reeval = 1;
     } else {
@@ -443,7 +443,7 @@ bool adv_danger_at(struct unit *punit, struct tile *ptile)
       /* We cannot see danger at (ptile1) => assume there is none */
       continue;
     }
-    unit_list_iterate(ptile1->units, enemy) {
+    unit_stack_iterate(ptile1->units, enemy) {
       if (pplayers_at_war(unit_owner(enemy), unit_owner(punit))
           && (unit_attack_unit_at_tile_result(enemy, NULL, punit, ptile)
               == ATT_OK)
@@ -455,7 +455,7 @@ bool adv_danger_at(struct unit *punit, struct tile *ptile)
           return TRUE;
         }
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   } adjc_iterate_end;
 
   return FALSE; /* as good a quick'n'dirty should be -- Syela */
@@ -470,11 +470,11 @@ static int stack_value(const struct tile *ptile,
   int cost = 0;
 
   if (is_stack_vulnerable(ptile)) {
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       if (unit_owner(punit) == pplayer) {
 	cost += unit_build_shield_cost_base(punit);
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   }
 
   return cost;
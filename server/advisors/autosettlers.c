@@ -183,7 +183,7 @@ adv_want adv_settlers_road_bonus(struct tile *ptile, struct road_type *proad)
       is_slow[i] = (build_time == 0 || build_time > 5);
 
       if (!real_road[i]) {
-	unit_list_iterate(tile1->units, punit) {
+	unit_stack_iterate(tile1->units, punit) {
           if (punit->activity == ACTIVITY_GEN_ROAD) {
             /* If a road, or its dependency is being built here, consider as if it's already
 	     * built. */
@@ -203,7 +203,7 @@ adv_want adv_settlers_road_bonus(struct tile *ptile, struct road_type *proad)
               }
             }
           }
-	} unit_list_iterate_end;
+	} unit_stack_iterate_end;
       }
     }
   }
@@ -482,13 +482,13 @@ adv_want settler_evaluate_improvements(struct unit *punit,
       }
 
       /* Do not go to tiles that already have workers there. */
-      unit_list_iterate(ptile->units, aunit) {
+      unit_stack_iterate(ptile->units, aunit) {
         if (unit_owner(aunit) == pplayer
             && aunit->id != punit->id
             && unit_has_type_flag(aunit, UTYF_SETTLERS)) {
           consider = FALSE;
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
 
       if (!consider) {
         continue;
@@ -844,13 +844,13 @@ struct city *settler_evaluate_city_requests(struct unit *punit,
       bool consider = TRUE;
 
       /* Do not go to tiles that already have workers there. */
-      unit_list_iterate(ptask->ptile->units, aunit) {
+      unit_stack_iterate(ptask->ptile->units, aunit) {
         if (unit_owner(aunit) == pplayer
             && aunit->id != punit->id
             && unit_has_type_flag(aunit, UTYF_SETTLERS)) {
           consider = FALSE;
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
 
       if (consider
           && auto_settlers_speculate_can_act_at(punit, ptask->act,
@@ -1125,11 +1125,11 @@ bool auto_settler_setup_work(struct player *pplayer, struct unit *punit,
 bool adv_settler_safe_tile(const struct player *pplayer, struct unit *punit,
                            struct tile *ptile)
 {
-  unit_list_iterate(ptile->units, defender) {
+  unit_stack_iterate(ptile->units, defender) {
     if (is_military_unit(defender)) {
       return TRUE;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   if (is_square_threatened(pplayer, ptile, !has_handicap(pplayer, H_FOG))) {
     return FALSE;
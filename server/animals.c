@@ -63,11 +63,11 @@ static void place_animal(struct player *plr)
     }
   } extra_type_by_rmcause_iterate_end;
 
-  if (unit_list_size(ptile->units) > 0 || tile_city(ptile)) {
+  if (unit_stack_size(ptile->units) > 0 || tile_city(ptile)) {
     return;
   }
   adjc_iterate(&(wld.map), ptile, padj) {
-    if (unit_list_size(padj->units) > 0 || tile_city(padj)) {
+    if (unit_stack_size(padj->units) > 0 || tile_city(padj)) {
       /* No animals next to start units or start city */
       return;
     }
@@ -294,9 +294,9 @@ bool unleash_barbarians(struct tile *ptile)
   if (BARBS_DISABLED == game.server.barbarianrate
       || game.info.turn < game.server.onsetbarbarian
       || num_role_units(L_BARBARIAN) == 0) {
-    unit_list_iterate_safe((ptile)->units, punit) {
+    unit_stack_iterate_safe((ptile)->units, punit) {
       wipe_unit(punit, ULR_BARB_UNLEASH, NULL);
-    } unit_list_iterate_safe_end;
+    } unit_stack_iterate_safe_end;
     return FALSE;
   }
 
@@ -346,7 +346,7 @@ bool unleash_barbarians(struct tile *ptile)
 
   if (land_tiles >= 3) {
     /* Enough land, scatter guys around */
-    unit_list_iterate_safe((ptile)->units, punit2) {
+    unit_stack_iterate_safe((ptile)->units, punit2) {
       if (unit_owner(punit2) == barbarians) {
         bool dest_found = FALSE;
 
@@ -374,7 +374,7 @@ bool unleash_barbarians(struct tile *ptile)
           barbarian_stays = TRUE;
         }
       }
-    } unit_list_iterate_safe_end;
+    } unit_stack_iterate_safe_end;
 
   } else {
     if (ocean_tiles > 0) {
@@ -401,7 +401,7 @@ bool unleash_barbarians(struct tile *ptile)
 
       if (boat) {
         /* We do have a boat. Try to get everybody in */
-        unit_list_iterate_safe((ptile)->units, punit2) {
+        unit_stack_iterate_safe((ptile)->units, punit2) {
           if (unit_owner(punit2) == barbarians) {
             if (is_action_enabled_unit_on_unit(ACTION_TRANSPORT_EMBARK,
                                                punit2, boat)) {
@@ -425,11 +425,11 @@ bool unleash_barbarians(struct tile *ptile)
                              0, "", ACTION_TRANSPORT_EMBARK4);
             }
           }
-        } unit_list_iterate_safe_end;
+        } unit_stack_iterate_safe_end;
       }
 
       /* Move rest of the barbarians to random land tiles */
-      unit_list_iterate_safe((ptile)->units, punit2) {
+      unit_stack_iterate_safe((ptile)->units, punit2) {
         if (unit_owner(punit2) == barbarians) {
           bool dest_found = FALSE;
 
@@ -457,7 +457,7 @@ bool unleash_barbarians(struct tile *ptile)
             barbarian_stays = TRUE;
           }
         }
-      } unit_list_iterate_safe_end;
+      } unit_stack_iterate_safe_end;
     } else {
       /* The village is surrounded! Barbarians cannot leave. */
       barbarian_stays = TRUE;
@@ -466,14 +466,14 @@ bool unleash_barbarians(struct tile *ptile)
 
   if (barbarian_stays) {
     /* There's barbarian in this village! Kill the explorer. */
-    unit_list_iterate_safe((ptile)->units, punit2) {
+    unit_stack_iterate_safe((ptile)->units, punit2) {
       if (unit_owner(punit2) != barbarians) {
         wipe_unit(punit2, ULR_BARB_UNLEASH, NULL);
         alive = FALSE;
       } else {
         send_unit_info(NULL, punit2);
       }
-    } unit_list_iterate_safe_end;
+    } unit_stack_iterate_safe_end;
   }
 
   /* FIXME: I don't know if this is needed */
@@ -504,7 +504,7 @@ static bool is_near_land(struct tile *tile0)
 static struct tile *find_empty_tile_nearby(struct tile *ptile)
 {
   square_iterate(&(wld.map), ptile, 1, tile1) {
-    if (unit_list_size(tile1->units) == 0) {
+    if (unit_stack_size(tile1->units) == 0) {
       return tile1;
     }
   } square_iterate_end;
@@ -704,9 +704,9 @@ static void try_summon_barbarians(void)
   }
 
   /* Is this necessary?  create_unit_full already sends unit info. */
-  unit_list_iterate(utile->units, punit2) {
+  unit_stack_iterate(utile->units, punit2) {
     send_unit_info(NULL, punit2);
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   /* to let them know where to get you */
   map_show_circle(barbarians, utile, BARBARIAN_INITIAL_VISION_RADIUS_SQ);
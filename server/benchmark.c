@@ -0,0 +1,256 @@
+/***********************************************************************
+ Freeciv - Copyright (C) 1996 - A Kjeldberg, L Gregersen, P Unold
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+***********************************************************************/
+
+/**********************************************************************
+  Benchmark mode (--benchmark TURNS): the server sets itself up for an
+  autogame, plays the turns without waiting for anyone and reports how
+  fast it went.  The per turn breakdown comes from the timing spans the
+  turn change records, see "timing.c".
+***********************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <fc_config.h>
+#endif
+
+#include <string.h>
+
+#ifndef FREECIV_MSWINDOWS
+#include <sys/resource.h>
+#endif
+
+/* utility */
+#include "astring.h"
+#include "fcintl.h"
+#include "log.h"
+#include "mem.h"
+#include "support.h"
+#include "timing.h"
+
+/* common */
+#include "game.h"
+#include "map.h"
+#include "player.h"
+#include "world_object.h"
+
+/* server */
+#include "console.h"
+#include "stdinhand.h"
+
+#include "benchmark.h"
+
+/* Parts of the turn change in the breakdown, by the names of their
+ * timing spans. */
+static const char *benchmark_parts[] = {
+  "begin_turn",
+  "begin_phase",
+  "end_phase",
+  "end_turn",
+  "ai_phase_begin",
+  "ai_first_activities",
+  "auto_settlers_player",
+  "ai_last_activities",
+  "update_city_activities",
+  "flush_packets"
+};
+#define BENCHMARK_NUM_PARTS ARRAY_SIZE(benchmark_parts)
+
+struct benchmark_turn {
+  int turn;
+  double seconds;
+  double parts[BENCHMARK_NUM_PARTS];
+};
+
+static struct {
+  struct timer *timer;
+  int turn;                     /* the turn being played */
+
+  struct benchmark_turn *turns;
+  int num_turns, size;
+  int dropped_spans;
+} bench;
+
+/**********************************************************************//**
+  Set the settings a benchmark needs, before the --read script may
+  change them: no human players needed, no timeout, no autosaves, and
+  fixed seeds.
+**************************************************************************/
+void benchmark_settings(void)
+{
+  const char *commands[] = {
+    "set minplayers 0",
+    "set timeout -1",
+    "set autosaves \"\"",
+    "set gameseed 1",
+    "set mapseed 1"
+  };
+  int i;
+
+  for (i = 0; i < ARRAY_SIZE(commands); i++) {
+    char buf[64];
+
+    sz_strlcpy(buf, commands[i]);
+    (void) handle_stdin_input(NULL, buf);
+  }
+}
+
+/**********************************************************************//**
+  Start the benchmark of a game about to be played: it ends after the
+  given number of turns.
+**************************************************************************/
+void benchmark_start(int turns)
+{
+  game.server.end_turn = MIN(game.info.turn + turns - 1, GAME_MAX_END_TURN);
+
+  bench.num_turns = 0;
+  bench.dropped_spans = 0;
+  bench.timer = timer_renew(bench.timer, TIMER_USER, TIMER_ACTIVE);
+  timer_start(bench.timer);
+
+  log_normal(_("Benchmark: playing turns %d to %d."),
+             game.info.turn, game.server.end_turn);
+}
+
+/**********************************************************************//**
+  A turn of the benchmark begins.
+**************************************************************************/
+void benchmark_turn_begin(void)
+{
+  bench.turn = game.info.turn;
+}
+
+/**********************************************************************//**
+  A turn of the benchmark has ended, and its timing spans with it.
+**************************************************************************/
+void benchmark_turn_end(void)
+{
+  struct benchmark_turn *pturn;
+  int i;
+
+  if (bench.num_turns >= bench.size) {
+    bench.size = MAX(64, 2 * bench.size);
+    bench.turns = fc_realloc(bench.turns,
+                             bench.size * sizeof(*bench.turns));
+  }
+  pturn = &bench.turns[bench.num_turns++];
+
+  pturn->turn = bench.turn;
+  pturn->seconds = timing_spans_seconds(bench.turn, "turn");
+  for (i = 0; i < BENCHMARK_NUM_PARTS; i++) {
+    pturn->parts[i] = timing_spans_seconds(bench.turn, benchmark_parts[i]);
+  }
+  bench.dropped_spans = timing_spans_dropped();
+}
+
+/**********************************************************************//**
+  Returns the most memory the server has had in RAM, in KiB, or -1 if
+  it is not known.
+**************************************************************************/
+static long benchmark_peak_rss(void)
+{
+#ifndef FREECIV_MSWINDOWS
+  struct rusage usage;
+
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; /* In bytes there */
+#else
+    return usage.ru_maxrss;
+#endif
+  }
+#endif /* FREECIV_MSWINDOWS */
+
+  return -1;
+}
+
+/**********************************************************************//**
+  Report the results of the benchmark: to the log for people, and as
+  lines of JSON on the console for scripts.
+**************************************************************************/
+void benchmark_report(void)
+{
+  double totals[BENCHMARK_NUM_PARTS];
+  double seconds, slowest = 0.0;
+  int slowest_turn = 0;
+  long peak_rss = benchmark_peak_rss();
+  struct astring json = ASTRING_INIT;
+  int i, j;
+
+  if (bench.timer == NULL) {
+    return;
+  }
+
+  seconds = timer_read_seconds(bench.timer);
+
+  memset(totals, 0, sizeof(totals));
+  for (i = 0; i < bench.num_turns; i++) {
+    for (j = 0; j < BENCHMARK_NUM_PARTS; j++) {
+      totals[j] += bench.turns[i].parts[j];
+    }
+    if (bench.turns[i].seconds > slowest) {
+      slowest = bench.turns[i].seconds;
+      slowest_turn = bench.turns[i].turn;
+    }
+  }
+
+  log_normal(_("Benchmark: %d turns in %.2f seconds, %.3f turns per second, "
+               "peak RSS %ld KiB."),
+             bench.num_turns, seconds,
+             seconds > 0.0 ? bench.num_turns / seconds : 0.0, peak_rss);
+  log_normal(_("Benchmark: slowest turn %d took %.3f seconds."),
+             slowest_turn, slowest);
+  if (bench.dropped_spans > 0) {
+    log_normal(_("Benchmark: %d timing spans were dropped, the parts of "
+                 "the turns are incomplete."), bench.dropped_spans);
+  }
+  for (j = 0; j < BENCHMARK_NUM_PARTS; j++) {
+    log_normal(_("Benchmark: %-24s %9.3f seconds"),
+               benchmark_parts[j], totals[j]);
+  }
+
+  /* One line of JSON for each turn, then one for the whole game. */
+  for (i = 0; i < bench.num_turns; i++) {
+    astr_set(&json, "{\"benchmark_turn\":{\"turn\":%d,\"seconds\":%.4f",
+             bench.turns[i].turn, bench.turns[i].seconds);
+    for (j = 0; j < BENCHMARK_NUM_PARTS; j++) {
+      astr_add(&json, ",\"%s\":%.4f",
+               benchmark_parts[j], bench.turns[i].parts[j]);
+    }
+    astr_add(&json, "}}");
+    con_puts(C_COMMENT, astr_str(&json));
+  }
+
+  astr_set(&json, "{\"benchmark\":{\"ruleset\":\"%s\",\"xsize\":%d,"
+           "\"ysize\":%d,\"players\":%d,\"gameseed\":%u,\"mapseed\":%u,"
+           "\"threads\":%d,\"turns\":%d,\"seconds\":%.3f,"
+           "\"turns_per_second\":%.4f,\"peak_rss_kib\":%ld,"
+           "\"slowest_turn\":%d,\"dropped_spans\":%d,\"parts\":{",
+           game.server.rulesetdir, wld.map.xsize, wld.map.ysize,
+           player_count(), game.server.seed, wld.map.server.seed,
+           game.server.threads, bench.num_turns, seconds,
+           seconds > 0.0 ? bench.num_turns / seconds : 0.0, peak_rss,
+           slowest_turn, bench.dropped_spans);
+  for (j = 0; j < BENCHMARK_NUM_PARTS; j++) {
+    astr_add(&json, "%s\"%s\":%.4f", j > 0 ? "," : "",
+             benchmark_parts[j], totals[j]);
+  }
+  astr_add(&json, "}}}");
+  con_puts(C_COMMENT, astr_str(&json));
+  con_flush();
+  astr_free(&json);
+
+  timer_destroy(bench.timer);
+  bench.timer = NULL;
+  FC_FREE(bench.turns);
+  bench.num_turns = 0;
+  bench.size = 0;
+}
@@ -0,0 +1,22 @@
+/***********************************************************************
+ Freeciv - Copyright (C) 1996 - A Kjeldberg, L Gregersen, P Unold
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+***********************************************************************/
+#ifndef FC__BENCHMARK_H
+#define FC__BENCHMARK_H
+
+void benchmark_settings(void);
+void benchmark_start(int turns);
+void benchmark_turn_begin(void);
+void benchmark_turn_end(void);
+void benchmark_report(void);
+
+#endif /* FC__BENCHMARK_H */
@@ -110,6 +110,7 @@ void handle_city_change_specialist(struct player *pplayer, int city_id,
 
   pcity->specialists[from]--;
   pcity->specialists[to]++;
+  city_refresh_mark(pcity, CITY_REFRESH_PRODUCTION);
 
   city_refresh(pcity);
   sanity_check_city(pcity);
@@ -148,6 +149,7 @@ void handle_city_make_specialist(struct player *pplayer,
   } else if (tile_worked(ptile) == pcity) {
     city_map_update_empty(pcity, ptile);
     pcity->specialists[DEFAULT_SPECIALIST]++;
+    city_refresh_mark(pcity, CITY_REFRESH_PRODUCTION);
   } else {
     log_verbose("handle_city_make_specialist() not working (%d, %d) "
                 "\"%s\".", TILE_XY(ptile), city_name_get(pcity));
@@ -218,6 +220,7 @@ void handle_city_make_worker(struct player *pplayer,
       break;
     }
   } specialist_type_iterate_end;
+  city_refresh_mark(pcity, CITY_REFRESH_PRODUCTION);
 
   city_refresh(pcity);
   sanity_check_city(pcity);
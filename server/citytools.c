@@ -33,6 +33,7 @@
 #include "base.h"
 #include "citizens.h"
 #include "city.h"
+#include "citygrid.h"
 #include "culture.h"
 #include "events.h"
 #include "game.h"
@@ -722,7 +723,7 @@ void transfer_city_units(struct player *pplayer, struct player *pvictim,
   /* Transfer enemy units in the city to the new owner.
    * Only relevant if we are transferring to another player. */
   if (pplayer != pvictim) {
-    unit_list_iterate_safe((ptile)->units, vunit)  {
+    unit_stack_iterate_safe((ptile)->units, vunit)  {
       if (vunit->server.dying) {
         /* Don't transfer or bounce a dying unit. It will soon be gone
          * anyway.
@@ -761,7 +762,7 @@ void transfer_city_units(struct player *pplayer, struct player *pvictim,
         /* the owner of vunit is allied to pvictim but not to pplayer */
         bounce_unit(vunit, verbose);
       }
-    } unit_list_iterate_safe_end;
+    } unit_stack_iterate_safe_end;
   }
 
   if (!city_exist(saved_id)) {
@@ -826,6 +827,77 @@ void transfer_city_units(struct player *pplayer, struct player *pvictim,
 #endif /* FREECIV_DEBUG */
 }
 
+/************************************************************************//**
+  Whether the city passes the restrictions of find_closest_city().
+****************************************************************************/
+static bool closest_city_fits(const struct city *pcity,
+                              Continent_id con,
+                              const struct city *pexclcity,
+                              const struct player *pplayer,
+                              bool only_ocean, bool only_continent,
+                              bool only_known, bool only_player,
+                              bool only_enemy,
+                              const struct unit_class *pclass)
+{
+  const struct player *aplayer = city_owner(pcity);
+
+  if (pplayer != NULL && only_player && pplayer != aplayer) {
+    /* only cities of player 'pplayer' */
+    return FALSE;
+  }
+
+  if (pplayer != NULL && only_enemy
+      && !pplayers_at_war(pplayer, aplayer)) {
+    /* only cities of players at war with player 'pplayer' */
+    return FALSE;
+  }
+
+  if (pexclcity && pexclcity == pcity) {
+    /* not this city */
+    return FALSE;
+  }
+
+  /* - (if required) on the same continent
+   * - (if required) adjacent to ocean
+   * - (if required) only cities known by the player
+   * - (if required) only cities native to the class */
+  return ((!only_continent || con == tile_continent(pcity->tile))
+          && (!only_ocean
+              || is_terrain_class_near_tile(city_tile(pcity), TC_OCEAN))
+          && (!only_known
+              || (map_is_known(city_tile(pcity), pplayer)
+                  && map_get_player_site(city_tile(pcity), pplayer)->identity
+                     > IDENTITY_NUMBER_ZERO))
+          && (pclass == NULL
+              || is_native_near_tile(&(wld.map), pclass, city_tile(pcity))));
+}
+
+/************************************************************************//**
+  Whether find_closest_city() scanning all the players and their city lists
+  would come to 'pcity1' before 'pcity2'.
+****************************************************************************/
+static bool closest_city_first(const struct city *pcity1,
+                               const struct city *pcity2)
+{
+  const struct player *pplayer1 = city_owner(pcity1);
+  const struct player *pplayer2 = city_owner(pcity2);
+
+  if (pplayer1 != pplayer2) {
+    return player_index(pplayer1) < player_index(pplayer2);
+  }
+
+  city_list_iterate(pplayer1->cities, pcity) {
+    if (pcity == pcity1) {
+      return TRUE;
+    }
+    if (pcity == pcity2) {
+      return FALSE;
+    }
+  } city_list_iterate_end;
+
+  return FALSE;
+}
+
 /************************************************************************//**
   Find the city closest to 'ptile'. Some restrictions can be applied:
 
@@ -843,7 +915,12 @@ void transfer_city_units(struct player *pplayer, struct player *pvictim,
   'pclass'          if set, and 'pclass' is not NULL only cities that have
                     adjacent native terrain for that unit class are returned.
 
-  If no city is found NULL is returned.
+  If no city is found NULL is returned.  Of cities equally close the
+  one of the first player, and first in its city list, is returned.
+
+  The cities near 'ptile' are looked up in the city grid, widening the
+  search until a city fits; only when the search would cover most of the
+  map are all the cities scanned.
 ****************************************************************************/
 struct city *find_closest_city(const struct tile *ptile,
                                const struct city *pexclcity,
@@ -852,9 +929,11 @@ struct city *find_closest_city(const struct tile *ptile,
                                bool only_known, bool only_player,
                                bool only_enemy, const struct unit_class *pclass)
 {
+  struct city_list *cells[4 * CITY_GRID_MAX_NEAR];
   Continent_id con;
   struct city *best_city = NULL;
   int best_dist = -1;
+  int dist, ncells, i;
 
   fc_assert_ret_val(ptile != NULL, NULL);
 
@@ -865,43 +944,45 @@ struct city *find_closest_city(const struct tile *ptile,
 
   con = tile_continent(ptile);
 
-  players_iterate(aplayer) {
-    if (pplayer != NULL && only_player && pplayer != aplayer) {
-      /* only cities of player 'pplayer' */
-      continue;
+  for (dist = CITY_GRID_CELL; ; dist *= 2) {
+    ncells = city_grid_near(&wld, ptile, dist, cells, ARRAY_SIZE(cells));
+    if (ncells < 0) {
+      break;
     }
 
-    if (pplayer != NULL && only_enemy
-        && !pplayers_at_war(pplayer, aplayer)) {
-      /* only cities of players at war with player 'pplayer' */
-      continue;
-    }
+    for (i = 0; i < ncells; i++) {
+      city_list_iterate(cells[i], pcity) {
+        int city_dist = real_map_distance(ptile, city_tile(pcity));
 
-    city_list_iterate(aplayer->cities, pcity) {
-      int city_dist;
+        if (city_dist <= dist
+            && (best_dist == -1 || city_dist < best_dist
+                || (city_dist == best_dist
+                    && closest_city_first(pcity, best_city)))
+            && closest_city_fits(pcity, con, pexclcity, pplayer,
+                                 only_ocean, only_continent, only_known,
+                                 only_player, only_enemy, pclass)) {
+          best_dist = city_dist;
+          best_city = pcity;
+        }
+      } city_list_iterate_end;
+    }
 
-      if (pexclcity && pexclcity == pcity) {
-        /* not this city */
-        continue;
-      }
+    if (best_city != NULL || ncells == 0
+        || dist > wld.map.xsize + wld.map.ysize) {
+      /* Any city outside of the searched cells is farther away. */
+      return best_city;
+    }
+  }
 
-      city_dist = real_map_distance(ptile, city_tile(pcity));
+  players_iterate(aplayer) {
+    city_list_iterate(aplayer->cities, pcity) {
+      int city_dist = real_map_distance(ptile, city_tile(pcity));
 
-      /* Find the closest city matching the requirements.
-       * - closer than the current best city
-       * - (if required) on the same continent
-       * - (if required) adjacent to ocean
-       * - (if required) only cities known by the player
-       * - (if required) only cities native to the class */
+      /* Find the closest city matching the requirements. */
       if ((best_dist == -1 || city_dist < best_dist)
-          && (!only_continent || con == tile_continent(pcity->tile))
-          && (!only_ocean || is_terrain_class_near_tile(city_tile(pcity), TC_OCEAN))
-          && (!only_known
-              || (map_is_known(city_tile(pcity), pplayer)
-                  && map_get_player_site(city_tile(pcity), pplayer)->identity
-                     > IDENTITY_NUMBER_ZERO))
-          && (pclass == NULL
-              || is_native_near_tile(&(wld.map), pclass, city_tile(pcity)))) {
+          && closest_city_fits(pcity, con, pexclcity, pplayer,
+                               only_ocean, only_continent, only_known,
+                               only_player, only_enemy, pclass)) {
         best_dist = city_dist;
         best_city = pcity;
       }
@@ -1079,7 +1160,7 @@ bool transfer_city(struct player *ptaker, struct city *pcity,
   const citizens old_giver_angry_citizens = player_angry_citizens(pgiver);
   bool taker_had_no_cities = (city_list_size(ptaker->cities) == 0);
   bool new_extras;
-  const int units_num = unit_list_size(pcenter->units);
+  const int units_num = unit_stack_size(pcenter->units);
   bv_player *could_see_unit = (units_num > 0
                                ? fc_malloc(sizeof(*could_see_unit)
                                            * units_num)
@@ -1090,7 +1171,7 @@ bool transfer_city(struct player *ptaker, struct city *pcity,
 
   /* Remember what player see what unit. */
   i = 0;
-  unit_list_iterate(pcenter->units, aunit) {
+  unit_stack_iterate(pcenter->units, aunit) {
     BV_CLR_ALL(could_see_unit[i]);
     players_iterate(aplayer) {
       if (can_player_see_unit(aplayer, aunit)) {
@@ -1098,7 +1179,7 @@ bool transfer_city(struct player *ptaker, struct city *pcity,
       }
     } players_iterate_end;
     i++;
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
   fc_assert(i == units_num);
 
   /* Remove AI control of the old owner. */
@@ -1180,7 +1261,7 @@ bool transfer_city(struct player *ptaker, struct city *pcity,
   /* Hide/reveal units. Do it after vision have been given to taker, city
    * owner has been changed, and before any script could be spawned. */
   i = 0;
-  unit_list_iterate(pcenter->units, aunit) {
+  unit_stack_iterate(pcenter->units, aunit) {
     players_iterate(aplayer) {
       if (can_player_see_unit(aplayer, aunit)) {
         if (!BV_ISSET(could_see_unit[i], player_index(aplayer))
@@ -1196,7 +1277,7 @@ bool transfer_city(struct player *ptaker, struct city *pcity,
       }
     } players_iterate_end;
     i++;
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
   fc_assert(i == units_num);
   free(could_see_unit);
   could_see_unit = NULL;
@@ -1492,11 +1573,11 @@ void create_city(struct player *pplayer, struct tile *ptile,
         || !map_is_known_and_seen(ptile, other_player, V_MAIN)) {
       continue;
     }
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       if (can_player_see_unit(other_player, punit)) {
         unit_goes_out_of_sight(other_player, punit);
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   } players_iterate_end;
 
   adv_city_alloc(pcity);
@@ -1578,7 +1659,7 @@ void create_city(struct player *pplayer, struct tile *ptile,
 
   /* Bases destroyed earlier may have had watchtower effect. Refresh
    * unit vision. */
-  unit_list_refresh_vision(ptile->units);
+  unit_stack_refresh_vision(ptile->units);
 
   update_tile_knowledge(ptile);
 
@@ -1598,7 +1679,7 @@ void create_city(struct player *pplayer, struct tile *ptile,
 		city_link(pcity));
   maybe_make_contact(ptile, city_owner(pcity));
 
-  unit_list_iterate((ptile)->units, punit) {
+  unit_stack_iterate((ptile)->units, punit) {
     struct city *home = game_city_by_number(punit->homecity);
 
     /* Catch fortress building, transforming into ocean, etc. */
@@ -1615,7 +1696,7 @@ void create_city(struct player *pplayer, struct tile *ptile,
       sanity_check_city(home);
       send_city_info(city_owner(home), home);
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   sanity_check_city(pcity);
 
@@ -1669,7 +1750,7 @@ void remove_city(struct city *pcity)
   } unit_list_iterate_safe_end;
 
   /* make sure ships are not left on land when city is removed. */
-  unit_list_iterate_safe(pcenter->units, punit) {
+  unit_stack_iterate_safe(pcenter->units, punit) {
     bool moved;
     const struct unit_type *punittype = unit_type_get(punit);
 
@@ -1718,7 +1799,7 @@ void remove_city(struct city *pcity)
                     unit_tile_link(punit));
       wipe_unit(punit, ULR_CITY_LOST, NULL);
     }
-  } unit_list_iterate_safe_end;
+  } unit_stack_iterate_safe_end;
 
   process_queue = tile_list_new();
   dbv_init(&tile_processed, map_num_tiles());
@@ -1737,7 +1818,7 @@ void remove_city(struct city *pcity)
         /* Adjacent tile has a city that may have been part of same channel */
         dbv_set(&tile_processed, tile_index(piter));
         tile_list_append(process_queue, piter);
-        unit_list_iterate_safe(piter->units, punit) {
+        unit_stack_iterate_safe(piter->units, punit) {
           struct unit_class *pclass = utype_class(punit->utype);
 
           if (!uclass_has_flag(pclass, UCF_BUILD_ANYWHERE)
@@ -1752,7 +1833,7 @@ void remove_city(struct city *pcity)
                           city_link(other_city));
             wipe_unit(punit, ULR_CITY_LOST, NULL);
           }
-        } unit_list_iterate_safe_end;
+        } unit_stack_iterate_safe_end;
       } else {
         dbv_set(&tile_processed, tile_index(piter));
       }
@@ -1811,11 +1892,11 @@ void remove_city(struct city *pcity)
         || !map_is_known_and_seen(pcenter, other_player, V_MAIN)) {
       continue;
     }
-    unit_list_iterate(pcenter->units, punit) {
+    unit_stack_iterate(pcenter->units, punit) {
       if (can_player_see_unit(other_player, punit)) {
         send_unit_info(other_player->connections, punit);
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   } players_iterate_end;
 
   fc_allocate_mutex(&game.server.mutexes.city_list);
@@ -2589,7 +2670,7 @@ bool update_dumb_city(struct player *pplayer, struct city *pcity)
   struct vision_site *pdcity = map_get_player_city(pcenter, pplayer);
   /* pcity->client.occupied isn't used at the server, so we go straight to the
    * unit list to check the occupied status. */
-  bool occupied = (unit_list_size(pcenter->units) > 0);
+  bool occupied = (unit_stack_size(pcenter->units) > 0);
   bool walls = city_got_citywalls(pcity);
   bool happy = city_happy(pcity);
   bool unhappy = city_unhappy(pcity);
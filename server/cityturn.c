@@ -22,11 +22,13 @@
 
 /* utility */
 #include "fcintl.h"
+#include "fcthreadpool.h"
 #include "log.h"
 #include "mem.h"
 #include "rand.h"
 #include "shared.h"
 #include "support.h"
+#include "timing.h"
 
 /* common/aicore */
 #include "cm.h"
@@ -38,6 +40,7 @@
 #include "calendar.h"
 #include "citizens.h"
 #include "city.h"
+#include "citygrid.h"
 #include "culture.h"
 #include "events.h"
 #include "disaster.h"
@@ -80,8 +83,59 @@
 /* server/scripting */
 #include "script_server.h"
 
-/* Queue for pending city_refresh() */
-static struct city_list *city_refresh_queue = NULL;
+/* Queue for pending city_refresh(), by city id. A city is in it while its
+ * needs_refresh flag is set. */
+#define SPECVEC_TAG city_id
+#define SPECVEC_TYPE int
+#include "specvec.h"
+
+static struct city_id_vector city_refresh_queue = { NULL, 0, 0 };
+
+/* Citizen arrangement of one city, see auto_arrange_workers() */
+struct arrange_job {
+  struct city *pcity;
+  struct cm_parameter cmp;
+  struct cm_result *cmr;
+  bool broadcast_needed;
+  bool param_failed;      /* Player-defined parameter could not be met */
+  bool emergency;
+  bool parallel;          /* Queried together with the rest of the batch */
+};
+
+/* A city waiting for its turn end processing in update_city_activities() */
+struct city_activity {
+  struct city *pcity;
+  bool refreshed;         /* Refreshed together with the other cities */
+  bool radius_changed;
+  bool is_happy;          /* Before the refresh */
+  bool is_celebrating;
+};
+
+/* Farthest a city can take in migrants from */
+#define MGR_MAX_DIST (CITY_MAP_MAX_RADIUS + GAME_MAX_MGR_DISTANCE)
+#define MGR_RANK_SIDE (2 * MGR_MAX_DIST + 1)
+
+/* The cities near a city that may migration happen with. */
+struct mgr_near {
+  /* Position of each map vector in the iterate_outward() order, or -1 */
+  int rank[MGR_RANK_SIDE * MGR_RANK_SIDE];
+  bool use_grid;
+
+  struct mgr_city {
+    struct city *pcity;
+    int rank;
+  } *cities;
+  int count, size;
+};
+
+/* Statistics of auto_arrange_workers_list() for the current turn */
+static struct {
+  struct timer *timer;
+  int batches;
+  int parallel;
+  int conflicts;
+  int serial;
+} arrange_stats;
 
 /* The game is currently considering to remove the listed units because of
  * missing gold upkeep. A unit ends up here if it has gold upkeep that
@@ -138,36 +192,145 @@ static bool player_balance_treasury_units(struct player *pplayer);
 static bool disband_city(struct city *pcity);
 
 static void define_orig_production_values(struct city *pcity);
-static void update_city_activity(struct city *pcity);
+static bool city_refresh_begin(struct city *pcity);
+static void city_refresh_end(struct city *pcity, bool radius_changed);
+static void update_city_activity(struct city_activity *act);
 static void nullify_caravan_and_disband_plus(struct city *pcity);
 static bool city_illness_check(const struct city * pcity);
 
 static float city_migration_score(struct city *pcity);
 static bool do_city_migration(struct city *pcity_from,
                               struct city *pcity_to);
-static bool check_city_migrations_player(const struct player *pplayer);
+static bool check_city_migrations_player(const struct player *pplayer,
+                                         struct mgr_near *near);
 
 /**********************************************************************//**
   Updates unit upkeeps and city internal cached data. Returns whether
   city radius has changed.
 **************************************************************************/
 bool city_refresh(struct city *pcity)
+{
+  bool retval = city_refresh_begin(pcity);
+
+  city_refresh_from_main_map(pcity, NULL);
+  city_refresh_end(pcity, retval);
+
+  return retval;
+}
+
+/**********************************************************************//**
+  The part of city_refresh() before the city itself gets refreshed. It
+  updates the city radius and unit upkeep. Returns whether city radius
+  has changed.
+**************************************************************************/
+static bool city_refresh_begin(struct city *pcity)
 {
   bool retval;
 
+  if (pcity->server.needs_refresh) {
+    /* Queued for whatever changed around the city. */
+    city_refresh_mark(pcity, CITY_REFRESH_ALL);
+  }
   pcity->server.needs_refresh = FALSE;
 
   retval = city_map_update_radius_sq(pcity);
-  city_units_upkeep(pcity); /* update unit upkeep */
-  city_refresh_from_main_map(pcity, NULL);
+  if (retval) {
+    city_refresh_mark(pcity, CITY_REFRESH_ALL);
+  }
+  if (city_refresh_stale(pcity, CITY_REFRESH_SUPPORT)) {
+    city_units_upkeep(pcity); /* update unit upkeep */
+  }
+
+  return retval;
+}
+
+/**********************************************************************//**
+  The part of city_refresh() after the city itself got refreshed.
+**************************************************************************/
+static void city_refresh_end(struct city *pcity, bool radius_changed)
+{
   city_style_refresh(pcity);
 
-  if (retval) {
+  if (radius_changed) {
     /* Force a sync of the city after the change. */
     send_city_info(city_owner(pcity), pcity);
   }
+}
 
-  return retval;
+/**********************************************************************//**
+  Task of city_refresh_activities(): refresh one of the cities.
+**************************************************************************/
+static void city_refresh_task(int index, void *arg)
+{
+  struct city **cities = (struct city **) arg;
+
+  city_refresh_from_main_map(cities[index], NULL);
+}
+
+/**********************************************************************//**
+  Refresh all the cities of update_city_activities() before any of them
+  gets processed, on 'citythreads' threads. Only the refresh proper runs
+  in the threads; unit upkeep, radius changes, packets and worker
+  arrangement are handled in this thread in the order of the array.
+
+  With the simple trade revenue style a city reads the trade of its trade
+  partners, so cities trading with each other are refreshed one after
+  another once the threads are done.
+**************************************************************************/
+static void city_refresh_activities(struct city_activity *acts, int n)
+{
+  struct city **parallel, **serial;
+  struct city_list *arrange;
+  int nparallel = 0, nserial = 0, i;
+
+  parallel = fc_malloc(n * sizeof(*parallel));
+  serial = fc_malloc(n * sizeof(*serial));
+
+  for (i = 0; i < n; i++) {
+    struct city *pcity = acts[i].pcity;
+    bool independent = TRUE;
+
+    acts[i].refreshed = TRUE;
+    acts[i].is_happy = city_happy(pcity);
+    acts[i].is_celebrating = city_celebrating(pcity);
+
+    city_units_upkeep(pcity);
+    acts[i].radius_changed = city_refresh_begin(pcity);
+
+    if (game.info.trade_revenue_style == TRS_SIMPLE) {
+      trade_partners_iterate(pcity, partner) {
+        if (city_owner(partner) == city_owner(pcity)) {
+          independent = FALSE;
+          break;
+        }
+      } trade_partners_iterate_end;
+    }
+    if (independent) {
+      parallel[nparallel++] = pcity;
+    } else {
+      serial[nserial++] = pcity;
+    }
+  }
+
+  fc_parallel_for(nparallel, game.server.city_threads, city_refresh_task,
+                  parallel);
+
+  for (i = 0; i < nserial; i++) {
+    city_refresh_from_main_map(serial[i], NULL);
+  }
+
+  arrange = city_list_new();
+  for (i = 0; i < n; i++) {
+    city_refresh_end(acts[i].pcity, acts[i].radius_changed);
+    if (acts[i].radius_changed) {
+      city_list_append(arrange, acts[i].pcity);
+    }
+  }
+  auto_arrange_workers_list(arrange);
+  city_list_destroy(arrange);
+
+  free(serial);
+  free(parallel);
 }
 
 /**********************************************************************//**
@@ -191,37 +354,82 @@ void city_refresh_for_player(struct player *pplayer)
 **************************************************************************/
 void city_refresh_queue_add(struct city *pcity)
 {
-  if (NULL == city_refresh_queue) {
-    city_refresh_queue = city_list_new();
-  } else if (city_list_find_number(city_refresh_queue, pcity->id)) {
+  if (pcity->server.needs_refresh) {
+    /* Already queued. */
     return;
   }
 
-  city_list_prepend(city_refresh_queue, pcity);
+  city_id_vector_append(&city_refresh_queue, pcity->id);
   pcity->server.needs_refresh = TRUE;
 }
 
+/**********************************************************************//**
+  Order cities by owner, then by id.
+**************************************************************************/
+static int city_refresh_owner_cmp(const void *a, const void *b)
+{
+  const struct city *pcity1 = *(const struct city **) a;
+  const struct city *pcity2 = *(const struct city **) b;
+  int diff = player_index(city_owner(pcity1))
+             - player_index(city_owner(pcity2));
+
+  return diff != 0 ? diff : pcity1->id - pcity2->id;
+}
+
 /**********************************************************************//**
   Refresh the listed cities.
   Called after significant changes to borders, and arranging workers.
+
+  All the cities are refreshed before any of them gets its workers
+  arranged, as arranging takes tiles from the neighbours while a refresh
+  only looks at the city itself. The cities whose radius changed are then
+  arranged together, and the new city info goes out one player at a time.
 **************************************************************************/
 void city_refresh_queue_processing(void)
 {
-  if (NULL == city_refresh_queue) {
+  struct city_id_vector queue = city_refresh_queue;
+  struct city_list *arrange;
+  struct city **refreshed;
+  int count = 0, i;
+
+  if (city_id_vector_size(&queue) == 0) {
     return;
   }
 
-  city_list_iterate(city_refresh_queue, pcity) {
-    if (pcity->server.needs_refresh) {
+  /* Cities queued from here on wait for the next call. */
+  city_id_vector_init(&city_refresh_queue);
+
+  arrange = city_list_new();
+  refreshed = fc_malloc(city_id_vector_size(&queue) * sizeof(*refreshed));
+  TYPED_VECTOR_ITERATE(int, &queue, pid) {
+    struct city *pcity = game_city_by_number(*pid);
+
+    /* The city may be gone, or refreshed directly meanwhile. */
+    if (NULL != pcity && pcity->server.needs_refresh) {
       if (city_refresh(pcity)) {
-        auto_arrange_workers(pcity);
+        city_list_append(arrange, pcity);
       }
-      send_city_info(city_owner(pcity), pcity);
+      refreshed[count++] = pcity;
     }
-  } city_list_iterate_end;
+  } VECTOR_ITERATE_END;
+  city_id_vector_free(&queue);
+
+  auto_arrange_workers_list(arrange);
+  city_list_destroy(arrange);
+
+  qsort(refreshed, count, sizeof(*refreshed), city_refresh_owner_cmp);
+  for (i = 0; i < count; i++) {
+    struct player *pplayer = city_owner(refreshed[i]);
 
-  city_list_destroy(city_refresh_queue);
-  city_refresh_queue = NULL;
+    if (i == 0 || pplayer != city_owner(refreshed[i - 1])) {
+      conn_list_do_buffer(pplayer->connections);
+    }
+    send_city_info(pplayer, refreshed[i]);
+    if (i == count - 1 || pplayer != city_owner(refreshed[i + 1])) {
+      conn_list_do_unbuffer(pplayer->connections);
+    }
+  }
+  free(refreshed);
 }
 
 /**********************************************************************//**
@@ -299,6 +507,8 @@ void apply_cmresult_to_city(struct city *pcity,
   specialist_type_iterate(sp) {
     pcity->specialists[sp] = cmr->specialists[sp];
   } specialist_type_iterate_end;
+
+  city_refresh_mark(pcity, CITY_REFRESH_PRODUCTION);
 }
 
 /**********************************************************************//**
@@ -350,25 +560,17 @@ static void set_default_city_manager(struct cm_parameter *cmp,
 }
 
 /**********************************************************************//**
-  Call sync_cities() to send the affected cities to the clients.
+  Get the city ready for the citizen governor query: update its tiles,
+  refresh it and set up the parameter and the result of the job.
 **************************************************************************/
-void auto_arrange_workers(struct city *pcity)
+static void arrange_workers_prepare(struct arrange_job *job)
 {
-  struct cm_parameter cmp;
-  struct cm_result *cmr;
-  bool broadcast_needed;
+  struct city *pcity = job->pcity;
 
-  /* See comment in freeze_workers(): we can't rearrange while
-   * workers are frozen (i.e. multiple updates need to be done). */
-  if (pcity->server.workers_frozen > 0) {
-    if (pcity->server.needs_arrange == CNA_NOT) {
-      pcity->server.needs_arrange = CNA_NORMAL;
-    }
-    return;
-  }
-  TIMING_LOG(AIT_CITIZEN_ARRANGE, TIMER_START);
-
-  broadcast_needed = (pcity->server.needs_arrange == CNA_BROADCAST_PENDING);
+  job->broadcast_needed
+    = (pcity->server.needs_arrange == CNA_BROADCAST_PENDING);
+  job->param_failed = FALSE;
+  job->emergency = FALSE;
 
   /* Freeze the workers and make sure all the tiles around the city
    * are up to date.  Then thaw, but hackishly make sure that thaw
@@ -385,55 +587,83 @@ void auto_arrange_workers(struct city *pcity)
   city_refresh(pcity);
 
   sanity_check_city(pcity);
-  cm_clear_cache(pcity);
 
-  cm_init_parameter(&cmp);
+  cm_init_parameter(&job->cmp);
 
   if (pcity->cm_parameter) {
-    cm_copy_parameter(&cmp, pcity->cm_parameter);
+    cm_copy_parameter(&job->cmp, pcity->cm_parameter);
   } else {
-    set_default_city_manager(&cmp, pcity);
+    set_default_city_manager(&job->cmp, pcity);
   }
 
   /* This must be after city_refresh() so that the result gets created for the right
    * city radius */
-  cmr = cm_result_new(pcity);
-  cm_query_result(pcity, &cmp, cmr, FALSE);
+  job->cmr = cm_result_new(pcity);
+}
+
+/**********************************************************************//**
+  Query the citizen governor, relaxing the parameter until some result
+  is found. Touches nothing but the city itself, so this may run in
+  a worker thread.
+**************************************************************************/
+static void arrange_workers_query(struct arrange_job *job)
+{
+  struct city *pcity = job->pcity;
+  struct cm_parameter *cmp = &job->cmp;
+  struct cm_result *cmr = job->cmr;
+
+  cm_query_result(pcity, cmp, cmr, FALSE);
 
   if (!cmr->found_a_valid) {
-    if (pcity->cm_parameter) {
-      /* If player-defined parameters fail, cancel and notify player. */
-      free(pcity->cm_parameter);
-      pcity->cm_parameter = NULL;
+    /* If player-defined parameters fail, they get cancelled later. */
+    job->param_failed = (pcity->cm_parameter != NULL);
 
-      notify_player(city_owner(pcity), city_tile(pcity),
-                    E_CITY_CMA_RELEASE, ftc_server,
-                    _("The citizen governor can't fulfill the requirements "
-                     "for %s. Passing back control."),
-                    city_link(pcity));
-    }
     /* Drop surpluses and try again. */
-    cmp.minimal_surplus[O_FOOD] = 0;
-    cmp.minimal_surplus[O_SHIELD] = 0;
-    cmp.minimal_surplus[O_GOLD] = -FC_INFINITY;
-    cm_query_result(pcity, &cmp, cmr, FALSE);
+    cmp->minimal_surplus[O_FOOD] = 0;
+    cmp->minimal_surplus[O_SHIELD] = 0;
+    cmp->minimal_surplus[O_GOLD] = -FC_INFINITY;
+    cm_query_result(pcity, cmp, cmr, FALSE);
   }
   if (!cmr->found_a_valid) {
     /* Emergency management.  Get _some_ result.  This doesn't use
      * cm_init_emergency_parameter so we can keep the factors from
      * above. */
     output_type_iterate(o) {
-      cmp.minimal_surplus[o] = MIN(cmp.minimal_surplus[o],
-				   MIN(pcity->surplus[o], 0));
+      cmp->minimal_surplus[o] = MIN(cmp->minimal_surplus[o],
+                                    MIN(pcity->surplus[o], 0));
     } output_type_iterate_end;
-    cmp.require_happy = FALSE;
-    cmp.allow_disorder = is_ai(city_owner(pcity)) ? FALSE : TRUE;
-    cm_query_result(pcity, &cmp, cmr, FALSE);
+    cmp->require_happy = FALSE;
+    cmp->allow_disorder = is_ai(city_owner(pcity)) ? FALSE : TRUE;
+    cm_query_result(pcity, cmp, cmr, FALSE);
   }
   if (!cmr->found_a_valid) {
+    job->emergency = TRUE;
+    cm_init_emergency_parameter(cmp);
+    cm_query_result(pcity, cmp, cmr, TRUE);
+  }
+}
+
+/**********************************************************************//**
+  Apply the result of the query to the city and tell about it.
+**************************************************************************/
+static void arrange_workers_finish(struct arrange_job *job)
+{
+  struct city *pcity = job->pcity;
+  struct cm_result *cmr = job->cmr;
+
+  if (job->param_failed) {
+    /* If player-defined parameters fail, cancel and notify player. */
+    free(pcity->cm_parameter);
+    pcity->cm_parameter = NULL;
+
+    notify_player(city_owner(pcity), city_tile(pcity),
+                  E_CITY_CMA_RELEASE, ftc_server,
+                  _("The citizen governor can't fulfill the requirements "
+                    "for %s. Passing back control."),
+                  city_link(pcity));
+  }
+  if (job->emergency) {
     CITY_LOG(LOG_DEBUG, pcity, "emergency management");
-    cm_init_emergency_parameter(&cmp);
-    cm_query_result(pcity, &cmp, cmr, TRUE);
   }
   fc_assert_ret(cmr->found_a_valid);
 
@@ -453,14 +683,213 @@ void auto_arrange_workers(struct city *pcity)
   }
   sanity_check_city(pcity);
 
-  if (broadcast_needed) {
+  if (job->broadcast_needed) {
     broadcast_city_info(pcity);
   }
 
   cm_result_destroy(cmr);
+  job->cmr = NULL;
+}
+
+/**********************************************************************//**
+  Call sync_cities() to send the affected cities to the clients.
+**************************************************************************/
+void auto_arrange_workers(struct city *pcity)
+{
+  struct arrange_job job;
+
+  /* See comment in freeze_workers(): we can't rearrange while
+   * workers are frozen (i.e. multiple updates need to be done). */
+  if (pcity->server.workers_frozen > 0) {
+    if (pcity->server.needs_arrange == CNA_NOT) {
+      pcity->server.needs_arrange = CNA_NORMAL;
+    }
+    return;
+  }
+  TIMING_LOG(AIT_CITIZEN_ARRANGE, TIMER_START);
+
+  job.pcity = pcity;
+  arrange_workers_prepare(&job);
+  arrange_workers_query(&job);
+  arrange_workers_finish(&job);
+
   TIMING_LOG(AIT_CITIZEN_ARRANGE, TIMER_STOP);
 }
 
+/**********************************************************************//**
+  Whether the city can be queried at the same time with the other cities
+  of the batch. With the simple trade revenue style, the query reads the
+  trade of the trade partners, which may be changing in other threads.
+**************************************************************************/
+static bool arrange_workers_independent(const struct city *pcity,
+                                        const struct city_list *cities)
+{
+  if (game.info.trade_revenue_style != TRS_SIMPLE) {
+    return TRUE;
+  }
+
+  trade_partners_iterate(pcity, partner) {
+    if (city_list_search(cities, partner)) {
+      return FALSE;
+    }
+  } trade_partners_iterate_end;
+
+  return TRUE;
+}
+
+/**********************************************************************//**
+  Whether the result still fits the city, i.e. all the tiles it wants
+  to work are either free or already worked by the city.
+**************************************************************************/
+static bool arrange_workers_result_fits(const struct city *pcity,
+                                        const struct cm_result *cmr)
+{
+  if (cmr->city_radius_sq != city_map_radius_sq_get(pcity)) {
+    return FALSE;
+  }
+
+  city_tile_iterate_skip_free_worked(cmr->city_radius_sq,
+                                     city_tile(pcity), ptile, idx, x, y) {
+    if (cmr->worker_positions[idx]) {
+      const struct city *pwork = tile_worked(ptile);
+
+      if (NULL == pwork ? !city_can_work_tile(pcity, ptile)
+                        : pwork != pcity) {
+        return FALSE;
+      }
+    }
+  } city_tile_iterate_skip_free_worked_end;
+
+  return TRUE;
+}
+
+/**********************************************************************//**
+  Task of auto_arrange_workers_list(): solve one of the queries.
+**************************************************************************/
+static void arrange_workers_task(int index, void *arg)
+{
+  struct arrange_job **jobs = (struct arrange_job **) arg;
+
+  arrange_workers_query(jobs[index]);
+}
+
+/**********************************************************************//**
+  Arrange the workers of all the listed cities. With the 'cmthreads'
+  server setting the citizen governor queries of the cities are solved
+  concurrently against the same map. The results are then applied in the
+  order of the list; a city whose result wants a tile that got taken
+  meanwhile is arranged again from scratch, so the outcome does not
+  depend on the thread timing.
+**************************************************************************/
+void auto_arrange_workers_list(struct city_list *cities)
+{
+  struct arrange_job *jobs;
+  struct arrange_job **parallel;
+  int count, nparallel, i;
+
+  count = city_list_size(cities);
+  if (game.server.cm_threads < 2 || count < 2) {
+    city_list_iterate(cities, pcity) {
+      auto_arrange_workers(pcity);
+    } city_list_iterate_end;
+    return;
+  }
+
+  TIMING_LOG(AIT_CITIZEN_ARRANGE, TIMER_START);
+  if (NULL == arrange_stats.timer) {
+    arrange_stats.timer = timer_new(TIMER_USER, TIMER_ACTIVE);
+  }
+  timer_start(arrange_stats.timer);
+
+  /* First pass: prepare every city in the main thread. */
+  jobs = fc_calloc(count, sizeof(*jobs));
+  parallel = fc_malloc(count * sizeof(*parallel));
+  nparallel = 0;
+  i = 0;
+  city_list_iterate(cities, pcity) {
+    struct arrange_job *job = &jobs[i++];
+
+    job->pcity = pcity;
+    if (pcity->server.workers_frozen > 0) {
+      /* Like in auto_arrange_workers() */
+      if (pcity->server.needs_arrange == CNA_NOT) {
+        pcity->server.needs_arrange = CNA_NORMAL;
+      }
+      continue;
+    }
+    arrange_workers_prepare(job);
+    if (arrange_workers_independent(pcity, cities)) {
+      job->parallel = TRUE;
+      parallel[nparallel++] = job;
+    }
+  } city_list_iterate_end;
+
+  /* Solve the independent queries on the pool. */
+  fc_parallel_for(nparallel, game.server.cm_threads, arrange_workers_task,
+                  parallel);
+
+  /* Second pass: apply the results in the list order. */
+  for (i = 0; i < count; i++) {
+    struct arrange_job *job = &jobs[i];
+
+    if (NULL == job->cmr) {
+      /* Frozen city */
+      continue;
+    }
+
+    if (!job->parallel) {
+      arrange_workers_query(job);
+      arrange_stats.serial++;
+    } else if (!arrange_workers_result_fits(job->pcity, job->cmr)) {
+      /* Some earlier city took a tile we wanted. Start over. */
+      bool broadcast_needed = job->broadcast_needed;
+
+      cm_result_destroy(job->cmr);
+      arrange_workers_prepare(job);
+      job->broadcast_needed = broadcast_needed;
+      arrange_workers_query(job);
+      arrange_stats.conflicts++;
+    } else {
+      arrange_stats.parallel++;
+    }
+    arrange_workers_finish(job);
+  }
+
+  free(parallel);
+  free(jobs);
+
+  timer_stop(arrange_stats.timer);
+  arrange_stats.batches++;
+  TIMING_LOG(AIT_CITIZEN_ARRANGE, TIMER_STOP);
+}
+
+/**********************************************************************//**
+  Log how the batched worker arrangement and the CM result cache did
+  during the turn, and start collecting again.
+**************************************************************************/
+void auto_arrange_workers_turn_report(void)
+{
+  int hits, misses;
+
+  if (arrange_stats.batches > 0) {
+    log_verbose("Citizen arrangement: %d batches, %d cities in parallel, "
+                "%d conflicts, %d dependent; %g seconds",
+                arrange_stats.batches, arrange_stats.parallel,
+                arrange_stats.conflicts, arrange_stats.serial,
+                timer_read_seconds(arrange_stats.timer));
+  }
+
+  cm_cache_stats_get(&hits, &misses);
+  if (hits + misses > 0) {
+    log_verbose("CM result cache: %d hits, %d misses (%d%% hit rate)",
+                hits, misses, hits * 100 / (hits + misses));
+  }
+  cm_cache_stats_reset();
+
+  timer_destroy(arrange_stats.timer);
+  memset(&arrange_stats, 0, sizeof(arrange_stats));
+}
+
 /**********************************************************************//**
   Notices about cities that should be sent to all players.
 **************************************************************************/
@@ -589,7 +1018,7 @@ void update_city_activities(struct player *pplayer)
   pplayer->server.bulbs_last_turn = 0;
 
   if (n > 0) {
-    struct city *cities[n];
+    struct city_activity cities[n];
     int i = 0, r;
 
     city_list_iterate(pplayer->cities, pcity) {
@@ -627,9 +1056,17 @@ void update_city_activities(struct player *pplayer)
       } trade_routes_iterate_safe_end;
 
       /* Add cities to array for later random order handling */
-      cities[i++] = pcity;
+      cities[i].pcity = pcity;
+      cities[i].refreshed = FALSE;
+      i++;
     } city_list_iterate_end;
 
+    if (game.server.city_threads >= 2) {
+      TIMING_SPAN_BEGIN("city_refresh_activities");
+      city_refresh_activities(cities, i);
+      TIMING_SPAN_END("city_refresh_activities");
+    }
+
     /* How gold upkeep is handled depends on the setting
      * 'game.info.gold_upkeep_style':
      * GOLD_UPKEEP_CITY: Each city tries to balance its upkeep individually
@@ -644,9 +1081,11 @@ void update_city_activities(struct player *pplayer)
     /* Iterate over cities in a random order. */
     while (i > 0) {
       r = fc_rand(i);
-      /* update unit upkeep */
-      city_units_upkeep(cities[r]);
-      update_city_activity(cities[r]);
+      if (!cities[r].refreshed) {
+        /* update unit upkeep */
+        city_units_upkeep(cities[r].pcity);
+      }
+      update_city_activity(&cities[r]);
       cities[r] = cities[--i];
     }
 
@@ -3059,10 +3498,10 @@ int city_incite_cost(struct player *pplayer, struct city *pcity)
   /* Gold factor */
   cost = city_owner(pcity)->economic.gold + game.server.base_incite_cost;
 
-  unit_list_iterate(pcity->tile->units, punit) {
+  unit_stack_iterate(pcity->tile->units, punit) {
     cost += (unit_build_shield_cost(pcity, punit)
 	     * game.server.incite_unit_factor);
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   /* Buildings */
   city_built_iterate(pcity, pimprove) {
@@ -3172,8 +3611,9 @@ void nullify_prechange_production(struct city *pcity)
 /**********************************************************************//**
   Called every turn, at end of turn, for every city.
 **************************************************************************/
-static void update_city_activity(struct city *pcity)
+static void update_city_activity(struct city_activity *act)
 {
+  struct city *pcity = act->pcity;
   struct player *pplayer;
   struct government *gov;
   bool is_happy;
@@ -3185,11 +3625,18 @@ static void update_city_activity(struct city *pcity)
 
   pplayer = city_owner(pcity);
   gov = government_of_city(pcity);
-  is_happy = city_happy(pcity);
-  is_celebrating = city_celebrating(pcity);
 
-  if (city_refresh(pcity)) {
-    auto_arrange_workers(pcity);
+  if (act->refreshed) {
+    /* See city_refresh_activities() */
+    is_happy = act->is_happy;
+    is_celebrating = act->is_celebrating;
+  } else {
+    is_happy = city_happy(pcity);
+    is_celebrating = city_celebrating(pcity);
+
+    if (city_refresh(pcity)) {
+      auto_arrange_workers(pcity);
+    }
   }
 
   /* Reporting of celebrations rewritten, copying the treatment of disorder below,
@@ -3791,7 +4238,9 @@ static bool do_city_migration(struct city *pcity_from,
 **************************************************************************/
 bool check_city_migrations(void)
 {
+  struct mgr_near near;
   bool internat = FALSE;
+  int i;
 
   if (!game.server.migration) {
     return FALSE;
@@ -3803,17 +4252,45 @@ bool check_city_migrations(void)
     return FALSE;
   }
 
+  for (i = 0; i < ARRAY_SIZE(near.rank); i++) {
+    near.rank[i] = -1;
+  }
+  for (i = 0; i < wld.map.num_iterate_outwards_indices; i++) {
+    const struct iter_index *pindex = &wld.map.iterate_outwards_indices[i];
+
+    if (pindex->dist > MGR_MAX_DIST) {
+      break;
+    }
+    if (abs(pindex->dx) <= MGR_MAX_DIST && abs(pindex->dy) <= MGR_MAX_DIST) {
+      near.rank[(pindex->dy + MGR_MAX_DIST) * MGR_RANK_SIDE
+                + pindex->dx + MGR_MAX_DIST] = i;
+    }
+  }
+
+  /* On a small wrapping map iterate_outward() can reach a tile from more
+   * than one direction; only the plain walk repeats that. */
+  near.use_grid
+    = !((current_topo_has_flag(TF_WRAPX)
+         && wld.map.xsize < 4 * MGR_MAX_DIST + 4)
+        || (current_topo_has_flag(TF_WRAPY)
+            && wld.map.ysize < 4 * MGR_MAX_DIST + 4));
+  near.cities = NULL;
+  near.count = 0;
+  near.size = 0;
+
   /* check for migration */
   players_iterate(pplayer) {
     if (!pplayer->cities) {
       continue;
     }
 
-    if (check_city_migrations_player(pplayer)) {
+    if (check_city_migrations_player(pplayer, &near)) {
       internat = TRUE;
     }
   } players_iterate_end;
 
+  free(near.cities);
+
   return internat;
 }
 
@@ -3979,6 +4456,83 @@ void check_disasters(void)
   } players_iterate_end;
 }
 
+/**********************************************************************//**
+  Compare the iterate_outward() positions of two migration candidates.
+**************************************************************************/
+static int mgr_city_cmp(const void *a, const void *b)
+{
+  return ((const struct mgr_city *) a)->rank
+         - ((const struct mgr_city *) b)->rank;
+}
+
+/**********************************************************************//**
+  Add a city to the migration candidates.
+**************************************************************************/
+static void mgr_near_add(struct mgr_near *near, struct city *pcity, int rank)
+{
+  if (near->count == near->size) {
+    near->size = MAX(16, 2 * near->size);
+    near->cities = fc_realloc(near->cities,
+                              near->size * sizeof(*near->cities));
+  }
+  near->cities[near->count].pcity = pcity;
+  near->cities[near->count].rank = rank;
+  near->count++;
+}
+
+/**********************************************************************//**
+  Collect the other cities within the maximal migration distance of the
+  city, in the order iterate_outward() reaches their tiles.  The city
+  grid gives the nearby cities without looking at every tile.
+**************************************************************************/
+static void mgr_near_collect(struct mgr_near *near, const struct city *pcity)
+{
+  struct city_list *cells[CITY_GRID_MAX_NEAR];
+  int ncells = -1, i;
+
+  near->count = 0;
+
+  if (near->use_grid) {
+    ncells = city_grid_near(&wld, city_tile(pcity), MGR_MAX_DIST,
+                            cells, ARRAY_SIZE(cells));
+  }
+
+  if (ncells < 0) {
+    /* consider all cities within the maximal possible distance
+     * (= CITY_MAP_MAX_RADIUS + GAME_MAX_MGR_DISTANCE) */
+    iterate_outward(&(wld.map), city_tile(pcity), MGR_MAX_DIST, ptile) {
+      struct city *acity = tile_city(ptile);
+
+      if (acity != NULL && acity != pcity) {
+        mgr_near_add(near, acity, near->count);
+      }
+    } iterate_outward_end;
+    return;
+  }
+
+  for (i = 0; i < ncells; i++) {
+    city_list_iterate(cells[i], acity) {
+      int dx, dy, rank;
+
+      if (acity == pcity) {
+        continue;
+      }
+
+      map_distance_vector(&dx, &dy, city_tile(pcity), city_tile(acity));
+      if (abs(dx) > MGR_MAX_DIST || abs(dy) > MGR_MAX_DIST) {
+        continue;
+      }
+      rank = near->rank[(dy + MGR_MAX_DIST) * MGR_RANK_SIDE
+                        + dx + MGR_MAX_DIST];
+      if (rank >= 0) {
+        mgr_near_add(near, acity, rank);
+      }
+    } city_list_iterate_end;
+  }
+
+  qsort(near->cities, near->count, sizeof(*near->cities), mgr_city_cmp);
+}
+
 /**********************************************************************//**
   Check for migration for each city of one player.
 
@@ -3987,13 +4541,14 @@ void check_disasters(void)
   * if a city is found check the distance
   * compare the migration score
 **************************************************************************/
-static bool check_city_migrations_player(const struct player *pplayer)
+static bool check_city_migrations_player(const struct player *pplayer,
+                                         struct mgr_near *near)
 {
   char city_link_text[MAX_LEN_LINK];
   float best_city_player_score, best_city_world_score;
   struct city *best_city_player, *best_city_world, *acity;
   float score_from, score_tmp, weight;
-  int dist, mgr_dist;
+  int dist, mgr_dist, i;
   bool internat = FALSE;
 
   /* check for each city
@@ -4027,16 +4582,9 @@ static bool check_city_migrations_player(const struct player *pplayer)
               game.info.turn, city_name_get(pcity), score_from,
               player_name(pplayer));
 
-    /* consider all cities within the maximal possible distance
-     * (= CITY_MAP_MAX_RADIUS + GAME_MAX_MGR_DISTANCE) */
-    iterate_outward(&(wld.map), city_tile(pcity),
-                    CITY_MAP_MAX_RADIUS + GAME_MAX_MGR_DISTANCE, ptile) {
-      acity = tile_city(ptile);
-
-      if (!acity || acity == pcity) {
-        /* no city or the city in the center */
-        continue;
-      }
+    mgr_near_collect(near, pcity);
+    for (i = 0; i < near->count; i++) {
+      acity = near->cities[i].pcity;
 
       /* Calculate the migration distance. The value of
        * game.server.mgr_distance is added to the current city radius. If the
@@ -4096,7 +4644,7 @@ static bool check_city_migrations_player(const struct player *pplayer)
                     best_city_world_score, score_from);
         }
       }
-    } iterate_outward_end;
+    }
 
     if (best_city_player_score > 0) {
       /* first, do the migration within one nation */
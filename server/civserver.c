@@ -224,6 +224,8 @@ int main(int argc, char *argv[])
 #endif /* FREECIV_NDEBUG */
     } else if ((option = get_option_malloc("--Ranklog", argv, &inx, argc, TRUE))) {
       srvarg.ranklog_filename = option;
+    } else if ((option = get_option_malloc("--Timing", argv, &inx, argc, TRUE))) {
+      srvarg.timing_filename = option;
     } else if (is_option("--keep", argv[inx])) {
       srvarg.metaconnection_persistent = TRUE;
       /* Implies --meta */
@@ -268,6 +270,16 @@ int main(int argc, char *argv[])
       free(option);
     } else if (is_option("--exit-on-end", argv[inx])) {
       srvarg.exit_on_end = TRUE;
+    } else if ((option = get_option_malloc("--benchmark", argv, &inx, argc, FALSE))) {
+      if (!str_to_int(option, &srvarg.benchmark_turns)
+          || srvarg.benchmark_turns <= 0) {
+        showhelp = TRUE;
+        break;
+      }
+      free(option);
+      srvarg.exit_on_end = TRUE;
+    } else if (is_option("--count-memory", argv[inx])) {
+      srvarg.count_memory = TRUE;
     } else if ((option = get_option_malloc("--debug", argv, &inx, argc, FALSE))) {
       if (!log_parse_level_str(option, &srvarg.loglevel)) {
         showhelp = TRUE;
@@ -364,6 +376,14 @@ int main(int argc, char *argv[])
                 _("Listen for clients on ADDR"));
     cmdhelp_add(help, "B", "Bind-meta ADDR",
                 _("Connect to metaserver from this address"));
+    cmdhelp_add(help, NULL,
+                /* TRANS: "benchmark" is exactly what user must type, do not translate. */
+                _("benchmark TURNS"),
+                _("Play TURNS turns with no clients, report the time they "
+                  "took and exit"));
+    cmdhelp_add(help, "c", "count-memory",
+                _("Count the memory held by the parts of the server, "
+                  "for the 'memory' command"));
 #ifdef FREECIV_DEBUG
     cmdhelp_add(help, "d",
                 /* TRANS: "debug" is exactly what user must type, do not translate. */
@@ -450,6 +470,11 @@ int main(int argc, char *argv[])
                 _("LoadAI MODULE"),
                 _("Load ai module MODULE. Can appear multiple times"));
 #endif /* AI_MODULES */
+    cmdhelp_add(help, "T",
+                /* TRANS: "Timing" is exactly what user must type, do not translate. */
+                _("Timing FILE"),
+                _("Write where the turns spend their time to FILE "
+                  "(CSV if it ends in .csv, else Chrome trace)"));
     cmdhelp_add(help, "v", "version",
                 _("Print the version number"));
     cmdhelp_add(help, "w", "warnings",
@@ -698,6 +698,19 @@ static struct command commands[] = {
    NULL, mapimg_help,
    CMD_ECHO_ADMINS, VCF_NONE, 50
   },
+  {"memory",	ALLOW_ADMIN,
+   /* no translatable parameters */
+   SYN_ORIG_("memory"),
+   N_("Show the memory held by the parts of the server."),
+   N_("Shows the memory now held by each part of the server that keeps "
+      "count of it, how many blocks that is, the most it has held at once "
+      "and how many blocks it has taken in all. The 'ai' part is the data "
+      "the AI keeps for players, cities and units, its settler caches and "
+      "the advisors' maps and tables. Smaller allocations made elsewhere "
+      "are not counted. Memory is only counted when the server was "
+      "started with --count-memory."), NULL,
+   CMD_ECHO_NONE, VCF_NONE, 0
+  },
   {"rfcstyle",	ALLOW_HACK,
    /* no translatable parameters */
    SYN_ORIG_("rfcstyle"),
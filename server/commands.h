@@ -96,6 +96,7 @@ enum command_id {
   CMD_AICMD,
   CMD_FCDB,
   CMD_MAPIMG,
+  CMD_MEMORY,
 
   /* undocumented */
   CMD_RFCSTYLE,
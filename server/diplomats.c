@@ -364,13 +364,13 @@ bool diplomat_investigate(struct player *pplayer, struct unit *pdiplomat,
      * something (e.g. investigating twice). */
     lsend_packet_unit_short_info(pplayer->connections, &unit_packet, TRUE);
   } unit_list_iterate_end;
-  unit_list_iterate((pcity->tile)->units, punit) {
+  unit_stack_iterate((pcity->tile)->units, punit) {
     package_short_unit(punit, &unit_packet,
                        UNIT_INFO_CITY_PRESENT, pcity->id);
     /* We need to force to send the packet to ensure the client will receive
      * something (e.g. investigating twice). */
     lsend_packet_unit_short_info(pplayer->connections, &unit_packet, TRUE);
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
   /* Send city info to investigator's player.
      As this is a special case we bypass send_city_info. */
   routes = traderoute_packet_list_new();
@@ -714,7 +714,7 @@ bool diplomat_bribe(struct player *pplayer, struct unit *pdiplomat,
    * it no longer can share a tile with. */
   pcity = tile_city(unit_tile(pvictim));
   bounce = ((NULL != pcity && !pplayers_allied(city_owner(pcity), pplayer))
-            || 1 < unit_list_size(unit_tile(pvictim)->units));
+            || 1 < unit_stack_size(unit_tile(pvictim)->units));
   if (bounce) {
     bounce_unit(pvictim, TRUE);
   }
@@ -2305,11 +2305,11 @@ int count_diplomats_on_tile(struct tile *ptile)
 {
   int count = 0;
 
-  unit_list_iterate((ptile)->units, punit) {
+  unit_stack_iterate((ptile)->units, punit) {
     if (unit_has_type_flag(punit, UTYF_DIPLOMAT)) {
       count++;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return count;
 }
@@ -548,7 +548,7 @@ void handle_edit_unit_remove(struct connection *pc, int owner,
   }
 
   i = 0;
-  unit_list_iterate_safe(ptile->units, punit) {
+  unit_stack_iterate_safe(ptile->units, punit) {
     if (i >= count) {
       break;
     }
@@ -558,7 +558,7 @@ void handle_edit_unit_remove(struct connection *pc, int owner,
     }
     wipe_unit(punit, ULR_EDITOR, NULL);
     i++;
-  } unit_list_iterate_safe_end;
+  } unit_stack_iterate_safe_end;
 }
 
 /************************************************************************//**
@@ -1209,13 +1209,13 @@ void handle_edit_player_vision(struct connection *pc, int plr_no,
         continue;
       }
 
-      unit_list_iterate(ptile->units, punit) {
+      unit_stack_iterate(ptile->units, punit) {
         if (unit_owner(punit) == pplayer
             || really_gives_vision(pplayer, unit_owner(punit))) {
           cannot_make_unknown = TRUE;
           break;
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
 
       if (cannot_make_unknown) {
         continue;
@@ -1225,11 +1225,11 @@ void handle_edit_player_vision(struct connection *pc, int plr_no,
        * contain no units (client/packhand.c +2368).
        * So here we tell it to remove units that do
        * not give it vision. */
-      unit_list_iterate(ptile->units, punit) {
+      unit_stack_iterate(ptile->units, punit) {
         conn_list_iterate(pplayer->connections, pconn) {
           dsend_packet_unit_remove(pconn, punit->id);
         } conn_list_iterate_end;
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     }
 
     if (known) {
@@ -1248,6 +1248,7 @@ void handle_edit_player_vision(struct connection *pc, int plr_no,
 ****************************************************************************/
 void handle_edit_recalculate_borders(struct connection *pc)
 {
+  map_borders_invalidate();
   map_calculate_borders();
 }
 
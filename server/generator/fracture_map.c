@@ -105,7 +105,7 @@ void make_fracture_map(void)
     x = fracture_points[nn].x;
     y = fracture_points[nn].y;
     ptile1 = native_pos_to_tile(&(wld.map), x, y);
-    ptile1->continent = nn + 1;
+    tile_set_continent(ptile1, nn + 1);
   }
 
   /* Assign a base elevation to the landmass */
@@ -223,15 +223,15 @@ static void fmfill(int x, int y, int c, int r)
     ptileX1Y1 = native_pos_to_tile(&(wld.map), x_less, y_less);
 
     if (ptileXY->continent == 0 ) {
-      ptileXY->continent = c;
-      ptileX2Y->continent = c;
-      ptileX1Y->continent = c;
-      ptileXY2->continent = c;
-      ptileXY1->continent = c;
-      ptileX2Y2->continent = c;
-      ptileX2Y1->continent = c;
-      ptileX1Y2->continent = c;
-      ptileX1Y1->continent = c;
+      tile_set_continent(ptileXY, c);
+      tile_set_continent(ptileX2Y, c);
+      tile_set_continent(ptileX1Y, c);
+      tile_set_continent(ptileXY2, c);
+      tile_set_continent(ptileXY1, c);
+      tile_set_continent(ptileX2Y2, c);
+      tile_set_continent(ptileX2Y1, c);
+      tile_set_continent(ptileX1Y2, c);
+      tile_set_continent(ptileX1Y1, c);
       hmap(ptileXY) = landmass[c-1].elevation;
       hmap(ptileX2Y) = landmass[c-1].elevation;
       hmap(ptileX1Y) = landmass[c-1].elevation;
@@ -2201,6 +2201,7 @@ static void initworld(struct gen234_state *pstate)
     tile_set_continent(ptile, 0);
     map_set_placed(ptile); /* not a land tile */
     BV_CLR_ALL(ptile->extras);
+    tile_dense_sync(ptile);
     tile_set_owner(ptile, NULL, NULL);
     ptile->extras_owner = NULL;
   } whole_map_iterate_end;
@@ -3453,6 +3454,7 @@ static bool map_generate_fair_islands(void)
     tile_set_terrain(ptile, deepest_ocean);
     tile_set_continent(ptile, 0);
     BV_CLR_ALL(ptile->extras);
+    tile_dense_sync(ptile);
     tile_set_owner(ptile, NULL, NULL);
     ptile->extras_owner = NULL;
   } whole_map_iterate_end;
@@ -3706,6 +3708,7 @@ static bool map_generate_fair_islands(void)
     fc_assert(pftile->pterrain != NULL);
     tile_set_terrain(ptile, pftile->pterrain);
     ptile->extras = pftile->extras;
+    tile_dense_sync(ptile);
     tile_set_resource(ptile, pftile->presource);
     if (pftile->flags & FTF_STARTPOS) {
       struct startpos *psp = map_startpos_new(ptile);
@@ -26,6 +26,9 @@
 #include "terrain.h"
 #include "tile.h"
 
+/* server */
+#include "maphand.h"
+
 #include "mapgen_utils.h"
 
 /**************************************************************************
@@ -242,6 +245,12 @@ static Continent_id *lake_surrounders = NULL;
 static int *continent_sizes = NULL;
 static int *ocean_sizes = NULL;
 
+/* The index of the first tile of each continent and ocean.  The numbers
+ * follow the order of these, which is the order of the map scan in
+ * assign_continent_numbers(). */
+static int *continent_first = NULL;
+static int *ocean_first = NULL;
+
 /**********************************************************************//**
   Calculate lake_surrounders[] array
 **************************************************************************/
@@ -279,15 +288,16 @@ static void recalculate_lake_surrounders(void)
 /**********************************************************************//**
   Number this tile and nearby tiles with the specified continent number 'nr'.
   Due to the number of recursion for large maps a non-recursive algorithm is
-  utilised.
+  utilised.  'queue' has room for the index of every tile of the map.
 
   is_land tells us whether we are assigning continent numbers or ocean 
   numbers.
 **************************************************************************/
-static void assign_continent_flood(struct tile *ptile, bool is_land, int nr)
+static void assign_continent_flood(struct tile *ptile, bool is_land, int nr,
+                                   int *queue)
 {
-  struct tile_list *tlist = NULL;
   const struct terrain *pterrain = NULL;
+  int head = 0, tail = 0;
 
   fc_assert_ret(ptile != NULL);
 
@@ -297,43 +307,35 @@ static void assign_continent_flood(struct tile *ptile, bool is_land, int nr)
                 && T_UNKNOWN != pterrain
                 && XOR(is_land, terrain_type_terrain_class(pterrain) == TC_OCEAN));
 
-  /* Create tile list and insert the initial tile. */
-  tlist = tile_list_new();
-  tile_list_append(tlist, ptile);
-
-  while (tile_list_size(tlist) > 0) {
-    /* Iterate over all unchecked tiles. */
-    tile_list_iterate(tlist, ptile2) {
-      /* Iterate over the adjacent tiles. */
-      adjc_iterate(&(wld.map), ptile2, ptile3) {
-        pterrain = tile_terrain(ptile3);
-
-        /* Check if it is a valid tile for continent / ocean. */
-        if (tile_continent(ptile3) != 0
-            || T_UNKNOWN == pterrain
-            || !XOR(is_land, terrain_type_terrain_class(pterrain) == TC_OCEAN)) {
-          continue;
-        }
+  /* Tiles are numbered when queued, so none is queued twice. */
+  tile_set_continent(ptile, nr);
+  queue[tail++] = tile_index(ptile);
 
-        /* Add the tile to the list of tiles to check. */
-        if (!tile_list_search(tlist, ptile3)) {
-          tile_list_append(tlist, ptile3);
-        }
-      } adjc_iterate_end;
+  while (head < tail) {
+    struct tile *ptile2 = index_to_tile(&(wld.map), queue[head++]);
 
-      /* Set the continent data and remove the tile from the list. */
-      tile_set_continent(ptile2, nr);
-      tile_list_remove(tlist, ptile2);
-      /* count the tile */
-      if (nr < 0) {
-        ocean_sizes[-nr]++;
-      } else {
-        continent_sizes[nr]++;
+    /* Iterate over the adjacent tiles. */
+    adjc_iterate(&(wld.map), ptile2, ptile3) {
+      pterrain = tile_terrain(ptile3);
+
+      /* Check if it is a valid tile for continent / ocean. */
+      if (tile_continent(ptile3) != 0
+          || T_UNKNOWN == pterrain
+          || !XOR(is_land, terrain_type_terrain_class(pterrain) == TC_OCEAN)) {
+        continue;
       }
-    } tile_list_iterate_end;
+
+      tile_set_continent(ptile3, nr);
+      queue[tail++] = tile_index(ptile3);
+    } adjc_iterate_end;
   }
 
-  tile_list_destroy(tlist);
+  /* count the tiles */
+  if (nr < 0) {
+    ocean_sizes[-nr] += tail;
+  } else {
+    continent_sizes[nr] += tail;
+  }
 }
 
 /**********************************************************************//**
@@ -446,6 +448,8 @@ int get_ocean_size(Continent_id id)
 **************************************************************************/
 void assign_continent_numbers(void)
 {
+  int *queue = fc_malloc(MAP_INDEX_SIZE * sizeof(*queue));
+
   /* Initialize */
   wld.map.num_continents = 0;
   wld.map.num_oceans = 0;
@@ -472,22 +476,204 @@ void assign_continent_numbers(void)
       continent_sizes = fc_realloc(continent_sizes,
                            (wld.map.num_continents + 1) * sizeof(*continent_sizes));
       continent_sizes[wld.map.num_continents] = 0;
-      assign_continent_flood(ptile, TRUE, wld.map.num_continents);
+      continent_first = fc_realloc(continent_first,
+                           (wld.map.num_continents + 1) * sizeof(*continent_first));
+      continent_first[wld.map.num_continents] = tile_index(ptile);
+      assign_continent_flood(ptile, TRUE, wld.map.num_continents, queue);
     } else {
       wld.map.num_oceans++;
       ocean_sizes = fc_realloc(ocean_sizes,
                        (wld.map.num_oceans + 1) * sizeof(*ocean_sizes));
       ocean_sizes[wld.map.num_oceans] = 0;
-      assign_continent_flood(ptile, FALSE, -wld.map.num_oceans);
+      ocean_first = fc_realloc(ocean_first,
+                       (wld.map.num_oceans + 1) * sizeof(*ocean_first));
+      ocean_first[wld.map.num_oceans] = tile_index(ptile);
+      assign_continent_flood(ptile, FALSE, -wld.map.num_oceans, queue);
     }
   } whole_map_iterate_end;
 
+  free(queue);
+
   recalculate_lake_surrounders();
 
+  /* Which tiles can be claimed depends on the continents. */
+  map_borders_invalidate();
+
   log_verbose("Map has %d continents and %d oceans", 
               wld.map.num_continents, wld.map.num_oceans);
 }
 
+/**********************************************************************//**
+  Returns whether the tiles are all connected to each other through
+  adjacent tiles of the list.  There are at most 8 of them.
+**************************************************************************/
+static bool tiles_connected(struct tile **tiles, int num_tiles)
+{
+  bool reached[8] = { FALSE, };
+  int queue[8];
+  int head = 0, tail = 0, i;
+
+  fc_assert_ret_val(num_tiles <= ARRAY_SIZE(reached), FALSE);
+
+  reached[0] = TRUE;
+  queue[tail++] = 0;
+  while (head < tail) {
+    struct tile *ptile = tiles[queue[head++]];
+
+    for (i = 0; i < num_tiles; i++) {
+      if (!reached[i] && is_tiles_adjacent(ptile, tiles[i])) {
+        reached[i] = TRUE;
+        queue[tail++] = i;
+      }
+    }
+  }
+
+  return tail == num_tiles;
+}
+
+/**********************************************************************//**
+  Try to renumber the single tile that changed between land and ocean
+  without looking at the rest of the map.  This works when the tile joins
+  exactly one continent (or ocean), leaves behind the rest of its old one
+  in one piece, and the order of the first tiles stays the same, so that
+  the numbers are the ones assign_continent_numbers() would give.  The
+  lake surrounders do not change then either.  Returns FALSE, changing
+  nothing, if this is not the case.
+**************************************************************************/
+static bool update_continent_tile(struct tile *ptile)
+{
+  const struct terrain *pterrain = tile_terrain(ptile);
+  Continent_id old_nr = tile_continent(ptile);
+  Continent_id new_nr = 0;
+  int index = tile_index(ptile);
+  struct tile *left[8];
+  int num_left = 0;
+  int *new_first, *old_first, *new_sizes, *old_sizes;
+  int new_count, old_count, old_new_first = index;
+  bool is_land;
+
+  if (T_UNKNOWN == pterrain || old_nr == 0) {
+    return FALSE;
+  }
+  is_land = (terrain_type_terrain_class(pterrain) != TC_OCEAN);
+  if (is_land == (old_nr > 0)) {
+    /* Still of the same class; not something to do locally. */
+    return FALSE;
+  }
+
+  adjc_iterate(&(wld.map), ptile, adjc_tile) {
+    Continent_id nr = tile_continent(adjc_tile);
+
+    if (nr == 0) {
+      continue;
+    }
+    if ((nr > 0) == is_land) {
+      if (new_nr != 0 && new_nr != nr) {
+        /* Joins several together. */
+        return FALSE;
+      }
+      new_nr = nr;
+    } else {
+      fc_assert_ret_val(num_left < ARRAY_SIZE(left), FALSE);
+      left[num_left++] = adjc_tile;
+    }
+  } adjc_iterate_end;
+
+  if (new_nr == 0 || num_left == 0
+      || !tiles_connected(left, num_left)) {
+    /* Makes a new one, removes one or splits one. */
+    return FALSE;
+  }
+
+  if (is_land) {
+    new_first = continent_first;
+    new_sizes = continent_sizes;
+    new_count = wld.map.num_continents;
+    old_first = ocean_first;
+    old_sizes = ocean_sizes;
+    old_count = wld.map.num_oceans;
+  } else {
+    new_first = ocean_first;
+    new_sizes = ocean_sizes;
+    new_count = wld.map.num_oceans;
+    old_first = continent_first;
+    old_sizes = continent_sizes;
+    old_count = wld.map.num_continents;
+  }
+  new_nr = ABS(new_nr);
+  old_nr = ABS(old_nr);
+
+  if (index < new_first[new_nr]
+      && new_nr > 1 && index < new_first[new_nr - 1]) {
+    /* Would come before the one numbered before it. */
+    return FALSE;
+  }
+  if (index == old_first[old_nr]) {
+    /* The next tile of the old one becomes its first. */
+    int i;
+
+    for (i = index + 1; i < MAP_INDEX_SIZE; i++) {
+      if (tile_continent(index_to_tile(&(wld.map), i))
+          == (is_land ? -old_nr : old_nr)) {
+        break;
+      }
+    }
+    fc_assert_ret_val(i < MAP_INDEX_SIZE, FALSE);
+    if (old_nr < old_count && i > old_first[old_nr + 1]) {
+      /* Would come after the one numbered after it. */
+      return FALSE;
+    }
+    old_new_first = i;
+  }
+  fc_assert_ret_val(new_nr <= new_count, FALSE);
+
+  tile_set_continent(ptile, is_land ? new_nr : -new_nr);
+  new_sizes[new_nr]++;
+  old_sizes[old_nr]--;
+  if (index < new_first[new_nr]) {
+    new_first[new_nr] = index;
+  }
+  if (index == old_first[old_nr]) {
+    old_first[old_nr] = old_new_first;
+  }
+
+  return TRUE;
+}
+
+/**********************************************************************//**
+  Update the continent and ocean numbers after the tile changed between
+  land and ocean, with the same result as assign_continent_numbers().
+  When only the tile gets a new number this does not go over the whole
+  map.  The tiles whose number changed are appended to 'changed'.
+  Returns TRUE if the numbers were updated that way, and FALSE if the
+  whole map was numbered again.
+**************************************************************************/
+bool update_continent_numbers(struct tile *ptile, struct tile_list *changed)
+{
+  Continent_id *old_nrs;
+
+  if (update_continent_tile(ptile)) {
+    tile_list_append(changed, ptile);
+    return TRUE;
+  }
+
+  old_nrs = fc_malloc(MAP_INDEX_SIZE * sizeof(*old_nrs));
+  whole_map_iterate(&(wld.map), atile) {
+    old_nrs[tile_index(atile)] = tile_continent(atile);
+  } whole_map_iterate_end;
+
+  assign_continent_numbers();
+
+  whole_map_iterate(&(wld.map), atile) {
+    if (old_nrs[tile_index(atile)] != tile_continent(atile)) {
+      tile_list_append(changed, atile);
+    }
+  } whole_map_iterate_end;
+  free(old_nrs);
+
+  return FALSE;
+}
+
 /**********************************************************************//**
   Return most shallow ocean terrain type. Prefers not to return freshwater
   terrain, and will ignore 'frozen' rather than do so.
@@ -668,6 +854,14 @@ void generator_free(void)
     free(ocean_sizes);
     ocean_sizes = NULL;
   }
+  if (continent_first != NULL) {
+    free(continent_first);
+    continent_first = NULL;
+  }
+  if (ocean_first != NULL) {
+    free(ocean_first);
+    ocean_first = NULL;
+  }
 }
 
 /**********************************************************************//**
@@ -22,6 +22,7 @@ void generator_free(void);
 void regenerate_lakes(void);
 void smooth_water_depth(void);
 void assign_continent_numbers(void);
+bool update_continent_numbers(struct tile *ptile, struct tile_list *changed);
 int get_lake_surrounders(Continent_id cont);
 int get_continent_size(Continent_id id);
 int get_ocean_size(Continent_id id);
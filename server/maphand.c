@@ -60,8 +60,56 @@
 /* Suppress send_tile_info() during game_load() */
 static bool send_tile_suppressed = FALSE;
 
-static void player_tile_init(struct tile *ptile, struct player *pplayer);
-static void player_tile_free(struct tile *ptile, struct player *pplayer);
+/* A border source as map_calculate_borders() last found it. */
+struct border_source {
+  struct tile *tile;
+  struct player *owner;
+  int radius_sq;
+  int max_radius_sq;        /* Largest radius it may have claimed in */
+  int strength;             /* tile_border_source_strength() */
+  int city_radius_sq;       /* Work radius of a city, -1 for a base */
+  bool claim_ocean;
+  bool claim_ocean_limited;
+  unsigned int pass;        /* Last pass that found the source */
+  unsigned int last_run;    /* Clock after its last claim in a pass */
+};
+
+static void border_source_destroy(struct border_source *psource);
+
+#define SPECHASH_TAG border_source
+#define SPECHASH_INT_KEY_TYPE
+#define SPECHASH_IDATA_TYPE struct border_source *
+#define SPECHASH_IDATA_FREE border_source_destroy
+#include "spechash.h"
+#define border_source_hash_data_iterate(phash, data)                        \
+  TYPED_HASH_DATA_ITERATE(struct border_source *, phash, data)
+#define border_source_hash_data_iterate_end HASH_DATA_ITERATE_END
+
+/* The state of the incremental border update.  Every tile remembers the
+ * clock when anything map_claim_border() looks at changed on it, and a
+ * source is only claimed again when a tile in its radius changed after
+ * its last claim. */
+static struct {
+  struct border_source_hash *sources;
+  unsigned int *tile_changed;
+  int num_tiles;
+  unsigned int clock;
+  unsigned int pass;
+  enum borders_mode mode;
+  bool in_pass;
+  int claims;               /* Tiles whose owner changed, for borderverify */
+} border_engine = { NULL, };
+
+/* Size of a player map chunk, for memory accounting */
+#define PLAYER_MAP_CHUNK_BYTES \
+  (PLAYER_MAP_CHUNK * (long) sizeof(struct player_tile))
+
+static void border_tile_changed(const struct tile *ptile);
+static int border_source_strength(struct tile *source);
+static int border_strength_at(struct tile *ptile, struct tile *source,
+                              int full_strength);
+static void player_tile_init(struct player_tile *plrtile);
+static void player_tile_free(struct player_tile *plrtile);
 static void give_tile_info_from_player_to_player(struct player *pfrom,
 						 struct player *pdest,
 						 struct tile *ptile);
@@ -69,6 +117,13 @@ static void shared_vision_change_seen(struct player *pplayer,
                                       struct tile *ptile,
                                       const v_radius_t change,
                                       bool can_reveal_tiles);
+static int vision_receivers(struct player *pplayer,
+                            struct player **receivers);
+static void receivers_change_seen(struct player **receivers,
+                                  int num_receivers,
+                                  struct tile *ptile,
+                                  const v_radius_t change,
+                                  bool can_reveal_tiles);
 static void map_change_seen(struct player *pplayer,
                             struct tile *ptile,
                             const v_radius_t change,
@@ -203,7 +258,7 @@ void climate_change(bool warming, int effect)
          after the terrain change has taken place, as the activity itself is still
          legal, but would be towards different terrain, and terrain types are not
          activity targets (target is NULL) */
-      unit_list_iterate(ptile->units, punit) {
+      unit_stack_iterate(ptile->units, punit) {
         if (punit->activity_target == NULL) {
           /* Target is always NULL for terrain changing activities. */
           if (punit->activity == ACTIVITY_CULTIVATE
@@ -212,7 +267,7 @@ void climate_change(bool warming, int effect)
             unit_activity_handling(punit, ACTIVITY_IDLE);
           }
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
 
       /* Really change the terrain. */
       tile_change_terrain(ptile, new);
@@ -220,11 +275,11 @@ void climate_change(bool warming, int effect)
       update_tile_knowledge(ptile);
 
       /* Check the unit activities. */
-      unit_list_iterate(ptile->units, punit) {
+      unit_stack_iterate(ptile->units, punit) {
         if (!can_unit_continue_current_activity(punit)) {
           unit_activity_handling(punit, ACTIVITY_IDLE);
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     } else if (old == new) {
       /* This counts toward a climate change although nothing is changed. */
       effect--;
@@ -544,7 +599,7 @@ void send_tile_info(struct conn_list *dest, struct tile *ptile,
                          : 0;
 
       if (pplayer != NULL) {
-	info.extras = map_get_player_tile(ptile, pplayer)->extras;
+	info.extras = map_get_player_tile_const(ptile, pplayer)->extras;
       } else {
 	info.extras = ptile->extras;
       }
@@ -558,26 +613,29 @@ void send_tile_info(struct conn_list *dest, struct tile *ptile,
 
       send_packet_tile_info(pconn, &info);
     } else if (pplayer && map_is_known(ptile, pplayer)) {
-      struct player_tile *plrtile = map_get_player_tile(ptile, pplayer);
+      const struct player_tile *plrtile
+        = map_get_player_tile_const(ptile, pplayer);
       struct vision_site *psite = map_get_player_site(ptile, pplayer);
+      struct terrain *pterrain = player_tile_terrain(plrtile);
+      struct extra_type *presource = player_tile_resource(plrtile);
 
       info.known = TILE_KNOWN_UNSEEN;
       info.continent = tile_continent(ptile);
       owner = (game.server.foggedborders
-               ? plrtile->owner
+               ? player_tile_owner(plrtile)
                : tile_owner(ptile));
-      eowner = plrtile->extras_owner;
+      eowner = player_tile_extras_owner(plrtile);
       info.owner = (owner ? player_number(owner) : MAP_TILE_OWNER_NULL);
       info.extras_owner = (eowner ? player_number(eowner) : MAP_TILE_OWNER_NULL);
       info.worked = (NULL != psite)
                     ? psite->identity
                     : IDENTITY_NUMBER_ZERO;
 
-      info.terrain = (NULL != plrtile->terrain)
-                      ? terrain_number(plrtile->terrain)
+      info.terrain = (NULL != pterrain)
+                      ? terrain_number(pterrain)
                       : terrain_count();
-      info.resource = (NULL != plrtile->resource)
-                       ? extra_number(plrtile->resource)
+      info.resource = (NULL != presource)
+                       ? extra_number(presource)
                        : MAX_EXTRA_TYPES;
       info.placing = -1;
       info.place_turn = 0;
@@ -637,6 +695,83 @@ void send_map_info(struct conn_list *dest)
   lsend_packet_map_info(dest, &minfo);
 }
 
+/**********************************************************************//**
+  Fill 'receivers' with the players a vision change of pplayer reaches:
+  pplayer itself first, then everyone it really gives shared vision to.
+  Returns their number.
+**************************************************************************/
+static int vision_receivers(struct player *pplayer,
+                            struct player **receivers)
+{
+  int num_receivers = 0;
+
+  receivers[num_receivers++] = pplayer;
+  players_iterate(pplayer2) {
+    if (really_gives_vision(pplayer, pplayer2)) {
+      receivers[num_receivers++] = pplayer2;
+    }
+  } players_iterate_end;
+
+  return num_receivers;
+}
+
+/**********************************************************************//**
+  Returns TRUE iff changing the seen counts of the player tile by 'change'
+  neither fogs, unfogs nor reveals anything, so that map_change_seen()
+  would do nothing but update the counts.
+**************************************************************************/
+static inline bool map_change_seen_is_quiet(const struct player *pplayer,
+                                            const struct tile *ptile,
+                                            const struct player_tile *plrtile,
+                                            const v_radius_t change,
+                                            bool can_reveal_tiles)
+{
+  vision_layer_iterate(v) {
+    /* When the fog of war is disabled, V_MAIN has an extra seen count
+     * point. */
+    int unseen = (V_MAIN == v ? !game.info.fogofwar : 0);
+
+    if ((0 > change[v] && plrtile->seen_count[v] + change[v] <= 0)
+        || (0 < change[v] && plrtile->seen_count[v] <= unseen)) {
+      return FALSE;
+    }
+  } vision_layer_iterate_end;
+
+  return (!can_reveal_tiles
+          || 0 >= plrtile->seen_count[V_MAIN] + change[V_MAIN]
+          || map_is_known(ptile, pplayer));
+}
+
+/**********************************************************************//**
+  Change the seen count of a tile for the players returned by
+  vision_receivers(), the first of them being the source of the vision.
+  Only where something gets fogged, unfogged or revealed this goes
+  through map_change_seen(); elsewhere the counts are updated in place.
+**************************************************************************/
+static void receivers_change_seen(struct player **receivers,
+                                  int num_receivers,
+                                  struct tile *ptile,
+                                  const v_radius_t change,
+                                  bool can_reveal_tiles)
+{
+  int i;
+
+  map_change_own_seen(receivers[0], ptile, change);
+
+  for (i = 0; i < num_receivers; i++) {
+    struct player_tile *plrtile = map_get_player_tile(ptile, receivers[i]);
+
+    if (map_change_seen_is_quiet(receivers[i], ptile, plrtile, change,
+                                 can_reveal_tiles)) {
+      vision_layer_iterate(v) {
+        plrtile->seen_count[v] += change[v];
+      } vision_layer_iterate_end;
+    } else {
+      map_change_seen(receivers[i], ptile, change, can_reveal_tiles);
+    }
+  }
+}
+
 /**********************************************************************//**
   Change the seen count of a tile for a pplayer. It will automatically
   handle the shared visions.
@@ -646,26 +781,29 @@ static void shared_vision_change_seen(struct player *pplayer,
                                       const v_radius_t change,
                                       bool can_reveal_tiles)
 {
-  map_change_own_seen(pplayer, ptile, change);
-  map_change_seen(pplayer, ptile, change, can_reveal_tiles);
+  struct player *receivers[MAX_NUM_PLAYER_SLOTS];
+  int num_receivers = vision_receivers(pplayer, receivers);
 
-  players_iterate(pplayer2) {
-    if (really_gives_vision(pplayer, pplayer2)) {
-      map_change_seen(pplayer2, ptile, change, can_reveal_tiles);
-    }
-  } players_iterate_end;
+  receivers_change_seen(receivers, num_receivers, ptile, change,
+                        can_reveal_tiles);
 }
 
 /**********************************************************************//**
-  There doesn't have to be a city.
+  Change the vision of pplayer around ptile from old_radius_sq to
+  new_radius_sq.  There doesn't have to be a city.
+
+  The players who get the vision are looked up once, the tiles whose
+  seen counts do not change at all are skipped, and the packets of each
+  player are buffered until the whole area is done.
 **************************************************************************/
 void map_vision_update(struct player *pplayer, struct tile *ptile,
                        const v_radius_t old_radius_sq,
                        const v_radius_t new_radius_sq,
                        bool can_reveal_tiles)
 {
+  struct player *receivers[MAX_NUM_PLAYER_SLOTS];
   v_radius_t change;
-  int max_radius;
+  int max_radius, num_receivers;
 
   if (old_radius_sq[V_MAIN] == new_radius_sq[V_MAIN]
       && old_radius_sq[V_INVIS] == new_radius_sq[V_INVIS]
@@ -693,18 +831,28 @@ void map_vision_update(struct player *pplayer, struct tile *ptile,
   } vision_layer_iterate_end;
 #endif /* FREECIV_DEBUG */
 
+  num_receivers = vision_receivers(pplayer, receivers);
+
   buffer_shared_vision(pplayer);
   circle_dxyr_iterate(&(wld.map), ptile, max_radius, tile1, dx, dy, dr) {
+    bool changed = FALSE;
+
     vision_layer_iterate(v) {
       if (dr > old_radius_sq[v] && dr <= new_radius_sq[v]) {
         change[v] = 1;
+        changed = TRUE;
       } else if (dr > new_radius_sq[v] && dr <= old_radius_sq[v]) {
         change[v] = -1;
+        changed = TRUE;
       } else {
         change[v] = 0;
       }
     } vision_layer_iterate_end;
-    shared_vision_change_seen(pplayer, tile1, change, can_reveal_tiles);
+
+    if (changed) {
+      receivers_change_seen(receivers, num_receivers, tile1, change,
+                            can_reveal_tiles);
+    }
   } circle_dxyr_iterate_end;
   unbuffer_shared_vision(pplayer);
 }
@@ -718,6 +866,8 @@ void map_set_border_vision(struct player *pplayer,
                            const bool is_enabled)
 {
   const v_radius_t radius_sq = V_RADIUS(is_enabled ? 1 : -1, 0, 0);
+  struct player *receivers[MAX_NUM_PLAYER_SLOTS];
+  int num_receivers;
 
   if (pplayer->server.border_vision == is_enabled) {
     /* No change. Changing the seen count beyond what already exists would
@@ -728,10 +878,12 @@ void map_set_border_vision(struct player *pplayer,
   /* Set the new border seer value. */
   pplayer->server.border_vision = is_enabled;
 
+  num_receivers = vision_receivers(pplayer, receivers);
   whole_map_iterate(&(wld.map), ptile) {
     if (pplayer == ptile->owner) {
       /* The tile is within the player's borders. */
-      shared_vision_change_seen(pplayer, ptile, radius_sq, TRUE);
+      receivers_change_seen(receivers, num_receivers, ptile, radius_sq,
+                            TRUE);
     }
   } whole_map_iterate_end;
 }
@@ -775,11 +927,11 @@ void map_show_tile(struct player *src_player, struct tile *ptile)
 
         vision_layer_iterate(v) {
           if (0 < map_get_seen(pplayer, ptile, v)) {
-            unit_list_iterate(ptile->units, punit) {
+            unit_stack_iterate(ptile->units, punit) {
               if (unit_is_visible_on_layer(punit, v)) {
                 send_unit_info(pplayer->connections, punit);
               }
-            } unit_list_iterate_end;
+            } unit_stack_iterate_end;
           }
         } vision_layer_iterate_end;
       }
@@ -816,11 +968,11 @@ void map_hide_tile(struct player *src_player, struct tile *ptile)
         /* Remove units. */
         vision_layer_iterate(v) {
           if (0 < map_get_seen(pplayer, ptile, v)) {
-            unit_list_iterate(ptile->units, punit) {
+            unit_stack_iterate(ptile->units, punit) {
               if (unit_is_visible_on_layer(punit, v)) {
                 unit_goes_out_of_sight(pplayer, punit);
               }
-            } unit_list_iterate_end;
+            } unit_stack_iterate_end;
           }
         } vision_layer_iterate_end;
       }
@@ -896,7 +1048,7 @@ static inline int map_get_seen(const struct player *pplayer,
                                const struct tile *ptile,
                                enum vision_layer vlayer)
 {
-  return map_get_player_tile(ptile, pplayer)->seen_count[vlayer];
+  return map_get_player_tile_const(ptile, pplayer)->seen_count[vlayer];
 }
 
 /**********************************************************************//**
@@ -931,7 +1083,7 @@ void map_change_seen(struct player *pplayer,
     log_debug("(%d, %d): hiding invisible units to player %s (nb %d).",
               TILE_XY(ptile), player_name(pplayer), player_number(pplayer));
 
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       if (unit_is_visible_on_layer(punit, V_INVIS)
           && can_player_see_unit(pplayer, punit)
           && (plrtile->seen_count[V_MAIN] + change[V_MAIN] <= 0
@@ -940,19 +1092,19 @@ void map_change_seen(struct player *pplayer,
          * That's how can_player_see_unit_at() works. */
         unit_goes_out_of_sight(pplayer, punit);
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   }
   if (0 > change[V_SUBSURFACE]
       && plrtile->seen_count[V_SUBSURFACE] == -change[V_SUBSURFACE]) {
     log_debug("(%d, %d): hiding subsurface units to player %s (nb %d).",
               TILE_XY(ptile), player_name(pplayer), player_number(pplayer));
 
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       if (unit_is_visible_on_layer(punit, V_SUBSURFACE)
           && can_player_see_unit(pplayer, punit)) {
         unit_goes_out_of_sight(pplayer, punit);
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   }
 
   if (0 > change[V_MAIN]
@@ -960,12 +1112,12 @@ void map_change_seen(struct player *pplayer,
     log_debug("(%d, %d): hiding visible units to player %s (nb %d).",
               TILE_XY(ptile), player_name(pplayer), player_number(pplayer));
 
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       if (unit_is_visible_on_layer(punit, V_MAIN)
           && can_player_see_unit(pplayer, punit)) {
         unit_goes_out_of_sight(pplayer, punit);
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   }
 
   vision_layer_iterate(v) {
@@ -1004,9 +1156,9 @@ void map_change_seen(struct player *pplayer,
 
     update_player_tile_last_seen(pplayer, ptile);
     if (game.server.foggedborders) {
-      plrtile->owner = tile_owner(ptile);
+      player_tile_set_owner(plrtile, tile_owner(ptile));
     }
-    plrtile->extras_owner = extra_owner(ptile);
+    player_tile_set_extras_owner(plrtile, extra_owner(ptile));
     send_tile_info(pplayer->connections, ptile, FALSE);
   }
 
@@ -1029,11 +1181,11 @@ void map_change_seen(struct player *pplayer,
     send_tile_info(pplayer->connections, ptile, FALSE);
 
     /* Discover units. */
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       if (unit_is_visible_on_layer(punit, V_MAIN)) {
         send_unit_info(pplayer->connections, punit);
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
 
     /* Discover cities. */
     reality_check_city(pplayer, ptile);
@@ -1050,11 +1202,11 @@ void map_change_seen(struct player *pplayer,
               TILE_XY(ptile), player_name(pplayer),
               player_number(pplayer));
     /* Discover units. */
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       if (unit_is_visible_on_layer(punit, V_INVIS)) {
         send_unit_info(pplayer->connections, punit);
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   }
   if ((revealing_tile && 0 < plrtile->seen_count[V_SUBSURFACE])
       || (0 < change[V_SUBSURFACE]
@@ -1063,11 +1215,11 @@ void map_change_seen(struct player *pplayer,
               TILE_XY(ptile), player_name(pplayer),
               player_number(pplayer));
     /* Discover units. */
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       if (unit_is_visible_on_layer(punit, V_SUBSURFACE)) {
         send_unit_info(pplayer->connections, punit);
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   }
 }
 
@@ -1081,7 +1233,7 @@ static inline int map_get_own_seen(const struct player *pplayer,
                                    const struct tile *ptile,
                                    enum vision_layer vlayer)
 {
-  return map_get_player_tile(ptile, pplayer)->own_seen[vlayer];
+  return map_get_player_tile_const(ptile, pplayer)->own_seen[vlayer];
 }
 
 /**********************************************************************//**
@@ -1123,6 +1275,7 @@ void change_playertile_site(struct player_tile *ptile,
 void map_set_known(struct tile *ptile, struct player *pplayer)
 {
   dbv_set(&pplayer->tile_known, tile_index(ptile));
+  border_tile_changed(ptile);
 }
 
 /**********************************************************************//**
@@ -1131,6 +1284,7 @@ void map_set_known(struct tile *ptile, struct player *pplayer)
 void map_clear_known(struct tile *ptile, struct player *pplayer)
 {
   dbv_clr(&pplayer->tile_known, tile_index(ptile));
+  border_tile_changed(ptile);
 }
 
 /**********************************************************************//**
@@ -1159,37 +1313,125 @@ void show_map_to_all(void)
   } players_iterate_end;
 }
 
+/**********************************************************************//**
+  Free the chunks of a player map, and the vision sites in them if
+  'free_sites' is set.
+**************************************************************************/
+static void player_map_free_chunks(struct player_map *pmap, bool free_sites)
+{
+  int i, j;
+
+  for (i = 0; i < pmap->num_chunks; i++) {
+    if (pmap->chunks[i] == NULL) {
+      continue;
+    }
+    if (free_sites) {
+      for (j = 0; j < PLAYER_MAP_CHUNK; j++) {
+        player_tile_free(pmap->chunks[i] + j);
+      }
+    }
+    free(pmap->chunks[i]);
+    pmap->chunks[i] = NULL;
+  }
+  fc_mem_account(MEM_TAG_PLAYER_MAPS,
+                 -pmap->num_allocated * PLAYER_MAP_CHUNK_BYTES,
+                 -pmap->num_allocated);
+  pmap->num_allocated = 0;
+}
+
 /**********************************************************************//**
   Allocate space for map, and initialise the tiles.
-  Uses current map.xsize and map.ysize.
+  Uses current map.xsize and map.ysize.  The tiles themselves are only
+  allocated in chunks as they get changed.
 **************************************************************************/
 void player_map_init(struct player *pplayer)
 {
-  pplayer->server.private_map
-    = fc_realloc(pplayer->server.private_map,
-                 MAP_INDEX_SIZE * sizeof(*pplayer->server.private_map));
+  struct player_map *pmap = pplayer->server.private_map;
 
-  whole_map_iterate(&(wld.map), ptile) {
-    player_tile_init(ptile, pplayer);
-  } whole_map_iterate_end;
+  if (pmap == NULL) {
+    pmap = fc_calloc(1, sizeof(*pmap));
+    pplayer->server.private_map = pmap;
+  } else {
+    player_map_free_chunks(pmap, FALSE);
+  }
+
+  pmap->num_chunks = (MAP_INDEX_SIZE + PLAYER_MAP_CHUNK - 1)
+                     / PLAYER_MAP_CHUNK;
+  pmap->chunks = fc_realloc(pmap->chunks,
+                            pmap->num_chunks * sizeof(*pmap->chunks));
+  memset(pmap->chunks, 0, pmap->num_chunks * sizeof(*pmap->chunks));
+  pmap->num_allocated = 0;
+
+  player_tile_init(&pmap->blank);
 
   dbv_init(&pplayer->tile_known, MAP_INDEX_SIZE);
 }
 
+/**********************************************************************//**
+  Free the chunks of the player map that tell nothing a never seen chunk
+  would not: no tile of them is known and all hold what the blank tile
+  holds.  The update times of unknown tiles are not looked at.  For use
+  after loading a savegame, which writes every tile.
+**************************************************************************/
+void player_map_compact(struct player *pplayer)
+{
+  struct player_map *pmap = pplayer->server.private_map;
+  const struct player_tile *blank;
+  int i, j;
+
+  if (pmap == NULL) {
+    return;
+  }
+  blank = &pmap->blank;
+
+  for (i = 0; i < pmap->num_chunks; i++) {
+    const struct player_tile *chunk = pmap->chunks[i];
+    bool empty = (chunk != NULL);
+
+    for (j = 0; empty && j < PLAYER_MAP_CHUNK; j++) {
+      const struct player_tile *plrtile = chunk + j;
+      int tindex = i * PLAYER_MAP_CHUNK + j;
+
+      if (tindex < MAP_INDEX_SIZE
+          && dbv_isset(&pplayer->tile_known, tindex)) {
+        empty = FALSE;
+      } else if (plrtile->site != NULL
+                 || plrtile->terrain != blank->terrain
+                 || plrtile->resource != blank->resource
+                 || plrtile->owner != blank->owner
+                 || plrtile->extras_owner != blank->extras_owner
+                 || !BV_ARE_EQUAL(plrtile->extras, blank->extras)
+                 || memcmp(plrtile->seen_count, blank->seen_count,
+                           sizeof(v_radius_t)) != 0
+                 || memcmp(plrtile->own_seen, blank->own_seen,
+                           sizeof(v_radius_t)) != 0) {
+        empty = FALSE;
+      }
+    }
+
+    if (empty) {
+      free(pmap->chunks[i]);
+      pmap->chunks[i] = NULL;
+      pmap->num_allocated--;
+      fc_mem_account(MEM_TAG_PLAYER_MAPS, -PLAYER_MAP_CHUNK_BYTES, -1);
+    }
+  }
+}
+
 /**********************************************************************//**
   Free a player's private map.
 **************************************************************************/
 void player_map_free(struct player *pplayer)
 {
-  if (!pplayer->server.private_map) {
+  struct player_map *pmap = pplayer->server.private_map;
+
+  if (!pmap) {
     return;
   }
 
-  whole_map_iterate(&(wld.map), ptile) {
-    player_tile_free(ptile, pplayer);
-  } whole_map_iterate_end;
-
-  free(pplayer->server.private_map);
+  player_map_free_chunks(pmap, TRUE);
+  free(pmap->chunks);
+  free(pmap);
   pplayer->server.private_map = NULL;
 
   dbv_free(&pplayer->tile_known);
@@ -1210,28 +1452,29 @@ void remove_player_from_maps(struct player *pplayer)
     bool reality_changed = FALSE;
 
     players_iterate(aplayer) {
-      struct player_tile *aplrtile;
+      const struct player_tile *aplrtile;
       bool changed = FALSE;
 
       if (!aplayer->server.private_map) {
         continue;
       }
-      aplrtile = map_get_player_tile(ptile, aplayer);
+      aplrtile = map_get_player_tile_const(ptile, aplayer);
 
       /* Free vision sites (cities) for removed and other players */
-      if (aplrtile && aplrtile->site
+      if (aplrtile->site
           && vision_site_owner(aplrtile->site) == pplayer) {
-        change_playertile_site(aplrtile, NULL);
+        change_playertile_site(map_get_player_tile(ptile, aplayer), NULL);
         changed = TRUE;
       }
 
       /* Remove references to player from others' maps */
-      if (aplrtile->owner == pplayer) {
-        aplrtile->owner = NULL;
+      if (player_tile_owner(aplrtile) == pplayer) {
+        player_tile_set_owner(map_get_player_tile(ptile, aplayer), NULL);
         changed = TRUE;
       }
-      if (aplrtile->extras_owner == pplayer) {
-        aplrtile->extras_owner = NULL;
+      if (player_tile_extras_owner(aplrtile) == pplayer) {
+        player_tile_set_extras_owner(map_get_player_tile(ptile, aplayer),
+                                     NULL);
         changed = TRUE;
       }
 
@@ -1251,6 +1494,7 @@ void remove_player_from_maps(struct player *pplayer)
     /* Free all claimed tiles. */
     if (tile_owner(ptile) == pplayer) {
       tile_set_owner(ptile, NULL, NULL);
+      border_tile_changed(ptile);
       reality_changed = TRUE;
     }
     if (extra_owner(ptile) == pplayer) {
@@ -1270,14 +1514,12 @@ void remove_player_from_maps(struct player *pplayer)
   We need to use fogofwar_old here, so the player's tiles get
   in the same state as the other players' tiles.
 **************************************************************************/
-static void player_tile_init(struct tile *ptile, struct player *pplayer)
+static void player_tile_init(struct player_tile *plrtile)
 {
-  struct player_tile *plrtile = map_get_player_tile(ptile, pplayer);
-
-  plrtile->terrain = T_UNKNOWN;
-  plrtile->resource = NULL;
-  plrtile->owner = NULL;
-  plrtile->extras_owner = NULL;
+  player_tile_set_terrain(plrtile, T_UNKNOWN);
+  player_tile_set_resource(plrtile, NULL);
+  player_tile_set_owner(plrtile, NULL);
+  player_tile_set_extras_owner(plrtile, NULL);
   plrtile->site = NULL;
   BV_CLR_ALL(plrtile->extras);
   if (!game.server.last_updated_year) {
@@ -1295,10 +1537,8 @@ static void player_tile_init(struct tile *ptile, struct player *pplayer)
 /**********************************************************************//**
   Free the memory stored into the player tile.
 **************************************************************************/
-static void player_tile_free(struct tile *ptile, struct player *pplayer)
+static void player_tile_free(struct player_tile *plrtile)
 {
-  struct player_tile *plrtile = map_get_player_tile(ptile, pplayer);
-
   if (plrtile->site != NULL) {
     vision_site_destroy(plrtile->site);
   }
@@ -1323,7 +1563,7 @@ struct vision_site *map_get_player_city(const struct tile *ptile,
 struct vision_site *map_get_player_site(const struct tile *ptile,
 					const struct player *pplayer)
 {
-  return map_get_player_tile(ptile, pplayer)->site;
+  return map_get_player_tile_const(ptile, pplayer)->site;
 }
 
 /**********************************************************************//**
@@ -1334,9 +1574,72 @@ struct vision_site *map_get_player_site(const struct tile *ptile,
 struct player_tile *map_get_player_tile(const struct tile *ptile,
 					const struct player *pplayer)
 {
-  fc_assert_ret_val(pplayer->server.private_map, NULL);
+  struct player_map *pmap = pplayer->server.private_map;
+  int tindex = tile_index(ptile);
+  struct player_tile **pchunk;
+
+  fc_assert_ret_val(pmap, NULL);
+
+  pchunk = pmap->chunks + tindex / PLAYER_MAP_CHUNK;
+  if (*pchunk == NULL) {
+    int i;
+
+    *pchunk = fc_malloc(PLAYER_MAP_CHUNK * sizeof(**pchunk));
+    for (i = 0; i < PLAYER_MAP_CHUNK; i++) {
+      (*pchunk)[i] = pmap->blank;
+    }
+    pmap->num_allocated++;
+    fc_mem_account(MEM_TAG_PLAYER_MAPS, PLAYER_MAP_CHUNK_BYTES, 1);
+  }
+
+  return *pchunk + tindex % PLAYER_MAP_CHUNK;
+}
+
+/**********************************************************************//**
+  Like map_get_player_tile(), but for reading only: a tile in a chunk
+  not yet allocated is not allocated for it.
+**************************************************************************/
+const struct player_tile *
+map_get_player_tile_const(const struct tile *ptile,
+                          const struct player *pplayer)
+{
+  const struct player_map *pmap = pplayer->server.private_map;
+  int tindex = tile_index(ptile);
+  const struct player_tile *chunk;
+
+  fc_assert_ret_val(pmap, NULL);
+
+  chunk = pmap->chunks[tindex / PLAYER_MAP_CHUNK];
+  if (chunk == NULL) {
+    return &pmap->blank;
+  }
+
+  return chunk + tindex % PLAYER_MAP_CHUNK;
+}
+
+/**********************************************************************//**
+  Log how much memory the player maps take, against what they would
+  take with every chunk allocated.
+**************************************************************************/
+void player_maps_log_memory(void)
+{
+  long allocated = 0, total = 0;
+
+  players_iterate(pplayer) {
+    const struct player_map *pmap = pplayer->server.private_map;
 
-  return pplayer->server.private_map + tile_index(ptile);
+    if (pmap != NULL) {
+      allocated += pmap->num_allocated;
+      total += pmap->num_chunks;
+    }
+  } players_iterate_end;
+
+  log_verbose("Player maps: %ld of %ld chunks allocated, %ld KiB of %ld KiB.",
+              allocated, total,
+              allocated * PLAYER_MAP_CHUNK
+              * (long) sizeof(struct player_tile) / 1024,
+              total * PLAYER_MAP_CHUNK
+              * (long) sizeof(struct player_tile) / 1024);
 }
 
 /**********************************************************************//**
@@ -1349,24 +1652,27 @@ struct player_tile *map_get_player_tile(const struct tile *ptile,
 **************************************************************************/
 bool update_player_tile_knowledge(struct player *pplayer, struct tile *ptile)
 {
-  struct player_tile *plrtile = map_get_player_tile(ptile, pplayer);
+  const struct player_tile *plrtile
+    = map_get_player_tile_const(ptile, pplayer);
 
-  if (plrtile->terrain != ptile->terrain
+  if (player_tile_terrain(plrtile) != ptile->terrain
       || !BV_ARE_EQUAL(plrtile->extras, ptile->extras)
-      || plrtile->resource != ptile->resource
-      || plrtile->owner != tile_owner(ptile)
-      || plrtile->extras_owner != extra_owner(ptile)) {
-    plrtile->terrain = ptile->terrain;
+      || player_tile_resource(plrtile) != ptile->resource
+      || player_tile_owner(plrtile) != tile_owner(ptile)
+      || player_tile_extras_owner(plrtile) != extra_owner(ptile)) {
+    struct player_tile *wtile = map_get_player_tile(ptile, pplayer);
+
+    player_tile_set_terrain(wtile, ptile->terrain);
     extra_type_iterate(pextra) {
       if (player_knows_extra_exist(pplayer, pextra, ptile)) {
-	BV_SET(plrtile->extras, extra_number(pextra));
+	BV_SET(wtile->extras, extra_number(pextra));
       } else {
-	BV_CLR(plrtile->extras, extra_number(pextra));
+	BV_CLR(wtile->extras, extra_number(pextra));
       }
     } extra_type_iterate_end;
-    plrtile->resource = ptile->resource;
-    plrtile->owner = tile_owner(ptile);
-    plrtile->extras_owner = extra_owner(ptile);
+    player_tile_set_resource(wtile, ptile->resource);
+    player_tile_set_owner(wtile, tile_owner(ptile));
+    player_tile_set_extras_owner(wtile, extra_owner(ptile));
 
     return TRUE;
   }
@@ -1428,7 +1734,9 @@ static void really_give_tile_info_from_player_to_player(struct player *pfrom,
                                                         struct player *pdest,
                                                         struct tile *ptile)
 {
-  struct player_tile *from_tile, *dest_tile;
+  const struct player_tile *from_tile;
+  struct player_tile *dest_tile;
+
   if (!map_is_known_and_seen(ptile, pdest, V_MAIN)) {
     /* I can just hear people scream as they try to comprehend this if :).
      * Let me try in words:
@@ -1439,10 +1747,10 @@ static void really_give_tile_info_from_player_to_player(struct player *pfrom,
      */
     if (map_is_known_and_seen(ptile, pfrom, V_MAIN)
 	|| (map_is_known(ptile, pfrom)
-	    && (((map_get_player_tile(ptile, pfrom)->last_updated
-		 > map_get_player_tile(ptile, pdest)->last_updated))
+	    && (((map_get_player_tile_const(ptile, pfrom)->last_updated
+		 > map_get_player_tile_const(ptile, pdest)->last_updated))
 	        || !map_is_known(ptile, pdest)))) {
-      from_tile = map_get_player_tile(ptile, pfrom);
+      from_tile = map_get_player_tile_const(ptile, pfrom);
       dest_tile = map_get_player_tile(ptile, pdest);
       /* Update and send tile knowledge */
       map_set_known(ptile, pdest);
@@ -1751,7 +2059,7 @@ static void ocean_to_land_fix_rivers(struct tile *ptile)
 **************************************************************************/
 static void check_units_single_tile(struct tile *ptile)
 {
-  unit_list_iterate_safe(ptile->units, punit) {
+  unit_stack_iterate_safe(ptile->units, punit) {
     bool unit_alive = TRUE;
 
     if (unit_tile(punit) == ptile
@@ -1796,7 +2104,7 @@ static void check_units_single_tile(struct tile *ptile)
         wipe_unit(punit, ULR_NONNATIVE_TERR, NULL);
       }
     }
-  } unit_list_iterate_safe_end;
+  } unit_stack_iterate_safe_end;
 }
 
 /**********************************************************************//**
@@ -1835,6 +2143,50 @@ bool need_to_reassign_continents(const struct terrain *oldter,
     || (!old_is_ocean && new_is_ocean);
 }
 
+/**********************************************************************//**
+  Renumber the continents after the tile changed between land and ocean,
+  and send the tiles whose continent number changed.
+**************************************************************************/
+void reassign_continents_at(struct tile *ptile)
+{
+  struct tile_list *changed = tile_list_new();
+
+  if (update_continent_numbers(ptile, changed)) {
+    /* Only the tile was renumbered, and terrain_changed() marked the
+     * borders around it.  But an ocean that grew or shrank across the
+     * size limit of claiming changes claims away from the tile too.
+     * A full renumbering invalidates the borders itself. */
+    bool small_ocean = FALSE;
+
+    if (is_ocean_tile(ptile)
+        && get_ocean_size(-tile_continent(ptile))
+           <= MAXIMUM_CLAIMED_OCEAN_SIZE + 1) {
+      small_ocean = TRUE;
+    }
+    adjc_iterate(&(wld.map), ptile, atile) {
+      if (is_ocean_tile(atile)
+          && get_ocean_size(-tile_continent(atile))
+             <= MAXIMUM_CLAIMED_OCEAN_SIZE + 1) {
+        small_ocean = TRUE;
+      }
+    } adjc_iterate_end;
+    if (small_ocean) {
+      map_borders_invalidate();
+    }
+  }
+
+  log_debug("Continent numbers of %d tiles changed",
+            tile_list_size(changed));
+
+  conn_list_do_buffer(game.est_connections);
+  tile_list_iterate(changed, ctile) {
+    send_tile_info(NULL, ctile, FALSE);
+  } tile_list_iterate_end;
+  conn_list_do_unbuffer(game.est_connections);
+
+  tile_list_destroy(changed);
+}
+
 /**********************************************************************//**
   Handle local side effects for a terrain change.
 **************************************************************************/
@@ -1842,6 +2194,12 @@ void terrain_changed(struct tile *ptile)
 {
   struct city *pcity = tile_city(ptile);
 
+  /* Whether the tile and the water next to it can be claimed. */
+  border_tile_changed(ptile);
+  adjc_iterate(&(wld.map), ptile, adjc_tile) {
+    border_tile_changed(adjc_tile);
+  } adjc_iterate_end;
+
   if (pcity != NULL) {
     /* Tile is city center and new terrain may support better extras. */
     upgrade_city_extras(pcity, NULL);
@@ -1927,8 +2285,7 @@ void check_terrain_change(struct tile *ptile, struct terrain *oldter)
   }
 
   if (need_to_reassign_continents(oldter, newter)) {
-    assign_continent_numbers();
-    send_all_known_tiles(NULL);
+    reassign_continents_at(ptile);
   }
 
   claimer = tile_claimer(ptile);
@@ -2007,7 +2364,7 @@ static bool is_claimable_ocean(struct tile *ptile, struct tile *source,
 **************************************************************************/
 static void map_unit_homecity_enqueue(struct tile *ptile)
 {
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     struct city *phome = game_city_by_number(punit->homecity);
 
     if (NULL == phome) {
@@ -2015,7 +2372,7 @@ static void map_unit_homecity_enqueue(struct tile *ptile)
     }
 
     city_refresh_queue_add(phome);
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 }
 
 /**********************************************************************//**
@@ -2045,7 +2402,11 @@ static void map_claim_border_ownership(struct tile *ptile,
     shared_vision_change_seen(powner, ptile, radius_sq, TRUE);
   }
 
+  if (ploser != powner || tile_claimer(ptile) != psource) {
+    border_engine.claims++;
+  }
   tile_set_owner(ptile, powner, psource);
+  border_tile_changed(ptile);
 
   /* Needed only when foggedborders enabled, but we do it unconditionally
    * in case foggedborders ever gets enabled later. Better to have correct
@@ -2148,6 +2509,8 @@ void map_update_border(struct tile *ptile, struct player *owner,
 void map_claim_border(struct tile *ptile, struct player *owner,
                       int radius_sq)
 {
+  int source_strength = -1;
+
   if (BORDERS_DISABLED == game.info.borders) {
     return;
   }
@@ -2204,8 +2567,12 @@ void map_claim_border(struct tile *ptile, struct player *owner,
         }
       }
 
-      strength_old = tile_border_strength(dtile, dclaimer);
-      strength_new = tile_border_strength(dtile, ptile);
+      if (source_strength < 0) {
+        source_strength = border_source_strength(ptile);
+      }
+      strength_old = border_strength_at(dtile, dclaimer,
+                                        border_source_strength(dclaimer));
+      strength_new = border_strength_at(dtile, ptile, source_strength);
 
       if (strength_new <= strength_old) {
         /* Stronger shall prevail,
@@ -2229,11 +2596,174 @@ void map_claim_border(struct tile *ptile, struct player *owner,
   } circle_dxyr_iterate_end;
 }
 
+/**********************************************************************//**
+  Free a border source record.
+**************************************************************************/
+static void border_source_destroy(struct border_source *psource)
+{
+  free(psource);
+}
+
+/**********************************************************************//**
+  Note that something map_claim_border() looks at changed on the tile:
+  its owner, its terrain, or whether a player knows it.
+**************************************************************************/
+static void border_tile_changed(const struct tile *ptile)
+{
+  if (border_engine.tile_changed != NULL) {
+    border_engine.tile_changed[tile_index(ptile)] = border_engine.clock;
+  }
+}
+
+/**********************************************************************//**
+  Mark every tile within radius_sq of the tile as changed.
+**************************************************************************/
+static void border_circle_changed(struct tile *ptile, int radius_sq)
+{
+  circle_iterate(&(wld.map), ptile, radius_sq, dtile) {
+    border_engine.tile_changed[tile_index(dtile)] = border_engine.clock;
+  } circle_iterate_end;
+}
+
+/**********************************************************************//**
+  Returns TRUE iff a tile within radius_sq of the tile changed at or
+  after the clock 'since'.
+**************************************************************************/
+static bool border_circle_changed_since(struct tile *ptile, int radius_sq,
+                                        unsigned int since)
+{
+  circle_iterate(&(wld.map), ptile, radius_sq, dtile) {
+    if (border_engine.tile_changed[tile_index(dtile)] >= since) {
+      return TRUE;
+    }
+  } circle_iterate_end;
+
+  return FALSE;
+}
+
+/**********************************************************************//**
+  Returns the full strength of the border source.  Inside
+  map_calculate_borders() this is what the pass found at its start.
+**************************************************************************/
+static int border_source_strength(struct tile *source)
+{
+  struct border_source *psource;
+
+  if (border_engine.in_pass
+      && border_source_hash_lookup(border_engine.sources,
+                                   tile_index(source), &psource)
+      && psource->pass == border_engine.pass) {
+    return psource->strength;
+  }
+
+  return tile_border_source_strength(source);
+}
+
+/**********************************************************************//**
+  Strength of the claim of a source with the given full strength on the
+  tile, as tile_border_strength().
+**************************************************************************/
+static int border_strength_at(struct tile *ptile, struct tile *source,
+                              int full_strength)
+{
+  int sq_dist = sq_map_distance(ptile, source);
+
+  if (sq_dist > 0) {
+    return full_strength * full_strength / sq_dist;
+  } else {
+    return FC_INFINITY;
+  }
+}
+
+/**********************************************************************//**
+  Look the border source on the tile up again.  If anything about it that
+  map_claim_border() depends on changed, its whole radius is marked as
+  changed, so that it and the sources around it claim again.
+**************************************************************************/
+static struct border_source *border_source_refresh(struct tile *ptile)
+{
+  struct border_source *psource;
+  struct border_source now;
+  struct city *pcity = tile_city(ptile);
+
+  now.tile = ptile;
+  now.owner = tile_owner(ptile);
+  now.radius_sq = tile_border_source_radius_sq(ptile);
+  now.strength = tile_border_source_strength(ptile);
+  now.city_radius_sq = (pcity != NULL ? city_map_radius_sq_get(pcity) : -1);
+  now.claim_ocean = (now.owner != NULL
+                     && num_known_tech_with_flag(now.owner,
+                                                 TF_CLAIM_OCEAN) > 0);
+  now.claim_ocean_limited =
+    (now.owner != NULL
+     && num_known_tech_with_flag(now.owner, TF_CLAIM_OCEAN_LIMITED) > 0);
+
+  if (!border_source_hash_lookup(border_engine.sources, tile_index(ptile),
+                                 &psource)) {
+    psource = fc_malloc(sizeof(*psource));
+    *psource = now;
+    psource->max_radius_sq = now.radius_sq;
+    psource->last_run = 0;
+    border_source_hash_insert(border_engine.sources, tile_index(ptile),
+                              psource);
+    border_circle_changed(ptile, now.radius_sq);
+  } else if (psource->owner != now.owner
+             || psource->radius_sq != now.radius_sq
+             || psource->strength != now.strength
+             || psource->city_radius_sq != now.city_radius_sq
+             || psource->claim_ocean != now.claim_ocean
+             || psource->claim_ocean_limited != now.claim_ocean_limited) {
+    int max_radius_sq = MAX(psource->max_radius_sq, now.radius_sq);
+
+    border_circle_changed(ptile, max_radius_sq);
+    now.max_radius_sq = max_radius_sq;
+    now.last_run = psource->last_run;
+    *psource = now;
+  }
+  psource->pass = border_engine.pass;
+
+  return psource;
+}
+
+/**********************************************************************//**
+  Forget what the border update knows, so that every source claims again
+  at the next map_calculate_borders().  Call this after changes the
+  update does not follow, like new continent numbers or a loaded game.
+**************************************************************************/
+void map_borders_invalidate(void)
+{
+  if (border_engine.sources != NULL) {
+    border_source_hash_clear(border_engine.sources);
+  }
+}
+
+/**********************************************************************//**
+  Free the state of the border update.
+**************************************************************************/
+void map_borders_free(void)
+{
+  if (border_engine.sources != NULL) {
+    border_source_hash_destroy(border_engine.sources);
+    border_engine.sources = NULL;
+  }
+  free(border_engine.tile_changed);
+  border_engine.tile_changed = NULL;
+  border_engine.num_tiles = 0;
+}
+
 /**********************************************************************//**
   Update borders for all sources. Call this on turn end.
+
+  Only the sources that changed themselves, or have a tile in their
+  radius that changed since they last claimed, claim again; for the
+  others map_claim_border() would not change anything.  With the
+  'borderverify' setting all sources claim again afterwards, and any
+  tile that still changes owner is reported.
 **************************************************************************/
 void map_calculate_borders(void)
 {
+  int num_sources = 0, num_claimed = 0;
+
   if (BORDERS_DISABLED == game.info.borders) {
     return;
   }
@@ -2245,12 +2775,84 @@ void map_calculate_borders(void)
 
   log_verbose("map_calculate_borders()");
 
+  if (border_engine.num_tiles != MAP_INDEX_SIZE
+      || border_engine.mode != game.info.borders) {
+    map_borders_free();
+    border_engine.sources = border_source_hash_new();
+    border_engine.tile_changed = fc_calloc(MAP_INDEX_SIZE,
+                                           sizeof(*border_engine.tile_changed));
+    border_engine.num_tiles = MAP_INDEX_SIZE;
+    border_engine.mode = game.info.borders;
+    border_engine.clock = 1;
+  }
+
+  /* Find what changed about the sources before any of them claims, as
+   * every claim compares with the sources around. */
+  border_engine.pass++;
   whole_map_iterate(&(wld.map), ptile) {
     if (is_border_source(ptile)) {
-      map_claim_border(ptile, ptile->owner, -1);
+      border_source_refresh(ptile);
     }
   } whole_map_iterate_end;
 
+  if (border_source_hash_size(border_engine.sources) > 0) {
+    int *gone = fc_malloc(border_source_hash_size(border_engine.sources)
+                          * sizeof(*gone));
+    int num_gone = 0, i;
+
+    border_source_hash_data_iterate(border_engine.sources, psource) {
+      if (psource->pass != border_engine.pass) {
+        border_circle_changed(psource->tile, psource->max_radius_sq);
+        gone[num_gone++] = tile_index(psource->tile);
+      }
+    } border_source_hash_data_iterate_end;
+    for (i = 0; i < num_gone; i++) {
+      border_source_hash_remove(border_engine.sources, gone[i]);
+    }
+    free(gone);
+  }
+
+  border_engine.in_pass = TRUE;
+  whole_map_iterate(&(wld.map), ptile) {
+    if (is_border_source(ptile)) {
+      struct border_source *psource;
+
+      if (!border_source_hash_lookup(border_engine.sources,
+                                     tile_index(ptile), &psource)
+          || psource->pass != border_engine.pass
+          || psource->owner != ptile->owner) {
+        /* It became a source or changed during this pass. */
+        psource = border_source_refresh(ptile);
+      }
+
+      num_sources++;
+      if (border_circle_changed_since(ptile, psource->radius_sq,
+                                      psource->last_run)) {
+        map_claim_border(ptile, ptile->owner, psource->radius_sq);
+        psource->last_run = ++border_engine.clock;
+        num_claimed++;
+      }
+    }
+  } whole_map_iterate_end;
+  border_engine.in_pass = FALSE;
+
+  log_verbose("map_calculate_borders(): %d of %d sources claimed",
+              num_claimed, num_sources);
+
+  if (game.server.border_verify) {
+    border_engine.claims = 0;
+    whole_map_iterate(&(wld.map), ptile) {
+      if (is_border_source(ptile)) {
+        map_claim_border(ptile, ptile->owner, -1);
+      }
+    } whole_map_iterate_end;
+
+    if (border_engine.claims > 0) {
+      log_error("map_calculate_borders(): full recomputation changed "
+                "%d tiles.", border_engine.claims);
+    }
+  }
+
   log_verbose("map_calculate_borders() workers");
   city_thaw_workers_queue();
   city_refresh_queue_processing();
@@ -2271,14 +2873,14 @@ void map_claim_base(struct tile *ptile, struct extra_type *pextra,
     return;
   }
 
-  units_num = unit_list_size(ptile->units);
+  units_num = unit_stack_size(ptile->units);
   could_see_unit = (units_num > 0
                     ? fc_malloc(sizeof(*could_see_unit) * units_num)
                     : NULL);
 
   i = 0;
   if (pextra->eus != EUS_NORMAL) {
-    unit_list_iterate(ptile->units, aunit) {
+    unit_stack_iterate(ptile->units, aunit) {
       BV_CLR_ALL(could_see_unit[i]);
       players_iterate(aplayer) {
         if (can_player_see_unit(aplayer, aunit)) {
@@ -2286,7 +2888,7 @@ void map_claim_base(struct tile *ptile, struct extra_type *pextra,
         }
       } players_iterate_end;
       i++;
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   }
 
   pbase = extra_base_get(pextra);
@@ -2340,7 +2942,7 @@ void map_claim_base(struct tile *ptile, struct extra_type *pextra,
 
   i = 0;
   if (pextra->eus != EUS_NORMAL) {
-    unit_list_iterate(ptile->units, aunit) {
+    unit_stack_iterate(ptile->units, aunit) {
       players_iterate(aplayer) {
         if (can_player_see_unit(aplayer, aunit)) {
           if (!BV_ISSET(could_see_unit[i], player_index(aplayer))) {
@@ -2353,7 +2955,7 @@ void map_claim_base(struct tile *ptile, struct extra_type *pextra,
         }
       } players_iterate_end;
       i++;
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   }
 }
 
@@ -2399,7 +3001,7 @@ void create_extra(struct tile *ptile, struct extra_type *pextra,
   } extra_type_iterate_end;
 
   if (pextra->eus != EUS_NORMAL) {
-    unit_list_iterate(ptile->units, aunit) {
+    unit_stack_iterate(ptile->units, aunit) {
       if (is_native_extra_to_utype(pextra, unit_type_get(aunit))) {
         players_iterate(aplayer) {
           if (!pplayers_allied(pplayer, aplayer)
@@ -2408,13 +3010,13 @@ void create_extra(struct tile *ptile, struct extra_type *pextra,
           }
         } players_iterate_end;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   }
 
   tile_add_extra(ptile, pextra);
 
   /* Watchtower might become effective. */
-  unit_list_refresh_vision(ptile->units);
+  unit_stack_refresh_vision(ptile->units);
 
   if (pextra->data.base != NULL) {
     /* Claim bases on tile */
@@ -2501,7 +3103,7 @@ void destroy_extra(struct tile *ptile, struct extra_type *pextra)
     if (pextra->eus != EUS_NORMAL) {
       struct player *eowner = extra_owner(ptile);
 
-      unit_list_iterate(ptile->units, aunit) {
+      unit_stack_iterate(ptile->units, aunit) {
         if (is_native_extra_to_utype(pextra, unit_type_get(aunit))) {
           players_iterate(aplayer) {
             if (can_player_see_unit(aplayer, aunit)
@@ -2510,7 +3112,7 @@ void destroy_extra(struct tile *ptile, struct extra_type *pextra)
             }
           } players_iterate_end;
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     }
   }
 }
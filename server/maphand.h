@@ -15,8 +15,10 @@
 
 #include "fc_types.h"
 
+#include "extras.h"
 #include "map.h"
 #include "packets.h"
+#include "player.h"
 #include "terrain.h"
 #include "vision.h"
 
@@ -28,10 +30,6 @@ struct conn_list;
 
 struct player_tile {
   struct vision_site *site;		/* NULL for no vision site */
-  struct extra_type *resource;          /* NULL for no resource */
-  struct terrain *terrain;		/* NULL for unknown tiles */
-  struct player *owner; 		/* NULL for unowned */
-  struct player *extras_owner;
   bv_extras extras;
 
   /* If you build a city with an unknown square within city radius
@@ -41,8 +39,104 @@ struct player_tile {
   v_radius_t own_seen;
   v_radius_t seen_count;
   short last_updated;
+
+  /* Numbers instead of pointers, to keep the player maps small.  Use the
+   * player_tile_*() functions below to read and set them. */
+  short owner;                          /* -1 for unowned */
+  short extras_owner;                   /* -1 for none */
+  signed char terrain;                  /* -1 for unknown tiles */
+  signed char resource;                 /* -1 for no resource */
+};
+
+/* A player map is kept in chunks of this many tiles.  A chunk is only
+ * allocated once one of its tiles has to change, so the parts of the map
+ * the player never came near take no memory. */
+#define PLAYER_MAP_CHUNK 64
+
+struct player_map {
+  struct player_tile **chunks;
+  int num_chunks;
+  int num_allocated;
+
+  /* What each tile of a chunk holds before the chunk is allocated. */
+  struct player_tile blank;
 };
 
+/**********************************************************************//**
+  Return the terrain the player knows at the tile, or T_UNKNOWN.
+**************************************************************************/
+static inline struct terrain *
+player_tile_terrain(const struct player_tile *plrtile)
+{
+  return 0 > plrtile->terrain ? T_UNKNOWN
+                              : terrain_by_number(plrtile->terrain);
+}
+
+/**********************************************************************//**
+  Set the terrain the player knows at the tile; may be T_UNKNOWN.
+**************************************************************************/
+static inline void player_tile_set_terrain(struct player_tile *plrtile,
+                                           const struct terrain *pterrain)
+{
+  plrtile->terrain = T_UNKNOWN == pterrain ? -1 : terrain_number(pterrain);
+}
+
+/**********************************************************************//**
+  Return the resource the player knows at the tile, or NULL.
+**************************************************************************/
+static inline struct extra_type *
+player_tile_resource(const struct player_tile *plrtile)
+{
+  return 0 > plrtile->resource ? NULL : extra_by_number(plrtile->resource);
+}
+
+/**********************************************************************//**
+  Set the resource the player knows at the tile; may be NULL.
+**************************************************************************/
+static inline void player_tile_set_resource(struct player_tile *plrtile,
+                                            const struct extra_type *pres)
+{
+  plrtile->resource = NULL == pres ? -1 : extra_number(pres);
+}
+
+/**********************************************************************//**
+  Return the owner the player knows for the tile, or NULL.
+**************************************************************************/
+static inline struct player *
+player_tile_owner(const struct player_tile *plrtile)
+{
+  return 0 > plrtile->owner ? NULL : player_by_number(plrtile->owner);
+}
+
+/**********************************************************************//**
+  Set the owner the player knows for the tile; may be NULL.
+**************************************************************************/
+static inline void player_tile_set_owner(struct player_tile *plrtile,
+                                         const struct player *powner)
+{
+  plrtile->owner = NULL == powner ? -1 : player_number(powner);
+}
+
+/**********************************************************************//**
+  Return the extras owner the player knows for the tile, or NULL.
+**************************************************************************/
+static inline struct player *
+player_tile_extras_owner(const struct player_tile *plrtile)
+{
+  return 0 > plrtile->extras_owner ? NULL
+                                   : player_by_number(plrtile->extras_owner);
+}
+
+/**********************************************************************//**
+  Set the extras owner the player knows for the tile; may be NULL.
+**************************************************************************/
+static inline void
+player_tile_set_extras_owner(struct player_tile *plrtile,
+                             const struct player *powner)
+{
+  plrtile->extras_owner = NULL == powner ? -1 : player_number(powner);
+}
+
 void global_warming(int effect);
 void nuclear_winter(int effect);
 void climate_change(bool warming, int effect);
@@ -84,6 +178,7 @@ void show_map_to_all(void);
 
 void player_map_init(struct player *pplayer);
 void player_map_free(struct player *pplayer);
+void player_map_compact(struct player *pplayer);
 void remove_player_from_maps(struct player *pplayer);
 
 struct vision_site *map_get_player_city(const struct tile *ptile,
@@ -92,6 +187,10 @@ struct vision_site *map_get_player_site(const struct tile *ptile,
                                         const struct player *pplayer);
 struct player_tile *map_get_player_tile(const struct tile *ptile,
                                         const struct player *pplayer);
+const struct player_tile *
+map_get_player_tile_const(const struct tile *ptile,
+                          const struct player *pplayer);
+void player_maps_log_memory(void);
 bool update_player_tile_knowledge(struct player *pplayer, struct tile *ptile);
 void update_tile_knowledge(struct tile *ptile);
 void update_player_tile_last_seen(struct player *pplayer, struct tile *ptile);
@@ -106,6 +205,8 @@ void enable_fog_of_war_player(struct player *pplayer);
 void disable_fog_of_war_player(struct player *pplayer);
 
 void map_calculate_borders(void);
+void map_borders_invalidate(void);
+void map_borders_free(void);
 void map_claim_border(struct tile *ptile, struct player *powner,
                       int radius_sq);
 void map_claim_ownership(struct tile *ptile, struct player *powner,
@@ -125,6 +226,7 @@ void fix_tile_on_terrain_change(struct tile *ptile,
                                 bool extend_rivers);
 bool need_to_reassign_continents(const struct terrain *oldter,
                                  const struct terrain *newter);
+void reassign_continents_at(struct tile *ptile);
 void bounce_units_on_terrain_change(struct tile *ptile);
 
 void vision_change_sight(struct vision *vision,
@@ -691,13 +691,13 @@ static void maybe_claim_base(struct tile *ptile, struct player *new_owner,
 {
   bool claim = FALSE;
 
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     if (unit_owner(punit) == new_owner
         && tile_has_claimable_base(ptile, unit_type_get(punit))) {
       claim = TRUE;
       break;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   if (claim) {
     extra_type_by_cause_iterate(EC_BASE, pextra) {
@@ -2181,9 +2181,9 @@ void maybe_make_contact(struct tile *ptile, struct player *pplayer)
     if (pcity) {
       make_contact(pplayer, city_owner(pcity), ptile);
     }
-    unit_list_iterate_safe(tile1->units, punit) {
+    unit_stack_iterate_safe(tile1->units, punit) {
       make_contact(pplayer, unit_owner(punit), ptile);
-    } unit_list_iterate_safe_end;
+    } unit_stack_iterate_safe_end;
   } square_iterate_end;
 }
 
@@ -2849,13 +2849,13 @@ struct player *civil_war(struct player *pplayer)
     }
 
     /* City hosting victim's GameLoss unit won't defect */
-    unit_list_iterate(city_tile(pcity)->units, punit) {
+    unit_stack_iterate(city_tile(pcity)->units, punit) {
       if (unit_owner(punit) == pplayer
           && unit_has_type_flag(punit, UTYF_GAMELOSS)) {
         gameloss_present = TRUE;
         break;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
     if (gameloss_present) {
       continue;
     }
@@ -9012,6 +9012,7 @@ static bool load_rulesetdir(const char *rsdir, bool compat_mode,
       set_unit_type_caches(ptype);
     } unit_type_iterate_end;
     city_production_caravan_shields_init();
+    city_tile_output_tables_init();
 
     /* Build advisors unit class cache corresponding to loaded rulesets */
     adv_units_ruleset_init();
@@ -30,6 +30,7 @@
 #include "specialist.h"
 #include "terrain.h"
 #include "unit.h"
+#include "unitgrid.h"
 #include "unitlist.h"
 
 /* server */
@@ -118,7 +119,8 @@ static void check_fow(const char *file, const char *function, int line)
 
   whole_map_iterate(&(wld.map), ptile) {
     players_iterate(pplayer) {
-      struct player_tile *plr_tile = map_get_player_tile(ptile, pplayer);
+      const struct player_tile *plr_tile
+        = map_get_player_tile_const(ptile, pplayer);
 
       vision_layer_iterate(v) {
         /* underflow of unsigned int */
@@ -202,19 +204,19 @@ static void check_map(const char *file, const char *function, int line)
       } adjc_iterate_end;
     }
 
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       SANITY_TILE(ptile, same_pos(unit_tile(punit), ptile));
 
       /* Check diplomatic status of stacked units. */
-      unit_list_iterate(ptile->units, punit2) {
+      unit_stack_iterate(ptile->units, punit2) {
 	SANITY_TILE(ptile, pplayers_allied(unit_owner(punit), 
                                            unit_owner(punit2)));
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
       if (pcity) {
 	SANITY_TILE(ptile, pplayers_allied(unit_owner(punit), 
                                            city_owner(pcity)));
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   } whole_map_iterate_end;
 }
 
@@ -416,6 +418,10 @@ static void check_units(const char *file, const char *function, int line)
       struct unit *ptrans = unit_transport_get(punit);
 
       SANITY_CHECK(unit_owner(punit) == pplayer);
+#ifdef FREECIV_WEB
+      SANITY_CHECK(punit->grid == wld.unit_grid);
+      SANITY_CHECK(unit_grid_is_placed(punit));
+#endif /* FREECIV_WEB */
 
       if (IDENTITY_NUMBER_ZERO != punit->homecity) {
         SANITY_CHECK(phome = player_city_by_number(pplayer,
@@ -684,7 +690,7 @@ void real_sanity_check_tile(struct tile *ptile, const char *file,
   SANITY_CHECK(ptile != NULL);
   SANITY_CHECK(ptile->terrain != NULL);
 
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     /* Check if the units can survive on the tile (terrain). Here only the
      * 'easy' test if the unit is transported is done. A complete check is
      * done by check_units() in real_sanity_check(). */
@@ -693,7 +699,7 @@ void real_sanity_check_tile(struct tile *ptile, const char *file,
       SANITY_FAIL("(%4d,%4d) %s can't survive on %s", TILE_XY(ptile),
                   unit_rule_name(punit), tile_get_info_text(ptile, TRUE, 0));
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 }
 
 #endif /* SANITY_CHECKING */
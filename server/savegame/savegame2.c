@@ -190,8 +190,9 @@ extern bool sg_success;
  *                  will be the y coordinate
  * Example:
  *   LOAD_MAP_CHAR(ch, ptile,
- *                 map_get_player_tile(ptile, plr)->terrain
- *                   = char2terrain(ch), file, "player%d.map_t%04d", plrno);
+ *                 player_tile_set_terrain(map_get_player_tile(ptile, plr),
+ *                                         char2terrain(ch)),
+ *                 file, "player%d.map_t%04d", plrno);
  *
  * Note: some (but not all) of the code this is replacing used to skip over
  *       lines that did not exist. This allowed for backward-compatibility.
@@ -779,7 +780,7 @@ static void unit_ordering_apply(void)
   } players_iterate_end;
 
   whole_map_iterate(&(wld.map), ptile) {
-    unit_list_sort_ord_map(ptile->units);
+    unit_stack_sort_ord_map(ptile->units);
   } whole_map_iterate_end;
 }
 
@@ -2733,6 +2734,7 @@ static void sg_load_players(struct loaddata *loading)
   unit_ordering_apply();
 
   /* All vision is ready; this calls city_thaw_workers_queue(). */
+  map_borders_invalidate();
   map_calculate_borders();
 
   /* Make sure everything is consistent. */
@@ -3740,7 +3742,7 @@ static void sg_load_player_units(struct loaddata *loading,
      * automatically reveal that tile. */
 
     unit_list_append(plr->units, punit);
-    unit_list_prepend(unit_tile(punit)->units, punit);
+    unit_stack_prepend(unit_tile(punit)->units, punit);
 
     /* Claim ownership of fortress? */
     if ((extra_owner(ptile) == NULL
@@ -4595,14 +4597,16 @@ static void sg_load_player_vision(struct loaddata *loading,
 
   /* Load player map (terrain). */
   LOAD_MAP_CHAR(ch, ptile,
-                map_get_player_tile(ptile, plr)->terrain
-                  = char2terrain(ch), loading->file,
+                player_tile_set_terrain(map_get_player_tile(ptile, plr),
+                                        char2terrain(ch)),
+                loading->file,
                 "player%d.map_t%04d", plrno);
 
   /* Load player map (resources). */
   LOAD_MAP_CHAR(ch, ptile,
-                map_get_player_tile(ptile, plr)->resource
-                  = char2resource(ch), loading->file,
+                player_tile_set_resource(map_get_player_tile(ptile, plr),
+                                         char2resource(ch)),
+                loading->file,
                 "player%d.map_res%04d", plrno);
 
   if (loading->version >= 30) {
@@ -4670,12 +4674,13 @@ static void sg_load_player_vision(struct loaddata *loading,
         sg_failure_ret('\0' != token[0],
                        "Savegame corrupt - map size not correct.");
         if (strcmp(token, "-") == 0) {
-          map_get_player_tile(ptile, plr)->owner = NULL;
+          player_tile_set_owner(map_get_player_tile(ptile, plr), NULL);
         } else  {
           sg_failure_ret(str_to_int(token, &number),
                          "Savegame corrupt - got tile owner=%s in (%d, %d).",
                          token, x, y);
-          map_get_player_tile(ptile, plr)->owner = player_by_number(number);
+          player_tile_set_owner(map_get_player_tile(ptile, plr),
+                                player_by_number(number));
         }
 
         if (loading->version >= 30) {
@@ -4683,16 +4688,18 @@ static void sg_load_player_vision(struct loaddata *loading,
           sg_failure_ret('\0' != token2[0],
                          "Savegame corrupt - map size not correct.");
           if (strcmp(token2, "-") == 0) {
-            map_get_player_tile(ptile, plr)->extras_owner = NULL;
+            player_tile_set_extras_owner(map_get_player_tile(ptile, plr), NULL);
           } else  {
             sg_failure_ret(str_to_int(token2, &number),
                            "Savegame corrupt - got extras owner=%s in (%d, %d).",
                            token, x, y);
-            map_get_player_tile(ptile, plr)->extras_owner = player_by_number(number);
+            player_tile_set_extras_owner(map_get_player_tile(ptile, plr),
+                                         player_by_number(number));
           }
         } else {
-          map_get_player_tile(ptile, plr)->extras_owner
-            = map_get_player_tile(ptile, plr)->owner;
+          struct player_tile *plrtile = map_get_player_tile(ptile, plr);
+
+          player_tile_set_extras_owner(plrtile, player_tile_owner(plrtile));
         }
       }
     }
@@ -4747,9 +4754,8 @@ static void sg_load_player_vision(struct loaddata *loading,
       }
     } else if (!game.server.foggedborders && map_is_known(ptile, plr)) {
       /* Non fogged borders aren't loaded. See hrm Bug #879084 */
-      struct player_tile *plrtile = map_get_player_tile(ptile, plr);
-
-      plrtile->owner = tile_owner(ptile);
+      player_tile_set_owner(map_get_player_tile(ptile, plr),
+                            tile_owner(ptile));
     }
   } whole_map_iterate_end;
 }
@@ -201,8 +201,9 @@ extern bool sg_success;
  *                  will be the y coordinate
  * Example:
  *   LOAD_MAP_CHAR(ch, ptile,
- *                 map_get_player_tile(ptile, plr)->terrain
- *                   = char2terrain(ch), file, "player%d.map_t%04d", plrno);
+ *                 player_tile_set_terrain(map_get_player_tile(ptile, plr),
+ *                                         char2terrain(ch)),
+ *                 file, "player%d.map_t%04d", plrno);
  *
  * Note: some (but not all) of the code this is replacing used to skip over
  *       lines that did not exist. This allowed for backward-compatibility.
@@ -1016,9 +1017,9 @@ static void unit_ordering_calc(void)
 
   whole_map_iterate(&(wld.map), ptile) {
     j = 0;
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       punit->server.ord_map = j++;
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   } whole_map_iterate_end;
 }
 
@@ -1036,7 +1037,7 @@ static void unit_ordering_apply(void)
   } players_iterate_end;
 
   whole_map_iterate(&(wld.map), ptile) {
-    unit_list_sort_ord_map(ptile->units);
+    unit_stack_sort_ord_map(ptile->units);
   } whole_map_iterate_end;
 }
 
@@ -3756,6 +3757,7 @@ static void sg_load_players(struct loaddata *loading)
   unit_ordering_apply();
 
   /* All vision is ready; this calls city_thaw_workers_queue(). */
+  map_borders_invalidate();
   map_calculate_borders();
 
   /* Make sure everything is consistent. */
@@ -5659,7 +5661,7 @@ static void sg_load_player_units(struct loaddata *loading,
      * automatically reveal that tile. */
 
     unit_list_append(plr->units, punit);
-    unit_list_prepend(unit_tile(punit)->units, punit);
+    unit_stack_prepend(unit_tile(punit)->units, punit);
   }
 }
 
@@ -6638,8 +6640,9 @@ static void sg_load_player_vision(struct loaddata *loading,
 
   /* Load player map (terrain). */
   LOAD_MAP_CHAR(ch, ptile,
-                map_get_player_tile(ptile, plr)->terrain
-                  = char2terrain(ch), loading->file,
+                player_tile_set_terrain(map_get_player_tile(ptile, plr),
+                                        char2terrain(ch)),
+                loading->file,
                 "player%d.map_t%04d", plrno);
 
   /* Load player map (extras). */
@@ -6676,24 +6679,26 @@ static void sg_load_player_vision(struct loaddata *loading,
         sg_failure_ret('\0' != token[0],
                        "Savegame corrupt - map size not correct.");
         if (strcmp(token, "-") == 0) {
-          map_get_player_tile(ptile, plr)->owner = NULL;
+          player_tile_set_owner(map_get_player_tile(ptile, plr), NULL);
         } else  {
           sg_failure_ret(str_to_int(token, &number),
                          "Savegame corrupt - got tile owner=%s in (%d, %d).",
                          token, x, y);
-          map_get_player_tile(ptile, plr)->owner = player_by_number(number);
+          player_tile_set_owner(map_get_player_tile(ptile, plr),
+                                player_by_number(number));
         }
 
         scanin(&ptr2, ",", token2, sizeof(token2));
         sg_failure_ret('\0' != token2[0],
                        "Savegame corrupt - map size not correct.");
         if (strcmp(token2, "-") == 0) {
-          map_get_player_tile(ptile, plr)->extras_owner = NULL;
+          player_tile_set_extras_owner(map_get_player_tile(ptile, plr), NULL);
         } else  {
           sg_failure_ret(str_to_int(token2, &number),
                          "Savegame corrupt - got extras owner=%s in (%d, %d).",
                          token, x, y);
-          map_get_player_tile(ptile, plr)->extras_owner = player_by_number(number);
+          player_tile_set_extras_owner(map_get_player_tile(ptile, plr),
+                                         player_by_number(number));
         }
       }
     }
@@ -6748,9 +6753,8 @@ static void sg_load_player_vision(struct loaddata *loading,
       }
     } else if (!game.server.foggedborders && map_is_known(ptile, plr)) {
       /* Non fogged borders aren't loaded. See hrm Bug #879084 */
-      struct player_tile *plrtile = map_get_player_tile(ptile, plr);
-
-      plrtile->owner = tile_owner(ptile);
+      player_tile_set_owner(map_get_player_tile(ptile, plr),
+                            tile_owner(ptile));
     }
   } whole_map_iterate_end;
 }
@@ -6880,7 +6884,8 @@ static void sg_save_player_vision(struct savedata *saving,
 
   /* Save the map (terrain). */
   SAVE_MAP_CHAR(ptile,
-                terrain2char(map_get_player_tile(ptile, plr)->terrain),
+                terrain2char(player_tile_terrain(
+                               map_get_player_tile_const(ptile, plr))),
                 saving->file, "player%d.map_t%04d", plrno);
 
   if (game.server.foggedborders) {
@@ -6894,13 +6899,14 @@ static void sg_save_player_vision(struct savedata *saving,
       for (x = 0; x < wld.map.xsize; x++) {
         char token[TOKEN_SIZE];
         struct tile *ptile = native_pos_to_tile(&(wld.map), x, y);
-        struct player_tile *plrtile = map_get_player_tile(ptile, plr);
+        const struct player_tile *plrtile
+          = map_get_player_tile_const(ptile, plr);
 
-        if (plrtile == NULL || plrtile->owner == NULL) {
+        if (plrtile == NULL || player_tile_owner(plrtile) == NULL) {
           strcpy(token, "-");
         } else {
           fc_snprintf(token, sizeof(token), "%d",
-                      player_number(plrtile->owner));
+                      player_number(player_tile_owner(plrtile)));
         }
         strcat(line, token);
         if (x < wld.map.xsize) {
@@ -6918,13 +6924,14 @@ static void sg_save_player_vision(struct savedata *saving,
       for (x = 0; x < wld.map.xsize; x++) {
         char token[TOKEN_SIZE];
         struct tile *ptile = native_pos_to_tile(&(wld.map), x, y);
-        struct player_tile *plrtile = map_get_player_tile(ptile, plr);
+        const struct player_tile *plrtile
+          = map_get_player_tile_const(ptile, plr);
 
-        if (plrtile == NULL || plrtile->extras_owner == NULL) {
+        if (plrtile == NULL || player_tile_extras_owner(plrtile) == NULL) {
           strcpy(token, "-");
         } else {
           fc_snprintf(token, sizeof(token), "%d",
-                      player_number(plrtile->extras_owner));
+                      player_number(player_tile_extras_owner(plrtile)));
         }
         strcat(line, token);
         if (x < wld.map.xsize) {
@@ -6950,8 +6957,9 @@ static void sg_save_player_vision(struct savedata *saving,
     }
 
     SAVE_MAP_CHAR(ptile,
-                  sg_extras_get(map_get_player_tile(ptile, plr)->extras,
-                                map_get_player_tile(ptile, plr)->resource,
+                  sg_extras_get(map_get_player_tile_const(ptile, plr)->extras,
+                                player_tile_resource(
+                                  map_get_player_tile_const(ptile, plr)),
                                 mod),
                   saving->file, "player%d.map_e%02d_%04d", plrno, j);
   } halfbyte_iterate_extras_end;
@@ -6961,7 +6969,7 @@ static void sg_save_player_vision(struct savedata *saving,
     /* put 4-bit segments of 16-bit "updated" field */
     SAVE_MAP_CHAR(ptile,
                   bin2ascii_hex(
-                    map_get_player_tile(ptile, plr)->last_updated, i),
+                    map_get_player_tile_const(ptile, plr)->last_updated, i),
                   saving->file, "player%d.map_u%02d_%04d", plrno, i);
   }
 
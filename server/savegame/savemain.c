@@ -24,9 +24,11 @@
 #include "ai.h"
 #include "capability.h"
 #include "game.h"
+#include "map.h"
 
 /* server */
 #include "console.h"
+#include "maphand.h"
 #include "notify.h"
 
 /* server/savegame */
@@ -71,6 +73,14 @@ void savegame_load(struct section_file *sfile)
     return;
   }
 
+  /* The loaders write the tile extras directly. */
+  main_map_dense_sync();
+
+  /* The loaders write every tile of the player maps. */
+  players_iterate(pplayer) {
+    player_map_compact(pplayer);
+  } players_iterate_end;
+
   players_iterate(pplayer) {
     unit_list_iterate(pplayer->units, punit) {
       CALL_FUNC_EACH_AI(unit_created, punit);
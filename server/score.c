@@ -161,6 +161,7 @@ static void print_landarea_map(struct claim_map *pcmap, int turn)
 static void build_landarea_map(struct claim_map *pcmap)
 {
   bv_player *claims = fc_calloc(MAP_INDEX_SIZE, sizeof(*claims));
+  int i;
 
   memset(pcmap, 0, sizeof(*pcmap));
 
@@ -175,11 +176,14 @@ static void build_landarea_map(struct claim_map *pcmap)
     } city_list_iterate_end;
   } players_iterate_end;
 
-  whole_map_iterate(&(wld.map), ptile) {
+  /* The terrain and owner come from the dense arrays, so ocean tiles
+   * are not looked at. */
+  for (i = 0; i < MAP_INDEX_SIZE; i++) {
     struct player *owner = NULL;
-    bv_player *pclaim = &claims[tile_index(ptile)];
+    bv_player *pclaim = &claims[i];
+    struct tile *ptile = wld.map.tiles + i;
 
-    if (is_ocean_tile(ptile)) {
+    if (is_ocean(wld.map.dense.terrain[i])) {
       /* Nothing. */
     } else if (NULL != tile_city(ptile)) {
       owner = city_owner(tile_city(ptile));
@@ -187,9 +191,9 @@ static void build_landarea_map(struct claim_map *pcmap)
     } else if (NULL != tile_worked(ptile)) {
       owner = city_owner(tile_worked(ptile));
       pcmap->player[player_index(owner)].settledarea++;
-    } else if (unit_list_size(ptile->units) > 0) {
+    } else if (unit_stack_size(ptile->units) > 0) {
       /* Because of allied stacking these calculations are a bit off. */
-      owner = unit_owner(unit_list_get(ptile->units, 0));
+      owner = unit_owner(unit_stack_get(ptile->units, 0));
       if (BV_ISSET(*pclaim, player_index(owner))) {
 	pcmap->player[player_index(owner)].settledarea++;
       }
@@ -198,12 +202,12 @@ static void build_landarea_map(struct claim_map *pcmap)
     if (BORDERS_DISABLED != game.info.borders) {
       /* If borders are enabled, use owner information directly from the
        * map.  Otherwise use the calculations above. */
-      owner = tile_owner(ptile);
+      owner = wld.map.dense.owner[i];
     }
     if (owner) {
       pcmap->player[player_index(owner)].landarea++;
     }
-  } whole_map_iterate_end;
+  }
 
   FC_FREE(claims);
 
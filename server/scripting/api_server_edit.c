@@ -45,9 +45,6 @@
 /* server/scripting */
 #include "script_server.h"
 
-/* server/generator */
-#include "mapgen_utils.h"
-
 #include "api_server_edit.h"
 
 
@@ -502,8 +499,7 @@ bool api_edit_change_terrain(lua_State *L, Tile *ptile, Terrain *pterr)
   tile_change_terrain(ptile, pterr);
   fix_tile_on_terrain_change(ptile, old_terrain, FALSE);
   if (need_to_reassign_continents(old_terrain, pterr)) {
-    assign_continent_numbers();
-    send_all_known_tiles(NULL);
+    reassign_continents_at(ptile);
   }
 
   update_tile_knowledge(ptile);
@@ -347,10 +347,9 @@ static void cut_lagging_connection(struct connection *pconn)
 }
 
 /*************************************************************************//**
-  Attempt to flush all information in the send buffers for upto 'netwait'
-  seconds.
+  Does the work of flush_packets().
 *****************************************************************************/
-void flush_packets(void)
+static void flush_send_buffers(void)
 {
   int i;
   int max_desc;
@@ -414,6 +413,17 @@ void flush_packets(void)
   }
 }
 
+/*************************************************************************//**
+  Attempt to flush all information in the send buffers for upto 'netwait'
+  seconds.
+*****************************************************************************/
+void flush_packets(void)
+{
+  TIMING_SPAN_BEGIN("flush_packets");
+  flush_send_buffers();
+  TIMING_SPAN_END("flush_packets");
+}
+
 struct packet_to_handle {
   void *data;
   enum packet_type type;
@@ -18,6 +18,7 @@
 /* utility */
 #include "astring.h"
 #include "fcintl.h"
+#include "fcthreadpool.h"
 #include "game.h"
 #include "ioz.h"
 #include "log.h"
@@ -781,6 +782,14 @@ static void topology_action(const struct setting *pset)
   } conn_list_iterate_end;
 }
 
+/************************************************************************//**
+  Resize the pool of threads.
+****************************************************************************/
+static void threads_action(const struct setting *pset)
+{
+  fc_threadpool_set_size(*pset->integer.pvalue);
+}
+
 /************************************************************************//**
   Update metaserver message string from changed user meta server message
   string.
@@ -2961,6 +2970,57 @@ static struct setting settings[] = {
               "users are not required to wait for the save to finish."),
            NULL, NULL, GAME_DEFAULT_THREADED_SAVE)
 
+  GEN_INT("threads", game.server.threads,
+          SSET_META, SSET_INTERNAL, SSET_RARE, ALLOW_HACK, ALLOW_HACK,
+          N_("Size of the pool of threads"),
+          /* TRANS: The strings between single quotes are setting names
+           * and should not be translated. */
+          N_("The number of threads, the main thread included, that the "
+             "server runs parallel work on, such as the work enabled by "
+             "'citythreads' and 'cmthreads'. With values below 2 "
+             "everything is done in the main thread."),
+          NULL, NULL, threads_action,
+          GAME_MIN_THREADS, GAME_MAX_THREADS, GAME_DEFAULT_THREADS)
+
+  GEN_INT("citythreads", game.server.city_threads,
+          SSET_META, SSET_INTERNAL, SSET_RARE, ALLOW_HACK, ALLOW_HACK,
+          N_("Threads used for refreshing cities at turn end"),
+          N_("With 2 or more, the cities of a player are all refreshed "
+             "on up to this many threads of the pool (see 'threads') "
+             "before any of them builds, grows or "
+             "pays upkeep at turn end, instead of each city being "
+             "refreshed just before its own turn end processing. Games "
+             "play out the same with any value of 2 or more, but "
+             "differently from games played with lower values."),
+          NULL, NULL, NULL,
+          GAME_MIN_CITY_THREADS, GAME_MAX_CITY_THREADS,
+          GAME_DEFAULT_CITY_THREADS)
+
+  GEN_INT("cmthreads", game.server.cm_threads,
+          SSET_META, SSET_INTERNAL, SSET_RARE, ALLOW_HACK, ALLOW_HACK,
+          N_("Threads used for arranging city workers"),
+          N_("When the workers of many cities get rearranged at once, "
+             "the citizen governor queries of independent cities are "
+             "solved concurrently on up to this many threads of the "
+             "pool (see 'threads'). Cities whose "
+             "result conflicts with an arrangement made before them "
+             "are solved again one by one, in a fixed order, so games "
+             "stay reproducible. With values below 2 all cities are "
+             "arranged one after another."),
+          NULL, NULL, NULL,
+          GAME_MIN_CM_THREADS, GAME_MAX_CM_THREADS, GAME_DEFAULT_CM_THREADS)
+
+  GEN_BOOL("borderverify", game.server.border_verify,
+           SSET_META, SSET_INTERNAL, SSET_RARE, ALLOW_HACK, ALLOW_HACK,
+           N_("Whether to check the border update by recomputing it"),
+           N_("At turn change, borders are only claimed again around the "
+              "border sources where something changed. If this setting "
+              "is enabled, every source claims its borders again "
+              "afterwards, and any tile that still changes owner is "
+              "logged as an error. This is meant for debugging and "
+              "slows down the turn change."),
+           NULL, NULL, GAME_DEFAULT_BORDER_VERIFY)
+
   GEN_INT("compress", game.server.save_compress_level,
           SSET_META, SSET_INTERNAL, SSET_RARE, ALLOW_HACK, ALLOW_HACK,
           N_("Savegame compression level"),
@@ -50,6 +50,7 @@
 #include "fc_cmdline.h"
 #include "fciconv.h"
 #include "fcintl.h"
+#include "fcthreadpool.h"
 #include "log.h"
 #include "mem.h"
 #include "netintf.h"
@@ -89,6 +90,7 @@
 #include "animals.h"
 #include "auth.h"
 #include "barbarian.h"
+#include "benchmark.h"
 #include "cityhand.h"
 #include "citytools.h"
 #include "cityturn.h"
@@ -143,7 +145,7 @@
 
 static void end_turn(void);
 static void announce_player(struct player *pplayer);
-static void fc_interface_init_server(void);
+static void timing_spans_save(void);
 
 static enum known_type mapimg_server_tile_known(const struct tile *ptile,
                                                 const struct player *pplayer,
@@ -264,6 +266,7 @@ void srv_init(void)
   srvarg.log_filename = NULL;
   srvarg.fatal_assertions = -1;
   srvarg.ranklog_filename = NULL;
+  srvarg.timing_filename = NULL;
   srvarg.load_filename[0] = '\0';
   srvarg.script_filename = NULL;
   srvarg.saves_pathname = "";
@@ -271,6 +274,8 @@ void srv_init(void)
   srvarg.ruleset = NULL;
 
   srvarg.quitidle = 0;
+  srvarg.benchmark_turns = 0;
+  srvarg.count_memory = FALSE;
 
   srvarg.fcdb_enabled = FALSE;
   srvarg.fcdb_conf = NULL;
@@ -773,18 +778,29 @@ static void update_environmental_upset(enum environment_upset_type type,
                                        int percent,
                                        void (*upset_action_fn)(int))
 {
-  int count;
+  const bv_extras *extras = wld.map.dense.extras;
+  int causes[MAX_EXTRA_TYPES];
+  int count, num_causes, i, j;
 
-  count = 0;
+  num_causes = 0;
   extra_type_iterate(cause) {
     if (extra_causes_env_upset(cause, type)) {
-      whole_map_iterate(&(wld.map), ptile) {
-        if (tile_has_extra(ptile, cause)) {
+      causes[num_causes++] = extra_index(cause);
+    }
+  } extra_type_iterate_end;
+
+  /* One pass over the dense extras instead of one over the tiles for
+   * each cause. */
+  count = 0;
+  if (num_causes > 0) {
+    for (i = 0; i < MAP_INDEX_SIZE; i++) {
+      for (j = 0; j < num_causes; j++) {
+        if (BV_ISSET(extras[i], causes[j])) {
           count++;
         }
-      } whole_map_iterate_end;
+      }
     }
-  } extra_type_iterate_end;
+  }
 
   *current = (count * percent) / 100;
   *accum += count;
@@ -1069,7 +1085,9 @@ static void ai_start_phase(void)
 {
   phase_players_iterate(pplayer) {
     if (is_ai(pplayer)) {
+      TIMING_SPAN_BEGIN("ai_first_activities");
       CALL_PLR_AI_FUNC(first_activities, pplayer, pplayer);
+      TIMING_SPAN_END("ai_first_activities");
     }
   } phase_players_iterate_end;
   kill_dying_players();
@@ -1085,6 +1103,7 @@ static void begin_turn(bool is_new_turn)
   log_debug("Begin turn");
 
   event_cache_remove_old();
+  fc_arena_reset(server.turn_arena);
 
   /* Reset this each turn. */
   if (is_new_turn) {
@@ -1209,9 +1228,11 @@ static void begin_phase(bool is_new_phase)
 
   /* Must be the first thing as it is needed for lots of functions below! */
   phase_players_iterate(pplayer) {
+    TIMING_SPAN_BEGIN("ai_phase_begin");
     /* human players also need this for building advice */
     adv_data_phase_init(pplayer, is_new_phase);
     CALL_PLR_AI_FUNC(phase_begin, pplayer, pplayer, is_new_phase);
+    TIMING_SPAN_END("ai_phase_begin");
   } phase_players_iterate_end;
 
   if (is_new_phase) {
@@ -1294,7 +1315,9 @@ static void begin_phase(bool is_new_phase)
     /* Try to avoid hiding events under a diplomacy dialog */
     phase_players_iterate(pplayer) {
       if (is_ai(pplayer)) {
+        TIMING_SPAN_BEGIN("ai_diplomacy_actions");
         CALL_PLR_AI_FUNC(diplomacy_actions, pplayer, pplayer);
+        TIMING_SPAN_END("ai_diplomacy_actions");
       }
     } phase_players_iterate_end;
 
@@ -1397,15 +1420,21 @@ static void end_phase(void)
   send_city_suppression(TRUE);
 
   /* AI end of turn activities */
+  TIMING_SPAN_BEGIN("ai_unit_turn_end");
   players_iterate(pplayer) {
     unit_list_iterate(pplayer->units, punit) {
       CALL_PLR_AI_FUNC(unit_turn_end, pplayer, punit);
     } unit_list_iterate_end;
   } players_iterate_end;
+  TIMING_SPAN_END("ai_unit_turn_end");
   phase_players_iterate(pplayer) {
+    TIMING_SPAN_BEGIN("auto_settlers_player");
     auto_settlers_player(pplayer);
+    TIMING_SPAN_END("auto_settlers_player");
     if (is_ai(pplayer)) {
+      TIMING_SPAN_BEGIN("ai_last_activities");
       CALL_PLR_AI_FUNC(last_activities, pplayer, pplayer);
+      TIMING_SPAN_END("ai_last_activities");
     }
   } phase_players_iterate_end;
 
@@ -1426,7 +1455,9 @@ static void end_phase(void)
                     _("Automatically placed spaceship parts that were still not placed."));
     }
 
+    TIMING_SPAN_BEGIN("update_city_activities");
     update_city_activities(pplayer);
+    TIMING_SPAN_END("update_city_activities");
     city_thaw_workers_queue();
     pplayer->history += nation_history_gain(pplayer);
     research_get(pplayer)->researching_saved = A_UNKNOWN;
@@ -1456,14 +1487,64 @@ static void end_phase(void)
   do_border_vision_effect();
 
   phase_players_iterate(pplayer) {
+    TIMING_SPAN_BEGIN("ai_phase_finished");
     CALL_PLR_AI_FUNC(phase_finished, pplayer, pplayer);
     /* This has to be after all access to advisor data. */
     /* We used to run this for ai players only, but data phase
        is initialized for human players also. */
     adv_data_phase_done(pplayer);
+    TIMING_SPAN_END("ai_phase_finished");
   } phase_players_iterate_end;
 }
 
+/**********************************************************************//**
+  Log what the threads of the pool did this turn.
+**************************************************************************/
+static void threadpool_turn_report(void)
+{
+  int i;
+
+  for (i = 0; i < fc_threadpool_stats_count(); i++) {
+    struct fc_threadpool_stats stats;
+
+    fc_threadpool_stats_get(i, &stats);
+    if (stats.tasks > 0) {
+      log_verbose("Thread %d of the pool: %d tasks, %d stolen; "
+                  "busy %g seconds", i, stats.tasks, stats.steals,
+                  stats.busy_seconds);
+    }
+  }
+  fc_threadpool_stats_reset();
+}
+
+/**********************************************************************//**
+  Log the allocations the main thread made this turn, and the memory
+  held by each part of the server.
+**************************************************************************/
+static void mem_turn_report(void)
+{
+  struct fc_mem_stats stats;
+  struct fc_mem_tag_usage usage;
+  enum mem_tag tag;
+
+  fc_mem_stats_get(&stats);
+  log_verbose("Allocations: %d mallocs, %d reallocs, %d from pools "
+              "(%d given back), %d from the turn arena (%lu bytes held)",
+              stats.mallocs, stats.reallocs, stats.pool_allocs,
+              stats.pool_frees, stats.arena_allocs,
+              (unsigned long) fc_arena_size(server.turn_arena));
+  fc_mem_stats_reset();
+
+  if (fc_mem_accounting_enabled()) {
+    for (tag = 0; tag < MEM_TAG_COUNT; tag++) {
+      fc_mem_tag_usage_get(tag, &usage);
+      log_verbose("Memory held by %s: %ld KiB in %ld blocks (peak %ld KiB)",
+                  mem_tag_name(tag), usage.bytes / 1024, usage.count,
+                  usage.peak_bytes / 1024);
+    }
+  }
+}
+
 /**********************************************************************//**
   Handle the end of each turn.
 **************************************************************************/
@@ -1506,6 +1587,10 @@ static void end_turn(void)
               total_player_citizens(pplayer), food, shields, trade,
               settlers, unit_list_size(pplayer->units));
   } players_iterate_end;
+  auto_arrange_workers_turn_report();
+  threadpool_turn_report();
+  mem_turn_report();
+  player_maps_log_memory();
 
   log_debug("Season of native unrests");
   summon_barbarians(); /* wild guess really, no idea where to put it, but
@@ -1776,6 +1861,9 @@ void server_quit(void)
     } phase_players_iterate_end;
   }
 
+  timing_spans_save();
+  fc_threadpool_free();
+
   if (game.server.save_timer != NULL) {
     timer_destroy(game.server.save_timer);
     game.server.save_timer = NULL;
@@ -1822,6 +1910,7 @@ void server_quit(void)
   registry_module_close();
   fc_destroy_mutex(&game.server.mutexes.city_list);
   free_libfreeciv();
+  fc_mem_accounting_free();
   free_nls();
   con_log_close();
   cmdline_option_values_free();
@@ -2723,6 +2812,29 @@ static void announce_player(struct player *pplayer)
   send_player_info_c(pplayer, NULL);
 }
 
+/**********************************************************************//**
+  Write the timing spans recorded during the game to the file given with
+  --Timing, if any, and stop recording them.
+**************************************************************************/
+static void timing_spans_save(void)
+{
+  const char *ext;
+
+  if (!timing_spans_active()) {
+    return;
+  }
+
+  if (srvarg.timing_filename != NULL) {
+    ext = strrchr(srvarg.timing_filename, '.');
+    if (ext != NULL && fc_strcasecmp(ext, ".csv") == 0) {
+      timing_spans_write_csv(srvarg.timing_filename);
+    } else {
+      timing_spans_write_trace(srvarg.timing_filename);
+    }
+  }
+  timing_spans_stop();
+}
+
 /**********************************************************************//**
   Play the game! Returns when S_S_RUNNING != server_state().
 **************************************************************************/
@@ -2740,6 +2852,15 @@ static void srv_running(void)
   log_verbose("srv_running() mostly redundant send_server_settings()");
   send_server_settings(NULL);
 
+  fc_threadpool_set_size(game.server.threads);
+
+  if (srvarg.timing_filename != NULL || srvarg.benchmark_turns > 0) {
+    timing_spans_start();
+  }
+  if (srvarg.benchmark_turns > 0) {
+    benchmark_start(srvarg.benchmark_turns);
+  }
+
   timer_start(eot_timer);
 
   if (game.server.autosaves & (1 << AS_TIMER)) {
@@ -2763,7 +2884,14 @@ static void srv_running(void)
      * We have to initialize data as well as do some actions.  However when
      * loading a game we don't want to do these actions (like AI unit
      * movement and AI diplomacy). */
+    timing_spans_frame(game.info.turn);
+    if (srvarg.benchmark_turns > 0) {
+      benchmark_turn_begin();
+    }
+    TIMING_SPAN_BEGIN("turn");
+    TIMING_SPAN_BEGIN("begin_turn");
     begin_turn(is_new_turn);
+    TIMING_SPAN_END("begin_turn");
 
     if (game.server.num_phases != 1) {
       /* We allow everyone to begin adjusting cities and such
@@ -2776,7 +2904,9 @@ static void srv_running(void)
     for (; game.info.phase < game.server.num_phases; game.info.phase++) {
       log_debug("Starting phase %d/%d.", game.info.phase,
                 game.server.num_phases);
+      TIMING_SPAN_BEGIN("begin_phase");
       begin_phase(is_new_turn);
+      TIMING_SPAN_END("begin_phase");
       if (need_send_pending_events) {
         /* When loading a savegame, we need to send loaded events, after
          * the clients switched to the game page (after the first
@@ -2811,7 +2941,9 @@ static void srv_running(void)
         if (save_counter >= game.server.save_nturns
             && game.server.save_nturns > 0) {
 	  save_counter = 0;
+          TIMING_SPAN_BEGIN("autosave");
 	  save_game_auto("Autosave", AS_TURN);
+          TIMING_SPAN_END("autosave");
 	}
 	save_counter++;
 
@@ -2839,9 +2971,11 @@ static void srv_running(void)
         log_debug("Inresponsive between turns %g seconds", game.server.turn_change_time);
       }
 
+      TIMING_SPAN_BEGIN("sniff");
       while (server_sniff_all_input() == S_E_OTHERWISE) {
         /* nothing */
       }
+      TIMING_SPAN_END("sniff");
 
       between_turns = timer_renew(between_turns, TIMER_USER, TIMER_ACTIVE);
       timer_start(between_turns);
@@ -2859,7 +2993,9 @@ static void srv_running(void)
        */
       lsend_packet_freeze_client(game.est_connections);
 
+      TIMING_SPAN_BEGIN("end_phase");
       end_phase();
+      TIMING_SPAN_END("end_phase");
 
       conn_list_do_unbuffer(game.est_connections);
 
@@ -2876,7 +3012,18 @@ static void srv_running(void)
      * where phase is too high for is_new_turn to get set. */
     is_new_turn = TRUE;
 
+    TIMING_SPAN_BEGIN("end_turn");
     end_turn();
+    TIMING_SPAN_END("end_turn");
+    TIMING_SPAN_END("turn");
+    if (srvarg.benchmark_turns > 0) {
+      benchmark_turn_end();
+      if (srvarg.timing_filename == NULL) {
+        /* Only the benchmark wants the spans, and it has its totals of
+         * the turn now. */
+        timing_spans_clear();
+      }
+    }
     log_debug("Sendinfotometaserver");
     (void) send_server_info_to_metaserver(META_REFRESH);
 
@@ -2907,6 +3054,8 @@ static void srv_running(void)
     between_turns = NULL;
   }
   timer_clear(eot_timer);
+
+  timing_spans_save();
 }
 
 /**********************************************************************//**
@@ -3335,6 +3484,7 @@ void server_game_init(bool keep_ruleset_value)
   identity_number_reserve(IDENTITY_NUMBER_ZERO);
 
   event_cache_init();
+  server.turn_arena = fc_arena_new(64 * 1024);
   game_init(keep_ruleset_value);
   /* game_init() set game.server.plr_colors to NULL. So we need to
    * initialize the colors after. */
@@ -3384,9 +3534,13 @@ void server_game_free(void)
   } players_iterate_end;
 
   event_cache_free();
+  unit_move_data_pool_free();
+  fc_arena_destroy(server.turn_arena);
+  server.turn_arena = NULL;
   log_civ_score_free();
   playercolor_free();
   citymap_free();
+  map_borders_free();
   game_free();
 }
 
@@ -3395,6 +3549,11 @@ void server_game_free(void)
 **************************************************************************/
 void srv_main(void)
 {
+  if (srvarg.count_memory) {
+    /* Before anything that counts its memory gets allocated. */
+    fc_mem_accounting_init();
+  }
+
   fc_interface_init_server();
 
   srv_prepare();
@@ -3403,6 +3562,11 @@ void srv_main(void)
   do {
     set_server_state(S_S_INITIAL);
 
+    if (srvarg.benchmark_turns > 0) {
+      /* Before the script, so that it can change them. */
+      benchmark_settings();
+    }
+
     /* Load a script file. */
     if (NULL != srvarg.script_filename) {
       /* Adding an error message more here will duplicate them. */
@@ -3414,6 +3578,11 @@ void srv_main(void)
       event_cache_clear();
     }
 
+    if (srvarg.benchmark_turns > 0 && !force_end_of_sniff) {
+      /* Nobody to wait for, unless the script started the game already. */
+      (void) start_command(NULL, FALSE, TRUE);
+    }
+
     log_normal(_("Now accepting new client connections on port %d."),
                srvarg.port);
     /* Remain in S_S_INITIAL until all players are ready. */
@@ -3428,6 +3597,9 @@ void srv_main(void)
       srv_ready(); /* srv_ready() sets server state to S_S_RUNNING. */
       srv_running();
       srv_scores();
+      if (srvarg.benchmark_turns > 0) {
+        benchmark_report();
+      }
     }
 
     /* Remain in S_S_OVER until players log out */
@@ -3473,7 +3645,8 @@ static inline void server_gui_color_free(struct color *pcolor)
 static int server_plr_tile_city_id_get(const struct tile *ptile,
                                        const struct player *pplayer)
 {
-  const struct player_tile *plrtile = map_get_player_tile(ptile, pplayer);
+  const struct player_tile *plrtile
+    = map_get_player_tile_const(ptile, pplayer);
 
   return plrtile && plrtile->site ? plrtile->site->identity
                                   : IDENTITY_NUMBER_ZERO;
@@ -3572,7 +3745,7 @@ unsigned int server_ss_val_bitwise_get(server_setting_id id)
 /**********************************************************************//**
   Initialize server specific functions.
 **************************************************************************/
-static void fc_interface_init_server(void)
+void fc_interface_init_server(void)
 {
   struct functions *funcs = fc_interface_funcs();
 
@@ -3615,8 +3788,10 @@ static struct terrain
                               const struct player *pplayer, bool knowledge)
 {
   if (knowledge && pplayer) {
-    struct player_tile *plrtile = map_get_player_tile(ptile, pplayer);
-    return plrtile->terrain;
+    const struct player_tile *plrtile
+      = map_get_player_tile_const(ptile, pplayer);
+
+    return player_tile_terrain(plrtile);
   }
 
   return tile_terrain(ptile);
@@ -3631,8 +3806,10 @@ static struct player *mapimg_server_tile_owner(const struct tile *ptile,
 {
   if (knowledge && pplayer
       && tile_get_known(ptile, pplayer) != TILE_KNOWN_SEEN) {
-    struct player_tile *plrtile = map_get_player_tile(ptile, pplayer);
-    return plrtile->owner;
+    const struct player_tile *plrtile
+      = map_get_player_tile_const(ptile, pplayer);
+
+    return player_tile_owner(plrtile);
   }
 
   return tile_owner(ptile);
@@ -3671,7 +3848,7 @@ static struct player *mapimg_server_tile_unit(const struct tile *ptile,
                                               const struct player *pplayer,
                                               bool knowledge)
 {
-  int unit_count = unit_list_size(ptile->units);
+  int unit_count = unit_stack_size(ptile->units);
 
   if (unit_count == 0) {
     return NULL;
@@ -3682,7 +3859,7 @@ static struct player *mapimg_server_tile_unit(const struct tile *ptile,
     return NULL;
   }
 
-  return unit_owner(unit_list_get(ptile->units, 0));
+  return unit_owner(unit_stack_get(ptile->units, 0));
 }
 
 /**********************************************************************//**
@@ -41,6 +41,7 @@ struct server_arguments {
   /* filenames */
   char *log_filename;
   char *ranklog_filename;
+  char *timing_filename;
   char load_filename[512]; /* FIXME: may not be long enough? use MAX_PATH? */
   char *script_filename;
   char *saves_pathname;
@@ -51,6 +52,10 @@ struct server_arguments {
   int quitidle;
   /* exit the server on game ending */
   bool exit_on_end;
+  /* play this many turns as a benchmark, 0 for no benchmark */
+  int benchmark_turns;
+  /* count the memory held by the parts of the server */
+  bool count_memory;
   /* authentication options */
   bool fcdb_enabled;            /* defaults to FALSE */
   char *fcdb_conf;              /* freeciv database configuration file */
@@ -83,11 +88,15 @@ extern struct civserver {
   unsigned identity_number;
 
   char game_identifier[MAX_LEN_GAME_IDENTIFIER];
+
+  /* Memory for data needed until the end of the turn */
+  struct fc_arena *turn_arena;
 } server;
 
 
 void init_game_seed(void);
 void srv_init(void);
+void fc_interface_init_server(void);
 void srv_main(void);
 void server_quit(void);
 void save_game_auto(const char *save_reason, enum autosave_type type);
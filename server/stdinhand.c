@@ -658,6 +658,42 @@ static bool show_serverid(struct connection *caller, char *arg)
   return TRUE;
 }
 
+/**********************************************************************//**
+  Show the memory held by each part of the server.
+**************************************************************************/
+static bool show_memory(struct connection *caller, char *arg)
+{
+  struct fc_mem_tag_usage usage;
+  long bytes = 0, count = 0;
+  enum mem_tag tag;
+
+  if (!fc_mem_accounting_enabled()) {
+    cmd_reply(CMD_MEMORY, caller, C_FAIL,
+              _("Memory is not being counted. Start the server with "
+                "--count-memory to count it."));
+    return FALSE;
+  }
+
+  cmd_reply(CMD_MEMORY, caller, C_COMMENT, horiz_line);
+  cmd_reply(CMD_MEMORY, caller, C_COMMENT, "%-18s %10s %9s %10s %10s",
+            _("Part"), _("Now (KiB)"), _("Blocks"), _("Peak (KiB)"),
+            _("All blocks"));
+  cmd_reply(CMD_MEMORY, caller, C_COMMENT, horiz_line);
+  for (tag = 0; tag < MEM_TAG_COUNT; tag++) {
+    fc_mem_tag_usage_get(tag, &usage);
+    cmd_reply(CMD_MEMORY, caller, C_COMMENT, "%-18s %10ld %9ld %10ld %10ld",
+              mem_tag_name(tag), usage.bytes / 1024, usage.count,
+              usage.peak_bytes / 1024, usage.total_count);
+    bytes += usage.bytes;
+    count += usage.count;
+  }
+  cmd_reply(CMD_MEMORY, caller, C_COMMENT, horiz_line);
+  cmd_reply(CMD_MEMORY, caller, C_COMMENT, "%-18s %10ld %9ld",
+            _("Total"), bytes / 1024, count);
+
+  return TRUE;
+}
+
 /**********************************************************************//**
   For command "save foo";
   Save the game, with filename=arg, provided server state is ok.
@@ -2822,7 +2858,7 @@ static bool debug_command(struct connection *caller, char *str,
       cmd_reply(CMD_DEBUG, caller, C_SYNTAX, _("Bad map coordinates."));
       goto cleanup;
     }
-    unit_list_iterate(ptile->units, punit) {
+    unit_stack_iterate(ptile->units, punit) {
       if (punit->server.debug) {
         punit->server.debug = FALSE;
         cmd_reply(CMD_DEBUG, caller, C_OK, _("%s %s no longer debugged."),
@@ -2834,7 +2870,7 @@ static bool debug_command(struct connection *caller, char *str,
                  nation_rule_name(nation_of_unit(punit)),
                  unit_name_translation(punit));
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   } else if (ntokens > 0 && strcmp(arg[0], "timing") == 0) {
     TIMING_RESULTS();
   } else if (ntokens > 0 && strcmp(arg[0], "ferries") == 0) {
@@ -4531,6 +4567,8 @@ static bool handle_stdin_input_real(struct connection *caller, char *str,
     return show_help(caller, arg);
   case CMD_SRVID:
     return show_serverid(caller, arg);
+  case CMD_MEMORY:
+    return show_memory(caller, arg);
   case CMD_LIST:
     return show_list(caller, arg);
   case CMD_AITOGGLE:
@@ -43,6 +43,7 @@
 #include "specialist.h"
 #include "traderoutes.h"
 #include "unit.h"
+#include "unitgrid.h"
 #include "unitlist.h"
 
 /* common/scriptcore */
@@ -296,7 +297,7 @@ static bool do_capture_units(struct player *pplayer,
   /* Sanity check: make sure that the capture won't result in the actor
    * ending up with more than one unit of each unique unit type. */
   BV_CLR_ALL(unique_on_tile);
-  unit_list_iterate(pdesttile->units, to_capture) {
+  unit_stack_iterate(pdesttile->units, to_capture) {
     bool unique_conflict = FALSE;
 
     /* Check what the player already has. */
@@ -331,13 +332,13 @@ static bool do_capture_units(struct player *pplayer,
 
       return FALSE;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   /* N.B: unit_link() always returns the same pointer. */
   sz_strlcpy(capturer_link, unit_link(punit));
 
   pcity = tile_city(pdesttile);
-  unit_list_iterate(pdesttile->units, to_capture) {
+  unit_stack_iterate(pdesttile->units, to_capture) {
     struct player *uplayer = unit_owner(to_capture);
     const char *victim_link;
 
@@ -372,7 +373,7 @@ static bool do_capture_units(struct player *pplayer,
       /* The captured unit is in a city. Bounce it. */
       bounce_unit(to_capture, TRUE);
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   unit_did_action(punit);
   unit_forget_last_activity(punit);
@@ -432,7 +433,7 @@ static bool do_wipe_units(struct unit *punit,
   /* N.B: unit_link() always returns the same pointer. */
   sz_strlcpy(wiper_link, unit_link(punit));
 
-  unit_list_iterate_safe(pdesttile->units, to_wipe) {
+  unit_stack_iterate_safe(pdesttile->units, to_wipe) {
     struct player *owner = unit_owner(to_wipe);
     const char *victim_link = unit_link(to_wipe);
 
@@ -454,7 +455,7 @@ static bool do_wipe_units(struct unit *punit,
     action_consequence_success(paction, wiper, act_utype, owner,
                                pdesttile, victim_link);
 
-  } unit_list_iterate_safe_end;
+  } unit_stack_iterate_safe_end;
 
   occupy_move(pdesttile, punit, paction);
 
@@ -1095,12 +1096,12 @@ static struct player *need_war_player_hlp(const struct unit *actor,
       return NULL;
     }
 
-    unit_list_iterate(target_tile->units, tunit) {
+    unit_stack_iterate(target_tile->units, tunit) {
       if (rel_may_become_war(actor_player, unit_owner(tunit))) {
         target_player = unit_owner(tunit);
         break;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
     break;
   case ATK_TILE:
     if (target_tile == NULL) {
@@ -1199,12 +1200,12 @@ static bool
 tile_has_units_not_allied_to_but_seen_by(const struct tile *ptile,
                                          const struct player *pplayer)
 {
-  unit_list_iterate(ptile->units, pother) {
+  unit_stack_iterate(ptile->units, pother) {
     if (can_player_see_unit(pplayer, pother)
         && !pplayers_allied(pplayer, unit_owner(pother))) {
       return TRUE;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return FALSE;
 }
@@ -1385,8 +1386,8 @@ static struct ane_expl *expl_act_not_enabl(struct unit *punit,
       /* A unit stack may contain units with multiple owners. Pick the
        * first one. */
       if (target_tile
-          && unit_list_size(target_tile->units) > 0) {
-        tgt_player = unit_owner(unit_list_get(target_tile->units, 0));
+          && unit_stack_size(target_tile->units) > 0) {
+        tgt_player = unit_owner(unit_stack_get(target_tile->units, 0));
       }
       break;
     case ATK_SELF:
@@ -2166,7 +2167,7 @@ void handle_unit_get_actions(struct connection *pc,
   /* The player may have outdated information about the target tile.
    * Limiting the player knowledge look up to the target tile is OK since
    * all targets must be located at it. */
-  plrtile = map_get_player_tile(target_tile, actor_player);
+  plrtile = map_get_player_tile_const(target_tile, actor_player);
 
   /* Distance between actor and target tile. */
   actor_target_distance = real_map_distance(unit_tile(actor_unit),
@@ -3882,7 +3883,9 @@ void unit_change_homecity_handling(struct unit *punit, struct city *new_pcity,
 
     unit_list_remove(old_owner->units, punit);
     unit_list_prepend(new_owner->units, punit);
+    unit_grid_remove(punit);
     punit->owner = new_owner;
+    unit_grid_add(&wld, punit);
 
     /* Activate AI control of the new owner. */
     CALL_PLR_AI_FUNC(unit_got, new_owner, punit);
@@ -4363,7 +4366,7 @@ static bool unit_bombard(struct unit *punit, struct tile *ptile,
             nation_rule_name(nation_of_player(pplayer)),
             unit_rule_name(punit), TILE_XY(ptile));
 
-  unit_list_iterate_safe(ptile->units, pdefender) {
+  unit_stack_iterate_safe(ptile->units, pdefender) {
     if (is_unit_reachable_at(pdefender, punit, ptile)) {
       bool adj;
       enum direction8 facing;
@@ -4439,7 +4442,7 @@ static bool unit_bombard(struct unit *punit, struct tile *ptile,
       }
     }
 
-  } unit_list_iterate_safe_end;
+  } unit_stack_iterate_safe_end;
 
   unit_did_action(punit);
   unit_forget_last_activity(punit);
@@ -6084,7 +6087,7 @@ static void unit_activity_dependencies(struct unit *punit,
     case ACTIVITY_PILLAGE: 
       {
         if (old_target != NULL) {
-          unit_list_iterate_safe(unit_tile(punit)->units, punit2) {
+          unit_stack_iterate_safe(unit_tile(punit)->units, punit2) {
             if (punit2->activity == ACTIVITY_PILLAGE) {
               extra_deps_iterate(&(punit2->activity_target->reqs), pdep) {
                 if (pdep == old_target) {
@@ -6094,7 +6097,7 @@ static void unit_activity_dependencies(struct unit *punit,
                 }
               } extra_deps_iterate_end;
             }
-          } unit_list_iterate_safe_end;
+          } unit_stack_iterate_safe_end;
         }
         break;
       }
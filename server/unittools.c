@@ -106,6 +106,9 @@ struct unit_move_data {
   TYPED_LIST_ITERATE_REV(struct unit_move_data, _plist, _pdata)
 #define unit_move_data_list_iterate_rev_end LIST_ITERATE_REV_END
 
+/* Unit move data kept for reuse */
+static struct fc_pool *move_data_pool = NULL;
+
 /* This data structure lets the auto attack code cache each potential
  * attacker unit's probability of success against the target unit during
  * the checks if the unit can do autoattack. It is then reused when the
@@ -703,12 +706,12 @@ static int total_activity(struct tile *ptile, enum unit_activity act,
   int total = 0;
   bool tgt_matters = activity_requires_target(act);
 
-  unit_list_iterate(ptile->units, punit) {
+  unit_stack_iterate(ptile->units, punit) {
     if (punit->activity == act
         && (!tgt_matters || punit->activity_target == tgt)) {
       total += punit->activity_count;
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 
   return total;
 }
@@ -781,7 +784,7 @@ static void unit_convert(struct unit *punit)
 **************************************************************************/
 void unit_activities_cancel_all_illegal(const struct tile *ptile)
 {
-  unit_list_iterate(ptile->units, punit2) {
+  unit_stack_iterate(ptile->units, punit2) {
     if (!can_unit_continue_current_activity(punit2)) {
       if (unit_has_orders(punit2)) {
         notify_player(unit_owner(punit2), unit_tile(punit2),
@@ -795,7 +798,7 @@ void unit_activities_cancel_all_illegal(const struct tile *ptile)
       set_unit_activity(punit2, ACTIVITY_IDLE);
       send_unit_info(NULL, punit2);
     }
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 }
 
 /**********************************************************************//**
@@ -882,7 +885,7 @@ static void update_unit_activity(struct unit *punit)
       bounce_units_on_terrain_change(ptile);
 
       /* Change vision if effects have changed. */
-      unit_list_refresh_vision(ptile->units);
+      unit_stack_refresh_vision(ptile->units);
     }
     break;
 
@@ -968,19 +971,19 @@ static void update_unit_activity(struct unit *punit)
        * Probably ACTIVITY_TRANSFORM should be associated to its terrain
        * target, whereas ACTIVITY_IRRIGATE and ACTIVITY_MINE should only
        * used for extras. */
-      unit_list_iterate(ptile->units, punit2) {
+      unit_stack_iterate(ptile->units, punit2) {
         if (punit2->activity == activity) {
           set_unit_activity(punit2, ACTIVITY_IDLE);
           send_unit_info(NULL, punit2);
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     } else {
-      unit_list_iterate(ptile->units, punit2) {
+      unit_stack_iterate(ptile->units, punit2) {
         if (!can_unit_continue_current_activity(punit2)) {
           set_unit_activity(punit2, ACTIVITY_IDLE);
           send_unit_info(NULL, punit2);
         }
-      } unit_list_iterate_end;
+      } unit_stack_iterate_end;
     }
 
     tile_changing_activities_iterate(act) {
@@ -1113,7 +1116,7 @@ static bool find_a_good_partisan_spot(struct tile *pcenter,
       continue;
     }
 
-    if (0 < unit_list_size(ptile->units)) {
+    if (0 < unit_stack_size(ptile->units)) {
       continue;
     }
 
@@ -1351,13 +1354,13 @@ static void resolve_stack_conflicts(struct player *pplayer,
     struct tile *ptile = unit_tile(punit);
 
     if (is_non_allied_unit_tile(ptile, pplayer)) {
-      unit_list_iterate_safe(ptile->units, aunit) {
+      unit_stack_iterate_safe(ptile->units, aunit) {
         if (unit_owner(aunit) == pplayer
             || unit_owner(aunit) == aplayer
             || !can_unit_survive_at_tile(&(wld.map), aunit, ptile)) {
           bounce_unit(aunit, verbose);
         }
-      } unit_list_iterate_safe_end;
+      } unit_stack_iterate_safe_end;
     }    
   } unit_list_iterate_safe_end;
 }
@@ -1395,11 +1398,11 @@ struct unit_list *get_units_seen_via_ally(const struct player *pplayer,
 
   /* Anybody's units inside ally's cities */
   city_list_iterate(aplayer->cities, pcity) {
-    unit_list_iterate(city_tile(pcity)->units, punit) {
+    unit_stack_iterate(city_tile(pcity)->units, punit) {
       if (can_player_see_unit(pplayer, punit)) {
         unit_list_append(seen_units, punit);
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   } city_list_iterate_end;
 
   /* Ally's own units inside transports */
@@ -1494,7 +1497,8 @@ bool is_airunit_refuel_point(const struct tile *ptile,
 
   pclass = unit_class_get(punit);
   if (NULL != pclass->cache.refuel_bases) {
-    const struct player_tile *plrtile = map_get_player_tile(ptile, pplayer);
+    const struct player_tile *plrtile
+      = map_get_player_tile_const(ptile, pplayer);
 
     extra_type_list_iterate(pclass->cache.refuel_bases, pextra) {
       if (BV_ISSET(plrtile->extras, extra_index(pextra))) {
@@ -1647,7 +1651,7 @@ struct unit *create_unit_full(struct player *pplayer, struct tile *ptile,
   punit->moved = (moves_left >= 0);
 
   unit_list_prepend(pplayer->units, punit);
-  unit_list_prepend(ptile->units, punit);
+  unit_stack_prepend(ptile->units, punit);
   if (pcity && !utype_has_flag(type, UTYF_NOHOME)) {
     fc_assert(city_owner(pcity) == pplayer);
     unit_list_prepend(pcity->units_supported, punit);
@@ -1718,9 +1722,9 @@ static void server_remove_unit_full(struct unit *punit, bool transported,
   punit->server.dying = TRUE;
 
 #ifdef FREECIV_DEBUG
-  unit_list_iterate(ptile->units, pcargo) {
+  unit_stack_iterate(ptile->units, pcargo) {
     fc_assert(unit_transport_get(pcargo) != punit);
-  } unit_list_iterate_end;
+  } unit_stack_iterate_end;
 #endif /* FREECIV_DEBUG */
 
   CALL_PLR_AI_FUNC(unit_lost, pplayer, punit);
@@ -1807,7 +1811,7 @@ static void server_remove_unit_full(struct unit *punit, bool transported,
     send_city_info(city_owner(pcity), pcity);
   }
 
-  if (pcity && unit_list_size(ptile->units) == 0) {
+  if (pcity && unit_stack_size(ptile->units) == 0) {
     /* The last unit in the city was killed: update the occupied flag. */
     send_city_info(NULL, pcity);
   }
@@ -2235,16 +2239,16 @@ void kill_unit(struct unit *pkiller, struct unit *punit, bool vet)
       && uclass_has_flag(unit_class_get(pkiller), UCF_COLLECT_RANSOM)) {
     collect_ransom = TRUE;
 
-    unit_list_iterate(unit_tile(punit)->units, capture) {
+    unit_stack_iterate(unit_tile(punit)->units, capture) {
       if (!unit_has_type_role(capture, L_BARBARIAN_LEADER)) {
         /* Cannot get ransom when there are other kind of units in the tile */
         collect_ransom = FALSE;
         break;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
 
     if (collect_ransom) {
-      unitcount = unit_list_size(unit_tile(punit)->units);
+      unitcount = unit_stack_size(unit_tile(punit)->units);
       ransom = unitcount * game.server.ransom_gold;
 
       if (pvictim->economic.gold < ransom) {
@@ -2268,11 +2272,11 @@ void kill_unit(struct unit *pkiller, struct unit *punit, bool vet)
   }
 
   if (unitcount == 0) {
-    unit_list_iterate(unit_tile(punit)->units, vunit) {
+    unit_stack_iterate(unit_tile(punit)->units, vunit) {
       if (pplayers_at_war(pvictor, unit_owner(vunit))) {
 	unitcount++;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   }
 
   if (!is_stack_vulnerable(unit_tile(punit)) || unitcount == 1) {
@@ -2297,7 +2301,7 @@ void kill_unit(struct unit *pkiller, struct unit *punit, bool vet)
     }
 
     /* count killed units */
-    unit_list_iterate(ptile->units, vunit) {
+    unit_stack_iterate(ptile->units, vunit) {
       struct player *vplayer = unit_owner(vunit);
 
       if (pplayers_at_war(pvictor, vplayer)
@@ -2322,7 +2326,7 @@ void kill_unit(struct unit *pkiller, struct unit *punit, bool vet)
               move_cost = map_move_cost_unit(&(wld.map), vunit, ptile2);
               if (pkiller->moves_left <= vunit->moves_left - move_cost
                   && (is_allied_unit_tile(ptile2, pvictim)
-                      || unit_list_size(ptile2->units)) == 0) {
+                      || unit_stack_size(ptile2->units)) == 0) {
                 curr_def_bonus = tile_extras_defense_bonus(ptile2,
                                                            vunit->utype);
                 if (def_bonus <= curr_def_bonus) {
@@ -2356,7 +2360,7 @@ void kill_unit(struct unit *pkiller, struct unit *punit, bool vet)
           }
         }
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
 
     /* Inform the destroyer again if more than one unit was killed */
     if (unitcount > 1 && !collect_ransom) {
@@ -2472,12 +2476,12 @@ void kill_unit(struct unit *pkiller, struct unit *punit, bool vet)
      * must be mimiced exactly in at least one place up above. */
     punit = NULL; /* wiped during following iteration so unsafe to use */
 
-    unit_list_iterate_safe(ptile->units, punit2) {
+    unit_stack_iterate_safe(ptile->units, punit2) {
       if (pplayers_at_war(pvictor, unit_owner(punit2))
 	  && is_unit_reachable_at(punit2, pkiller, ptile)) {
         wipe_unit(punit2, ULR_KILLED, pvictor);
       }
-    } unit_list_iterate_safe_end;
+    } unit_stack_iterate_safe_end;
   }
 }
 
@@ -2701,7 +2705,7 @@ static void do_nuke_tile(struct player *pplayer, struct tile *ptile,
 
   pcity = tile_city(ptile);
 
-  unit_list_iterate_safe(ptile->units, punit) {
+  unit_stack_iterate_safe(ptile->units, punit) {
 
     /* unit in a city may survive */
     if (pcity && fc_rand(100) < game.info.nuke_defender_survival_chance_pct) {
@@ -2720,7 +2724,7 @@ static void do_nuke_tile(struct player *pplayer, struct tile *ptile,
                     unit_tile_link(punit));
     }
     wipe_unit(punit, ULR_NUKE, pplayer);
-  } unit_list_iterate_safe_end;
+  } unit_stack_iterate_safe_end;
 
 
   if (pcity) {
@@ -2891,20 +2895,23 @@ bool do_paradrop(struct unit *punit, struct tile *ptile,
    */
   if (!map_is_known_and_seen(ptile, pplayer, V_MAIN)) {
     /* Only take in account values from player map. */
-    const struct player_tile *plrtile = map_get_player_tile(ptile, pplayer);
+    const struct player_tile *plrtile
+      = map_get_player_tile_const(ptile, pplayer);
+    struct terrain *pterrain = player_tile_terrain(plrtile);
+    struct player *powner = player_tile_owner(plrtile);
 
     if (NULL == plrtile->site
-        && !is_native_to_class(unit_class_get(punit), plrtile->terrain,
+        && !is_native_to_class(unit_class_get(punit), pterrain,
                                &(plrtile->extras))) {
       notify_player(pplayer, ptile, E_BAD_COMMAND, ftc_server,
                     _("This unit cannot paradrop into %s."),
-                    terrain_name_translation(plrtile->terrain));
+                    terrain_name_translation(pterrain));
       return FALSE;
     }
 
     if (NULL != plrtile->site
-        && plrtile->owner != NULL
-        && !pplayers_allied(pplayer, plrtile->owner)
+        && powner != NULL
+        && !pplayers_allied(pplayer, powner)
         && !action_has_result(paction, ACTRES_PARADROP_CONQUER)) {
       notify_player(pplayer, ptile, E_BAD_COMMAND, ftc_server,
                     /* Trans: Paratroopers ... Paradrop Unit */
@@ -2915,11 +2922,11 @@ bool do_paradrop(struct unit *punit, struct tile *ptile,
     }
 
     if (NULL != plrtile->site
-        && plrtile->owner != NULL
-        && (pplayers_non_attack(pplayer, plrtile->owner)
-            || (player_diplstate_get(pplayer, plrtile->owner)->type
+        && powner != NULL
+        && (pplayers_non_attack(pplayer, powner)
+            || (player_diplstate_get(pplayer, powner)->type
                 == DS_ALLIANCE)
-            || (player_diplstate_get(pplayer, plrtile->owner)->type
+            || (player_diplstate_get(pplayer, powner)->type
                 == DS_TEAM))
         && action_has_result(paction, ACTRES_PARADROP_CONQUER)) {
       notify_player(pplayer, ptile, E_BAD_COMMAND, ftc_server,
@@ -3137,15 +3144,6 @@ void unit_transport_unload_send(struct unit *punit)
   send_unit_info(NULL, ptrans);
 }
 
-/**********************************************************************//**
-  Used when unit_survive_autoattack()'s autoattack_prob_list
-  autoattack frees its items.
-**************************************************************************/
-static void autoattack_prob_free(struct autoattack_prob *prob)
-{
-  free(prob);
-}
-
 /**********************************************************************//**
   This function is passed to autoattack_prob_list_sort() to sort a list of
   units and action probabilities according to their win chance against the
@@ -3200,6 +3198,7 @@ static int compare_units(const struct autoattack_prob *const *p1,
 static bool unit_survive_autoattack(struct unit *punit)
 {
   struct autoattack_prob_list *autoattack;
+  struct fc_arena_mark mark;
   int moves = punit->moves_left;
   int sanity1 = punit->id;
 
@@ -3207,32 +3206,35 @@ static bool unit_survive_autoattack(struct unit *punit)
     return TRUE;
   }
 
-  autoattack = autoattack_prob_list_new_full(autoattack_prob_free);
+  /* The items live in the turn arena until the list goes away. */
+  fc_arena_mark(server.turn_arena, &mark);
+  autoattack = autoattack_prob_list_new();
 
   /* Kludge to prevent attack power from dropping to zero during calc */
   punit->moves_left = MAX(punit->moves_left, 1);
 
   adjc_iterate(&(wld.map), unit_tile(punit), ptile) {
     /* First add all eligible units to a autoattack list */
-    unit_list_iterate(ptile->units, penemy) {
-      struct autoattack_prob *probability = fc_malloc(sizeof(*probability));
+    unit_stack_iterate(ptile->units, penemy) {
       struct tile *tgt_tile = unit_tile(punit);
+      struct act_prob prob;
 
       fc_assert_action(tgt_tile, continue);
 
-      probability->prob =
-          action_auto_perf_unit_prob(AAPC_UNIT_MOVED_ADJ,
-                                     penemy, unit_owner(punit), NULL, NULL,
-                                     tgt_tile, tile_city(tgt_tile),
-                                     punit, NULL);
+      prob = action_auto_perf_unit_prob(AAPC_UNIT_MOVED_ADJ,
+                                        penemy, unit_owner(punit), NULL, NULL,
+                                        tgt_tile, tile_city(tgt_tile),
+                                        punit, NULL);
+
+      if (action_prob_possible(prob)) {
+        struct autoattack_prob *probability
+          = fc_arena_alloc(server.turn_arena, sizeof(*probability));
 
-      if (action_prob_possible(probability->prob)) {
+        probability->prob = prob;
         probability->unit_id = penemy->id;
         autoattack_prob_list_prepend(autoattack, probability);
-      } else {
-        FC_FREE(probability);
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   } adjc_iterate_end;
 
   /* Sort the potential attackers from highest to lowest success
@@ -3251,7 +3253,7 @@ static bool unit_survive_autoattack(struct unit *punit)
 
     fc_assert(tgt_tile);
 
-    if (tile_city(ptile) && unit_list_size(ptile->units) == 1) {
+    if (tile_city(ptile) && unit_stack_size(ptile->units) == 1) {
       /* Don't leave city defenseless */
       threshold = 0.90;
     }
@@ -3310,11 +3312,13 @@ static bool unit_survive_autoattack(struct unit *punit)
       send_unit_info(NULL, punit);
     } else {
       autoattack_prob_list_destroy(autoattack);
+      fc_arena_release(server.turn_arena, &mark);
       return FALSE; /* moving unit dead */
     }
   } autoattack_prob_list_iterate_safe_end;
 
   autoattack_prob_list_destroy(autoattack);
+  fc_arena_release(server.turn_arena, &mark);
   if (game_unit_by_number(sanity1)) {
     /* We could have lost movement in combat */
     punit->moves_left = MIN(punit->moves_left, moves);
@@ -3346,12 +3350,12 @@ static void wakeup_neighbor_sentries(struct unit *punit)
   if (NULL != tile_city(unit_tile(punit))) {
     int count = 0;
 
-    unit_list_iterate(unit_tile(punit)->units, aunit) {
+    unit_stack_iterate(unit_tile(punit)->units, aunit) {
       /* Consider only units not transported. */
       if (!unit_transported(aunit)) {
         count++;
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
 
     alone_in_city = (1 == count);
   } else {
@@ -3361,7 +3365,7 @@ static void wakeup_neighbor_sentries(struct unit *punit)
   /* There may be sentried units with a sightrange > 3, but we don't
      wake them up if the punit is farther away than 3. */
   square_iterate(&(wld.map), unit_tile(punit), 3, ptile) {
-    unit_list_iterate(ptile->units, penemy) {
+    unit_stack_iterate(ptile->units, penemy) {
       int distance_sq = sq_map_distance(unit_tile(punit), ptile);
       int radius_sq = get_unit_vision_at(penemy, unit_tile(penemy), V_MAIN);
 
@@ -3377,13 +3381,13 @@ static void wakeup_neighbor_sentries(struct unit *punit)
         set_unit_activity(penemy, ACTIVITY_IDLE);
         send_unit_info(NULL, penemy);
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   } square_iterate_end;
 
   /* Wakeup patrolling units we bump into.
      We do not wakeup units further away than 3 squares... */
   square_iterate(&(wld.map), unit_tile(punit), 3, ptile) {
-    unit_list_iterate(ptile->units, ppatrol) {
+    unit_stack_iterate(ptile->units, ppatrol) {
       if (punit != ppatrol
 	  && unit_has_orders(ppatrol)
 	  && ppatrol->orders.vigilant) {
@@ -3396,7 +3400,7 @@ static void wakeup_neighbor_sentries(struct unit *punit)
                         unit_link(ppatrol));
         }
       }
-    } unit_list_iterate_end;
+    } unit_stack_iterate_end;
   } square_iterate_end;
 }
 
@@ -3602,7 +3606,10 @@ static struct unit_move_data *unit_move_data(struct unit *punit,
                   "Unit number %d (%p) has done an incomplete move.",
                   punit->id, punit);
   } else {
-    pdata = fc_malloc(sizeof(*pdata));
+    if (move_data_pool == NULL) {
+      move_data_pool = fc_pool_new(sizeof(*pdata));
+    }
+    pdata = fc_pool_alloc(move_data_pool);
     pdata->ref_count = 1;
     pdata->punit = punit;
     punit->server.moving = pdata;
@@ -3614,12 +3621,12 @@ static struct unit_move_data *unit_move_data(struct unit *punit,
 
   /* Remove unit from the source tile. */
   fc_assert(unit_tile(punit) == psrctile);
-  success = unit_list_remove(psrctile->units, punit);
+  success = unit_stack_remove(psrctile->units, punit);
   fc_assert(success == TRUE);
 
   /* Set new tile. */
   unit_tile_set(punit, pdesttile);
-  unit_list_prepend(pdesttile->units, punit);
+  unit_stack_prepend(pdesttile->units, punit);
 
   if (unit_transported(punit)) {
     /* Silently free orders since they won't be applicable anymore. */
@@ -3663,7 +3670,19 @@ static void unit_move_data_unref(struct unit_move_data *pdata)
       fc_assert(pdata->punit->server.moving == pdata);
       pdata->punit->server.moving = NULL;
     }
-    free(pdata);
+    fc_pool_free(move_data_pool, pdata);
+  }
+}
+
+/**********************************************************************//**
+  Free the unit move data kept for reuse. There must be no unit moves
+  in progress.
+**************************************************************************/
+void unit_move_data_pool_free(void)
+{
+  if (move_data_pool != NULL) {
+    fc_pool_destroy(move_data_pool);
+    move_data_pool = NULL;
   }
 }
 
@@ -4636,6 +4655,16 @@ void unit_list_refresh_vision(struct unit_list *punitlist)
   } unit_list_iterate_end;
 }
 
+/**********************************************************************//**
+  Refresh the vision of all units in the stack - see unit_refresh_vision.
+**************************************************************************/
+void unit_stack_refresh_vision(struct unit_stack *pstack)
+{
+  unit_stack_iterate(pstack, punit) {
+    unit_refresh_vision(punit);
+  } unit_stack_iterate_end;
+}
+
 /**********************************************************************//**
   Used to implement the game rule controlled by the unitwaittime setting.
   Notifies the unit owner if the unit is unable to act.
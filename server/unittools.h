@@ -114,12 +114,14 @@ int get_unit_vision_at(struct unit *punit, const struct tile *ptile,
                        enum vision_layer vlayer);
 void unit_refresh_vision(struct unit *punit);
 void unit_list_refresh_vision(struct unit_list *punitlist);
+void unit_stack_refresh_vision(struct unit_stack *pstack);
 void bounce_unit(struct unit *punit, bool verbose);
 bool unit_activity_needs_target_from_client(enum unit_activity activity);
 void unit_assign_specific_activity_target(struct unit *punit,
                                           enum unit_activity *activity,
                                           struct extra_type **target);
 void unit_forget_last_activity(struct unit *punit);
+void unit_move_data_pool_free(void);
 
 /* creation/deletion/upgrading */
 void transform_unit(struct unit *punit, const struct unit_type *to_unit,
@@ -0,0 +1,413 @@
+/***********************************************************************
+ Freeciv - Copyright (C) 1996 - A Kjeldberg, L Gregersen, P Unold
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+***********************************************************************/
+
+/*
+ * freeciv-cmbench loads savegames and runs the city governor (CM) for
+ * every city of them under a set of parameter presets, timing the
+ * queries and collecting the size of the problems the CM solved.  It
+ * is meant for judging CM changes on real game data.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <fc_config.h>
+#endif
+
+#include <signal.h>
+#include <stdlib.h>
+
+#ifdef FREECIV_MSWINDOWS
+#include <windows.h>
+#endif
+
+/* utility */
+#include "fc_cmdline.h"
+#include "fciconv.h"
+#include "fcintl.h"
+#include "log.h"
+#include "registry.h"
+#include "support.h"
+#include "timing.h"
+
+/* common */
+#include "capstr.h"
+#include "city.h"
+#include "fc_cmdhelp.h"
+#include "fc_interface.h"
+#include "game.h"
+#include "map.h"
+#include "player.h"
+#include "tile.h"
+
+/* common/aicore */
+#include "cm.h"
+
+/* server */
+#include "console.h"
+#include "diplhand.h"
+#include "edithand.h"
+#include "sernet.h"
+#include "settings.h"
+#include "srv_main.h"
+#include "stdinhand.h"
+#include "voting.h"
+
+/* A named parameter to query the cities with. */
+struct cmbench_preset {
+  const char *name;
+  struct cm_parameter parameter;
+};
+
+/* What the queries of one preset took, over all savegames. */
+struct cmbench_result {
+  int queries;
+  int valid;
+  int aborted;
+  struct timer *timer;
+  long lattice_sum;
+  int lattice_max;
+  long nodes_sum;
+  int nodes_max;
+};
+
+/* The same as the presets of the client governor, plus the defaults. */
+static struct cmbench_preset presets[] = {
+  { "default", { { 0, } } },
+  { "emergency", { { 0, } } },
+  { "very happy",
+    { .minimal_surplus = {0, 0, 0, -20, 0, 0},
+      .allow_specialists = TRUE,
+      .factor = {10, 5, 0, 4, 0, 4},
+      .happy_factor = 25 } },
+  { "prefer food",
+    { .minimal_surplus = {-20, 0, 0, -20, 0, 0},
+      .allow_specialists = TRUE,
+      .factor = {25, 5, 0, 4, 0, 4} } },
+  { "prefer production",
+    { .minimal_surplus = {0, -20, 0, -20, 0, 0},
+      .allow_specialists = TRUE,
+      .factor = {10, 25, 0, 4, 0, 4} } },
+  { "prefer gold",
+    { .minimal_surplus = {0, 0, 0, -20, 0, 0},
+      .allow_specialists = TRUE,
+      .factor = {10, 5, 0, 25, 0, 4} } },
+  { "prefer science",
+    { .minimal_surplus = {0, 0, 0, -20, 0, 0},
+      .allow_specialists = TRUE,
+      .factor = {10, 5, 0, 4, 0, 25} } }
+};
+
+static struct cmbench_result results[ARRAY_SIZE(presets)];
+
+static int repeat = 1;
+static bool keep_state = FALSE;
+
+/**********************************************************************//**
+  Parse freeciv-cmbench commandline parameters.  Returns the index of the
+  first savegame argument.
+**************************************************************************/
+static int cmbench_parse_cmdline(int argc, char *argv[])
+{
+  int i = 1;
+
+  while (i < argc && argv[i][0] == '-') {
+    char *option = NULL;
+
+    if (is_option("--help", argv[i])) {
+      struct cmdhelp *help = cmdhelp_new(argv[0]);
+
+      cmdhelp_add(help, "h", "help",
+                  _("Print a summary of the options"));
+      cmdhelp_add(help, "d",
+                  /* TRANS: "debug" is exactly what user must type, do not translate. */
+                  _("debug NUM"),
+                  _("Set debug log level (%d to %d)"),
+                  LOG_FATAL, LOG_DEBUG);
+#ifndef FREECIV_NDEBUG
+      cmdhelp_add(help, "F",
+                  /* TRANS: "Fatal" is exactly what user must type, do not translate. */
+                  _("Fatal [SIGNAL]"),
+                  _("Raise a signal on failed assertion"));
+#endif /* FREECIV_NDEBUG */
+      cmdhelp_add(help, "r",
+                  /* TRANS: "repeat" is exactly what user must type, do not translate. */
+                  _("repeat NUM"),
+                  _("Query every city NUM times with each preset"));
+      cmdhelp_add(help, "k", "keep-state",
+                  _("Keep the CM state between queries, and take a tile "
+                    "from the city and give it back between them, so "
+                    "that the queries update the state instead of "
+                    "starting from scratch"));
+
+      /* The function below prints a header and footer for the options.
+       * Furthermore, the options are sorted. */
+      cmdhelp_display(help, TRUE, FALSE, TRUE);
+      cmdhelp_destroy(help);
+
+      fc_fprintf(stdout, _("Usage: %s [option ...] savegame ...\n"),
+                 argv[0]);
+      cmdline_option_values_free();
+      exit(EXIT_SUCCESS);
+    } else if ((option = get_option_malloc("--debug", argv, &i, argc,
+                                           FALSE))) {
+      if (!log_parse_level_str(option, &srvarg.loglevel)) {
+        fc_fprintf(stderr, _("Invalid debug level \"%s\".\n"), option);
+        exit(EXIT_FAILURE);
+      }
+      free(option);
+#ifndef FREECIV_NDEBUG
+    } else if (is_option("--Fatal", argv[i])) {
+      if (i + 1 >= argc || '-' == argv[i + 1][0]) {
+        srvarg.fatal_assertions = SIGABRT;
+      } else if (str_to_int(argv[i + 1], &srvarg.fatal_assertions)) {
+        i++;
+      } else {
+        fc_fprintf(stderr, _("Invalid signal number \"%s\".\n"),
+                   argv[i + 1]);
+        fc_fprintf(stderr, _("Try using --help.\n"));
+        exit(EXIT_FAILURE);
+      }
+#endif /* FREECIV_NDEBUG */
+    } else if ((option = get_option_malloc("--repeat", argv, &i, argc,
+                                           FALSE))) {
+      if (!str_to_int(option, &repeat) || repeat < 1) {
+        fc_fprintf(stderr, _("Invalid repeat count \"%s\".\n"), option);
+        exit(EXIT_FAILURE);
+      }
+      free(option);
+    } else if (is_option("--keep-state", argv[i])) {
+      keep_state = TRUE;
+    } else {
+      fc_fprintf(stderr, _("Unrecognized option: \"%s\"\n"), argv[i]);
+      cmdline_option_values_free();
+      exit(EXIT_FAILURE);
+    }
+    i++;
+  }
+
+  return i;
+}
+
+/**********************************************************************//**
+  Returns a tile the city can work but does not, or NULL if there is
+  none.
+**************************************************************************/
+static struct tile *cmbench_spare_tile(const struct city *pcity)
+{
+  city_tile_iterate(city_map_radius_sq_get(pcity), city_tile(pcity),
+                    ptile) {
+    if (tile_worked(ptile) == NULL && city_can_work_tile(pcity, ptile)) {
+      return ptile;
+    }
+  } city_tile_iterate_end;
+
+  return NULL;
+}
+
+/**********************************************************************//**
+  Run the queries of one preset for every city of the loaded game.
+
+  With --keep-state every query is solved from the state kept in the
+  city rather than answered from the kept results.  Between the queries
+  of a city one of its tiles is given to another player and back, so
+  that the state has a changed tile to update.
+**************************************************************************/
+static void cmbench_run_preset(const struct cm_parameter *parameter,
+                               struct cmbench_result *res)
+{
+  players_iterate(pplayer) {
+    struct player *other = NULL;
+
+    players_iterate(pother) {
+      if (pother != pplayer) {
+        other = pother;
+        break;
+      }
+    } players_iterate_end;
+
+    city_list_iterate(pplayer->cities, pcity) {
+      struct cm_result *cmr = cm_result_new(pcity);
+      struct tile *spare = NULL;
+      struct player *spare_owner = NULL;
+      struct tile *spare_claimer = NULL;
+      int i;
+
+      if (keep_state && other != NULL) {
+        spare = cmbench_spare_tile(pcity);
+      }
+      if (spare != NULL) {
+        spare_owner = tile_owner(spare);
+        spare_claimer = tile_claimer(spare);
+      }
+
+      for (i = 0; i < repeat; i++) {
+        struct cm_search_stats stats;
+
+        if (!keep_state) {
+          cm_clear_cache(pcity);
+        } else {
+          if (spare != NULL && i > 0) {
+            if (i % 2 == 1) {
+              tile_set_owner(spare, other, spare_claimer);
+            } else {
+              tile_set_owner(spare, spare_owner, spare_claimer);
+            }
+          }
+          cm_clear_results(pcity);
+        }
+
+        timer_start(res->timer);
+        cm_query_result(pcity, parameter, cmr, FALSE);
+        timer_stop(res->timer);
+
+        res->queries++;
+        if (cmr->found_a_valid) {
+          res->valid++;
+        }
+        if (cmr->aborted) {
+          res->aborted++;
+        }
+        if (cm_search_stats_get(pcity, &stats)) {
+          res->lattice_sum += stats.lattice_size;
+          res->lattice_max = MAX(res->lattice_max, stats.lattice_size);
+          res->nodes_sum += stats.nodes;
+          res->nodes_max = MAX(res->nodes_max, stats.nodes);
+        }
+      }
+
+      if (spare != NULL) {
+        tile_set_owner(spare, spare_owner, spare_claimer);
+      }
+      cm_result_destroy(cmr);
+    } city_list_iterate_end;
+  } players_iterate_end;
+}
+
+/**********************************************************************//**
+  Print what the queries took.
+**************************************************************************/
+static void cmbench_report(void)
+{
+  int total_queries = 0;
+  double total_seconds = 0.0;
+  int i;
+
+  log_normal("%-18s %8s %8s %8s %9s %10s %13s %15s",
+             "preset", "queries", "valid", "aborted", "seconds",
+             "queries/s", "lattice/max", "nodes/max");
+  for (i = 0; i < ARRAY_SIZE(presets); i++) {
+    const struct cmbench_result *res = &results[i];
+    double seconds = timer_read_seconds(res->timer);
+    int queries = MAX(res->queries, 1);
+
+    log_normal("%-18s %8d %8d %8d %9.3f %10.1f %7.1f/%-5d %8.1f/%-6d",
+               presets[i].name, res->queries, res->valid, res->aborted,
+               seconds, seconds > 0.0 ? res->queries / seconds : 0.0,
+               (double) res->lattice_sum / queries, res->lattice_max,
+               (double) res->nodes_sum / queries, res->nodes_max);
+
+    total_queries += res->queries;
+    total_seconds += seconds;
+  }
+
+  log_normal("total: %d queries in %.3f seconds, %.1f queries/s",
+             total_queries, total_seconds,
+             total_seconds > 0.0 ? total_queries / total_seconds : 0.0);
+}
+
+/**********************************************************************//**
+  Main entry point for freeciv-cmbench
+**************************************************************************/
+int main(int argc, char **argv)
+{
+  int first_save, i;
+  int exit_status = EXIT_SUCCESS;
+
+  /* Load Windows post-crash debugger */
+#ifdef FREECIV_MSWINDOWS
+# ifndef FREECIV_NDEBUG
+  if (LoadLibrary("exchndl.dll") == NULL) {
+#  ifdef FREECIV_DEBUG
+    fprintf(stderr, "exchndl.dll could not be loaded, no crash debugger\n");
+#  endif /* FREECIV_DEBUG */
+  }
+# endif /* FREECIV_NDEBUG */
+#endif /* FREECIV_MSWINDOWS */
+
+  srv_init();
+
+  first_save = cmbench_parse_cmdline(argc, argv);
+  if (first_save >= argc) {
+    fc_fprintf(stderr, _("No savegames given.\n"));
+    fc_fprintf(stderr, _("Try using --help.\n"));
+    exit(EXIT_FAILURE);
+  }
+
+  init_our_capability();
+  fc_interface_init_server();
+
+  /* must be before con_log_init() */
+  init_connections();
+  con_log_init(NULL, srvarg.loglevel, srvarg.fatal_assertions);
+  /* logging available after this point */
+
+  settings_init(TRUE);
+  stdinhand_init();
+  edithand_init();
+  voting_init();
+  diplhand_init();
+  server_game_init(FALSE);
+
+  cm_init_parameter(&presets[0].parameter);
+  cm_init_emergency_parameter(&presets[1].parameter);
+  for (i = 0; i < ARRAY_SIZE(presets); i++) {
+    results[i].timer = timer_new(TIMER_USER, TIMER_ACTIVE);
+  }
+
+  for (i = first_save; i < argc; i++) {
+    int j;
+
+    set_server_state(S_S_INITIAL);
+    if (!load_command(NULL, argv[i], FALSE, TRUE)) {
+      log_error(_("Can't load savegame %s"), argv[i]);
+      exit_status = EXIT_FAILURE;
+      continue;
+    }
+
+    log_normal(_("Loaded %s: turn %d, %d players"),
+               argv[i], game.info.turn, player_count());
+
+    for (j = 0; j < ARRAY_SIZE(presets); j++) {
+      cmbench_run_preset(&presets[j].parameter, &results[j]);
+    }
+  }
+
+  cmbench_report();
+
+  for (i = 0; i < ARRAY_SIZE(presets); i++) {
+    timer_destroy(results[i].timer);
+  }
+
+  server_game_free();
+  diplhand_free();
+  voting_free();
+  edithand_free();
+  stdinhand_free();
+  settings_free();
+  registry_module_close();
+  con_log_close();
+  free_libfreeciv();
+  free_nls();
+  cmdline_option_values_free();
+
+  return exit_status;
+}
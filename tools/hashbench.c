@@ -0,0 +1,290 @@
+/***********************************************************************
+ Freeciv - Copyright (C) 1996 - A Kjeldberg, L Gregersen, P Unold
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+***********************************************************************/
+
+/*
+ * freeciv-hashbench times the genhash tables: inserting keys, looking
+ * them up, looking up keys that are not there and removing them again.
+ * It does so once with integer keys like the ids of the game objects
+ * and once with strings like the entries of a section file.  It is
+ * meant for judging changes to the hash tables.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <fc_config.h>
+#endif
+
+#include <stdlib.h>
+
+#ifdef FREECIV_MSWINDOWS
+#include <windows.h>
+#endif
+
+/* utility */
+#include "fc_cmdline.h"
+#include "fciconv.h"
+#include "fcintl.h"
+#include "genhash.h"
+#include "log.h"
+#include "mem.h"
+#include "rand.h"
+#include "shared.h"
+#include "support.h"
+#include "timing.h"
+
+/* common */
+#include "fc_cmdhelp.h"
+
+/* Room for a string key. */
+#define HASHBENCH_KEY_LEN 32
+
+static int count = 1000000;
+static int repeat = 10;
+static enum log_level loglevel = LOG_NORMAL;
+
+/**********************************************************************//**
+  Parse freeciv-hashbench commandline parameters.
+**************************************************************************/
+static void hashbench_parse_cmdline(int argc, char *argv[])
+{
+  int i = 1;
+
+  while (i < argc) {
+    char *option = NULL;
+
+    if (is_option("--help", argv[i])) {
+      struct cmdhelp *help = cmdhelp_new(argv[0]);
+
+      cmdhelp_add(help, "h", "help",
+                  _("Print a summary of the options"));
+      cmdhelp_add(help, "d",
+                  /* TRANS: "debug" is exactly what user must type, do not translate. */
+                  _("debug NUM"),
+                  _("Set debug log level (%d to %d)"),
+                  LOG_FATAL, LOG_DEBUG);
+      cmdhelp_add(help, "k",
+                  /* TRANS: "keys" is exactly what user must type, do not translate. */
+                  _("keys NUM"),
+                  _("Put NUM keys into every table (default %d)"), count);
+      cmdhelp_add(help, "R",
+                  /* TRANS: "Repeat" is exactly what user must type, do not translate. */
+                  _("Repeat NUM"),
+                  _("Fill every table NUM times (default %d)"), repeat);
+
+      /* The function below prints a header and footer for the options.
+       * Furthermore, the options are sorted. */
+      cmdhelp_display(help, TRUE, FALSE, TRUE);
+      cmdhelp_destroy(help);
+
+      cmdline_option_values_free();
+      exit(EXIT_SUCCESS);
+    } else if ((option = get_option_malloc("--debug", argv, &i, argc,
+                                           FALSE))) {
+      if (!log_parse_level_str(option, &loglevel)) {
+        fc_fprintf(stderr, _("Invalid debug level \"%s\".\n"), option);
+        exit(EXIT_FAILURE);
+      }
+      free(option);
+    } else if ((option = get_option_malloc("--keys", argv, &i, argc,
+                                           FALSE))) {
+      if (!str_to_int(option, &count) || count < 1) {
+        fc_fprintf(stderr, _("Invalid key count \"%s\".\n"), option);
+        exit(EXIT_FAILURE);
+      }
+      free(option);
+    } else if ((option = get_option_malloc("--Repeat", argv, &i, argc,
+                                           FALSE))) {
+      if (!str_to_int(option, &repeat) || repeat < 1) {
+        fc_fprintf(stderr, _("Invalid repeat count \"%s\".\n"), option);
+        exit(EXIT_FAILURE);
+      }
+      free(option);
+    } else {
+      fc_fprintf(stderr, _("Unrecognized option: \"%s\"\n"), argv[i]);
+      cmdline_option_values_free();
+      exit(EXIT_FAILURE);
+    }
+    i++;
+  }
+}
+
+/**********************************************************************//**
+  Time inserting the keys into a genhash table, looking them all up,
+  looking up as many missing keys and removing them again, and print the
+  time per operation.  The keys are inserted in turn, but looked up and
+  removed in the given order.  Returns FALSE if the table lost or made
+  up keys.
+**************************************************************************/
+static bool hashbench_keys(const char *name, const void **keys,
+                           const void **missing, const int *order,
+                           genhash_val_fn_t key_val_func,
+                           genhash_comp_fn_t key_comp_func)
+{
+  struct timer *timers[4];
+  long found = 0;
+  bool agree = TRUE;
+  int i, j, k;
+
+  for (k = 0; k < ARRAY_SIZE(timers); k++) {
+    timers[k] = timer_new(TIMER_USER, TIMER_ACTIVE);
+  }
+
+  for (j = 0; j < repeat; j++) {
+    struct genhash *hash = genhash_new(key_val_func, key_comp_func);
+    void *data;
+
+    timer_start(timers[0]);
+    for (i = 0; i < count; i++) {
+      genhash_insert(hash, keys[i], keys[i]);
+    }
+    timer_stop(timers[0]);
+
+    timer_start(timers[1]);
+    for (i = 0; i < count; i++) {
+      if (genhash_lookup(hash, keys[order[i]], &data)
+          && data == keys[order[i]]) {
+        found++;
+      }
+    }
+    timer_stop(timers[1]);
+
+    timer_start(timers[2]);
+    for (i = 0; i < count; i++) {
+      if (genhash_lookup(hash, missing[order[i]], NULL)) {
+        found--;
+      }
+    }
+    timer_stop(timers[2]);
+
+    timer_start(timers[3]);
+    for (i = 0; i < count; i++) {
+      genhash_remove(hash, keys[order[i]]);
+    }
+    timer_stop(timers[3]);
+
+    if (0 != genhash_size(hash)) {
+      agree = FALSE;
+    }
+    genhash_destroy(hash);
+  }
+
+  if (found != (long) count * repeat) {
+    agree = FALSE;
+  }
+  if (!agree) {
+    log_error("Hash %s: found %ld of %d keys.", name, found / repeat, count);
+  }
+
+  log_normal("%-10s %10.1f %10.1f %10.1f %10.1f", name,
+             1e9 * timer_read_seconds(timers[0]) / repeat / count,
+             1e9 * timer_read_seconds(timers[1]) / repeat / count,
+             1e9 * timer_read_seconds(timers[2]) / repeat / count,
+             1e9 * timer_read_seconds(timers[3]) / repeat / count);
+
+  for (k = 0; k < ARRAY_SIZE(timers); k++) {
+    timer_destroy(timers[k]);
+  }
+
+  return agree;
+}
+
+/**********************************************************************//**
+  Time genhash tables once with integer keys and once with string keys.
+  The keys are looked up in random order.
+**************************************************************************/
+static bool hashbench_run(void)
+{
+  const void **keys = fc_malloc(2 * count * sizeof(*keys));
+  const void **missing = keys + count;
+  char *names = fc_malloc(2 * count * HASHBENCH_KEY_LEN);
+  int *order = fc_malloc(count * sizeof(*order));
+  bool agree = TRUE;
+  int i;
+
+  log_normal("%-10s %10s %10s %10s %10s", "hash", "insert ns", "lookup ns",
+             "missing ns", "remove ns");
+
+  for (i = 0; i < count; i++) {
+    order[i] = i;
+  }
+  for (i = count - 1; i > 0; i--) {
+    int j = fc_rand(i + 1), swap = order[i];
+
+    order[i] = order[j];
+    order[j] = swap;
+  }
+
+  for (i = 0; i < count; i++) {
+    keys[i] = FC_INT_TO_PTR(2 * i + 1);
+    missing[i] = FC_INT_TO_PTR(2 * i + 2);
+  }
+  if (!hashbench_keys("integer", keys, missing, order, NULL, NULL)) {
+    agree = FALSE;
+  }
+
+  for (i = 0; i < 2 * count; i++) {
+    fc_snprintf(names + i * HASHBENCH_KEY_LEN, HASHBENCH_KEY_LEN,
+                "player%d.unit%d", i % 64, i / 64);
+    keys[i] = names + i * HASHBENCH_KEY_LEN;
+  }
+  if (!hashbench_keys("string", keys, missing, order,
+                      (genhash_val_fn_t) genhash_str_val_func,
+                      (genhash_comp_fn_t) genhash_str_comp_func)) {
+    agree = FALSE;
+  }
+
+  free(order);
+  free(names);
+  free(keys);
+
+  return agree;
+}
+
+/**********************************************************************//**
+  Main entry point for freeciv-hashbench
+**************************************************************************/
+int main(int argc, char **argv)
+{
+  int exit_status = EXIT_SUCCESS;
+
+  /* Load Windows post-crash debugger */
+#ifdef FREECIV_MSWINDOWS
+# ifndef FREECIV_NDEBUG
+  if (LoadLibrary("exchndl.dll") == NULL) {
+#  ifdef FREECIV_DEBUG
+    fprintf(stderr, "exchndl.dll could not be loaded, no crash debugger\n");
+#  endif /* FREECIV_DEBUG */
+  }
+# endif /* FREECIV_NDEBUG */
+#endif /* FREECIV_MSWINDOWS */
+
+  init_nls();
+  init_character_encodings(FC_DEFAULT_DATA_ENCODING, FALSE);
+
+  hashbench_parse_cmdline(argc, argv);
+
+  log_init(NULL, loglevel, NULL, NULL, -1);
+  /* logging available after this point */
+
+  fc_srand(1);
+  log_normal(_("%d keys, %d runs per table"), count, repeat);
+
+  if (!hashbench_run()) {
+    exit_status = EXIT_FAILURE;
+  }
+
+  log_close();
+  free_nls();
+  cmdline_option_values_free();
+
+  return exit_status;
+}
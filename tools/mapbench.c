@@ -0,0 +1,1061 @@
+/***********************************************************************
+ Freeciv - Copyright (C) 1996 - A Kjeldberg, L Gregersen, P Unold
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+***********************************************************************/
+
+/*
+ * freeciv-mapbench builds a map of the requested size from the terrains
+ * and extras of a ruleset and times whole map scans over it, once
+ * reading the fields from the tiles and once from the dense tile arrays
+ * of the map, and iterates the neighbourhood of every tile, once
+ * normalizing every position and once with the map iterators.  It then
+ * walks a vision source with a large radius across
+ * the map the way units move, and turns coast tiles between land and
+ * ocean, renumbering the continents each time.  At last it spreads the
+ * units of a few players over the map and finds the units near the
+ * tiles, once looking at the tiles around and once asking the unit grid.
+ * It is meant for judging changes to the map storage, to the vision code,
+ * to the continent numbering and to the unit grid.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <fc_config.h>
+#endif
+
+#include <signal.h>
+#include <stdlib.h>
+
+#ifdef FREECIV_MSWINDOWS
+#include <windows.h>
+#endif
+
+/* utility */
+#include "fc_cmdline.h"
+#include "fciconv.h"
+#include "fcintl.h"
+#include "log.h"
+#include "mem.h"
+#include "rand.h"
+#include "registry.h"
+#include "support.h"
+#include "timing.h"
+
+/* common */
+#include "capstr.h"
+#include "extras.h"
+#include "fc_cmdhelp.h"
+#include "fc_interface.h"
+#include "game.h"
+#include "idex.h"
+#include "map.h"
+#include "terrain.h"
+#include "unit.h"
+#include "unitgrid.h"
+#include "unitlist.h"
+#include "vision.h"
+
+/* server */
+#include "aiiface.h"
+#include "console.h"
+#include "diplhand.h"
+#include "edithand.h"
+#include "maphand.h"
+#include "plrhand.h"
+#include "ruleset.h"
+#include "sernet.h"
+#include "settings.h"
+#include "srv_main.h"
+#include "stdinhand.h"
+#include "voting.h"
+
+/* server/generator */
+#include "mapgen_utils.h"
+
+/* Side of the square blocks of the same terrain and continent. */
+#define MAPBENCH_BLOCK 16
+
+/* Players owning the units of the proximity queries, and the tiles per
+ * unit of each. */
+#define MAPBENCH_UNIT_PLAYERS 4
+#define MAPBENCH_UNIT_SPREAD 100
+
+/* Every how manyth tile the proximity queries are made around. */
+#define MAPBENCH_NEAR_STRIDE 7
+
+/* A whole map scan, done both the plain way and a faster way, like over
+ * the tiles and over the dense arrays.  Both return a checksum of what
+ * they found, which must agree. */
+struct mapbench_scan {
+  const char *name;
+  long (*base)(void);
+  long (*fast)(void);
+};
+
+static int xsize = 1000, ysize = 1000;
+static int repeat = 10;
+static int sight = 50;
+static int topology = 0;
+
+static struct player *unit_players[MAPBENCH_UNIT_PLAYERS];
+
+/**********************************************************************//**
+  Count the ocean tiles, reading the tiles.
+**************************************************************************/
+static long scan_ocean_tiles(void)
+{
+  long count = 0;
+
+  whole_map_iterate(&(wld.map), ptile) {
+    if (is_ocean_tile(ptile)) {
+      count++;
+    }
+  } whole_map_iterate_end;
+
+  return count;
+}
+
+/**********************************************************************//**
+  Count the ocean tiles, reading the dense arrays.
+**************************************************************************/
+static long scan_ocean_dense(void)
+{
+  long count = 0;
+  int i;
+
+  for (i = 0; i < MAP_INDEX_SIZE; i++) {
+    if (is_ocean(wld.map.dense.terrain[i])) {
+      count++;
+    }
+  }
+
+  return count;
+}
+
+/**********************************************************************//**
+  Count the owned tiles, reading the tiles.
+**************************************************************************/
+static long scan_owner_tiles(void)
+{
+  long count = 0;
+
+  whole_map_iterate(&(wld.map), ptile) {
+    if (tile_owner(ptile) != NULL) {
+      count++;
+    }
+  } whole_map_iterate_end;
+
+  return count;
+}
+
+/**********************************************************************//**
+  Count the owned tiles, reading the dense arrays.
+**************************************************************************/
+static long scan_owner_dense(void)
+{
+  long count = 0;
+  int i;
+
+  for (i = 0; i < MAP_INDEX_SIZE; i++) {
+    if (wld.map.dense.owner[i] != NULL) {
+      count++;
+    }
+  }
+
+  return count;
+}
+
+/**********************************************************************//**
+  Weigh the land tiles by their continent, reading the tiles.
+**************************************************************************/
+static long scan_continent_tiles(void)
+{
+  long sum = 0;
+
+  whole_map_iterate(&(wld.map), ptile) {
+    if (tile_continent(ptile) > 0) {
+      sum += tile_continent(ptile);
+    }
+  } whole_map_iterate_end;
+
+  return sum;
+}
+
+/**********************************************************************//**
+  Weigh the land tiles by their continent, reading the dense arrays.
+**************************************************************************/
+static long scan_continent_dense(void)
+{
+  long sum = 0;
+  int i;
+
+  for (i = 0; i < MAP_INDEX_SIZE; i++) {
+    if (wld.map.dense.continent[i] > 0) {
+      sum += wld.map.dense.continent[i];
+    }
+  }
+
+  return sum;
+}
+
+/**********************************************************************//**
+  Count the extras of every type, reading the tiles.
+**************************************************************************/
+static long scan_extras_tiles(void)
+{
+  long count = 0;
+
+  extra_type_iterate(pextra) {
+    whole_map_iterate(&(wld.map), ptile) {
+      if (tile_has_extra(ptile, pextra)) {
+        count++;
+      }
+    } whole_map_iterate_end;
+  } extra_type_iterate_end;
+
+  return count;
+}
+
+/**********************************************************************//**
+  Count the extras of every type, reading the dense arrays.
+**************************************************************************/
+static long scan_extras_dense(void)
+{
+  long count = 0;
+  int i;
+
+  extra_type_iterate(pextra) {
+    int idx = extra_index(pextra);
+
+    for (i = 0; i < MAP_INDEX_SIZE; i++) {
+      if (BV_ISSET(wld.map.dense.extras[i], idx)) {
+        count++;
+      }
+    }
+  } extra_type_iterate_end;
+
+  return count;
+}
+
+static const struct mapbench_scan scans[] = {
+  { "ocean", scan_ocean_tiles, scan_ocean_dense },
+  { "owner", scan_owner_tiles, scan_owner_dense },
+  { "continent", scan_continent_tiles, scan_continent_dense },
+  { "extras", scan_extras_tiles, scan_extras_dense }
+};
+
+/**********************************************************************//**
+  Returns the tile at the map position, normalizing it the way the map
+  iterators do near the edges.
+**************************************************************************/
+static inline long iter_sum(int map_x, int map_y)
+{
+  struct tile *ptile = map_pos_to_tile(&(wld.map), map_x, map_y);
+
+  return ptile != NULL ? tile_index(ptile) + 1 : 0;
+}
+
+/**********************************************************************//**
+  Sum the indices of the tiles adjacent to every tile, normalizing every
+  position.
+**************************************************************************/
+static long iter_adjc_normalized(void)
+{
+  long sum = 0;
+
+  whole_map_iterate(&(wld.map), ptile) {
+    int map_x, map_y, i;
+
+    index_to_map_pos(&map_x, &map_y, tile_index(ptile));
+    for (i = 0; i < wld.map.num_valid_dirs; i++) {
+      int dx, dy;
+
+      DIRSTEP(dx, dy, wld.map.valid_dirs[i]);
+      sum += iter_sum(map_x + dx, map_y + dy);
+    }
+  } whole_map_iterate_end;
+
+  return sum;
+}
+
+/**********************************************************************//**
+  Sum the indices of the tiles adjacent to every tile with
+  adjc_iterate().
+**************************************************************************/
+static long iter_adjc_iterator(void)
+{
+  long sum = 0;
+
+  whole_map_iterate(&(wld.map), ptile) {
+    adjc_iterate(&(wld.map), ptile, adjc_tile) {
+      sum += tile_index(adjc_tile) + 1;
+    } adjc_iterate_end;
+  } whole_map_iterate_end;
+
+  return sum;
+}
+
+/**********************************************************************//**
+  Sum the indices of the tiles within real distance 'radius' of every
+  tile, or within squared distance 'sq_radius' if that is not negative,
+  normalizing every position.
+**************************************************************************/
+static long iter_outward_normalized(int radius, int sq_radius)
+{
+  long sum = 0;
+
+  whole_map_iterate(&(wld.map), ptile) {
+    int map_x, map_y, i;
+
+    index_to_map_pos(&map_x, &map_y, tile_index(ptile));
+    for (i = 0; i < wld.map.num_iterate_outwards_indices; i++) {
+      const struct iter_index *pindex = &wld.map.iterate_outwards_indices[i];
+
+      if (pindex->dist > radius) {
+        break;
+      }
+      if (sq_radius < 0
+          || map_vector_to_sq_distance(pindex->dx, pindex->dy)
+             <= sq_radius) {
+        sum += iter_sum(map_x + pindex->dx, map_y + pindex->dy);
+      }
+    }
+  } whole_map_iterate_end;
+
+  return sum;
+}
+
+/**********************************************************************//**
+  Sum the indices of the tiles within distance 3 of every tile,
+  normalizing every position.
+**************************************************************************/
+static long iter_square_normalized(void)
+{
+  return iter_outward_normalized(3, -1);
+}
+
+/**********************************************************************//**
+  Sum the indices of the tiles within distance 3 of every tile with
+  square_iterate().
+**************************************************************************/
+static long iter_square_iterator(void)
+{
+  long sum = 0;
+
+  whole_map_iterate(&(wld.map), ptile) {
+    square_iterate(&(wld.map), ptile, 3, square_tile) {
+      sum += tile_index(square_tile) + 1;
+    } square_iterate_end;
+  } whole_map_iterate_end;
+
+  return sum;
+}
+
+/**********************************************************************//**
+  Sum the indices of the tiles within squared distance 26 of every tile,
+  normalizing every position.
+**************************************************************************/
+static long iter_circle_normalized(void)
+{
+  /* 5 * 5 <= 26 < 6 * 6 */
+  return iter_outward_normalized(5, 26);
+}
+
+/**********************************************************************//**
+  Sum the indices of the tiles within squared distance 26 of every tile
+  with circle_iterate().
+**************************************************************************/
+static long iter_circle_iterator(void)
+{
+  long sum = 0;
+
+  whole_map_iterate(&(wld.map), ptile) {
+    circle_iterate(&(wld.map), ptile, 26, circle_tile) {
+      sum += tile_index(circle_tile) + 1;
+    } circle_iterate_end;
+  } whole_map_iterate_end;
+
+  return sum;
+}
+
+static const struct mapbench_scan iterators[] = {
+  { "adjc", iter_adjc_normalized, iter_adjc_iterator },
+  { "square 3", iter_square_normalized, iter_square_iterator },
+  { "circle 26", iter_circle_normalized, iter_circle_iterator }
+};
+
+/**********************************************************************//**
+  Parse freeciv-mapbench commandline parameters.
+**************************************************************************/
+static void mapbench_parse_cmdline(int argc, char *argv[])
+{
+  int i = 1;
+
+  while (i < argc) {
+    char *option = NULL;
+
+    if (is_option("--help", argv[i])) {
+      struct cmdhelp *help = cmdhelp_new(argv[0]);
+
+      cmdhelp_add(help, "h", "help",
+                  _("Print a summary of the options"));
+      cmdhelp_add(help, "d",
+                  /* TRANS: "debug" is exactly what user must type, do not translate. */
+                  _("debug NUM"),
+                  _("Set debug log level (%d to %d)"),
+                  LOG_FATAL, LOG_DEBUG);
+#ifndef FREECIV_NDEBUG
+      cmdhelp_add(help, "F",
+                  /* TRANS: "Fatal" is exactly what user must type, do not translate. */
+                  _("Fatal [SIGNAL]"),
+                  _("Raise a signal on failed assertion"));
+#endif /* FREECIV_NDEBUG */
+      cmdhelp_add(help, "r",
+                  /* TRANS: "ruleset" is exactly what user must type, do not translate. */
+                  _("ruleset RULESET"),
+                  _("Take the terrains and extras from RULESET"));
+      cmdhelp_add(help, "s",
+                  /* TRANS: "sight" is exactly what user must type, do not translate. */
+                  _("sight NUM"),
+                  _("Walk a vision source of squared radius NUM "
+                    "(default %d)"), sight);
+      cmdhelp_add(help, "t",
+                  /* TRANS: "topology" is exactly what user must type, do not translate. */
+                  _("topology NUM"),
+                  _("Give the map the topology flags NUM: 1 wraps in x, "
+                    "2 wraps in y, 4 is isometric, 8 is hexagonal "
+                    "(default %d)"), topology);
+      cmdhelp_add(help, "x",
+                  /* TRANS: "xsize" is exactly what user must type, do not translate. */
+                  _("xsize NUM"),
+                  _("Make the map NUM tiles wide (default %d)"), xsize);
+      cmdhelp_add(help, "y",
+                  /* TRANS: "ysize" is exactly what user must type, do not translate. */
+                  _("ysize NUM"),
+                  _("Make the map NUM tiles high (default %d)"), ysize);
+      cmdhelp_add(help, "R",
+                  /* TRANS: "Repeat" is exactly what user must type, do not translate. */
+                  _("Repeat NUM"),
+                  _("Run every scan NUM times (default %d)"), repeat);
+
+      /* The function below prints a header and footer for the options.
+       * Furthermore, the options are sorted. */
+      cmdhelp_display(help, TRUE, FALSE, TRUE);
+      cmdhelp_destroy(help);
+
+      cmdline_option_values_free();
+      exit(EXIT_SUCCESS);
+    } else if ((option = get_option_malloc("--debug", argv, &i, argc,
+                                           FALSE))) {
+      if (!log_parse_level_str(option, &srvarg.loglevel)) {
+        fc_fprintf(stderr, _("Invalid debug level \"%s\".\n"), option);
+        exit(EXIT_FAILURE);
+      }
+      free(option);
+#ifndef FREECIV_NDEBUG
+    } else if (is_option("--Fatal", argv[i])) {
+      if (i + 1 >= argc || '-' == argv[i + 1][0]) {
+        srvarg.fatal_assertions = SIGABRT;
+      } else if (str_to_int(argv[i + 1], &srvarg.fatal_assertions)) {
+        i++;
+      } else {
+        fc_fprintf(stderr, _("Invalid signal number \"%s\".\n"),
+                   argv[i + 1]);
+        fc_fprintf(stderr, _("Try using --help.\n"));
+        exit(EXIT_FAILURE);
+      }
+#endif /* FREECIV_NDEBUG */
+    } else if ((option = get_option_malloc("--ruleset", argv, &i, argc,
+                                           FALSE))) {
+      sz_strlcpy(game.server.rulesetdir, option);
+      free(option);
+    } else if ((option = get_option_malloc("--sight", argv, &i, argc,
+                                           FALSE))) {
+      if (!str_to_int(option, &sight) || sight < 2) {
+        fc_fprintf(stderr, _("Invalid vision radius \"%s\".\n"), option);
+        exit(EXIT_FAILURE);
+      }
+      free(option);
+    } else if ((option = get_option_malloc("--topology", argv, &i, argc,
+                                           FALSE))) {
+      if (!str_to_int(option, &topology)
+          || topology < 0 || topology >= (1 << TOPO_FLAG_BITS)) {
+        fc_fprintf(stderr, _("Invalid topology \"%s\".\n"), option);
+        exit(EXIT_FAILURE);
+      }
+      free(option);
+    } else if ((option = get_option_malloc("--xsize", argv, &i, argc,
+                                           FALSE))) {
+      if (!str_to_int(option, &xsize)
+          || xsize < MAP_MIN_LINEAR_SIZE || xsize > MAP_MAX_LINEAR_SIZE) {
+        fc_fprintf(stderr, _("Invalid map width \"%s\".\n"), option);
+        exit(EXIT_FAILURE);
+      }
+      free(option);
+    } else if ((option = get_option_malloc("--ysize", argv, &i, argc,
+                                           FALSE))) {
+      if (!str_to_int(option, &ysize)
+          || ysize < MAP_MIN_LINEAR_SIZE || ysize > MAP_MAX_LINEAR_SIZE) {
+        fc_fprintf(stderr, _("Invalid map height \"%s\".\n"), option);
+        exit(EXIT_FAILURE);
+      }
+      free(option);
+    } else if ((option = get_option_malloc("--Repeat", argv, &i, argc,
+                                           FALSE))) {
+      if (!str_to_int(option, &repeat) || repeat < 1) {
+        fc_fprintf(stderr, _("Invalid repeat count \"%s\".\n"), option);
+        exit(EXIT_FAILURE);
+      }
+      free(option);
+    } else {
+      fc_fprintf(stderr, _("Unrecognized option: \"%s\"\n"), argv[i]);
+      cmdline_option_values_free();
+      exit(EXIT_FAILURE);
+    }
+    i++;
+  }
+}
+
+/**********************************************************************//**
+  Build the map: square blocks of a random terrain, each its own
+  continent or ocean, with a random extra on some of the tiles.
+**************************************************************************/
+static void mapbench_build_map(void)
+{
+  int nblocks_x = (xsize + MAPBENCH_BLOCK - 1) / MAPBENCH_BLOCK;
+  int nblocks = nblocks_x * ((ysize + MAPBENCH_BLOCK - 1) / MAPBENCH_BLOCK);
+  struct terrain **block_terrain = fc_malloc(nblocks * sizeof(*block_terrain));
+  int i;
+
+  wld.map.topology_id = topology;
+  wld.map.xsize = xsize;
+  wld.map.ysize = ysize;
+  map_init_topology();
+  main_map_allocate();
+
+  for (i = 0; i < nblocks; i++) {
+    block_terrain[i] = terrain_by_number(fc_rand(terrain_count()));
+  }
+
+  whole_map_iterate(&(wld.map), ptile) {
+    int nat_x, nat_y, block;
+
+    index_to_native_pos(&nat_x, &nat_y, tile_index(ptile));
+    block = (nat_y / MAPBENCH_BLOCK) * nblocks_x + nat_x / MAPBENCH_BLOCK;
+
+    tile_set_terrain(ptile, block_terrain[block]);
+    tile_set_continent(ptile, is_ocean(block_terrain[block])
+                              ? -(block + 1) : block + 1);
+    if (extra_count() > 0 && fc_rand(8) == 0) {
+      tile_add_extra(ptile, extra_by_number(fc_rand(extra_count())));
+    }
+  } whole_map_iterate_end;
+
+  free(block_terrain);
+}
+
+/**********************************************************************//**
+  Run every scan of the list both ways, and print what they took.
+  Returns FALSE if the two ways disagree.
+**************************************************************************/
+static bool mapbench_run(const struct mapbench_scan *list, int count,
+                         const char *base_name, const char *fast_name)
+{
+  struct timer *base_timer = timer_new(TIMER_USER, TIMER_ACTIVE);
+  struct timer *fast_timer = timer_new(TIMER_USER, TIMER_ACTIVE);
+  char base_title[64], fast_title[64];
+  bool agree = TRUE;
+  int i, j;
+
+  fc_snprintf(base_title, sizeof(base_title), "%s ms", base_name);
+  fc_snprintf(fast_title, sizeof(fast_title), "%s ms", fast_name);
+  log_normal("%-10s %12s %12s %8s", "scan", base_title, fast_title,
+             "speedup");
+  for (i = 0; i < count; i++) {
+    long base_result = 0, fast_result = 0;
+    double base_ms, fast_ms;
+
+    timer_clear(base_timer);
+    timer_clear(fast_timer);
+    for (j = 0; j < repeat; j++) {
+      timer_start(base_timer);
+      base_result = list[i].base();
+      timer_stop(base_timer);
+
+      timer_start(fast_timer);
+      fast_result = list[i].fast();
+      timer_stop(fast_timer);
+    }
+
+    if (base_result != fast_result) {
+      log_error("Scan %s: %s gives %ld, %s gives %ld.", list[i].name,
+                base_name, base_result, fast_name, fast_result);
+      agree = FALSE;
+    }
+
+    base_ms = 1000.0 * timer_read_seconds(base_timer) / repeat;
+    fast_ms = 1000.0 * timer_read_seconds(fast_timer) / repeat;
+    log_normal("%-10s %12.3f %12.3f %7.1fx", list[i].name,
+               base_ms, fast_ms, fast_ms > 0.0 ? base_ms / fast_ms : 0.0);
+  }
+
+  timer_destroy(base_timer);
+  timer_destroy(fast_timer);
+
+  return agree;
+}
+
+/**********************************************************************//**
+  Walk a vision source of pplayer along the middle row of the map, the
+  way unit_move() moves the vision of a unit: the vision at the
+  destination is added before the one at the source is cleared.  Returns
+  the number of moves.
+**************************************************************************/
+static int mapbench_vision_walk(struct player *pplayer)
+{
+  const v_radius_t radius_sq = V_RADIUS(sight, 2, 2);
+  struct vision *old_vision = NULL;
+  int moves = 0;
+  int x;
+
+  for (x = 0; x < wld.map.xsize; x++) {
+    struct tile *ptile = native_pos_to_tile(&(wld.map), x,
+                                            wld.map.ysize / 2);
+    struct vision *new_vision = vision_new(pplayer, ptile);
+
+    vision_change_sight(new_vision, radius_sq);
+    if (old_vision != NULL) {
+      vision_clear_sight(old_vision);
+      vision_free(old_vision);
+      moves++;
+    }
+    old_vision = new_vision;
+  }
+
+  vision_clear_sight(old_vision);
+  vision_free(old_vision);
+
+  return moves;
+}
+
+/**********************************************************************//**
+  Time the vision walks of a player sharing its vision with another one.
+  The first walk reveals the tiles, the others only fog and unfog them.
+**************************************************************************/
+static void mapbench_run_vision(void)
+{
+  struct timer *first_timer = timer_new(TIMER_USER, TIMER_ACTIVE);
+  struct timer *again_timer = timer_new(TIMER_USER, TIMER_ACTIVE);
+  struct player *pplayer, *pally;
+  int moves = 0;
+  int i;
+
+  pplayer = server_create_player(-1, default_ai_type_name(), NULL, FALSE);
+  pally = server_create_player(-1, default_ai_type_name(), NULL, FALSE);
+  server_player_init(pplayer, TRUE, TRUE);
+  server_player_init(pally, TRUE, TRUE);
+  BV_SET(pplayer->server.really_gives_vision, player_index(pally));
+
+  timer_start(first_timer);
+  moves = mapbench_vision_walk(pplayer);
+  timer_stop(first_timer);
+
+  for (i = 0; i < repeat; i++) {
+    timer_start(again_timer);
+    moves = mapbench_vision_walk(pplayer);
+    timer_stop(again_timer);
+  }
+
+  log_normal("vision: %d moves of squared radius %d, first walk %.3f ms, "
+             "then %.3f ms per walk (%.2f us per move)",
+             moves, sight, 1000.0 * timer_read_seconds(first_timer),
+             1000.0 * timer_read_seconds(again_timer) / repeat,
+             moves > 0 ? 1e6 * timer_read_seconds(again_timer)
+                         / repeat / moves : 0.0);
+
+  timer_destroy(first_timer);
+  timer_destroy(again_timer);
+}
+
+#ifdef FREECIV_WEB
+/**********************************************************************//**
+  Sum the ids of the units within real distance 'dist' of every
+  MAPBENCH_NEAR_STRIDEth tile, looking at the tiles around them.
+**************************************************************************/
+static long near_units_tiles(int dist)
+{
+  long sum = 0;
+  int index;
+
+  for (index = 0; index < MAP_INDEX_SIZE; index += MAPBENCH_NEAR_STRIDE) {
+    struct tile *center = index_to_tile(&(wld.map), index);
+
+    square_iterate(&(wld.map), center, dist, ptile) {
+      unit_stack_iterate(ptile->units, punit) {
+        sum += punit->id;
+      } unit_stack_iterate_end;
+    } square_iterate_end;
+  }
+
+  return sum;
+}
+
+/**********************************************************************//**
+  Sum the ids of the units within real distance 'dist' of every
+  MAPBENCH_NEAR_STRIDEth tile, asking the unit grid.
+**************************************************************************/
+static long near_units_grid(int dist)
+{
+  struct unit_list *cells[UNIT_GRID_MAX_NEAR];
+  long sum = 0;
+  int index, i;
+
+  for (index = 0; index < MAP_INDEX_SIZE; index += MAPBENCH_NEAR_STRIDE) {
+    struct tile *center = index_to_tile(&(wld.map), index);
+    int ncells = unit_grid_near(&wld, NULL, center, dist,
+                                cells, ARRAY_SIZE(cells));
+
+    if (ncells < 0) {
+      log_error("The unit grid gives no cells near (%d, %d).",
+                TILE_XY(center));
+      return -1;
+    }
+    for (i = 0; i < ncells; i++) {
+      unit_list_iterate(cells[i], punit) {
+        if (real_map_distance(center, unit_tile(punit)) <= dist) {
+          sum += punit->id;
+        }
+      } unit_list_iterate_end;
+    }
+  }
+
+  return sum;
+}
+
+/**********************************************************************//**
+  Units within distance 3, looking at the tiles.
+**************************************************************************/
+static long near3_tiles(void)
+{
+  return near_units_tiles(3);
+}
+
+/**********************************************************************//**
+  Units within distance 3, asking the unit grid.
+**************************************************************************/
+static long near3_grid(void)
+{
+  return near_units_grid(3);
+}
+
+/**********************************************************************//**
+  Units within distance 10, looking at the tiles.
+**************************************************************************/
+static long near10_tiles(void)
+{
+  return near_units_tiles(10);
+}
+
+/**********************************************************************//**
+  Units within distance 10, asking the unit grid.
+**************************************************************************/
+static long near10_grid(void)
+{
+  return near_units_grid(10);
+}
+
+static const struct mapbench_scan near_units[] = {
+  { "near 3", near3_tiles, near3_grid },
+  { "near 10", near10_tiles, near10_grid },
+};
+#endif /* FREECIV_WEB */
+
+/**********************************************************************//**
+  Spread the units of a few players over the map, and walk them one tile
+  along the rows so their tile stacks, and the unit grid of freeciv-web,
+  have to follow them.  Returns the time per move in microseconds.
+**************************************************************************/
+static double mapbench_place_units(void)
+{
+  struct timer *move_timer = timer_new(TIMER_USER, TIMER_ACTIVE);
+  const struct unit_type *ptype = utype_by_number(0);
+  int per_player = MAX(1, MAP_INDEX_SIZE / MAPBENCH_UNIT_SPREAD);
+  int moves = 0;
+  double us;
+  int p, i;
+
+  for (p = 0; p < MAPBENCH_UNIT_PLAYERS; p++) {
+    unit_players[p] = server_create_player(-1, default_ai_type_name(),
+                                           NULL, FALSE);
+    server_player_init(unit_players[p], TRUE, TRUE);
+
+    for (i = 0; i < per_player; i++) {
+      struct unit *punit = unit_virtual_create(unit_players[p], NULL,
+                                               ptype, 0);
+      struct tile *ptile = rand_map_pos(&(wld.map));
+
+      punit->id = identity_number();
+      idex_register_unit(&wld, punit);
+      unit_list_prepend(unit_players[p]->units, punit);
+      unit_tile_set(punit, ptile);
+      unit_stack_prepend(ptile->units, punit);
+    }
+  }
+
+  timer_start(move_timer);
+  for (p = 0; p < MAPBENCH_UNIT_PLAYERS; p++) {
+    unit_list_iterate(unit_players[p]->units, punit) {
+      struct tile *ptile = mapstep(&(wld.map), unit_tile(punit),
+                                   DIR8_EAST);
+
+      if (ptile != NULL) {
+        unit_stack_remove(unit_tile(punit)->units, punit);
+        unit_tile_set(punit, ptile);
+        unit_stack_prepend(ptile->units, punit);
+        moves++;
+      }
+    } unit_list_iterate_end;
+  }
+  timer_stop(move_timer);
+
+  us = moves > 0 ? 1e6 * timer_read_seconds(move_timer) / moves : 0.0;
+  timer_destroy(move_timer);
+
+  return us;
+}
+
+/**********************************************************************//**
+  Returns a random terrain of the other class than pterrain, or NULL if
+  the ruleset has none.
+**************************************************************************/
+static struct terrain *mapbench_other_terrain(const struct terrain *pterrain)
+{
+  int i;
+
+  for (i = 0; i < 100; i++) {
+    struct terrain *pother = terrain_by_number(fc_rand(terrain_count()));
+
+    if (is_ocean(pother) != is_ocean(pterrain)
+        && !terrain_has_flag(pother, TER_NOT_GENERATED)) {
+      return pother;
+    }
+  }
+
+  return NULL;
+}
+
+/**********************************************************************//**
+  Returns a random tile with a neighbour of the other class, the tiles
+  that change between land and ocean in a game.
+**************************************************************************/
+static struct tile *mapbench_coast_tile(void)
+{
+  for (;;) {
+    struct tile *ptile = rand_map_pos(&(wld.map));
+
+    adjc_iterate(&(wld.map), ptile, adjc_tile) {
+      if (is_ocean_tile(adjc_tile) != is_ocean_tile(ptile)) {
+        return ptile;
+      }
+    } adjc_iterate_end;
+  }
+}
+
+/**********************************************************************//**
+  Returns a checksum of the continent and ocean sizes and of the lake
+  surrounders.
+**************************************************************************/
+static long mapbench_continent_sum(void)
+{
+  long sum = 0;
+  int i;
+
+  for (i = 1; i <= wld.map.num_continents; i++) {
+    sum += (long) i * get_continent_size(i);
+  }
+  for (i = 1; i <= wld.map.num_oceans; i++) {
+    sum += 3L * i * get_ocean_size(i) + 7L * i * get_lake_surrounders(-i);
+  }
+
+  return sum;
+}
+
+/**********************************************************************//**
+  Turn coast tiles between land and ocean, renumbering the continents
+  after each change once with update_continent_numbers() and once with
+  assign_continent_numbers().  Returns FALSE if the two disagree.
+**************************************************************************/
+static bool mapbench_run_continents(void)
+{
+  struct timer *update_timer = timer_new(TIMER_USER, TIMER_ACTIVE);
+  struct timer *assign_timer = timer_new(TIMER_USER, TIMER_ACTIVE);
+  Continent_id *nrs = fc_malloc(MAP_INDEX_SIZE * sizeof(*nrs));
+  struct tile_list *changed = tile_list_new();
+  int flips = 10 * repeat, num_changed = 0, locally = 0;
+  bool agree = TRUE;
+  int i;
+
+  assign_continent_numbers();
+
+  for (i = 0; i < flips && agree; i++) {
+    struct tile *ptile = mapbench_coast_tile();
+    struct terrain *pterrain = mapbench_other_terrain(tile_terrain(ptile));
+    int num_continents, num_oceans, diff = 0;
+    long sum;
+
+    if (pterrain == NULL) {
+      log_error("The ruleset lacks land or ocean terrains.");
+      break;
+    }
+    tile_set_terrain(ptile, pterrain);
+
+    tile_list_clear(changed);
+    timer_start(update_timer);
+    if (update_continent_numbers(ptile, changed)) {
+      locally++;
+    }
+    timer_stop(update_timer);
+    num_changed += tile_list_size(changed);
+
+    whole_map_iterate(&(wld.map), atile) {
+      nrs[tile_index(atile)] = tile_continent(atile);
+    } whole_map_iterate_end;
+    num_continents = wld.map.num_continents;
+    num_oceans = wld.map.num_oceans;
+    sum = mapbench_continent_sum();
+
+    timer_start(assign_timer);
+    assign_continent_numbers();
+    timer_stop(assign_timer);
+
+    whole_map_iterate(&(wld.map), atile) {
+      if (nrs[tile_index(atile)] != tile_continent(atile)) {
+        diff++;
+      }
+    } whole_map_iterate_end;
+    if (diff > 0 || num_continents != wld.map.num_continents
+        || num_oceans != wld.map.num_oceans
+        || sum != mapbench_continent_sum()) {
+      log_error("Continents at (%d, %d): %d tiles numbered differently, "
+                "%d/%d continents, %d/%d oceans, sizes sum %ld/%ld.",
+                TILE_XY(ptile), diff, num_continents, wld.map.num_continents,
+                num_oceans, wld.map.num_oceans,
+                sum, mapbench_continent_sum());
+      agree = FALSE;
+    }
+  }
+
+  log_normal("continents: %d coast changes, %d renumbered locally, "
+             "%d tiles renumbered; update %.3f ms, full %.3f ms per change",
+             i, locally, num_changed,
+             i > 0 ? 1000.0 * timer_read_seconds(update_timer) / i : 0.0,
+             i > 0 ? 1000.0 * timer_read_seconds(assign_timer) / i : 0.0);
+
+  tile_list_destroy(changed);
+  free(nrs);
+  timer_destroy(update_timer);
+  timer_destroy(assign_timer);
+
+  return agree;
+}
+
+/**********************************************************************//**
+  Main entry point for freeciv-mapbench
+**************************************************************************/
+int main(int argc, char **argv)
+{
+  int exit_status = EXIT_SUCCESS;
+
+  /* Load Windows post-crash debugger */
+#ifdef FREECIV_MSWINDOWS
+# ifndef FREECIV_NDEBUG
+  if (LoadLibrary("exchndl.dll") == NULL) {
+#  ifdef FREECIV_DEBUG
+    fprintf(stderr, "exchndl.dll could not be loaded, no crash debugger\n");
+#  endif /* FREECIV_DEBUG */
+  }
+# endif /* FREECIV_NDEBUG */
+#endif /* FREECIV_MSWINDOWS */
+
+  srv_init();
+
+  init_our_capability();
+  fc_interface_init_server();
+
+  /* must be before con_log_init() */
+  init_connections();
+
+  settings_init(TRUE);
+  stdinhand_init();
+  edithand_init();
+  voting_init();
+  diplhand_init();
+  server_game_init(FALSE);
+
+  /* After server_game_init(), which resets the ruleset directory. */
+  mapbench_parse_cmdline(argc, argv);
+  if (xsize * ysize > MAP_MAX_SIZE * 1000) {
+    fc_fprintf(stderr, _("The map can have at most %d tiles.\n"),
+               MAP_MAX_SIZE * 1000);
+    exit(EXIT_FAILURE);
+  }
+  if ((topology & (TF_ISO | TF_HEX)) && ysize % 2 != 0) {
+    fc_fprintf(stderr, _("An isometric or hexagonal map needs an even "
+                         "height.\n"));
+    exit(EXIT_FAILURE);
+  }
+
+  con_log_init(NULL, srvarg.loglevel, srvarg.fatal_assertions);
+  /* logging available after this point */
+
+  if (!load_rulesets(NULL, NULL, FALSE, NULL, FALSE, FALSE, FALSE)) {
+    log_error(_("Can't load ruleset %s"), game.server.rulesetdir);
+    exit(EXIT_FAILURE);
+  }
+
+  fc_srand(1);
+  mapbench_build_map();
+  log_normal(_("Map of %d x %d = %d tiles, %d runs per scan"),
+             wld.map.xsize, wld.map.ysize, MAP_INDEX_SIZE, repeat);
+
+  if (!mapbench_run(scans, ARRAY_SIZE(scans), "tiles", "dense")) {
+    exit_status = EXIT_FAILURE;
+  }
+  if (!mapbench_run(iterators, ARRAY_SIZE(iterators),
+                    "normalized", "iterator")) {
+    exit_status = EXIT_FAILURE;
+  }
+  mapbench_run_vision();
+  if (!mapbench_run_continents()) {
+    exit_status = EXIT_FAILURE;
+  }
+  log_normal("units: %d players with a unit per %d tiles, %.3f us per move",
+             MAPBENCH_UNIT_PLAYERS, MAPBENCH_UNIT_SPREAD,
+             mapbench_place_units());
+#ifdef FREECIV_WEB
+  if (!mapbench_run(near_units, ARRAY_SIZE(near_units), "tiles", "grid")) {
+    exit_status = EXIT_FAILURE;
+  }
+#endif /* FREECIV_WEB */
+
+  server_game_free();
+  diplhand_free();
+  voting_free();
+  edithand_free();
+  stdinhand_free();
+  settings_free();
+  registry_module_close();
+  con_log_close();
+  free_libfreeciv();
+  free_nls();
+  cmdline_option_values_free();
+
+  return exit_status;
+}
@@ -66,6 +66,17 @@ extern "C" {
 
 #endif /* FREECIV_HAVE_PTHREAD */
 
+/* Storage class for variables of which each thread has its own copy */
+#ifdef FREECIV_C11_THR
+#define fc_thread_local _Thread_local
+#elif defined(__GNUC__)
+#define fc_thread_local __thread
+#elif defined(_MSC_VER)
+#define fc_thread_local __declspec(thread)
+#else
+#error "No thread local storage implementation"
+#endif
+
 int fc_thread_start(fc_thread *thread, void (*function) (void *arg), void *arg);
 void fc_thread_wait(fc_thread *thread);
 
@@ -0,0 +1,611 @@
+/***********************************************************************
+ Freeciv - Copyright (C) 1996 - A Kjeldberg, L Gregersen, P Unold
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+***********************************************************************/
+
+/****************************************************************************
+  A work-stealing pool of threads.
+
+  Every thread of the pool has a queue of tasks of its own. A thread adds
+  the tasks it creates to the tail of its queue and takes them back from
+  the tail, so nested work stays with the thread that made it. A thread
+  with nothing in its queue steals from the head of the queue of another
+  one. Threads outside of the pool (the main thread, or anyone else
+  calling in) share queue 0.
+
+  Tasks are put into task groups. fc_task_group_wait() runs queued tasks
+  in the calling thread until the whole group is done, so waiting never
+  leaves a thread idle while there is work, and a task may itself create
+  and wait for a group.
+
+  The size of the pool counts the calling thread too: a size of 4 starts
+  3 threads. With a size below 2, or without condition variables, tasks
+  are run right away by fc_task_group_add().
+
+  fc_parallel_reduce() splits the range into fixed chunks and combines
+  their results in the order of the chunks in the calling thread, so the
+  outcome does not depend on the thread timing nor the pool size.
+****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <fc_config.h>
+#endif
+
+#include <string.h>
+
+/* utility */
+#include "fcthread.h"
+#include "log.h"
+#include "mem.h"
+#include "shared.h"
+#include "timing.h"
+
+#include "fcthreadpool.h"
+
+#define TASK_QUEUE_MIN_SIZE 64
+
+struct fc_task {
+  void (*func) (void *arg);
+  void *arg;
+  struct fc_task_group *group;
+};
+
+/* A ring of tasks. The owner works at the tail, thieves at the head. */
+struct fc_task_queue {
+  fc_mutex mutex;
+  struct fc_task *tasks;
+  int size;                     /* allocated */
+  int head;
+  int count;
+  struct fc_threadpool_stats stats;
+};
+
+struct fc_task_group {
+  fc_mutex mutex;
+  fc_thread_cond done;
+  int remaining;                /* added but not finished */
+};
+
+static struct {
+  int size;                     /* threads, the caller included */
+  int num_workers;              /* running threads */
+  fc_thread *workers;
+  struct fc_task_queue *queues; /* 'size' queues; 0 is for the callers */
+  fc_mutex mutex;
+  fc_thread_cond wakeup;
+  int pending;                  /* queued tasks nobody took yet */
+  bool shutdown;
+  bool initialized;
+} pool = { .size = 1 };
+
+/* Queue of the current thread */
+static fc_thread_local int own_queue = 0;
+
+/************************************************************************//**
+  Add a task to the tail of a queue, growing it when full.
+****************************************************************************/
+static void task_queue_push(struct fc_task_queue *queue,
+                            const struct fc_task *task)
+{
+  fc_allocate_mutex(&queue->mutex);
+  if (queue->count == queue->size) {
+    int new_size = MAX(2 * queue->size, TASK_QUEUE_MIN_SIZE);
+    struct fc_task *tasks = fc_malloc(new_size * sizeof(*tasks));
+    int i;
+
+    for (i = 0; i < queue->count; i++) {
+      tasks[i] = queue->tasks[(queue->head + i) % queue->size];
+    }
+    free(queue->tasks);
+    queue->tasks = tasks;
+    queue->size = new_size;
+    queue->head = 0;
+  }
+  queue->tasks[(queue->head + queue->count) % queue->size] = *task;
+  queue->count++;
+  fc_release_mutex(&queue->mutex);
+}
+
+/************************************************************************//**
+  Take a task from the tail of a queue (own work) or from its head
+  (stealing). Returns FALSE if the queue is empty.
+****************************************************************************/
+static bool task_queue_pop(struct fc_task_queue *queue, bool steal,
+                           struct fc_task *task)
+{
+  bool found = FALSE;
+
+  fc_allocate_mutex(&queue->mutex);
+  if (queue->count > 0) {
+    if (steal) {
+      *task = queue->tasks[queue->head];
+      queue->head = (queue->head + 1) % queue->size;
+    } else {
+      *task = queue->tasks[(queue->head + queue->count - 1) % queue->size];
+    }
+    queue->count--;
+    found = TRUE;
+  }
+  fc_release_mutex(&queue->mutex);
+
+  return found;
+}
+
+/************************************************************************//**
+  Find a task for the current thread: its own newest one, or the oldest
+  one of another thread.
+****************************************************************************/
+static bool take_task(struct fc_task *task, bool *stolen)
+{
+  int i;
+
+  *stolen = FALSE;
+  if (!task_queue_pop(&pool.queues[own_queue], FALSE, task)) {
+    for (i = 1; i < pool.size; i++) {
+      if (task_queue_pop(&pool.queues[(own_queue + i) % pool.size], TRUE,
+                         task)) {
+        break;
+      }
+    }
+    if (i == pool.size) {
+      return FALSE;
+    }
+    *stolen = TRUE;
+  }
+
+  fc_allocate_mutex(&pool.mutex);
+  pool.pending--;
+  fc_release_mutex(&pool.mutex);
+
+  return TRUE;
+}
+
+/************************************************************************//**
+  Mark one task of the group finished.
+****************************************************************************/
+static void task_group_finish(struct fc_task_group *group)
+{
+  fc_allocate_mutex(&group->mutex);
+  group->remaining--;
+  if (group->remaining == 0) {
+    fc_thread_cond_signal(&group->done);
+  }
+  fc_release_mutex(&group->mutex);
+}
+
+/************************************************************************//**
+  Run a task in the current thread and account for it.
+****************************************************************************/
+static void run_task(const struct fc_task *task, bool stolen,
+                     struct timer *busy)
+{
+  struct fc_task_queue *queue = &pool.queues[own_queue];
+
+  timer_clear(busy);
+  timer_start(busy);
+  TIMING_SPAN_BEGIN("task");
+  task->func(task->arg);
+  TIMING_SPAN_END("task");
+  timer_stop(busy);
+
+  fc_allocate_mutex(&queue->mutex);
+  queue->stats.tasks++;
+  if (stolen) {
+    queue->stats.steals++;
+  }
+  queue->stats.busy_seconds += timer_read_seconds(busy);
+  fc_release_mutex(&queue->mutex);
+
+  task_group_finish(task->group);
+}
+
+/************************************************************************//**
+  Main loop of a thread of the pool.
+****************************************************************************/
+static void worker_main(void *arg)
+{
+  struct timer *busy = timer_new(TIMER_USER, TIMER_ACTIVE);
+
+  own_queue = FC_PTR_TO_INT(arg);
+
+  while (TRUE) {
+    struct fc_task task;
+    bool stolen;
+
+    if (take_task(&task, &stolen)) {
+      run_task(&task, stolen, busy);
+      continue;
+    }
+
+    fc_allocate_mutex(&pool.mutex);
+    while (pool.pending <= 0 && !pool.shutdown) {
+      fc_thread_cond_wait(&pool.wakeup, &pool.mutex);
+    }
+    if (pool.shutdown && pool.pending <= 0) {
+      fc_release_mutex(&pool.mutex);
+      break;
+    }
+    fc_release_mutex(&pool.mutex);
+  }
+
+  timer_destroy(busy);
+}
+
+/************************************************************************//**
+  Set up the queues, and start the threads unless tasks are to be run
+  right away.
+****************************************************************************/
+static void threadpool_start(void)
+{
+  int i;
+
+  pool.queues = fc_calloc(pool.size, sizeof(*pool.queues));
+  for (i = 0; i < pool.size; i++) {
+    fc_init_mutex(&pool.queues[i].mutex);
+  }
+  fc_init_mutex(&pool.mutex);
+  fc_thread_cond_init(&pool.wakeup);
+  pool.pending = 0;
+  pool.shutdown = FALSE;
+  pool.num_workers = 0;
+  pool.initialized = TRUE;
+
+  if (pool.size < 2) {
+    return;
+  }
+
+  pool.workers = fc_malloc((pool.size - 1) * sizeof(*pool.workers));
+  for (i = 1; i < pool.size; i++) {
+    if (fc_thread_start(&pool.workers[i - 1], worker_main,
+                        FC_INT_TO_PTR(i)) != 0) {
+      log_error("Failed to start thread %d of the pool.", i);
+      break;
+    }
+    pool.num_workers++;
+  }
+}
+
+/************************************************************************//**
+  Stop the threads of the pool and free the queues. Must not be called
+  while tasks are running.
+****************************************************************************/
+void fc_threadpool_free(void)
+{
+  int i;
+
+  if (!pool.initialized) {
+    return;
+  }
+
+  fc_allocate_mutex(&pool.mutex);
+  pool.shutdown = TRUE;
+  fc_release_mutex(&pool.mutex);
+  for (i = 0; i < pool.num_workers; i++) {
+    fc_allocate_mutex(&pool.mutex);
+    fc_thread_cond_signal(&pool.wakeup);
+    fc_release_mutex(&pool.mutex);
+  }
+  for (i = 0; i < pool.num_workers; i++) {
+    fc_thread_wait(&pool.workers[i]);
+  }
+  free(pool.workers);
+  pool.workers = NULL;
+  pool.num_workers = 0;
+
+  for (i = 0; i < pool.size; i++) {
+    fc_assert(pool.queues[i].count == 0);
+    free(pool.queues[i].tasks);
+    fc_destroy_mutex(&pool.queues[i].mutex);
+  }
+  free(pool.queues);
+  pool.queues = NULL;
+  fc_thread_cond_destroy(&pool.wakeup);
+  fc_destroy_mutex(&pool.mutex);
+  pool.initialized = FALSE;
+}
+
+/************************************************************************//**
+  Set the number of threads working on tasks, the calling thread
+  included. The threads are started when the first task is added.
+  Must not be called while tasks are running.
+****************************************************************************/
+void fc_threadpool_set_size(int threads)
+{
+  if (threads < 1 || !has_thread_cond_impl()) {
+    threads = 1;
+  }
+  if (threads == pool.size) {
+    return;
+  }
+
+  fc_threadpool_free();
+  pool.size = threads;
+}
+
+/************************************************************************//**
+  Returns the number of threads working on tasks, the calling thread
+  included.
+****************************************************************************/
+int fc_threadpool_size(void)
+{
+  return pool.size;
+}
+
+/************************************************************************//**
+  Create a new, empty task group.
+****************************************************************************/
+struct fc_task_group *fc_task_group_new(void)
+{
+  struct fc_task_group *group = fc_malloc(sizeof(*group));
+
+  fc_init_mutex(&group->mutex);
+  fc_thread_cond_init(&group->done);
+  group->remaining = 0;
+
+  if (!pool.initialized) {
+    threadpool_start();
+  }
+
+  return group;
+}
+
+/************************************************************************//**
+  Add a task to the group. It may start running at once, in any thread.
+****************************************************************************/
+void fc_task_group_add(struct fc_task_group *group,
+                       void (*func) (void *arg), void *arg)
+{
+  struct fc_task task = { func, arg, group };
+
+  fc_allocate_mutex(&group->mutex);
+  group->remaining++;
+  fc_release_mutex(&group->mutex);
+
+  if (pool.num_workers == 0) {
+    struct timer *busy = timer_new(TIMER_USER, TIMER_ACTIVE);
+
+    run_task(&task, FALSE, busy);
+    timer_destroy(busy);
+    return;
+  }
+
+  task_queue_push(&pool.queues[own_queue], &task);
+
+  fc_allocate_mutex(&pool.mutex);
+  pool.pending++;
+  fc_thread_cond_signal(&pool.wakeup);
+  fc_release_mutex(&pool.mutex);
+}
+
+/************************************************************************//**
+  Wait for all the tasks of the group to finish. The calling thread runs
+  queued tasks meanwhile.
+****************************************************************************/
+void fc_task_group_wait(struct fc_task_group *group)
+{
+  struct timer *busy = NULL;
+
+  while (TRUE) {
+    struct fc_task task;
+    bool stolen, done;
+
+    fc_allocate_mutex(&group->mutex);
+    done = (group->remaining == 0);
+    fc_release_mutex(&group->mutex);
+    if (done) {
+      break;
+    }
+
+    if (pool.num_workers > 0 && take_task(&task, &stolen)) {
+      if (busy == NULL) {
+        busy = timer_new(TIMER_USER, TIMER_ACTIVE);
+      }
+      run_task(&task, stolen, busy);
+      continue;
+    }
+
+    /* The rest of the tasks are running elsewhere. */
+    fc_allocate_mutex(&group->mutex);
+    while (group->remaining > 0) {
+      fc_thread_cond_wait(&group->done, &group->mutex);
+    }
+    fc_release_mutex(&group->mutex);
+    break;
+  }
+
+  if (busy != NULL) {
+    timer_destroy(busy);
+  }
+}
+
+/************************************************************************//**
+  Free a task group. All of its tasks must have finished.
+****************************************************************************/
+void fc_task_group_destroy(struct fc_task_group *group)
+{
+  fc_assert(group->remaining == 0);
+
+  fc_thread_cond_destroy(&group->done);
+  fc_destroy_mutex(&group->mutex);
+  free(group);
+}
+
+/* Indices shared by the tasks of fc_parallel_for() */
+struct parallel_for_data {
+  int count;
+  int next;
+  fc_mutex mutex;
+  void (*func) (int index, void *arg);
+  void *arg;
+};
+
+/************************************************************************//**
+  Task of fc_parallel_for(). Takes indices until there are none left.
+****************************************************************************/
+static void parallel_for_task(void *arg)
+{
+  struct parallel_for_data *data = (struct parallel_for_data *) arg;
+
+  while (TRUE) {
+    int i;
+
+    fc_allocate_mutex(&data->mutex);
+    i = data->next++;
+    fc_release_mutex(&data->mutex);
+
+    if (i >= data->count) {
+      break;
+    }
+    data->func(i, data->arg);
+  }
+}
+
+/************************************************************************//**
+  Call func(index, arg) for every index from 0 to count - 1, on at most
+  max_tasks threads at once (on all of the pool if max_tasks is 0). The
+  calls are made in no particular order. Returns once all are done.
+****************************************************************************/
+void fc_parallel_for(int count, int max_tasks,
+                     void (*func) (int index, void *arg), void *arg)
+{
+  struct parallel_for_data data;
+  struct fc_task_group *group;
+  int tasks, i;
+
+  tasks = pool.size;
+  if (max_tasks > 0) {
+    tasks = MIN(tasks, max_tasks);
+  }
+  tasks = MIN(tasks, count);
+
+  if (tasks < 2) {
+    for (i = 0; i < count; i++) {
+      func(i, arg);
+    }
+    return;
+  }
+
+  data.count = count;
+  data.next = 0;
+  data.func = func;
+  data.arg = arg;
+  fc_init_mutex(&data.mutex);
+
+  group = fc_task_group_new();
+  for (i = 0; i < tasks; i++) {
+    fc_task_group_add(group, parallel_for_task, &data);
+  }
+  fc_task_group_wait(group);
+  fc_task_group_destroy(group);
+
+  fc_destroy_mutex(&data.mutex);
+}
+
+/* Chunks of fc_parallel_reduce() */
+struct parallel_reduce_data {
+  int count;
+  int chunk;
+  size_t partial_size;
+  char *partials;
+  void (*map) (int first, int last, void *partial, void *arg);
+  void *arg;
+};
+
+/************************************************************************//**
+  Map one chunk of fc_parallel_reduce().
+****************************************************************************/
+static void parallel_reduce_chunk(int index, void *arg)
+{
+  struct parallel_reduce_data *data = (struct parallel_reduce_data *) arg;
+  int first = index * data->chunk;
+
+  data->map(first, MIN(first + data->chunk, data->count) - 1,
+            data->partials + index * data->partial_size, data->arg);
+}
+
+/************************************************************************//**
+  Reduce the indices from 0 to count - 1. The range is split into chunks
+  of 'chunk' indices; map(first, last, partial, arg) is called for each,
+  in parallel, with a zeroed 'partial' of 'partial_size' bytes of its
+  own. The partials are then combined into 'total' with
+  combine(total, partial, arg) in the order of the chunks, in the calling
+  thread. As the chunks do not depend on the pool size either, the
+  result is the same however many threads there are.
+****************************************************************************/
+void fc_parallel_reduce(int count, int chunk, size_t partial_size,
+                        void (*map) (int first, int last, void *partial,
+                                     void *arg),
+                        void (*combine) (void *total, const void *partial,
+                                         void *arg),
+                        void *total, void *arg)
+{
+  struct parallel_reduce_data data;
+  int chunks, i;
+
+  fc_assert_ret(chunk > 0);
+  if (count <= 0) {
+    return;
+  }
+
+  chunks = (count + chunk - 1) / chunk;
+  data.count = count;
+  data.chunk = chunk;
+  data.partial_size = partial_size;
+  data.partials = fc_calloc(chunks, partial_size);
+  data.map = map;
+  data.arg = arg;
+
+  fc_parallel_for(chunks, 0, parallel_reduce_chunk, &data);
+
+  for (i = 0; i < chunks; i++) {
+    combine(total, data.partials + i * partial_size, arg);
+  }
+  free(data.partials);
+}
+
+/************************************************************************//**
+  Returns the number of threads fc_threadpool_stats_get() knows about.
+  Thread 0 stands for the threads calling in.
+****************************************************************************/
+int fc_threadpool_stats_count(void)
+{
+  return pool.initialized ? pool.size : 0;
+}
+
+/************************************************************************//**
+  Get what a thread of the pool did since the last reset.
+****************************************************************************/
+void fc_threadpool_stats_get(int thread, struct fc_threadpool_stats *pstats)
+{
+  fc_assert_ret(pool.initialized && thread >= 0 && thread < pool.size);
+
+  fc_allocate_mutex(&pool.queues[thread].mutex);
+  *pstats = pool.queues[thread].stats;
+  fc_release_mutex(&pool.queues[thread].mutex);
+}
+
+/************************************************************************//**
+  Reset the statistics of all the threads.
+****************************************************************************/
+void fc_threadpool_stats_reset(void)
+{
+  int i;
+
+  if (!pool.initialized) {
+    return;
+  }
+
+  for (i = 0; i < pool.size; i++) {
+    fc_allocate_mutex(&pool.queues[i].mutex);
+    memset(&pool.queues[i].stats, 0, sizeof(pool.queues[i].stats));
+    fc_release_mutex(&pool.queues[i].mutex);
+  }
+}
@@ -0,0 +1,64 @@
+/***********************************************************************
+ Freeciv - Copyright (C) 1996 - A Kjeldberg, L Gregersen, P Unold
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+***********************************************************************/
+#ifndef FC__FCTHREADPOOL_H
+#define FC__FCTHREADPOOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/****************************************************************************
+   A pool of threads shared by everything that wants to run work in
+   parallel.  See comments in "fcthreadpool.c".
+****************************************************************************/
+
+/* utility */
+#include "support.h"            /* bool type */
+
+struct fc_task_group;           /* opaque */
+
+/* What a thread of the pool did since the last reset. */
+struct fc_threadpool_stats {
+  int tasks;                    /* tasks run */
+  int steals;                   /* tasks taken from another thread */
+  double busy_seconds;          /* time spent running tasks */
+};
+
+void fc_threadpool_set_size(int threads);
+int fc_threadpool_size(void);
+void fc_threadpool_free(void);
+
+struct fc_task_group *fc_task_group_new(void);
+void fc_task_group_add(struct fc_task_group *group,
+                       void (*func) (void *arg), void *arg);
+void fc_task_group_wait(struct fc_task_group *group);
+void fc_task_group_destroy(struct fc_task_group *group);
+
+void fc_parallel_for(int count, int max_tasks,
+                     void (*func) (int index, void *arg), void *arg);
+void fc_parallel_reduce(int count, int chunk, size_t partial_size,
+                        void (*map) (int first, int last, void *partial,
+                                     void *arg),
+                        void (*combine) (void *total, const void *partial,
+                                         void *arg),
+                        void *total, void *arg);
+
+int fc_threadpool_stats_count(void);
+void fc_threadpool_stats_get(int thread, struct fc_threadpool_stats *pstats);
+void fc_threadpool_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FC__FCTHREADPOOL_H */
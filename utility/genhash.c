@@ -50,9 +50,25 @@
    data_copy_func: same as 'key_copy_func', but for data.
    data_free_func: same as 'key_free_func', but for data.
 
-   Implementation uses open hashing. Collision resolution is done by
-   separate chaining with linked lists. Resize hash table when deemed
-   necessary by making and populating a new table.
+
+   Implementation uses open addressing with Robin Hood hashing: the
+   entries are kept in a single array, a power of two long.  An entry
+   goes in the first free slot from its home slot on, but takes the slot
+   of any entry it meets that is closer to its own home slot, which goes
+   on looking further.  So lookups end as soon as they meet an entry
+   closer to home than the key would be.  Removing an entry shifts the
+   entries following it back by one slot.  The hash value and the
+   distance from home of every entry are kept in a separate, smaller
+   array of slots, which is all a lookup of a missing key reads.  As the
+   hash values are stored, neither comparing keys nor resizing the table
+   calls the key functions more than needed.  Resize the table when
+   deemed necessary by making and populating a new one.
+
+   Iteration goes through the slots in order.  That order depends on the
+   hash values and on the size of the table, not on the order in which
+   the entries were inserted, and it changes when the table is resized.
+   Replacing the data of an entry while iterating is fine, but inserting
+   or removing entries is not.
 ****************************************************************************/
 
 #ifdef HAVE_CONFIG_H
@@ -64,7 +80,6 @@
 /* utility */
 #include "log.h"
 #include "mem.h"
-#include "shared.h"     /* ARRAY_SIZE */
 #include "support.h"
 
 #include "genhash.h"
@@ -72,31 +87,42 @@
 #define FULL_RATIO 0.75         /* consider expanding when above this */
 #define MIN_RATIO 0.24          /* shrink when below this */
 
+/* Spreads the hash values over the slots (Fibonacci hashing), as the
+ * hash values of integer and pointer keys are the keys themselves. */
+#define GENHASH_MIX 0x9E3779B9u
+
+struct genhash_slot {
+  genhash_val_t hash_val;
+  unsigned int dist;            /* 0 when free, or 1 + distance from the
+                                 * home slot of the entry. */
+};
+
 struct genhash_entry {
   void *key;
   void *data;
-  genhash_val_t hash_val;
-  struct genhash_entry *next;
 };
 
 /* Contents of the opaque type: */
 struct genhash {
-  struct genhash_entry **buckets;
+  struct genhash_slot *slots;
+  struct genhash_entry *entries;
   genhash_val_fn_t key_val_func;
   genhash_comp_fn_t key_comp_func;
   genhash_copy_fn_t key_copy_func;
   genhash_free_fn_t key_free_func;
   genhash_copy_fn_t data_copy_func;
   genhash_free_fn_t data_free_func;
-  size_t num_buckets;
+  size_t num_slots;
   size_t num_entries;
+  int shift;                    /* Hash value bits not used for the home
+                                 * slot. */
   bool no_shrink;               /* Do not auto-shrink when set. */
 };
 
 struct genhash_iter {
   struct iterator vtable;
-  struct genhash_entry *const *bucket, *const *end;
-  const struct genhash_entry *iterator;
+  const struct genhash_slot *slot, *end;
+  const struct genhash_entry *entry;
 };
 
 #define GENHASH_ITER(p) ((struct genhash_iter *) (p))
@@ -104,17 +130,18 @@ struct genhash_iter {
 
 /************************************************************************//**
   A supplied genhash function appropriate to nul-terminated strings.
-  Prefers table sizes that are prime numbers.
+  This is FNV-1a: with open addressing, keys differing only in a few
+  characters must not end up in neighbouring slots.
 ****************************************************************************/
 genhash_val_t genhash_str_val_func(const char *vkey)
 {
-  unsigned long result = 0;
+  unsigned long result = 2166136261ul;
 
   for (; *vkey != '\0'; vkey++) {
-    result *= 5; 
-    result += *vkey;
+    result ^= (unsigned char) *vkey;
+    result *= 16777619ul;
+    result &= 0xFFFFFFFF; /* To make results independent of sizeof(long) */
   }
-  result &= 0xFFFFFFFF; /* To make results independent of sizeof(long) */
   return result;
 }
 
@@ -146,9 +173,9 @@ void genhash_str_free_func(char *vkey)
 }
 
 /************************************************************************//**
-  Calculate a "reasonable" number of buckets for a given number of entries.
-  Gives a prime number far from powers of 2, allowing at least a factor of
-  2 from the given number of entries for breathing room.
+  Calculate a "reasonable" number of slots for a given number of entries.
+  Gives a power of 2, allowing at least a factor of 2 from the given
+  number of entries for breathing room.
 
   Generalized restrictions on the behavior of this function:
   * MIN_BUCKETS <= genhash_calc_num_buckets(x)
@@ -158,41 +185,42 @@ void genhash_str_free_func(char *vkey)
   This one is more of a recommendation, to ensure enough free space:
   * genhash_calc_num_buckets(x) >= 2 * x.
 ****************************************************************************/
-#define MIN_BUCKETS 29  /* Historical purposes. */
+#define MIN_BUCKETS 16
 static size_t genhash_calc_num_buckets(size_t num_entries)
 {
-  /* A bunch of prime numbers close to successive elements of the sequence
-   * A_n = 3 * 2 ^ n; to be used for table sizes. */
-  static const size_t sizes[] = {
-    MIN_BUCKETS,          53,         97,           193,
-    389,       769,       1543,       3079,         6151,
-    12289,     24593,     49157,      98317,        196613,
-    393241,    786433,    1572869,    3145739,      6291469,
-    12582917,  25165843,  50331653,   100663319,    201326611,
-    402653189, 805306457, 1610612741, 3221225473ul, 4294967291ul
-  };
-  const size_t *pframe = sizes, *pmid;
-  int fsize = ARRAY_SIZE(sizes) - 1, lpart;
+  size_t num_slots = MIN_BUCKETS;
 
   num_entries <<= 1; /* breathing room */
 
-  while (fsize > 0) {
-    lpart = fsize >> 1;
-    pmid = pframe + lpart;
-    if (*pmid < num_entries) {
-      pframe = pmid + 1;
-      fsize = fsize - lpart - 1;
-    } else {
-      fsize = lpart;
-    }
+  while (num_slots < num_entries) {
+    num_slots <<= 1;
+  }
+  return num_slots;
+}
+
+/************************************************************************//**
+  Allocate empty slots for the genhash table, which must be a power of 2.
+****************************************************************************/
+static void genhash_alloc_slots(struct genhash *pgenhash, size_t num_slots)
+{
+  int bits = 0;
+
+  fc_assert(0 == (num_slots & (num_slots - 1)));
+
+  while (((size_t) 1 << bits) < num_slots) {
+    bits++;
   }
-  return *pframe;
+
+  pgenhash->slots = fc_calloc(num_slots, sizeof(*pgenhash->slots));
+  pgenhash->entries = fc_malloc(num_slots * sizeof(*pgenhash->entries));
+  pgenhash->num_slots = num_slots;
+  pgenhash->shift = 8 * sizeof(genhash_val_t) - bits;
 }
 
 /************************************************************************//**
-  Internal constructor, specifying exact number of buckets.
+  Internal constructor, specifying exact number of slots.
   Allows to specify functions to free the memory allocated for the key and
-  user-data that get called when removing the bucket from the hash table or
+  user-data that get called when removing the entry from the hash table or
   changing key/user-data values.
 
   NB: Be sure to check the "copy constructor" genhash_copy() if you change
@@ -209,17 +237,16 @@ genhash_new_nbuckets(genhash_val_fn_t key_val_func,
 {
   struct genhash *pgenhash = fc_malloc(sizeof(*pgenhash));
 
-  log_debug("New genhash table with %lu buckets",
+  log_debug("New genhash table with %lu slots",
             (long unsigned) num_buckets);
 
-  pgenhash->buckets = fc_calloc(num_buckets, sizeof(*pgenhash->buckets));
+  genhash_alloc_slots(pgenhash, num_buckets);
   pgenhash->key_val_func = key_val_func;
   pgenhash->key_comp_func = key_comp_func;
   pgenhash->key_copy_func = key_copy_func;
   pgenhash->key_free_func = key_free_func;
   pgenhash->data_copy_func = data_copy_func;
   pgenhash->data_free_func = data_free_func;
-  pgenhash->num_buckets = num_buckets;
   pgenhash->num_entries = 0;
   pgenhash->no_shrink = FALSE;
 
@@ -229,7 +256,7 @@ genhash_new_nbuckets(genhash_val_fn_t key_val_func,
 /************************************************************************//**
   Constructor specifying number of entries.
   Allows to specify functions to free the memory allocated for the key and
-  user-data that get called when removing the bucket from the hash table or
+  user-data that get called when removing the entry from the hash table or
   changing key/user-data values.
 ****************************************************************************/
 struct genhash *
@@ -262,7 +289,7 @@ struct genhash *genhash_new_nentries(genhash_val_fn_t key_val_func,
 /************************************************************************//**
   Constructor with unspecified number of entries.
   Allows to specify functions to free the memory allocated for the key and
-  user-data that get called when removing the bucket from the hash table or
+  user-data that get called when removing the entry from the hash table or
   changing key/user-data values.
 ****************************************************************************/
 struct genhash *genhash_new_full(genhash_val_fn_t key_val_func,
@@ -295,45 +322,79 @@ void genhash_destroy(struct genhash *pgenhash)
   fc_assert_ret(NULL != pgenhash);
   pgenhash->no_shrink = TRUE;
   genhash_clear(pgenhash);
-  free(pgenhash->buckets);
+  free(pgenhash->slots);
+  free(pgenhash->entries);
   free(pgenhash);
 }
 
 /************************************************************************//**
-  Resize the genhash table: relink entries.
+  Returns the home slot of the hash value.
+****************************************************************************/
+static inline size_t genhash_home_slot(const struct genhash *pgenhash,
+                                       genhash_val_t hash_val)
+{
+  return (genhash_val_t) (hash_val * GENHASH_MIX) >> pgenhash->shift;
+}
+
+/************************************************************************//**
+  Put the entry in its place, where there must be no entry with the same
+  key yet, moving the entries closer to their home slot further.
+****************************************************************************/
+static void genhash_entry_place(struct genhash *pgenhash,
+                                genhash_val_t hash_val,
+                                struct genhash_entry entry)
+{
+  size_t mask = pgenhash->num_slots - 1;
+  size_t slot = genhash_home_slot(pgenhash, hash_val);
+  struct genhash_slot place = { hash_val, 1 };
+
+  for (; ; place.dist++, slot = (slot + 1) & mask) {
+    struct genhash_slot *pslot = pgenhash->slots + slot;
+
+    if (0 == pslot->dist) {
+      *pslot = place;
+      pgenhash->entries[slot] = entry;
+      return;
+    }
+    if (pslot->dist < place.dist) {
+      struct genhash_slot poorer_slot = *pslot;
+      struct genhash_entry poorer = pgenhash->entries[slot];
+
+      *pslot = place;
+      pgenhash->entries[slot] = entry;
+      place = poorer_slot;
+      entry = poorer;
+    }
+  }
+}
+
+/************************************************************************//**
+  Resize the genhash table: place the entries in new slots.
 ****************************************************************************/
 static void genhash_resize_table(struct genhash *pgenhash,
                                  size_t new_nbuckets)
 {
-  struct genhash_entry **new_buckets, **bucket, **end, **slot;
-  struct genhash_entry *iter, *next;
-
-  fc_assert(new_nbuckets >= pgenhash->num_entries);
+  struct genhash_slot *old_slots = pgenhash->slots;
+  struct genhash_entry *old_entries = pgenhash->entries;
+  size_t old_nbuckets = pgenhash->num_slots;
+  size_t i;
 
-  new_buckets = fc_calloc(new_nbuckets, sizeof(*pgenhash->buckets));
+  fc_assert(new_nbuckets > pgenhash->num_entries);
 
-  bucket = pgenhash->buckets;
-  end = bucket + pgenhash->num_buckets;
-  for (; bucket < end; bucket++) {
-    for (iter = *bucket; NULL != iter; iter = next) {
-      slot = new_buckets + (iter->hash_val % new_nbuckets);
-      next = iter->next;
-      iter->next = *slot;
-      *slot = iter;
+  genhash_alloc_slots(pgenhash, new_nbuckets);
+  for (i = 0; i < old_nbuckets; i++) {
+    if (0 != old_slots[i].dist) {
+      genhash_entry_place(pgenhash, old_slots[i].hash_val, old_entries[i]);
     }
   }
 
-  free(pgenhash->buckets);
-  pgenhash->buckets = new_buckets;
-  pgenhash->num_buckets = new_nbuckets;
+  free(old_slots);
+  free(old_entries);
 }
 
 /************************************************************************//**
   Call this when an entry might be added or deleted: resizes the genhash
-  table if seems like a good idea.  Count deleted entries in check
-  because efficiency may be degraded if there are too many deleted
-  entries.  But for determining new size, ignore deleted entries,
-  since they'll be removed by rehashing.
+  table if seems like a good idea.
 ****************************************************************************/
 #define genhash_maybe_expand(htab) genhash_maybe_resize((htab), TRUE)
 #define genhash_maybe_shrink(htab) genhash_maybe_resize((htab), FALSE)
@@ -345,15 +406,15 @@ static bool genhash_maybe_resize(struct genhash *pgenhash, bool expandingp)
     return FALSE;
   }
   if (expandingp) {
-    limit = FULL_RATIO * pgenhash->num_buckets;
+    limit = FULL_RATIO * pgenhash->num_slots;
     if (pgenhash->num_entries < limit) {
       return FALSE;
     }
   } else {
-    if (pgenhash->num_buckets <= MIN_BUCKETS) {
+    if (pgenhash->num_slots <= MIN_BUCKETS) {
       return FALSE;
     }
-    limit = MIN_RATIO * pgenhash->num_buckets;
+    limit = MIN_RATIO * pgenhash->num_slots;
     if (pgenhash->num_entries > limit) {
       return FALSE;
     }
@@ -361,13 +422,13 @@ static bool genhash_maybe_resize(struct genhash *pgenhash, bool expandingp)
 
   new_nbuckets = genhash_calc_num_buckets(pgenhash->num_entries);
 
-  log_debug("%s genhash (entries = %lu, buckets =  %lu, new = %lu, "
+  log_debug("%s genhash (entries = %lu, slots =  %lu, new = %lu, "
             "%s limit = %lu)",
-            (new_nbuckets < pgenhash->num_buckets ? "Shrinking"
-             : (new_nbuckets > pgenhash->num_buckets
+            (new_nbuckets < pgenhash->num_slots ? "Shrinking"
+             : (new_nbuckets > pgenhash->num_slots
                 ? "Expanding" : "Rehashing")),
             (long unsigned) pgenhash->num_entries,
-            (long unsigned) pgenhash->num_buckets,
+            (long unsigned) pgenhash->num_slots,
             (long unsigned) new_nbuckets,
             expandingp ? "up": "down", (long unsigned) limit);
   genhash_resize_table(pgenhash, new_nbuckets);
@@ -389,33 +450,41 @@ static inline genhash_val_t genhash_val_calc(const struct genhash *pgenhash,
 }
 
 /************************************************************************//**
-  Return slot (entry pointer) in genhash table where key resides, or where
-  it should go if it is to be a new key.
+  Return the entry of the genhash table with the key, or NULL if there is
+  none.
 ****************************************************************************/
-static inline struct genhash_entry **
+static inline struct genhash_entry *
 genhash_slot_lookup(const struct genhash *pgenhash,
                     const void *key,
                     genhash_val_t hash_val)
 {
-  struct genhash_entry **slot;
   genhash_comp_fn_t key_comp_func = pgenhash->key_comp_func;
-
-  slot = pgenhash->buckets + (hash_val % pgenhash->num_buckets);
+  const struct genhash_slot *slots = pgenhash->slots;
+  struct genhash_entry *entries = pgenhash->entries;
+  size_t mask = pgenhash->num_slots - 1;
+  size_t slot = genhash_home_slot(pgenhash, hash_val);
+  unsigned int dist;
+
+  /* Past an entry closer to its home slot than the key would be, the key
+   * cannot be found. */
   if (NULL != key_comp_func) {
-    for (; NULL != *slot; slot = &(*slot)->next) {
-      if (hash_val == (*slot)->hash_val
-          && key_comp_func((*slot)->key, key)) {
-        return slot;
+    for (dist = 1; dist <= slots[slot].dist;
+         dist++, slot = (slot + 1) & mask) {
+      if (hash_val == slots[slot].hash_val
+          && key_comp_func(entries[slot].key, key)) {
+        return entries + slot;
       }
     }
   } else {
-    for (; NULL != *slot; slot = &(*slot)->next) {
-      if (key == (*slot)->key) {
-        return slot;
+    for (dist = 1; dist <= slots[slot].dist;
+         dist++, slot = (slot + 1) & mask) {
+      if (hash_val == slots[slot].hash_val && key == entries[slot].key) {
+        return entries + slot;
       }
     }
   }
-  return slot;
+
+  return NULL;
 }
 
 /************************************************************************//**
@@ -434,75 +503,82 @@ static inline void genhash_default_get(void **pkey, void **data)
 /************************************************************************//**
   Function to store data.
 ****************************************************************************/
-static inline void genhash_slot_get(struct genhash_entry *const *slot,
+static inline void genhash_slot_get(const struct genhash_entry *pentry,
                                     void **pkey, void **data)
 {
-  const struct genhash_entry *entry = *slot;
-
   if (NULL != pkey) {
-    *pkey = entry->key;
+    *pkey = pentry->key;
   }
   if (NULL != data) {
-    *data = entry->data;
+    *data = pentry->data;
   }
 }
 
 /************************************************************************//**
-  Create the entry and call the copy callbacks.
+  Create the entry, calling the copy callbacks, and place it.
 ****************************************************************************/
 static inline void genhash_slot_create(struct genhash *pgenhash,
-                                       struct genhash_entry **slot,
                                        const void *key, const void *data,
                                        genhash_val_t hash_val)
 {
-  struct genhash_entry *entry = fc_malloc(sizeof(*entry));
+  struct genhash_entry entry;
 
-  entry->key = (NULL != pgenhash->key_copy_func
-                ? pgenhash->key_copy_func(key) : (void *) key);
-  entry->data = (NULL != pgenhash->data_copy_func
-                 ? pgenhash->data_copy_func(data) : (void *) data);
-  entry->hash_val = hash_val;
-  entry->next = *slot;
-  *slot = entry;
+  entry.key = (NULL != pgenhash->key_copy_func
+               ? pgenhash->key_copy_func(key) : (void *) key);
+  entry.data = (NULL != pgenhash->data_copy_func
+                ? pgenhash->data_copy_func(data) : (void *) data);
+  genhash_entry_place(pgenhash, hash_val, entry);
 }
 
 /************************************************************************//**
-  Free the entry slot and call the free callbacks.
+  Call the free callbacks of the entry.
 ****************************************************************************/
-static inline void genhash_slot_free(struct genhash *pgenhash,
-                                     struct genhash_entry **slot)
+static inline void genhash_slot_free_data(struct genhash *pgenhash,
+                                          struct genhash_entry *pentry)
 {
-  struct genhash_entry *entry = *slot;
-
   if (NULL != pgenhash->key_free_func) {
-    pgenhash->key_free_func(entry->key);
+    pgenhash->key_free_func(pentry->key);
   }
   if (NULL != pgenhash->data_free_func) {
-    pgenhash->data_free_func(entry->data);
+    pgenhash->data_free_func(pentry->data);
+  }
+}
+
+/************************************************************************//**
+  Free the entry slot and call the free callbacks.  The entries following
+  it are moved back by one slot, until a free one or one in its home slot.
+****************************************************************************/
+static inline void genhash_slot_free(struct genhash *pgenhash,
+                                     struct genhash_entry *pentry)
+{
+  size_t mask = pgenhash->num_slots - 1;
+  size_t slot = pentry - pgenhash->entries;
+  size_t next = (slot + 1) & mask;
+
+  genhash_slot_free_data(pgenhash, pentry);
+
+  while (1 < pgenhash->slots[next].dist) {
+    pgenhash->slots[slot].hash_val = pgenhash->slots[next].hash_val;
+    pgenhash->slots[slot].dist = pgenhash->slots[next].dist - 1;
+    pgenhash->entries[slot] = pgenhash->entries[next];
+    slot = next;
+    next = (next + 1) & mask;
   }
-  *slot = entry->next;
-  free(entry);
+  pgenhash->slots[slot].dist = 0;
 }
 
 /************************************************************************//**
   Clear previous values (with free callback) and call the copy callbacks.
 ****************************************************************************/
 static inline void genhash_slot_set(struct genhash *pgenhash,
-                                    struct genhash_entry **slot,
+                                    struct genhash_entry *pentry,
                                     const void *key, const void *data)
 {
-  struct genhash_entry *entry = *slot;
-
-  if (NULL != pgenhash->key_free_func) {
-    pgenhash->key_free_func(entry->key);
-  }
-  if (NULL != pgenhash->data_free_func) {
-    pgenhash->data_free_func(entry->data);
-  }
-  entry->key = (NULL != pgenhash->key_copy_func
-                ? pgenhash->key_copy_func(key) : (void *) key);
-  entry->data = (NULL != pgenhash->data_copy_func
-                 ? pgenhash->data_copy_func(data) : (void *) data);
+  genhash_slot_free_data(pgenhash, pentry);
+  pentry->key = (NULL != pgenhash->key_copy_func
+                 ? pgenhash->key_copy_func(key) : (void *) key);
+  pentry->data = (NULL != pgenhash->data_copy_func
+                  ? pgenhash->data_copy_func(data) : (void *) data);
 }
 
 /************************************************************************//**
@@ -529,23 +605,22 @@ size_t genhash_size(const struct genhash *pgenhash)
 }
 
 /************************************************************************//**
-  Returns the number of buckets in the genhash table.
+  Returns the number of slots in the genhash table.
 ****************************************************************************/
 size_t genhash_capacity(const struct genhash *pgenhash)
 {
   fc_assert_ret_val(NULL != pgenhash, 0);
-  return pgenhash->num_buckets;
+  return pgenhash->num_slots;
 }
 
 /************************************************************************//**
   Returns a newly allocated mostly deep copy of the given genhash table.
+  The entries keep their slots, so both tables iterate in the same order.
 ****************************************************************************/
 struct genhash *genhash_copy(const struct genhash *pgenhash)
 {
   struct genhash *new_genhash;
-  struct genhash_entry *const *src_bucket, *const *end;
-  const struct genhash_entry *src_iter;
-  struct genhash_entry **dest_slot, **dest_bucket;
+  size_t i;
 
   fc_assert_ret_val(NULL != pgenhash, NULL);
 
@@ -554,22 +629,28 @@ struct genhash *genhash_copy(const struct genhash *pgenhash)
   /* Copy fields. */
   *new_genhash = *pgenhash;
 
-  /* But make fresh buckets. */
-  new_genhash->buckets = fc_calloc(new_genhash->num_buckets,
-                                   sizeof(*new_genhash->buckets));
-
-  /* Let's re-insert all data */
-  src_bucket = pgenhash->buckets;
-  end = src_bucket + pgenhash->num_buckets;
-  dest_bucket = new_genhash->buckets;
-
-  for (; src_bucket < end; src_bucket++, dest_bucket++) {
-    dest_slot = dest_bucket;
-    for (src_iter = *src_bucket; NULL != src_iter;
-         src_iter = src_iter->next) {
-      genhash_slot_create(new_genhash, dest_slot, src_iter->key,
-                          src_iter->data, src_iter->hash_val);
-      dest_slot = &(*dest_slot)->next;
+  /* But make fresh slots. */
+  new_genhash->slots = fc_malloc(new_genhash->num_slots
+                                 * sizeof(*new_genhash->slots));
+  memcpy(new_genhash->slots, pgenhash->slots,
+         new_genhash->num_slots * sizeof(*new_genhash->slots));
+  new_genhash->entries = fc_malloc(new_genhash->num_slots
+                                   * sizeof(*new_genhash->entries));
+  memcpy(new_genhash->entries, pgenhash->entries,
+         new_genhash->num_slots * sizeof(*new_genhash->entries));
+
+  /* And copy the keys and data. */
+  for (i = 0; i < new_genhash->num_slots; i++) {
+    struct genhash_entry *pentry = new_genhash->entries + i;
+
+    if (0 == new_genhash->slots[i].dist) {
+      continue;
+    }
+    if (NULL != new_genhash->key_copy_func) {
+      pentry->key = new_genhash->key_copy_func(pentry->key);
+    }
+    if (NULL != new_genhash->data_copy_func) {
+      pentry->data = new_genhash->data_copy_func(pentry->data);
     }
   }
 
@@ -581,15 +662,14 @@ struct genhash *genhash_copy(const struct genhash *pgenhash)
 ****************************************************************************/
 void genhash_clear(struct genhash *pgenhash)
 {
-  struct genhash_entry **bucket, **end;
+  size_t i;
 
   fc_assert_ret(NULL != pgenhash);
 
-  bucket = pgenhash->buckets;
-  end = bucket + pgenhash->num_buckets;
-  for (; bucket < end; bucket++) {
-    while (NULL != *bucket) {
-      genhash_slot_free(pgenhash, bucket);
+  for (i = 0; i < pgenhash->num_slots; i++) {
+    if (0 != pgenhash->slots[i].dist) {
+      genhash_slot_free_data(pgenhash, pgenhash->entries + i);
+      pgenhash->slots[i].dist = 0;
     }
   }
 
@@ -604,21 +684,16 @@ void genhash_clear(struct genhash *pgenhash)
 bool genhash_insert(struct genhash *pgenhash, const void *key,
                     const void *data)
 {
-  struct genhash_entry **slot;
   genhash_val_t hash_val;
 
   fc_assert_ret_val(NULL != pgenhash, FALSE);
 
   hash_val = genhash_val_calc(pgenhash, key);
-  slot = genhash_slot_lookup(pgenhash, key, hash_val);
-  if (NULL != *slot) {
+  if (NULL != genhash_slot_lookup(pgenhash, key, hash_val)) {
     return FALSE;
   } else {
-    if (genhash_maybe_expand(pgenhash)) {
-      /* Recalculate slot. */
-      slot = pgenhash->buckets + (hash_val % pgenhash->num_buckets);
-    }
-    genhash_slot_create(pgenhash, slot, key, data, hash_val);
+    genhash_maybe_expand(pgenhash);
+    genhash_slot_create(pgenhash, key, data, hash_val);
     pgenhash->num_entries++;
     return TRUE;
   }
@@ -640,7 +715,7 @@ bool genhash_replace(struct genhash *pgenhash, const void *key,
   Returns TRUE if a data have been replaced, FALSE if it was a simple
   insertion.
 
-  Returns in 'old_pkey' and 'old_pdata' the old content of the bucket if
+  Returns in 'old_pkey' and 'old_pdata' the old content of the entry if
   they are not NULL. NB: It can returns freed pointers if free functions
   were supplied to the genhash table.
 ****************************************************************************/
@@ -648,27 +723,24 @@ bool genhash_replace_full(struct genhash *pgenhash, const void *key,
                           const void *data, void **old_pkey,
                           void **old_pdata)
 {
-  struct genhash_entry **slot;
+  struct genhash_entry *pentry;
   genhash_val_t hash_val;
 
   fc_assert_action(NULL != pgenhash,
                    genhash_default_get(old_pkey, old_pdata); return FALSE);
 
   hash_val = genhash_val_calc(pgenhash, key);
-  slot = genhash_slot_lookup(pgenhash, key, hash_val);
-  if (NULL != *slot) {
+  pentry = genhash_slot_lookup(pgenhash, key, hash_val);
+  if (NULL != pentry) {
     /* Replace. */
-    genhash_slot_get(slot, old_pkey, old_pdata);
-    genhash_slot_set(pgenhash, slot, key, data);
+    genhash_slot_get(pentry, old_pkey, old_pdata);
+    genhash_slot_set(pgenhash, pentry, key, data);
     return TRUE;
   } else {
     /* Insert. */
-    if (genhash_maybe_expand(pgenhash)) {
-      /* Recalculate slot. */
-      slot = pgenhash->buckets + (hash_val % pgenhash->num_buckets);
-    }
+    genhash_maybe_expand(pgenhash);
     genhash_default_get(old_pkey, old_pdata);
-    genhash_slot_create(pgenhash, slot, key, data, hash_val);
+    genhash_slot_create(pgenhash, key, data, hash_val);
     pgenhash->num_entries++;
     return FALSE;
   }
@@ -681,14 +753,15 @@ bool genhash_replace_full(struct genhash *pgenhash, const void *key,
 bool genhash_lookup(const struct genhash *pgenhash, const void *key,
                     void **pdata)
 {
-  struct genhash_entry **slot;
+  struct genhash_entry *pentry;
 
   fc_assert_action(NULL != pgenhash,
                    genhash_default_get(NULL, pdata); return FALSE);
 
-  slot = genhash_slot_lookup(pgenhash, key, genhash_val_calc(pgenhash, key));
-  if (NULL != *slot) {
-    genhash_slot_get(slot, NULL, pdata);
+  pentry = genhash_slot_lookup(pgenhash, key,
+                               genhash_val_calc(pgenhash, key));
+  if (NULL != pentry) {
+    genhash_slot_get(pentry, NULL, pdata);
     return TRUE;
   } else {
     genhash_default_get(NULL, pdata);
@@ -714,19 +787,20 @@ bool genhash_remove(struct genhash *pgenhash, const void *key)
 bool genhash_remove_full(struct genhash *pgenhash, const void *key,
                          void **deleted_pkey, void **deleted_pdata)
 {
-  struct genhash_entry **slot;
+  struct genhash_entry *pentry;
 
   fc_assert_action(NULL != pgenhash,
                    genhash_default_get(deleted_pkey, deleted_pdata);
                    return FALSE);
 
-  slot = genhash_slot_lookup(pgenhash, key, genhash_val_calc(pgenhash, key));
-  if (NULL != *slot) {
-    genhash_slot_get(slot, deleted_pkey, deleted_pdata);
-    genhash_slot_free(pgenhash, slot);
-    genhash_maybe_shrink(pgenhash);
+  pentry = genhash_slot_lookup(pgenhash, key,
+                               genhash_val_calc(pgenhash, key));
+  if (NULL != pentry) {
+    genhash_slot_get(pentry, deleted_pkey, deleted_pdata);
+    genhash_slot_free(pgenhash, pentry);
     fc_assert(0 < pgenhash->num_entries);
     pgenhash->num_entries--;
+    genhash_maybe_shrink(pgenhash);
     return TRUE;
   } else {
     genhash_default_get(deleted_pkey, deleted_pdata);
@@ -751,8 +825,8 @@ bool genhashs_are_equal_full(const struct genhash *pgenhash1,
                              const struct genhash *pgenhash2,
                              genhash_comp_fn_t data_comp_func)
 {
-  struct genhash_entry *const *bucket1, *const *max1, *const *slot2;
-  const struct genhash_entry *iter1;
+  const struct genhash_entry *entry1, *entry2;
+  size_t i;
 
   /* Check pointers. */
   if (pgenhash1 == pgenhash2) {
@@ -770,18 +844,19 @@ bool genhashs_are_equal_full(const struct genhash *pgenhash1,
     return FALSE;
   }
 
-  /* Compare buckets. */
-  bucket1 = pgenhash1->buckets;
-  max1 = bucket1 + pgenhash1->num_buckets;
-  for (; bucket1 < max1; bucket1++) {
-    for (iter1 = *bucket1; NULL != iter1; iter1 = iter1->next) {
-      slot2 = genhash_slot_lookup(pgenhash2, iter1->key, iter1->hash_val);
-      if (NULL == *slot2
-          || (iter1->data != (*slot2)->data
-              && (NULL == data_comp_func
-                  || !data_comp_func(iter1->data, (*slot2)->data)))) {
-        return FALSE;
-      }
+  /* Compare entries. */
+  for (i = 0; i < pgenhash1->num_slots; i++) {
+    if (0 == pgenhash1->slots[i].dist) {
+      continue;
+    }
+    entry1 = pgenhash1->entries + i;
+    entry2 = genhash_slot_lookup(pgenhash2, entry1->key,
+                                 pgenhash1->slots[i].hash_val);
+    if (NULL == entry2
+        || (entry1->data != entry2->data
+            && (NULL == data_comp_func
+                || !data_comp_func(entry1->data, entry2->data)))) {
+      return FALSE;
     }
   }
 
@@ -803,7 +878,7 @@ size_t genhash_iter_sizeof(void)
 void *genhash_iter_key(const struct iterator *genhash_iter)
 {
   struct genhash_iter *iter = GENHASH_ITER(genhash_iter);
-  return (void *) iter->iterator->key;
+  return (void *) iter->entry->key;
 }
 
 /************************************************************************//**
@@ -812,7 +887,7 @@ void *genhash_iter_key(const struct iterator *genhash_iter)
 void *genhash_iter_value(const struct iterator *genhash_iter)
 {
   struct genhash_iter *iter = GENHASH_ITER(genhash_iter);
-  return (void *) iter->iterator->data;
+  return (void *) iter->entry->data;
 }
 
 /************************************************************************//**
@@ -822,14 +897,9 @@ static void genhash_iter_next(struct iterator *genhash_iter)
 {
   struct genhash_iter *iter = GENHASH_ITER(genhash_iter);
 
-  iter->iterator = iter->iterator->next;
-  if (NULL != iter->iterator) {
-    return;
-  }
-
-  for (iter->bucket++; iter->bucket < iter->end; iter->bucket++) {
-    if (NULL != *iter->bucket) {
-      iter->iterator = *iter->bucket;
+  for (iter->slot++, iter->entry++; iter->slot < iter->end;
+       iter->slot++, iter->entry++) {
+    if (0 != iter->slot->dist) {
       return;
     }
   }
@@ -851,7 +921,7 @@ static void *genhash_iter_get(const struct iterator *genhash_iter)
 static bool genhash_iter_valid(const struct iterator *genhash_iter)
 {
   struct genhash_iter *iter = GENHASH_ITER(genhash_iter);
-  return iter->bucket < iter->end;
+  return iter->slot < iter->end;
 }
 
 /************************************************************************//**
@@ -869,13 +939,13 @@ genhash_iter_init_common(struct genhash_iter *iter,
   iter->vtable.next = genhash_iter_next;
   iter->vtable.get = get;
   iter->vtable.valid = genhash_iter_valid;
-  iter->bucket = pgenhash->buckets;
-  iter->end = pgenhash->buckets + pgenhash->num_buckets;
+  iter->slot = pgenhash->slots;
+  iter->end = pgenhash->slots + pgenhash->num_slots;
+  iter->entry = pgenhash->entries;
 
-  /* Seek to the first used bucket. */
-  for (; iter->bucket < iter->end; iter->bucket++) {
-    if (NULL != *iter->bucket) {
-      iter->iterator = *iter->bucket;
+  /* Seek to the first used slot. */
+  for (; iter->slot < iter->end; iter->slot++, iter->entry++) {
+    if (0 != iter->slot->dist) {
       break;
     }
   }
@@ -895,7 +965,7 @@ struct iterator *genhash_iter_init(struct genhash_iter *iter,
 }
 
 /************************************************************************//**
-  Returns an iterator over the genhash table's k genhashgenhashenhashys.
+  Returns an iterator over the genhash table's keys.
 ****************************************************************************/
 struct iterator *genhash_key_iter_init(struct genhash_iter *iter,
                                        const struct genhash *pgenhash)
@@ -26,11 +26,50 @@
 
 /* utility */
 #include "fcintl.h"
+#include "fcthread.h"
 #include "log.h"
 #include "shared.h"		/* TRUE, FALSE */
 
 #include "mem.h"
 
+/* Alignment of the memory handed out by arenas and pools */
+#define MEM_ALIGN (2 * sizeof(void *))
+#define MEM_ALIGN_SIZE(_size) (((_size) + MEM_ALIGN - 1) & ~(MEM_ALIGN - 1))
+
+/* Objects a pool allocates at once */
+#define POOL_CHUNK_OBJS 64
+
+struct arena_block {
+  struct arena_block *next;
+  size_t size;                  /* usable bytes after the header */
+};
+
+struct fc_arena {
+  size_t block_size;
+  struct arena_block *blocks;   /* kept over resets */
+  struct arena_block *current;
+  size_t used;                  /* of the current block */
+  struct arena_block *large;    /* bigger than a block; freed on reset */
+};
+
+struct pool_chunk {
+  struct pool_chunk *next;
+};
+
+struct fc_pool {
+  size_t obj_size;
+  void *free_objs;              /* linked through their first bytes */
+  struct pool_chunk *chunks;
+};
+
+static fc_thread_local struct fc_mem_stats mem_stats;
+
+static struct {
+  bool enabled;
+  fc_mutex mutex;
+  struct fc_mem_tag_usage tags[MEM_TAG_COUNT];
+} accounting;
+
 /******************************************************************//**
   Do whatever we should do when malloc fails.
   At the moment this just prints a log message and calls exit(EXIT_FAILURE)
@@ -90,6 +129,7 @@ void *fc_real_malloc(size_t size,
   if (ptr == NULL) {
     handle_alloc_failure(size, called_as, line, file);
   }
+  mem_stats.mallocs++;
 
   return ptr;
 }
@@ -115,6 +155,7 @@ void *fc_real_realloc(void *ptr, size_t size,
   if (!new_ptr) {
     handle_alloc_failure(size, called_as, line, file);
   }
+  mem_stats.reallocs++;
 
   return new_ptr;
 }
@@ -155,3 +196,323 @@ char *real_fc_strdup(const char *str,
 
   return dest;
 }
+
+/******************************************************************//**
+  Create an arena getting memory from the system in blocks of
+  'block_size' bytes.
+**********************************************************************/
+struct fc_arena *fc_arena_new(size_t block_size)
+{
+  struct fc_arena *arena = fc_calloc(1, sizeof(*arena));
+
+  arena->block_size = MEM_ALIGN_SIZE(block_size);
+
+  return arena;
+}
+
+/******************************************************************//**
+  Free a list of arena blocks.
+**********************************************************************/
+static void arena_blocks_free(struct arena_block *block)
+{
+  while (block != NULL) {
+    struct arena_block *next = block->next;
+
+    free(block);
+    block = next;
+  }
+}
+
+/******************************************************************//**
+  Free an arena and everything allocated from it.
+**********************************************************************/
+void fc_arena_destroy(struct fc_arena *arena)
+{
+  arena_blocks_free(arena->blocks);
+  arena_blocks_free(arena->large);
+  free(arena);
+}
+
+/******************************************************************//**
+  Get 'size' bytes from the arena. They stay valid until the arena is
+  reset or destroyed; there is no way to give them back earlier.
+**********************************************************************/
+void *fc_arena_alloc(struct fc_arena *arena, size_t size)
+{
+  const size_t header = MEM_ALIGN_SIZE(sizeof(struct arena_block));
+  struct arena_block *block;
+
+  size = MEM_ALIGN_SIZE(MAX(size, 1));
+  mem_stats.arena_allocs++;
+
+  if (size > arena->block_size) {
+    block = fc_malloc(header + size);
+    block->size = size;
+    block->next = arena->large;
+    arena->large = block;
+
+    return (char *) block + header;
+  }
+
+  if (arena->current == NULL
+      || arena->used + size > arena->current->size) {
+    /* Move on to the next block, allocating it if needed. */
+    block = (arena->current != NULL ? arena->current->next
+                                    : arena->blocks);
+    if (block == NULL) {
+      block = fc_malloc(header + arena->block_size);
+      block->size = arena->block_size;
+      block->next = NULL;
+      if (arena->current != NULL) {
+        arena->current->next = block;
+      } else {
+        arena->blocks = block;
+      }
+    }
+    arena->current = block;
+    arena->used = 0;
+  }
+
+  block = arena->current;
+  arena->used += size;
+
+  return (char *) block + header + arena->used - size;
+}
+
+/******************************************************************//**
+  Give back everything allocated from the arena. The blocks are kept
+  for the allocations to come.
+**********************************************************************/
+void fc_arena_reset(struct fc_arena *arena)
+{
+  arena_blocks_free(arena->large);
+  arena->large = NULL;
+  arena->current = NULL;
+  arena->used = 0;
+}
+
+/******************************************************************//**
+  Remember where the arena is, for giving back everything allocated
+  from it after this with fc_arena_release().
+**********************************************************************/
+void fc_arena_mark(const struct fc_arena *arena, struct fc_arena_mark *mark)
+{
+  mark->current = arena->current;
+  mark->used = arena->used;
+  mark->large = arena->large;
+}
+
+/******************************************************************//**
+  Give back everything allocated from the arena since the mark was
+  taken. Marks must be released in the reverse order they were taken,
+  and not after a reset of the arena.
+**********************************************************************/
+void fc_arena_release(struct fc_arena *arena,
+                      const struct fc_arena_mark *mark)
+{
+  while (arena->large != mark->large) {
+    struct arena_block *next;
+
+    fc_assert_ret(arena->large != NULL);
+    next = arena->large->next;
+    free(arena->large);
+    arena->large = next;
+  }
+  arena->current = mark->current;
+  arena->used = mark->used;
+}
+
+/******************************************************************//**
+  Returns the number of bytes the arena holds from the system.
+**********************************************************************/
+size_t fc_arena_size(const struct fc_arena *arena)
+{
+  const struct arena_block *block;
+  size_t size = 0;
+
+  for (block = arena->blocks; block != NULL; block = block->next) {
+    size += block->size;
+  }
+  for (block = arena->large; block != NULL; block = block->next) {
+    size += block->size;
+  }
+
+  return size;
+}
+
+/******************************************************************//**
+  Create a pool of objects of 'obj_size' bytes.
+**********************************************************************/
+struct fc_pool *fc_pool_new(size_t obj_size)
+{
+  struct fc_pool *pool = fc_calloc(1, sizeof(*pool));
+
+  pool->obj_size = MEM_ALIGN_SIZE(MAX(obj_size, sizeof(void *)));
+
+  return pool;
+}
+
+/******************************************************************//**
+  Free a pool and all of its objects, also the ones still in use.
+**********************************************************************/
+void fc_pool_destroy(struct fc_pool *pool)
+{
+  while (pool->chunks != NULL) {
+    struct pool_chunk *next = pool->chunks->next;
+
+    free(pool->chunks);
+    pool->chunks = next;
+  }
+  free(pool);
+}
+
+/******************************************************************//**
+  Take an object from the pool. Its contents are undefined.
+**********************************************************************/
+void *fc_pool_alloc(struct fc_pool *pool)
+{
+  void *obj;
+
+  if (pool->free_objs == NULL) {
+    const size_t header = MEM_ALIGN_SIZE(sizeof(struct pool_chunk));
+    struct pool_chunk *chunk
+      = fc_malloc(header + POOL_CHUNK_OBJS * pool->obj_size);
+    char *objs = (char *) chunk + header;
+    int i;
+
+    chunk->next = pool->chunks;
+    pool->chunks = chunk;
+    for (i = POOL_CHUNK_OBJS - 1; i >= 0; i--) {
+      *(void **) (objs + i * pool->obj_size) = pool->free_objs;
+      pool->free_objs = objs + i * pool->obj_size;
+    }
+  }
+
+  obj = pool->free_objs;
+  pool->free_objs = *(void **) obj;
+  mem_stats.pool_allocs++;
+
+  return obj;
+}
+
+/******************************************************************//**
+  Give an object back to the pool it was taken from.
+**********************************************************************/
+void fc_pool_free(struct fc_pool *pool, void *obj)
+{
+  *(void **) obj = pool->free_objs;
+  pool->free_objs = obj;
+  mem_stats.pool_frees++;
+}
+
+/******************************************************************//**
+  Get the allocation counts of the calling thread since the last reset.
+**********************************************************************/
+void fc_mem_stats_get(struct fc_mem_stats *pstats)
+{
+  *pstats = mem_stats;
+}
+
+/******************************************************************//**
+  Reset the allocation counts of the calling thread.
+**********************************************************************/
+void fc_mem_stats_reset(void)
+{
+  memset(&mem_stats, 0, sizeof(mem_stats));
+}
+
+/******************************************************************//**
+  Start counting the memory reported with fc_mem_account(). Must be
+  called before other threads are started.
+**********************************************************************/
+void fc_mem_accounting_init(void)
+{
+  if (!accounting.enabled) {
+    fc_init_mutex(&accounting.mutex);
+    memset(accounting.tags, 0, sizeof(accounting.tags));
+    accounting.enabled = TRUE;
+  }
+}
+
+/******************************************************************//**
+  Stop counting memory.
+**********************************************************************/
+void fc_mem_accounting_free(void)
+{
+  if (accounting.enabled) {
+    accounting.enabled = FALSE;
+    fc_destroy_mutex(&accounting.mutex);
+  }
+}
+
+/******************************************************************//**
+  Returns whether memory is being counted.
+**********************************************************************/
+bool fc_mem_accounting_enabled(void)
+{
+  return accounting.enabled;
+}
+
+/******************************************************************//**
+  Count 'count' blocks of memory, 'bytes' in total, taken by the
+  subsystem. Negative values give them back.
+**********************************************************************/
+void fc_mem_account(enum mem_tag tag, long bytes, int count)
+{
+  struct fc_mem_tag_usage *usage;
+
+  if (!accounting.enabled) {
+    return;
+  }
+  fc_assert_ret(tag >= 0 && tag < MEM_TAG_COUNT);
+
+  usage = &accounting.tags[tag];
+  fc_allocate_mutex(&accounting.mutex);
+  usage->bytes += bytes;
+  usage->count += count;
+  if (count > 0) {
+    usage->total_count += count;
+  }
+  if (usage->bytes > usage->peak_bytes) {
+    usage->peak_bytes = usage->bytes;
+  }
+  fc_release_mutex(&accounting.mutex);
+}
+
+/******************************************************************//**
+  Get the memory counted for the subsystem.
+**********************************************************************/
+void fc_mem_tag_usage_get(enum mem_tag tag, struct fc_mem_tag_usage *usage)
+{
+  fc_assert_ret(tag >= 0 && tag < MEM_TAG_COUNT);
+
+  if (!accounting.enabled) {
+    memset(usage, 0, sizeof(*usage));
+    return;
+  }
+
+  fc_allocate_mutex(&accounting.mutex);
+  *usage = accounting.tags[tag];
+  fc_release_mutex(&accounting.mutex);
+}
+
+/******************************************************************//**
+  Returns the name of the subsystem.
+**********************************************************************/
+const char *mem_tag_name(enum mem_tag tag)
+{
+  static const char *names[MEM_TAG_COUNT] = {
+    [MEM_TAG_MAP] = "map",
+    [MEM_TAG_PLAYER_MAPS] = "player maps",
+    [MEM_TAG_PF] = "pathfinding",
+    [MEM_TAG_CM] = "citizen governor",
+    [MEM_TAG_PACKETS] = "packets",
+    [MEM_TAG_LUA] = "lua",
+    [MEM_TAG_SECFILE] = "secfiles",
+    [MEM_TAG_AI] = "ai"
+  };
+
+  fc_assert_ret_val(tag >= 0 && tag < MEM_TAG_COUNT, NULL);
+
+  return names[tag];
+}
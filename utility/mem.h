@@ -61,6 +61,79 @@ char *real_fc_strdup(const char *str,
                      const char *called_as, int line, const char *file)
                      fc__warn_unused_result;
 
+/* Arenas hand out memory that is all given back at once with
+ * fc_arena_reset(), such as memory needed until the end of the turn,
+ * or with fc_arena_release() back to a mark taken earlier.
+ * Pools keep freed objects of one size for reuse. Neither is thread
+ * safe. */
+struct fc_arena;
+struct fc_pool;
+struct arena_block;
+
+/* Where an arena was at fc_arena_mark() */
+struct fc_arena_mark {
+  struct arena_block *current;
+  size_t used;
+  struct arena_block *large;
+};
+
+struct fc_arena *fc_arena_new(size_t block_size);
+void fc_arena_destroy(struct fc_arena *arena);
+void *fc_arena_alloc(struct fc_arena *arena, size_t size)
+     fc__warn_unused_result;
+void fc_arena_reset(struct fc_arena *arena);
+void fc_arena_mark(const struct fc_arena *arena, struct fc_arena_mark *mark);
+void fc_arena_release(struct fc_arena *arena,
+                      const struct fc_arena_mark *mark);
+size_t fc_arena_size(const struct fc_arena *arena);
+
+struct fc_pool *fc_pool_new(size_t obj_size);
+void fc_pool_destroy(struct fc_pool *pool);
+void *fc_pool_alloc(struct fc_pool *pool) fc__warn_unused_result;
+void fc_pool_free(struct fc_pool *pool, void *obj);
+
+/* Allocations made by the calling thread since the last reset. Plain
+ * free() calls are not counted; memory given back to pools is. */
+struct fc_mem_stats {
+  int mallocs;                  /* fc_malloc(), fc_calloc(), fc_strdup() */
+  int reallocs;
+  int pool_allocs;              /* objects taken from pools */
+  int pool_frees;
+  int arena_allocs;
+};
+
+void fc_mem_stats_get(struct fc_mem_stats *pstats);
+void fc_mem_stats_reset(void);
+
+/* Memory held by the big consumers, as reported by themselves with
+ * fc_mem_account(). Only counted once fc_mem_accounting_init() has been
+ * called, which must happen before any of it is allocated. */
+enum mem_tag {
+  MEM_TAG_MAP,
+  MEM_TAG_PLAYER_MAPS,
+  MEM_TAG_PF,
+  MEM_TAG_CM,
+  MEM_TAG_PACKETS,
+  MEM_TAG_LUA,
+  MEM_TAG_SECFILE,
+  MEM_TAG_AI,
+  MEM_TAG_COUNT
+};
+
+struct fc_mem_tag_usage {
+  long bytes;                   /* held now */
+  long count;                   /* blocks held now */
+  long peak_bytes;
+  long total_count;             /* blocks ever taken */
+};
+
+void fc_mem_accounting_init(void);
+void fc_mem_accounting_free(void);
+bool fc_mem_accounting_enabled(void);
+void fc_mem_account(enum mem_tag tag, long bytes, int count);
+void fc_mem_tag_usage_get(enum mem_tag tag, struct fc_mem_tag_usage *usage);
+const char *mem_tag_name(enum mem_tag tag);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
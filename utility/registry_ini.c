@@ -2908,6 +2908,7 @@ struct section *secfile_section_new(struct section_file *secfile,
   }
 
   psection = fc_malloc(sizeof(struct section));
+  fc_mem_account(MEM_TAG_SECFILE, sizeof(struct section), 1);
   psection->special = EST_NORMAL;
   psection->name = fc_strdup(name);
   psection->entries = entry_list_new_full(entry_destroy);
@@ -2948,6 +2949,7 @@ void section_destroy(struct section *psection)
   entry_list_destroy(psection->entries);
   free(psection->name);
   free(psection);
+  fc_mem_account(MEM_TAG_SECFILE, -(long) sizeof(struct section), -1);
 }
 
 /**********************************************************************//**
@@ -3113,6 +3115,7 @@ static struct entry *entry_new(struct section *psection, const char *name)
   }
 
   pentry = fc_malloc(sizeof(struct entry));
+  fc_mem_account(MEM_TAG_SECFILE, sizeof(struct entry), 1);
   if (long_comment) {
     pentry->name = NULL;
   } else {
@@ -3283,6 +3286,7 @@ void entry_destroy(struct entry *pentry)
     free(pentry->comment);
   }
   free(pentry);
+  fc_mem_account(MEM_TAG_SECFILE, -(long) sizeof(struct entry), -1);
 }
 
 /**********************************************************************//**
@@ -437,7 +437,7 @@ static inline size_t SPECHASH_FOO(_hash_size) (const SPECHASH_HASH *tthis)
 }
 
 /****************************************************************************
-  Return the real number of buckets.
+  Return the real number of slots.
 ****************************************************************************/
 static inline size_t
 SPECHASH_FOO(_hash_capacity) (const SPECHASH_HASH *tthis)
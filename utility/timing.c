@@ -38,12 +38,20 @@
   memory allocation and deallocation for it.  Some of the functions
   below are intended to make this reasonably convenient; see function
   comments.
+
+  Spans are different: they need no timer of their own.  Each thread
+  keeps a stack of its open spans, and every span is recorded with its
+  start, duration, the span it is nested in and the current frame (the
+  server uses the turn).  The record can be written out as a Chrome
+  trace ("chrome://tracing", Perfetto) or as a CSV table of the time
+  spent in each span per frame.
 ***********************************************************************/
 
 #ifdef HAVE_CONFIG_H
 #include <fc_config.h>
 #endif
 
+#include <string.h>
 #include <time.h>
 
 #ifdef HAVE_GETTIMEOFDAY
@@ -56,6 +64,8 @@
 #endif
 
 /* utility */
+#include "fcintl.h"
+#include "fcthread.h"
 #include "log.h"
 #include "mem.h"
 #include "shared.h"		/* TRUE, FALSE */
@@ -102,6 +112,42 @@ struct timer {
   } start;
 };
 
+struct timing_span {
+  const char *name;
+  int frame;
+  int thread;
+  int parent;                   /* enclosing span, or -1 */
+  double start;                 /* seconds since timing_spans_start() */
+  double duration;              /* negative while still open */
+};
+
+/* Most spans recorded, and most nested in each other, before further
+ * ones are dropped. */
+#define TIMING_SPANS_MAX (1 << 20)
+#define TIMING_SPAN_MAX_DEPTH 32
+
+static struct {
+  bool active;
+  bool mutex_init;
+  fc_mutex mutex;
+  int generation;               /* of the current recording */
+  double origin;
+  int frame;
+  int threads;
+
+  struct timing_span *list;
+  int count, size;
+  int dropped;
+} spans;
+
+/* Open spans of this thread. */
+static fc_thread_local struct {
+  int generation;
+  int thread;
+  int depth;
+  int open[TIMING_SPAN_MAX_DEPTH];  /* -1 for dropped spans */
+} span_stack;
+
 /*******************************************************************//**
   Report if clock() returns -1, but only the first time.
   Ignore this timer from now on.
@@ -405,3 +451,333 @@ void timer_usleep_since_start(struct timer *t, long usec)
   fc_usleep(usec);
 #endif
 }
+
+/*******************************************************************//**
+  Returns the wall clock time in seconds, from some fixed point.
+***********************************************************************/
+static double span_clock(void)
+{
+#ifdef HAVE_GETTIMEOFDAY
+  struct timeval now;
+
+  if (gettimeofday(&now, NULL) == -1) {
+    return 0.0;
+  }
+  return now.tv_sec + now.tv_usec / (double)N_USEC_PER_SEC;
+#elif defined HAVE_FTIME
+  struct timeb now;
+
+  ftime(&now);
+  return now.time + now.millitm / 1000.0;
+#else
+  return (double)time(NULL);
+#endif
+}
+
+/*******************************************************************//**
+  Start recording spans, forgetting the ones recorded before.  Must not
+  be called while other threads may begin or end spans.
+***********************************************************************/
+void timing_spans_start(void)
+{
+  if (!spans.mutex_init) {
+    fc_init_mutex(&spans.mutex);
+    spans.mutex_init = TRUE;
+  }
+
+  spans.count = 0;
+  spans.dropped = 0;
+  spans.frame = 0;
+  spans.threads = 0;
+  spans.generation++;
+  spans.origin = span_clock();
+  spans.active = TRUE;
+}
+
+/*******************************************************************//**
+  Stop recording spans and free the record.  Must not be called while
+  other threads may begin or end spans.
+***********************************************************************/
+void timing_spans_stop(void)
+{
+  spans.active = FALSE;
+  if (spans.dropped > 0) {
+    log_verbose("%d timing spans were dropped.", spans.dropped);
+  }
+  FC_FREE(spans.list);
+  spans.count = 0;
+  spans.size = 0;
+}
+
+/*******************************************************************//**
+  Forget the spans recorded so far but keep recording.  Must not be
+  called while any span is open.
+***********************************************************************/
+void timing_spans_clear(void)
+{
+  if (!spans.active) {
+    return;
+  }
+
+  fc_allocate_mutex(&spans.mutex);
+  spans.count = 0;
+  fc_release_mutex(&spans.mutex);
+}
+
+/*******************************************************************//**
+  Returns how many spans were dropped since timing_spans_start()
+  because too many were recorded.
+***********************************************************************/
+int timing_spans_dropped(void)
+{
+  return spans.dropped;
+}
+
+/*******************************************************************//**
+  Returns whether spans are being recorded.
+***********************************************************************/
+bool timing_spans_active(void)
+{
+  return spans.active;
+}
+
+/*******************************************************************//**
+  Set the frame the spans begun from now on belong to.
+***********************************************************************/
+void timing_spans_frame(int frame)
+{
+  spans.frame = frame;
+}
+
+/*******************************************************************//**
+  Begin a span in this thread, nested in the innermost open one.
+***********************************************************************/
+void timing_span_begin(const char *name)
+{
+  struct timing_span *span;
+  double now;
+  int index = -1;
+
+  if (!spans.active) {
+    return;
+  }
+
+  if (span_stack.generation != spans.generation) {
+    /* First span of this thread in this recording. */
+    span_stack.generation = spans.generation;
+    span_stack.thread = 0;
+    span_stack.depth = 0;
+  }
+  if (span_stack.depth >= TIMING_SPAN_MAX_DEPTH) {
+    span_stack.depth++;
+    return;
+  }
+
+  now = span_clock() - spans.origin;
+
+  fc_allocate_mutex(&spans.mutex);
+  if (span_stack.thread == 0) {
+    span_stack.thread = ++spans.threads;
+  }
+  if (spans.count >= TIMING_SPANS_MAX) {
+    spans.dropped++;
+  } else {
+    if (spans.count >= spans.size) {
+      spans.size = MAX(1024, 2 * spans.size);
+      spans.list = fc_realloc(spans.list,
+                              spans.size * sizeof(*spans.list));
+    }
+    index = spans.count++;
+    span = &spans.list[index];
+    span->name = name;
+    span->frame = spans.frame;
+    span->thread = span_stack.thread;
+    span->parent = (span_stack.depth > 0
+                    ? span_stack.open[span_stack.depth - 1] : -1);
+    span->start = now;
+    span->duration = -1.0;
+  }
+  fc_release_mutex(&spans.mutex);
+
+  span_stack.open[span_stack.depth++] = index;
+}
+
+/*******************************************************************//**
+  End the innermost open span of this thread, which must be the one
+  with the given name.
+***********************************************************************/
+void timing_span_end(const char *name)
+{
+  double now;
+  int index;
+
+  if (!spans.active) {
+    return;
+  }
+  if (span_stack.generation != spans.generation
+      || span_stack.depth <= 0) {
+    /* Begun before the recording started. */
+    return;
+  }
+
+  span_stack.depth--;
+  if (span_stack.depth >= TIMING_SPAN_MAX_DEPTH) {
+    return;
+  }
+  index = span_stack.open[span_stack.depth];
+  if (index < 0) {
+    return;
+  }
+
+  now = span_clock() - spans.origin;
+
+  fc_allocate_mutex(&spans.mutex);
+  fc_assert(0 == strcmp(spans.list[index].name, name));
+  spans.list[index].duration = MAX(0.0, now - spans.list[index].start);
+  fc_release_mutex(&spans.mutex);
+}
+
+/*******************************************************************//**
+  Returns the seconds spent in the finished spans with the name in the
+  latest frame, which must be the frame given.
+***********************************************************************/
+double timing_spans_seconds(int frame, const char *name)
+{
+  double seconds = 0.0;
+  int i;
+
+  if (!spans.active) {
+    return 0.0;
+  }
+
+  fc_allocate_mutex(&spans.mutex);
+  for (i = spans.count - 1; i >= 0 && spans.list[i].frame == frame; i--) {
+    if (spans.list[i].duration >= 0.0
+        && 0 == strcmp(spans.list[i].name, name)) {
+      seconds += spans.list[i].duration;
+    }
+  }
+  fc_release_mutex(&spans.mutex);
+
+  return seconds;
+}
+
+/*******************************************************************//**
+  Write the spans recorded so far as a Chrome trace (JSON trace event
+  format) to the file.  Spans still open are left out.
+***********************************************************************/
+bool timing_spans_write_trace(const char *filename)
+{
+  FILE *fp;
+  bool first = TRUE;
+  int i;
+
+  fp = fc_fopen(filename, "w");
+  if (fp == NULL) {
+    log_error(_("Can't open \"%s\" for writing the timing spans."),
+              filename);
+    return FALSE;
+  }
+
+  fprintf(fp, "{\"traceEvents\":[\n");
+  for (i = 0; i < spans.count; i++) {
+    const struct timing_span *span = &spans.list[i];
+
+    if (span->duration < 0.0) {
+      continue;
+    }
+    fprintf(fp, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,"
+            "\"tid\":%d,\"ts\":%.0f,\"dur\":%.0f,"
+            "\"args\":{\"frame\":%d}}",
+            first ? "" : ",\n", span->name, span->thread,
+            span->start * N_USEC_PER_SEC, span->duration * N_USEC_PER_SEC,
+            span->frame);
+    first = FALSE;
+  }
+  fprintf(fp, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+  return fclose(fp) == 0;
+}
+
+/*******************************************************************//**
+  Write the path of the span, the names of it and the spans it is nested
+  in from the outermost, separated by '/', to buf.
+***********************************************************************/
+static void span_path(int index, char *buf, size_t bufsz)
+{
+  if (spans.list[index].parent >= 0) {
+    span_path(spans.list[index].parent, buf, bufsz);
+    fc_strlcat(buf, "/", bufsz);
+  } else {
+    buf[0] = '\0';
+  }
+  fc_strlcat(buf, spans.list[index].name, bufsz);
+}
+
+/*******************************************************************//**
+  Write the spans recorded so far as a CSV table to the file: for each
+  frame and span path, how many times the span was recorded and the
+  seconds spent in it.  Spans still open are left out.
+***********************************************************************/
+bool timing_spans_write_csv(const char *filename)
+{
+  struct span_row {
+    char path[256];
+    int calls;
+    double seconds;
+  } *rows = NULL;
+  int num_rows = 0, rows_size = 0;
+  FILE *fp;
+  int first, last, i, j;
+
+  fp = fc_fopen(filename, "w");
+  if (fp == NULL) {
+    log_error(_("Can't open \"%s\" for writing the timing spans."),
+              filename);
+    return FALSE;
+  }
+
+  fprintf(fp, "frame,span,calls,seconds\n");
+  for (first = 0; first < spans.count; first = last) {
+    /* The spans of a frame follow each other. */
+    for (last = first; last < spans.count
+         && spans.list[last].frame == spans.list[first].frame; last++) {
+      /* Nothing */
+    }
+
+    num_rows = 0;
+    for (i = first; i < last; i++) {
+      char path[256];
+
+      if (spans.list[i].duration < 0.0) {
+        continue;
+      }
+      span_path(i, path, sizeof(path));
+      for (j = 0; j < num_rows; j++) {
+        if (0 == strcmp(rows[j].path, path)) {
+          break;
+        }
+      }
+      if (j == num_rows) {
+        if (num_rows >= rows_size) {
+          rows_size = MAX(32, 2 * rows_size);
+          rows = fc_realloc(rows, rows_size * sizeof(*rows));
+        }
+        sz_strlcpy(rows[j].path, path);
+        rows[j].calls = 0;
+        rows[j].seconds = 0.0;
+        num_rows++;
+      }
+      rows[j].calls++;
+      rows[j].seconds += spans.list[i].duration;
+    }
+
+    for (j = 0; j < num_rows; j++) {
+      fprintf(fp, "%d,%s,%d,%.6f\n", spans.list[first].frame, rows[j].path,
+              rows[j].calls, rows[j].seconds);
+    }
+  }
+  free(rows);
+
+  return fclose(fp) == 0;
+}
@@ -84,6 +84,32 @@ double timer_read_seconds(struct timer *t);
 
 void timer_usleep_since_start(struct timer *t, long usec);
 
+/* Spans: named stretches of wall clock time, nested in each other, to
+ * see where a bigger piece of work spends its time.  The names must be
+ * string constants.  Spans are only recorded between
+ * timing_spans_start() and timing_spans_stop(). */
+#ifdef LOG_TIMERS
+#define TIMING_SPAN_BEGIN(name) timing_span_begin(name)
+#define TIMING_SPAN_END(name) timing_span_end(name)
+#else  /* LOG_TIMERS */
+#define TIMING_SPAN_BEGIN(name)
+#define TIMING_SPAN_END(name)
+#endif /* LOG_TIMERS */
+
+void timing_spans_start(void);
+void timing_spans_stop(void);
+void timing_spans_clear(void);
+int timing_spans_dropped(void);
+bool timing_spans_active(void);
+void timing_spans_frame(int frame);
+
+void timing_span_begin(const char *name);
+void timing_span_end(const char *name);
+double timing_spans_seconds(int frame, const char *name);
+
+bool timing_spans_write_trace(const char *filename);
+bool timing_spans_write_csv(const char *filename);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */